@@ -38,6 +38,12 @@ endif()
 option(MEGAMOL_INSTALL_DEPENDENCIES "MegaMol dependencies in install" ON)
 mark_as_advanced(MEGAMOL_INSTALL_DEPENDENCIES)
 
+# Tests
+option(BUILD_TESTS "Build the unit tests of the plugins, which are run by ctest" OFF)
+if(BUILD_TESTS)
+  enable_testing()
+endif()
+
 # CUDA
 option(ENABLE_CUDA "Enable CUDA, which is needed for certain plugins" OFF)
 if(ENABLE_CUDA)
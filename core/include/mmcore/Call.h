@@ -11,7 +11,9 @@
 #pragma once
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "mmcore/api/MegaMolCore.std.h"
 
@@ -25,6 +27,9 @@ namespace core {
     namespace factories {
         class CallDescription;
     }
+    namespace profiler {
+        class CallProfiler;
+    }
 
 
     /**
@@ -42,6 +47,9 @@ namespace core {
         /** The caller slot registeres itself in the call */
         friend class CallerSlot;
 
+        /** The call profiler caches the names of the callbacks in the call */
+        friend class ::megamol::core::profiler::CallProfiler;
+
         /** Shared ptr type alias */
         using ptr_type = std::shared_ptr<Call>;
 
@@ -109,6 +117,15 @@ namespace core {
         /** The function id mapping */
         unsigned int *funcMap;
 
+        /**
+         * Profiling names of the callbacks, by function id, filled on demand by
+         * the CallProfiler on the thread issuing the call
+         */
+        std::vector<const char*> profilingNames;
+
+        /** The CallProfiler name generation 'profilingNames' was filled in */
+        uint64_t profilingNamesGeneration;
+
     };
 
 
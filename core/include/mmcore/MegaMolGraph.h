@@ -2,7 +2,10 @@
 
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "mmcore/factories/CallDescriptionManager.h"
@@ -173,6 +176,21 @@ private:
 
     std::vector<megamol::frontend::FrontendResource> get_requested_resources(std::vector<std::string> resource_requests);
 
+    // the lookup indices below hold iterators into module_list_ and call_list_,
+    // which stay valid as long as the referenced element is not erased
+    void index_module(ModuleList_t::iterator module_it);
+    void unindex_module(ModuleList_t::iterator module_it);
+    void index_call(CallList_t::iterator call_it);
+    void unindex_call(CallList_t::iterator call_it);
+    void clear_indices();
+
+    struct CallKeyHash {
+        std::size_t operator()(std::pair<std::string, std::string> const& key) const {
+            const std::hash<std::string> hash;
+            return hash(key.first) ^ (hash(key.second) + 0x9e3779b9 + (hash(key.first) << 6) + (hash(key.first) >> 2));
+        }
+    };
+
 
     // the dummy_namespace must be above the call_list_ and module_list_ because it needs to be destroyed AFTER all
     // calls and modules during ~MegaMolGraph()
@@ -184,6 +202,27 @@ private:
     /** List of call that this graph owns */
     CallList_t call_list_;
 
+    /** Modules by normalized (lower case, no leading/trailing '::') name */
+    std::unordered_map<std::string, ModuleList_t::iterator> module_index_;
+
+    /** Modules by exact name, used to match module names as prefixes of slot names */
+    std::unordered_map<std::string, ModuleList_t::iterator> module_id_index_;
+
+    /** Calls by normalized (from, to) slot names */
+    std::unordered_map<std::pair<std::string, std::string>, CallList_t::iterator, CallKeyHash> call_index_;
+
+    /** A resolved parameter slot and the module owning it */
+    struct CachedParamSlot {
+        std::weak_ptr<Module> module;
+        param::ParamSlot* slot;
+    };
+
+    /**
+     * Resolved parameter slots by full parameter name, cleared whenever modules are added, deleted or renamed.
+     * Each hit is validated against the owning module, which may also have made the slot unavailable.
+     */
+    mutable std::unordered_map<std::string, CachedParamSlot> param_slot_cache_;
+
     std::vector<megamol::frontend::FrontendResource> provided_resources;
 
     // for each View in the MegaMol graph we create a GraphEntryPoint
@@ -11,10 +11,13 @@
 #pragma once
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
+#include <memory>
+
 #include "mmcore/AbstractGetData3DCall.h"
 #include "mmcore/factories/CallAutoDescription.h"
 
 #include "mmcore/misc/VolumetricDataCallTypes.h"
+#include "mmcore/misc/VolumetricRangePyramid.h"
 
 #include "vislib/Array.h"
 #include "mmcore/utility/log/Log.h"
@@ -87,6 +90,18 @@ namespace misc {
          */
         static bool GetMetadata(core::misc::VolumetricDataCall& call);
 
+        /**
+         * Invoke the range call and possibly the data call if the source
+         * could not provide the value ranges of the requested frame without
+         * loading it.
+         *
+         * @param call The call to be invoked.
+         *
+         * @return true if the call succeeded and provided the ranges, false
+         *         otherwise.
+         */
+        static bool GetRanges(core::misc::VolumetricDataCall& call);
+
         /** Index of the function retrieving the data. */
         static const unsigned int IDX_GET_DATA;
 
@@ -105,6 +120,27 @@ namespace misc {
         /** Index of the function retrieving data that might be unavailable. */
         static const unsigned int IDX_TRY_GET_DATA;
 
+        /** Index of the function retrieving the value range pyramid. */
+        static const unsigned int IDX_GET_RANGES;
+
+        /** Index of the function retrieving a sub-region of a frame. */
+        static const unsigned int IDX_GET_REGION;
+
+        /**
+         * Answer the resolution of a subsampled level along an axis. Level l
+         * comprises every 2^l-th voxel of the full resolution.
+         *
+         * @param resolution The full resolution.
+         * @param level      The level.
+         *
+         * @return The number of voxels of the level.
+         */
+        static inline size_t GetLevelResolution(const size_t resolution,
+                const unsigned int level) {
+            return (level >= 8 * sizeof(size_t)) ? 1
+                : (resolution + (size_t(1) << level) - 1) >> level;
+        }
+
         /**
          * Initialises a new instance.
          */
@@ -210,6 +246,44 @@ namespace misc {
             return this->metadata;
         }
 
+        /**
+         * Gets the pyramid of value ranges of the current frame. The caller
+         * may keep the pyramid beyond the next request to the callee.
+         *
+         * @return The ranges if available, nullptr otherwise.
+         */
+        inline const std::shared_ptr<const VolumetricRangePyramid>&
+        GetRanges(void) const {
+            return this->ranges;
+        }
+
+        /**
+         * Gets the level of the region requested via IDX_GET_REGION.
+         *
+         * @return The level of the region.
+         */
+        inline unsigned int GetRegionLevel(void) const {
+            return this->regionLevel;
+        }
+
+        /**
+         * Gets the first voxel of the region requested via IDX_GET_REGION.
+         *
+         * @return The first voxel on the level of the region.
+         */
+        inline const size_t *GetRegionOrigin(void) const {
+            return this->regionOrigin;
+        }
+
+        /**
+         * Gets the size of the region requested via IDX_GET_REGION.
+         *
+         * @return The number of voxels of the region along each axis.
+         */
+        inline const size_t *GetRegionSize(void) const {
+            return this->regionSize;
+        }
+
         /**
          * Gets the resolution in the specified dimension.
          *
@@ -310,6 +384,29 @@ namespace misc {
          */
         void SetMetadata(const Metadata *metadata);
 
+        /**
+         * Sets the region that IDX_GET_REGION retrieves from the current
+         * frame. After the call, GetData() designates the voxels of the
+         * region in x-fastest order in the scalar format of the metadata.
+         *
+         * @param origin The first voxel on the given level.
+         * @param size   The number of voxels along each axis.
+         * @param level  The level, see GetLevelResolution().
+         */
+        void SetRegion(const size_t origin[3], const size_t size[3],
+            const unsigned int level = 0);
+
+        /**
+         * Update the value ranges.
+         *
+         * @param ranges The ranges of the current frame. The callee must not
+         *               modify the pyramid after passing it to the call.
+         */
+        inline void SetRanges(
+                std::shared_ptr<const VolumetricRangePyramid> ranges) {
+            this->ranges = std::move(ranges);
+        }
+
         /**
          * Assignment.
          *
@@ -325,7 +422,7 @@ namespace misc {
         typedef AbstractGetData3DCall Base;
 
         /** The functions that are provided by the call. */
-        static const char *FUNCTIONS[6];
+        static const char *FUNCTIONS[8];
 
         /** The pointer to the raw data. The call does not own this memory! */
         void *data;
@@ -336,6 +433,18 @@ namespace misc {
         /** Pointer to the metadata descriptor of the data set. */
         const Metadata *metadata;
 
+        /** The value ranges of the current frame, shared with the callee. */
+        std::shared_ptr<const VolumetricRangePyramid> ranges;
+
+        /** The level of the requested region. */
+        unsigned int regionLevel;
+
+        /** The first voxel of the requested region. */
+        size_t regionOrigin[3];
+
+        /** The size of the requested region. */
+        size_t regionSize[3];
+
     };
 
     /** Call Descriptor.  */
@@ -0,0 +1,277 @@
+/*
+ * VolumetricRangePyramid.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mmcore/api/MegaMolCore.std.h"
+
+#include "mmcore/misc/VolumetricDataCallTypes.h"
+
+
+namespace megamol {
+namespace core {
+namespace misc {
+
+    /**
+     * Value ranges of one frame of a cartesian volume, organised as a pyramid
+     * of bricks (macrocells).
+     *
+     * A brick on level 0 covers the cells between BrickSize() + 1 voxels per
+     * axis, ie neighbouring bricks share their border voxels. Its minimum and
+     * maximum therefore bound every value that can be interpolated within the
+     * brick. Each level above merges 2 x 2 x 2 bricks of the level below until
+     * a single brick remains, which holds the range of the whole frame.
+     *
+     * In addition, each brick holds a coarse histogram per component over the
+     * range of the whole frame. Histograms count every voxel exactly once,
+     * shared border voxels are assigned to the brick with the higher index,
+     * ie a brick owns the voxels from its first one up to, but excluding, the
+     * first voxel of its successor.
+     */
+    class MEGAMOLCORE_API VolumetricRangePyramid {
+
+    public:
+
+        /** The default number of voxels along the edge of a brick. */
+        static const size_t DEFAULT_BRICK_SIZE;
+
+        /** The default number of histogram bins. */
+        static const size_t DEFAULT_BINS;
+
+        /**
+         * Answer the path of the sidecar file that caches the pyramids of a
+         * dat file.
+         *
+         * @param datFile The path to the dat file.
+         *
+         * @return The path to the sidecar file.
+         */
+        static std::string SidecarPath(const std::string& datFile);
+
+        /**
+         * Computes the global minimum and maximum of each component in
+         * parallel without building a pyramid.
+         *
+         * @param data        The voxels in x-fastest order, components
+         *                    interleaved.
+         * @param resolution  The number of voxels along each axis.
+         * @param components  The number of components per voxel.
+         * @param type        The type of the scalars.
+         * @param length      The size of a scalar in bytes.
+         * @param outMins     Receives the minimum of each component.
+         * @param outMaxes    Receives the maximum of each component.
+         *
+         * @return false if the scalar format is not supported.
+         */
+        static bool ComputeMinMax(const void *data, const size_t resolution[3],
+            const size_t components, const ScalarType_t type,
+            const size_t length, std::vector<double>& outMins,
+            std::vector<double>& outMaxes);
+
+        /**
+         * Initialises an empty instance.
+         */
+        VolumetricRangePyramid(void);
+
+        /**
+         * Builds the pyramid for one frame in parallel.
+         *
+         * @param data        The voxels in x-fastest order, components
+         *                    interleaved.
+         * @param resolution  The number of voxels along each axis.
+         * @param components  The number of components per voxel.
+         * @param type        The type of the scalars.
+         * @param length      The size of a scalar in bytes.
+         * @param frameID     The frame the data belong to.
+         * @param brickSize   The number of cells along the edge of a brick.
+         * @param bins        The number of histogram bins.
+         *
+         * @return false if the scalar format is not supported, in which case
+         *         the pyramid is cleared.
+         */
+        bool Compute(const void *data, const size_t resolution[3],
+            const size_t components, const ScalarType_t type,
+            const size_t length, const unsigned int frameID,
+            const size_t brickSize = DEFAULT_BRICK_SIZE,
+            const size_t bins = DEFAULT_BINS);
+
+        /**
+         * Removes all data.
+         */
+        void Clear(void);
+
+        /**
+         * Answer whether the pyramid holds data.
+         */
+        inline bool IsValid(void) const {
+            return !this->levels.empty();
+        }
+
+        /** Answer the frame the pyramid was built for. */
+        inline unsigned int FrameID(void) const {
+            return this->frameID;
+        }
+
+        /** Answer the number of cells along the edge of a level 0 brick. */
+        inline size_t BrickSize(void) const {
+            return this->brickSize;
+        }
+
+        /** Answer the number of histogram bins. */
+        inline size_t Bins(void) const {
+            return this->bins;
+        }
+
+        /** Answer the number of components per voxel. */
+        inline size_t Components(void) const {
+            return this->components;
+        }
+
+        /** Answer the number of levels, the last one has a single brick. */
+        inline size_t Levels(void) const {
+            return this->levels.size();
+        }
+
+        /**
+         * Answer the number of bricks along an axis.
+         *
+         * @param level The level, level 0 is the finest.
+         * @param axis  The axis within [0, 3[.
+         */
+        inline size_t BrickCount(const size_t level, const int axis) const {
+            return this->levels[level].Bricks[axis];
+        }
+
+        /**
+         * Answer the minimum of a component within a brick.
+         */
+        inline double Min(const size_t level, const size_t x, const size_t y,
+                const size_t z, const size_t c = 0) const {
+            auto& l = this->levels[level];
+            return l.Mins[this->brickIndex(l, x, y, z) * this->components + c];
+        }
+
+        /**
+         * Answer the maximum of a component within a brick.
+         */
+        inline double Max(const size_t level, const size_t x, const size_t y,
+                const size_t z, const size_t c = 0) const {
+            auto& l = this->levels[level];
+            return l.Maxes[this->brickIndex(l, x, y, z) * this->components + c];
+        }
+
+        /**
+         * Answer the Bins() counts of a component within a brick. The bins
+         * evenly divide [GlobalMin(c), GlobalMax(c)].
+         */
+        inline const uint64_t *Histogram(const size_t level, const size_t x,
+                const size_t y, const size_t z, const size_t c = 0) const {
+            auto& l = this->levels[level];
+            return l.Histograms.data() + (this->brickIndex(l, x, y, z)
+                * this->components + c) * this->bins;
+        }
+
+        /** Answer the minimum of a component within the whole frame. */
+        inline double GlobalMin(const size_t c = 0) const {
+            return this->levels.back().Mins[c];
+        }
+
+        /** Answer the maximum of a component within the whole frame. */
+        inline double GlobalMax(const size_t c = 0) const {
+            return this->levels.back().Maxes[c];
+        }
+
+        /**
+         * Answer a conservative range of the values that can be interpolated
+         * within a box of voxels using the level 0 bricks.
+         *
+         * @param lo     The first voxel of the box.
+         * @param hi     The last voxel of the box (inclusive).
+         * @param c      The component.
+         * @param outMin Receives the lower bound.
+         * @param outMax Receives the upper bound.
+         */
+        void QueryRange(const size_t lo[3], const size_t hi[3], const size_t c,
+            double& outMin, double& outMax) const;
+
+        /**
+         * Loads the pyramid of a frame from a sidecar file. The file is only
+         * used if it matches the format of the volume and is not older than
+         * any of the files the volume is read from.
+         *
+         * @param path    The path to the sidecar file.
+         * @param sources The dat file and the raw file(s) of the volume.
+         *
+         * @return true if the frame was found in the file, false otherwise,
+         *         in which case the pyramid remains unchanged.
+         */
+        bool Load(const std::string& path,
+            const std::vector<std::string>& sources,
+            const size_t resolution[3], const size_t components,
+            const ScalarType_t type, const size_t length,
+            const size_t frames, const unsigned int frameID,
+            const size_t brickSize = DEFAULT_BRICK_SIZE,
+            const size_t bins = DEFAULT_BINS);
+
+        /**
+         * Stores the pyramid in a sidecar file. Other frames already stored
+         * in the file are kept if the file matches the format of the volume
+         * and is not older than any of 'sources', otherwise the file is
+         * recreated.
+         *
+         * @param path    The path to the sidecar file.
+         * @param sources The dat file and the raw file(s) of the volume.
+         *
+         * @return true on success, false otherwise.
+         */
+        bool Save(const std::string& path,
+            const std::vector<std::string>& sources,
+            const ScalarType_t type, const size_t length,
+            const size_t frames) const;
+
+    private:
+
+        /** The bricks of a single level. */
+        struct Level {
+            size_t Bricks[3];
+            std::vector<double> Mins;
+            std::vector<double> Maxes;
+            std::vector<uint64_t> Histograms;
+        };
+
+        /** Allocates all levels for the current resolution. */
+        void allocate(void);
+
+        /** Merges level 'level' - 1 into 'level'. */
+        void merge(const size_t level);
+
+        inline size_t brickIndex(const Level& l, const size_t x,
+                const size_t y, const size_t z) const {
+            return (z * l.Bricks[1] + y) * l.Bricks[0] + x;
+        }
+
+        size_t bins;
+
+        size_t brickSize;
+
+        size_t components;
+
+        unsigned int frameID;
+
+        std::vector<Level> levels;
+
+        size_t resolution[3];
+
+    };
+
+} /* end namespace misc */
+} /* end namespace core */
+} /* end namespace megamol */
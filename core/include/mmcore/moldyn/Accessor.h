@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstdint>
+#include <cstring>
+#include <limits>
 #include <type_traits>
 
 #if !defined(_MSC_VER)
@@ -25,6 +28,54 @@ template <class T> T const* access(char const* ptr, size_t idx, size_t stride) {
 }
 
 
+/**
+ * Decodes the elements [begin, end) of a strided array, where each element
+ * consists of N consecutive values of type T, into the tightly packed output
+ * array 'out' holding N values of type R per element. If Norm is set,
+ * integral values are normalized to [0, 1].
+ *
+ * Tightly packed input is converted in a single flat loop, which compilers
+ * vectorize; otherwise each element is loaded separately.
+ */
+template <class T, class R, unsigned int N, bool Norm = false>
+void decode_strided(char const* ptr, size_t stride, size_t begin, size_t end, R* out) {
+    static_assert(std::is_floating_point<R>::value, "decoding is only supported into floating point types");
+    R const scale = (Norm && std::is_integral<T>::value) ? static_cast<R>(1) / static_cast<R>(std::numeric_limits<T>::max())
+                                                         : static_cast<R>(1);
+    if (end <= begin) return;
+    if (stride == N * sizeof(T)) {
+        T const* src = reinterpret_cast<T const*>(ptr + begin * stride);
+        size_t const cnt = (end - begin) * N;
+        for (size_t k = 0; k < cnt; ++k) {
+            out[k] = static_cast<R>(src[k]) * scale;
+        }
+    } else {
+        T tmp[N];
+        for (size_t i = begin; i < end; ++i, out += N) {
+            std::memcpy(tmp, ptr + i * stride, N * sizeof(T));
+            for (unsigned int c = 0; c < N; ++c) {
+                out[c] = static_cast<R>(tmp[c]) * scale;
+            }
+        }
+    }
+}
+
+
+/**
+ * Decodes the single component 'comp' of the elements [begin, end) of a
+ * strided array of T into the tightly packed output array 'out'.
+ */
+template <class T, class R>
+void decode_strided_component(char const* ptr, size_t stride, unsigned int comp, size_t begin, size_t end, R* out) {
+    char const* base = ptr + comp * sizeof(T);
+    T tmp;
+    for (size_t i = begin; i < end; ++i) {
+        std::memcpy(&tmp, base + i * stride, sizeof(T));
+        out[i - begin] = static_cast<R>(tmp);
+    }
+}
+
+
 /**
  * Interface for accessor classes.
  */
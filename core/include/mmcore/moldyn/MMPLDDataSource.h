@@ -118,6 +118,8 @@ namespace moldyn {
              */
             inline void Clear(void) {
                 this->dat.EnforceSize(0);
+                this->mapped = nullptr;
+                this->mappedSize = 0;
             }
 
             /**
@@ -133,6 +135,18 @@ namespace moldyn {
              */
             bool LoadFrame(vislib::sys::File *file, unsigned int idx, UINT64 size, unsigned int version);
 
+            /**
+             * Points this object to frame data residing in a memory-mapped
+             * file. No data is copied; the memory must stay mapped as long as
+             * this frame is in use.
+             *
+             * @param data Pointer to the first byte of the frame data
+             * @param idx The zero-based index of the frame
+             * @param size The size of the frame data in bytes
+             * @param version File version (100 = standard, 101 with clusterInfos)
+             */
+            void MapFrame(const void *data, unsigned int idx, UINT64 size, unsigned int version);
+
             /**
              * Sets the data into the call
              *
@@ -142,9 +156,37 @@ namespace moldyn {
 
         private:
 
+            /**
+             * Answer whether this frame holds any data
+             *
+             * @return True if data has been loaded or mapped
+             */
+            inline bool hasData(void) const {
+                return (this->mapped != nullptr) ? (this->mappedSize > 0) : !this->dat.IsEmpty();
+            }
+
+            /**
+             * Answer a typed pointer into the frame data
+             *
+             * @param offset The offset in bytes from the beginning of the frame
+             *
+             * @return Pointer to the data at 'offset'
+             */
+            template<class T>
+            inline const T *dataAt(SIZE_T offset) const {
+                return reinterpret_cast<const T *>((this->mapped != nullptr)
+                    ? (this->mapped + offset) : this->dat.At(offset));
+            }
+
             /** position data per type */
             vislib::RawStorage dat;
 
+            /** frame data inside the memory-mapped file, or nullptr if 'dat' is used */
+            const unsigned char *mapped;
+
+            /** size of the mapped frame data in bytes */
+            UINT64 mappedSize;
+
             /** file version */
             unsigned int fileVersion;
 
@@ -215,6 +257,27 @@ namespace moldyn {
          */
         bool getExtentCallback(Call& caller);
 
+        /**
+         * Maps the whole opened file into memory.
+         *
+         * @return 'true' on success, 'false' on failure.
+         */
+        bool mapFile(void);
+
+        /**
+         * Unmaps the file if it is mapped.
+         */
+        void unmapFile(void);
+
+        /**
+         * Hints the operating system that the given frames will be accessed
+         * soon, such that their pages are read ahead.
+         *
+         * @param first The first frame to be prefetched
+         * @param cnt The number of frames to be prefetched
+         */
+        void prefetchFrames(unsigned int first, unsigned int cnt);
+
         /** The file name */
         param::ParamSlot filename;
 
@@ -227,6 +290,12 @@ namespace moldyn {
         /** Override local bbox */
         param::ParamSlot overrideBBoxSlot;
 
+        /** Memory-maps the file instead of reading frames into the cache */
+        param::ParamSlot useMMapSlot;
+
+        /** Number of frames following the requested one to be prefetched when memory-mapping */
+        param::ParamSlot prefetchFramesSlot;
+
         /** The slot for requesting data */
         CalleeSlot getData;
 
@@ -236,6 +305,12 @@ namespace moldyn {
         /** The frame index table */
         UINT64 *frameIdx;
 
+        /** The memory-mapped file content, or nullptr if not mapped */
+        unsigned char *mappedData;
+
+        /** The size of the mapping in bytes */
+        UINT64 mappedSize;
+
         /** The data set bounding box */
         vislib::math::Cuboid<float> bbox;
 
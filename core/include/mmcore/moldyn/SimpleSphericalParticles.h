@@ -1,5 +1,7 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <type_traits>
 
@@ -72,6 +74,10 @@ public:
 
         void SetVertexData(SimpleSphericalParticles::VertexDataType const t, char const* p, unsigned int const s = 0,
             float const globRad = 0.5f) {
+            this->vert_type_ = t;
+            this->vert_ptr_ = p;
+            this->vert_stride_ = (s == 0) ? SimpleSphericalParticles::VertexDataSize[t] : s;
+            this->glob_rad_ = globRad;
             switch (t) {
             case SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ: {
                 this->x_acc_ = std::make_shared<Accessor_Impl<double>>(p, s);
@@ -110,6 +116,13 @@ public:
         void SetColorData(SimpleSphericalParticles::ColourDataType const t, char const* p, unsigned int const s = 0,
             unsigned char const r = 255, unsigned char const g = 255, unsigned char const b = 255,
             unsigned char const a = 255) {
+            this->col_type_ = t;
+            this->col_ptr_ = p;
+            this->col_stride_ = (s == 0) ? SimpleSphericalParticles::ColorDataSize[t] : s;
+            this->glob_col_[0] = r;
+            this->glob_col_[1] = g;
+            this->glob_col_[2] = b;
+            this->glob_col_[3] = a;
             switch (t) {
             case SimpleSphericalParticles::COLDATA_DOUBLE_I: {
                 this->cr_acc_ = std::make_shared<Accessor_Impl<double>>(p, s);
@@ -164,6 +177,9 @@ public:
         }
 
         void SetDirData(SimpleSphericalParticles::DirDataType const t, char const* p, unsigned int const s = 0) {
+            this->dir_type_ = t;
+            this->dir_ptr_ = p;
+            this->dir_stride_ = (s == 0) ? SimpleSphericalParticles::DirDataSize[t] : s;
             switch (t) {
             case DIRDATA_FLOAT_XYZ: {
                 this->dx_acc_ = std::make_shared<Accessor_Impl<float>>(p, s);
@@ -179,6 +195,9 @@ public:
         }
 
         void SetIDData(SimpleSphericalParticles::IDDataType const t, char const* p, unsigned int const s = 0) {
+            this->id_type_ = t;
+            this->id_ptr_ = p;
+            this->id_stride_ = (s == 0) ? SimpleSphericalParticles::IDDataSize[t] : s;
             switch (t) {
             case SimpleSphericalParticles::IDDATA_UINT32: {
                 this->id_acc_ = std::make_shared<Accessor_Impl<unsigned int>>(reinterpret_cast<char const*>(p), s);
@@ -215,6 +234,222 @@ public:
 
         std::shared_ptr<Accessor> const& GetIDAcc() const { return this->id_acc_; }
 
+        /**
+         * Decodes the positions of the particles [begin, end) into 'xyz',
+         * three values per particle. In contrast to the accessors, this
+         * dispatches on the vertex data type once per range instead of once
+         * per value.
+         *
+         * @param begin The index of the first particle
+         * @param end The index after the last particle
+         * @param xyz Output array of at least 3 * (end - begin) values
+         */
+        template <class R> void GetPositions(size_t const begin, size_t const end, R* xyz) const {
+            switch (this->vert_type_) {
+            case SimpleSphericalParticles::VERTDATA_FLOAT_XYZ:
+            case SimpleSphericalParticles::VERTDATA_FLOAT_XYZR:
+                decode_strided<float, R, 3>(this->vert_ptr_, this->vert_stride_, begin, end, xyz);
+                break;
+            case SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ:
+                decode_strided<double, R, 3>(this->vert_ptr_, this->vert_stride_, begin, end, xyz);
+                break;
+            case SimpleSphericalParticles::VERTDATA_SHORT_XYZ:
+                decode_strided<unsigned short, R, 3>(this->vert_ptr_, this->vert_stride_, begin, end, xyz);
+                break;
+            case SimpleSphericalParticles::VERTDATA_NONE:
+            default:
+                std::fill(xyz, xyz + 3 * (end - begin), static_cast<R>(0));
+            }
+        }
+
+        /**
+         * Decodes the positions of the particles [begin, end) into three
+         * separate arrays.
+         *
+         * @param begin The index of the first particle
+         * @param end The index after the last particle
+         * @param x Output array of at least (end - begin) values
+         * @param y Output array of at least (end - begin) values
+         * @param z Output array of at least (end - begin) values
+         */
+        template <class R> void GetPositions(size_t const begin, size_t const end, R* x, R* y, R* z) const {
+            R* const out[3] = {x, y, z};
+            for (unsigned int c = 0; c < 3; ++c) {
+                switch (this->vert_type_) {
+                case SimpleSphericalParticles::VERTDATA_FLOAT_XYZ:
+                case SimpleSphericalParticles::VERTDATA_FLOAT_XYZR:
+                    decode_strided_component<float, R>(this->vert_ptr_, this->vert_stride_, c, begin, end, out[c]);
+                    break;
+                case SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ:
+                    decode_strided_component<double, R>(this->vert_ptr_, this->vert_stride_, c, begin, end, out[c]);
+                    break;
+                case SimpleSphericalParticles::VERTDATA_SHORT_XYZ:
+                    decode_strided_component<unsigned short, R>(
+                        this->vert_ptr_, this->vert_stride_, c, begin, end, out[c]);
+                    break;
+                case SimpleSphericalParticles::VERTDATA_NONE:
+                default:
+                    std::fill(out[c], out[c] + (end - begin), static_cast<R>(0));
+                }
+            }
+        }
+
+        /**
+         * Decodes the radii of the particles [begin, end) into 'r'. Yields
+         * the global radius unless the vertex data type is
+         * VERTDATA_FLOAT_XYZR.
+         *
+         * @param begin The index of the first particle
+         * @param end The index after the last particle
+         * @param r Output array of at least (end - begin) values
+         */
+        template <class R> void GetRadii(size_t const begin, size_t const end, R* r) const {
+            if (this->vert_type_ == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR) {
+                decode_strided_component<float, R>(this->vert_ptr_, this->vert_stride_, 3, begin, end, r);
+            } else {
+                std::fill(r, r + (end - begin), static_cast<R>(this->glob_rad_));
+            }
+        }
+
+        /**
+         * Decodes the colours of the particles [begin, end) into 'rgba',
+         * four values per particle. Unlike the accessors, integral colour
+         * components are normalized to [0, 1]. Missing alpha is reported as
+         * 1. Intensities (COLDATA_FLOAT_I, COLDATA_DOUBLE_I) are written to
+         * the first component, the remaining components are 0.
+         *
+         * @param begin The index of the first particle
+         * @param end The index after the last particle
+         * @param rgba Output array of at least 4 * (end - begin) values
+         */
+        template <class R> void GetColors(size_t const begin, size_t const end, R* rgba) const {
+            size_t const cnt = end - begin;
+            switch (this->col_type_) {
+            case SimpleSphericalParticles::COLDATA_UINT8_RGBA:
+                decode_strided<unsigned char, R, 4, true>(this->col_ptr_, this->col_stride_, begin, end, rgba);
+                break;
+            case SimpleSphericalParticles::COLDATA_USHORT_RGBA:
+                decode_strided<unsigned short, R, 4, true>(this->col_ptr_, this->col_stride_, begin, end, rgba);
+                break;
+            case SimpleSphericalParticles::COLDATA_FLOAT_RGBA:
+                decode_strided<float, R, 4>(this->col_ptr_, this->col_stride_, begin, end, rgba);
+                break;
+            case SimpleSphericalParticles::COLDATA_UINT8_RGB:
+            case SimpleSphericalParticles::COLDATA_FLOAT_RGB: {
+                R rgb[3 * 256];
+                for (size_t b = begin; b < end; b += 256) {
+                    size_t const e = std::min(end, b + 256);
+                    if (this->col_type_ == SimpleSphericalParticles::COLDATA_UINT8_RGB) {
+                        decode_strided<unsigned char, R, 3, true>(this->col_ptr_, this->col_stride_, b, e, rgb);
+                    } else {
+                        decode_strided<float, R, 3>(this->col_ptr_, this->col_stride_, b, e, rgb);
+                    }
+                    R* out = rgba + 4 * (b - begin);
+                    for (size_t i = 0; i < e - b; ++i) {
+                        out[4 * i + 0] = rgb[3 * i + 0];
+                        out[4 * i + 1] = rgb[3 * i + 1];
+                        out[4 * i + 2] = rgb[3 * i + 2];
+                        out[4 * i + 3] = static_cast<R>(1);
+                    }
+                }
+            } break;
+            case SimpleSphericalParticles::COLDATA_FLOAT_I:
+            case SimpleSphericalParticles::COLDATA_DOUBLE_I: {
+                std::fill(rgba, rgba + 4 * cnt, static_cast<R>(0));
+                for (size_t b = begin; b < end; b += 256) {
+                    R val[256];
+                    size_t const e = std::min(end, b + 256);
+                    if (this->col_type_ == SimpleSphericalParticles::COLDATA_FLOAT_I) {
+                        decode_strided<float, R, 1>(this->col_ptr_, this->col_stride_, b, e, val);
+                    } else {
+                        decode_strided<double, R, 1>(this->col_ptr_, this->col_stride_, b, e, val);
+                    }
+                    for (size_t i = 0; i < e - b; ++i) {
+                        rgba[4 * (b - begin + i)] = val[i];
+                    }
+                }
+            } break;
+            case SimpleSphericalParticles::COLDATA_NONE:
+            default: {
+                R const norm = static_cast<R>(1) / static_cast<R>(255);
+                for (size_t i = 0; i < cnt; ++i) {
+                    for (unsigned int c = 0; c < 4; ++c) {
+                        rgba[4 * i + c] = static_cast<R>(this->glob_col_[c]) * norm;
+                    }
+                }
+            }
+            }
+        }
+
+        /**
+         * Decodes the intensities of the particles [begin, end) into 'i'.
+         * Yields 0 if the colour data type is not an intensity.
+         *
+         * @param begin The index of the first particle
+         * @param end The index after the last particle
+         * @param i Output array of at least (end - begin) values
+         */
+        template <class R> void GetIntensities(size_t const begin, size_t const end, R* i) const {
+            switch (this->col_type_) {
+            case SimpleSphericalParticles::COLDATA_FLOAT_I:
+                decode_strided<float, R, 1>(this->col_ptr_, this->col_stride_, begin, end, i);
+                break;
+            case SimpleSphericalParticles::COLDATA_DOUBLE_I:
+                decode_strided<double, R, 1>(this->col_ptr_, this->col_stride_, begin, end, i);
+                break;
+            default:
+                std::fill(i, i + (end - begin), static_cast<R>(0));
+            }
+        }
+
+        /**
+         * Decodes the directions of the particles [begin, end) into 'dxyz',
+         * three values per particle.
+         *
+         * @param begin The index of the first particle
+         * @param end The index after the last particle
+         * @param dxyz Output array of at least 3 * (end - begin) values
+         */
+        template <class R> void GetDirections(size_t const begin, size_t const end, R* dxyz) const {
+            if (this->dir_type_ == SimpleSphericalParticles::DIRDATA_FLOAT_XYZ) {
+                decode_strided<float, R, 3>(this->dir_ptr_, this->dir_stride_, begin, end, dxyz);
+            } else {
+                std::fill(dxyz, dxyz + 3 * (end - begin), static_cast<R>(0));
+            }
+        }
+
+        /**
+         * Copies the IDs of the particles [begin, end) into 'id'. Yields 0 if
+         * there are no IDs.
+         *
+         * @param begin The index of the first particle
+         * @param end The index after the last particle
+         * @param id Output array of at least (end - begin) values
+         */
+        void GetIDs(size_t const begin, size_t const end, uint64_t* id) const {
+            switch (this->id_type_) {
+            case SimpleSphericalParticles::IDDATA_UINT32: {
+                uint32_t tmp;
+                for (size_t i = begin; i < end; ++i) {
+                    std::memcpy(&tmp, this->id_ptr_ + i * this->id_stride_, sizeof(uint32_t));
+                    id[i - begin] = tmp;
+                }
+            } break;
+            case SimpleSphericalParticles::IDDATA_UINT64:
+                if (this->id_stride_ == sizeof(uint64_t)) {
+                    std::memcpy(id, this->id_ptr_ + begin * sizeof(uint64_t), (end - begin) * sizeof(uint64_t));
+                } else {
+                    for (size_t i = begin; i < end; ++i) {
+                        std::memcpy(id + (i - begin), this->id_ptr_ + i * this->id_stride_, sizeof(uint64_t));
+                    }
+                }
+                break;
+            case SimpleSphericalParticles::IDDATA_NONE:
+            default:
+                std::fill(id, id + (end - begin), static_cast<uint64_t>(0));
+            }
+        }
+
     private:
         std::shared_ptr<Accessor> x_acc_  = std::make_shared<Accessor_0>();
         std::shared_ptr<Accessor> y_acc_  = std::make_shared<Accessor_0>();
@@ -228,6 +463,22 @@ public:
         std::shared_ptr<Accessor> dy_acc_ = std::make_shared<Accessor_0>();
         std::shared_ptr<Accessor> dz_acc_ = std::make_shared<Accessor_0>();
         std::shared_ptr<Accessor> id_acc_ = std::make_shared<Accessor_0>();
+
+        // raw layout used by the batch decoders
+        SimpleSphericalParticles::VertexDataType vert_type_ = SimpleSphericalParticles::VERTDATA_NONE;
+        char const* vert_ptr_ = nullptr;
+        unsigned int vert_stride_ = 0;
+        float glob_rad_ = 0.5f;
+        SimpleSphericalParticles::ColourDataType col_type_ = SimpleSphericalParticles::COLDATA_NONE;
+        char const* col_ptr_ = nullptr;
+        unsigned int col_stride_ = 0;
+        unsigned char glob_col_[4] = {255, 255, 255, 255};
+        SimpleSphericalParticles::DirDataType dir_type_ = SimpleSphericalParticles::DIRDATA_NONE;
+        char const* dir_ptr_ = nullptr;
+        unsigned int dir_stride_ = 0;
+        SimpleSphericalParticles::IDDataType id_type_ = SimpleSphericalParticles::IDDATA_NONE;
+        char const* id_ptr_ = nullptr;
+        unsigned int id_stride_ = 0;
     };
 
     /** possible values of accumulated data sizes over all vertex coordinates */
@@ -0,0 +1,220 @@
+/*
+ * profiler/CallProfiler.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#ifndef MEGAMOLCORE_PROFILER_CALLPROFILER_H_INCLUDED
+#define MEGAMOLCORE_PROFILER_CALLPROFILER_H_INCLUDED
+#pragma once
+
+#include "mmcore/api/MegaMolCore.std.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace megamol {
+namespace core {
+
+    class Call;
+
+namespace profiler {
+
+    /**
+     * Lightweight profiler for the graph call path, independent of the
+     * CoreInstance.
+     *
+     * Every Call::operator() opens a Scope. While profiling is disabled this
+     * costs a single relaxed atomic load. While enabled, each call records
+     * its wall time and its self time (wall time minus the wall time of the
+     * nested calls issued from the same thread) into a lock-free ring buffer
+     * owned by the calling thread. Collect() drains these buffers, aggregates
+     * the events per "module::call::callback" and keeps them for the
+     * Chrome-trace/Perfetto export.
+     */
+    class MEGAMOLCORE_API CallProfiler {
+    public:
+
+        /** Aggregated timings of one callback of one call */
+        struct Statistics {
+            /** "callee module::call class::callback" */
+            std::string name;
+            uint64_t count = 0;
+            double total_ms = 0.0;
+            double self_ms = 0.0;
+            double max_ms = 0.0;
+        };
+
+        /**
+         * Records one call for the lifetime of the object.
+         */
+        class MEGAMOLCORE_API Scope {
+        public:
+
+            /**
+             * Starts recording if profiling is enabled.
+             *
+             * @param call The call being issued
+             * @param func The callback index being called
+             */
+            inline Scope(Call& call, unsigned int func) : name(nullptr) {
+                if (CallProfiler::Instance().IsEnabled()) {
+                    this->begin(call, func);
+                }
+            }
+
+            inline ~Scope(void) {
+                if (this->name != nullptr) {
+                    this->end();
+                }
+            }
+
+            Scope(Scope const&) = delete;
+            Scope& operator=(Scope const&) = delete;
+
+        private:
+
+            void begin(Call& call, unsigned int func);
+
+            void end(void);
+
+            const char *name;
+            uint64_t start;
+
+        };
+
+        /**
+         * Answer the only instance of this class
+         *
+         * @return The only instance of this class
+         */
+        static CallProfiler& Instance(void);
+
+        /** Answer whether calls are being recorded */
+        inline bool IsEnabled(void) const {
+            return this->enabled.load(std::memory_order_relaxed);
+        }
+
+        /** Starts or stops recording calls */
+        void SetEnabled(bool enable);
+
+        /**
+         * Drains the per-thread buffers. Should be called regularly (e.g.
+         * once per frame) while profiling is enabled, otherwise events are
+         * dropped once a thread buffer is full.
+         */
+        void Collect(void);
+
+        /**
+         * Answer the aggregated timings collected so far, sorted by
+         * descending self time.
+         */
+        std::vector<Statistics> GetStatistics(void);
+
+        /** Answer the number of events lost to full buffers */
+        uint64_t DroppedEvents(void) const;
+
+        /**
+         * Writes all collected events as Chrome trace (JSON object format),
+         * which can be loaded in chrome://tracing or Perfetto.
+         *
+         * @param path The output file
+         *
+         * @return True on success
+         */
+        bool WriteChromeTrace(std::string const& path);
+
+        /** Discards all collected events and statistics */
+        void Reset(void);
+
+        /**
+         * Drops the callback names cached in the calls, so they are rebuilt
+         * on their next use. Must be called whenever a module is renamed.
+         */
+        void InvalidateNames(void);
+
+    private:
+
+        /** A recorded call */
+        struct Event {
+            const char *name;
+            uint64_t start;
+            uint64_t duration;
+            uint64_t self;
+            uint32_t thread;
+        };
+
+        /** Single-producer/single-consumer ring buffer of one thread */
+        struct ThreadBuffer {
+            explicit ThreadBuffer(uint32_t id);
+
+            /** Called by the owning thread only */
+            void Push(Event const& e);
+
+            std::vector<Event> ring;
+            std::atomic<uint64_t> head;
+            std::atomic<uint64_t> tail;
+            std::atomic<uint64_t> dropped;
+
+            /** Accumulated wall time of the nested calls, one entry per open scope */
+            std::vector<uint64_t> childTime;
+
+            uint32_t id;
+        };
+
+        /** Hidden ctor */
+        CallProfiler(void);
+
+        /** Hidden dtor */
+        ~CallProfiler(void);
+
+        /** Answer the buffer of the calling thread, creating it on first use */
+        ThreadBuffer& threadBuffer(void);
+
+        /** Answer the name of a callback of a call, cached in the call, 'nameLock' is only taken on a miss */
+        const char *nameOf(Call& call, unsigned int func);
+
+        /** Answer the nanoseconds since the profiler was created */
+        inline uint64_t now(void) const {
+            return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - this->epoch).count());
+        }
+
+        /** Drains the buffers, 'collectLock' must be held */
+        void collect(void);
+
+        std::atomic<bool> enabled;
+
+        std::chrono::steady_clock::time_point epoch;
+
+        /** Guards 'buffers' */
+        std::mutex bufferLock;
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+
+        /** Guards 'names' */
+        std::mutex nameLock;
+        std::unordered_set<std::string> names;
+
+        /** Incremented by InvalidateNames, calls with an older cache rebuild it */
+        std::atomic<uint64_t> nameGeneration;
+
+        /** Guards everything collected */
+        std::mutex collectLock;
+        std::vector<Event> events;
+        std::unordered_map<const char*, Statistics> statistics;
+        uint64_t droppedTrace;
+
+    };
+
+} /* end namespace profiler */
+} /* end namespace core */
+} /* end namespace megamol */
+
+#endif /* MEGAMOLCORE_PROFILER_CALLPROFILER_H_INCLUDED */
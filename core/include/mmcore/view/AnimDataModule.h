@@ -12,6 +12,10 @@
 #endif /* (defined(_MSC_VER) && (_MSC_VER > 1000)) */
 
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 #include "mmcore/Module.h"
 #include "vislib/sys/CriticalSection.h"
@@ -193,6 +197,16 @@ namespace view {
          */
         void setFrameCount(unsigned int cnt);
 
+        /**
+         * Sets the number of loader threads. Only set this to more than one
+         * if 'loadFrame' may safely be invoked concurrently for different
+         * frames. Must not be called after the frame cache has been
+         * initialised!
+         *
+         * @param cnt The number of loader threads. Must not be zero.
+         */
+        void setLoaderThreadCount(unsigned int cnt);
+
         /** frame is a friend to be able to call 'unlock' */
         friend class ::megamol::core::view::AnimDataModule::Frame;
 
@@ -200,12 +214,51 @@ namespace view {
 
         /**
          * The loader thread function.
+         */
+        void loaderFunction(void);
+
+        /**
+         * Answer the predicted index of the 'step'-th frame to be shown after
+         * the last requested one, based on the observed playback direction
+         * and speed. Must be called with 'stateLock' held.
          *
-         * @param userData Pointer to this object.
+         * @param step The number of steps into the future.
          *
-         * @return The return value.
+         * @return The predicted frame index.
          */
-        static DWORD loaderFunction(void *userData);
+        unsigned int predictFrame(unsigned int step) const;
+
+        /**
+         * Answer how expendable a cached frame is with respect to the last
+         * requested frame. Frames behind the playhead rank higher than frames
+         * ahead of it. Must be called with 'stateLock' held.
+         *
+         * @param idx The frame index.
+         *
+         * @return The eviction rank; larger values are evicted first.
+         */
+        unsigned int evictionRank(unsigned int idx) const;
+
+        /**
+         * Searches the frame cache for the given frame. Must be called with
+         * 'stateLock' held.
+         *
+         * @param idx The frame index.
+         * @param includeLoading Also answer frames still being loaded.
+         *
+         * @return The cached frame or NULL if the frame is not cached.
+         */
+        Frame *findCachedFrame(unsigned int idx, bool includeLoading) const;
+
+        /**
+         * Starts the loader threads.
+         */
+        void startLoaders(void);
+
+        /**
+         * Stops and joins the loader threads.
+         */
+        void stopLoaders(void);
 
         /**
          * Unlocks the given frame
@@ -219,8 +272,11 @@ namespace view {
         /** The number of time frames of the dataset */
         unsigned int frameCnt;
 
-        /** The loading thread */
-        vislib::sys::Thread loader;
+        /** The loading threads */
+        std::vector<std::thread> loaders;
+
+        /** The number of loading threads to be started */
+        unsigned int loaderCnt;
 
         /** The frame cache */
         Frame **frameCache;
@@ -232,11 +288,26 @@ namespace view {
          * The critical section to synchornise the state changes of the 
          * cached frames. 
          */
-        vislib::sys::CriticalSection stateLock;
+        std::mutex stateLock;
+
+        /** Wakes the loader threads when a new frame is requested or a cached frame is freed */
+        std::condition_variable loaderCond;
+
+        /** Wakes the threads waiting for a frame to become available */
+        std::condition_variable availableCond;
 
         /** The frame number requested the last time 'requestLockedFrame' was called */
         unsigned int lastRequested;
 
+        /** The observed playback direction (1 or -1) */
+        int playDirection;
+
+        /** The observed number of frames advanced between two distinct requests */
+        unsigned int playStep;
+
+        /** The direction of the previous distinct request, used for hysteresis */
+        int lastStepDirection;
+
 		/** TODO: The Mueller shalt document his stuff */
 		std::atomic_bool isRunning;
 #ifdef _WIN32
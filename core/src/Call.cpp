@@ -10,6 +10,7 @@
 #include "mmcore/Call.h"
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
+#include "mmcore/profiler/CallProfiler.h"
 #ifdef RIG_RENDERCALLS_WITH_DEBUGGROUPS
 #    include "mmcore/view/Renderer2DModule.h"
 #    include "mmcore/view/Renderer3DModule.h"
@@ -23,7 +24,8 @@ using namespace megamol::core;
 /*
  * Call::Call
  */
-Call::Call(void) : callee(nullptr), caller(nullptr), className(nullptr), funcMap(nullptr) {
+Call::Call(void) : callee(nullptr), caller(nullptr), className(nullptr), funcMap(nullptr), profilingNames(),
+        profilingNamesGeneration(0) {
     // intentionally empty
 }
 
@@ -52,6 +54,7 @@ Call::~Call(void) {
 bool Call::operator()(unsigned int func) {
     bool res = false;
     if (this->callee != nullptr) {
+        profiler::CallProfiler::Scope profile(*this, func);
 #ifdef RIG_RENDERCALLS_WITH_DEBUGGROUPS
         auto f = this->callee->GetCallbackFuncName(func);
         auto parent = callee->Parent().get();
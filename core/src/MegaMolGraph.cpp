@@ -4,6 +4,7 @@
 #include "mmcore/MegaMolGraph.h"
 
 #include "mmcore/AbstractSlot.h"
+#include "mmcore/profiler/CallProfiler.h"
 
 #include "mmcore/utility/log/Log.h"
 
@@ -34,6 +35,8 @@ static std::string tolower(std::string s) {
 static std::string clean(std::string const& path) {
     auto begin = path.find_first_not_of(':');
     auto end   = path.find_last_not_of(':');
+    if (begin == std::string::npos)
+        return std::string{};
 
     return tolower(path.substr(begin, end+1 - begin));
 }
@@ -132,10 +135,19 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& oldId, std::st
         log_error("error. could not rename module. module is nullptr: " + oldId);
         return false;
     }
+    const auto existing_it = find_module(newId);
+    if (existing_it != module_list_.end() && existing_it != module_it) {
+        log_error("error. could not rename module " + oldId + ", a module named " + newId + " already exists");
+        return false;
+    }
 
     log("rename module " + module_it->request.id + " to " + newId);
+    unindex_module(module_it);
     module_it->request.id = newId;
     module_it->modulePtr->setName(newId.c_str());
+    index_module(module_it);
+    param_slot_cache_.clear();
+    profiler::CallProfiler::Instance().InvalidateNames();
 
     const auto clean_old = clean(oldId);
     const auto matches_old_prefix = [&](std::string const& call_slot) {
@@ -149,13 +161,21 @@ bool megamol::core::MegaMolGraph::RenameModule(std::string const& oldId, std::st
         log("rename call at slot " + old + " to " + name);
     };
 
-    for (auto& call : call_list_) {
-        if (matches_old_prefix(call.request.from)) {
+    for (auto call_it = call_list_.begin(); call_it != call_list_.end(); ++call_it) {
+        auto& call = *call_it;
+        const bool from_matches = matches_old_prefix(call.request.from);
+        const bool to_matches = matches_old_prefix(call.request.to);
+        if (!from_matches && !to_matches)
+            continue;
+
+        unindex_call(call_it);
+        if (from_matches) {
             put_new_prefix(call.request.from);
         }
-        if (matches_old_prefix(call.request.to)) {
+        if (to_matches) {
             put_new_prefix(call.request.to);
         }
+        index_call(call_it);
     }
 
     // dont know what we are supposed to do when entry point renaming fails... how can it fail?
@@ -181,40 +201,64 @@ bool megamol::core::MegaMolGraph::CreateCall(
 }
 
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module(std::string const& name) {
-    auto it = std::find_if(this->module_list_.begin(), this->module_list_.end(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return clean(el.request.id) == clean(name); });
+    auto it = module_index_.find(clean(name));
 
-    return it;
+    return (it == module_index_.end()) ? this->module_list_.end() : it->second;
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module(
     std::string const& name) const {
 
-    auto it = std::find_if(this->module_list_.cbegin(), this->module_list_.cend(),
-        [&name](megamol::core::ModuleInstance_t const& el) { return clean(el.request.id) == clean(name); });
+    auto it = module_index_.find(clean(name));
 
-    return it;
+    return (it == module_index_.end()) ? this->module_list_.cend() : it->second;
 }
 
 megamol::core::CallList_t::iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) {
-    auto it = std::find_if(
-        this->call_list_.begin(), this->call_list_.end(), [&](megamol::core::CallInstance_t const& el) {
-            return clean(el.request.from) == clean(from) && clean(el.request.to) == clean(to);
-        });
+    auto it = call_index_.find({clean(from), clean(to)});
 
-    return it;
+    return (it == call_index_.end()) ? this->call_list_.end() : it->second;
 }
 
 megamol::core::CallList_t::const_iterator megamol::core::MegaMolGraph::find_call(
     std::string const& from, std::string const& to) const {
 
-    auto it = std::find_if(
-        this->call_list_.cbegin(), this->call_list_.cend(), [&](megamol::core::CallInstance_t const& el) {
-            return clean(el.request.from) == clean(from) && clean(el.request.to) == clean(to);
-        });
+    auto it = call_index_.find({clean(from), clean(to)});
+
+    return (it == call_index_.end()) ? this->call_list_.cend() : it->second;
+}
 
-    return it;
+void megamol::core::MegaMolGraph::index_module(ModuleList_t::iterator module_it) {
+    module_index_[clean(module_it->request.id)] = module_it;
+    module_id_index_[module_it->request.id] = module_it;
+}
+
+void megamol::core::MegaMolGraph::unindex_module(ModuleList_t::iterator module_it) {
+    const auto erase_if_same = [&](auto& index, std::string const& key) {
+        auto it = index.find(key);
+        if (it != index.end() && it->second == module_it)
+            index.erase(it);
+    };
+    erase_if_same(module_index_, clean(module_it->request.id));
+    erase_if_same(module_id_index_, module_it->request.id);
+}
+
+void megamol::core::MegaMolGraph::index_call(CallList_t::iterator call_it) {
+    call_index_[{clean(call_it->request.from), clean(call_it->request.to)}] = call_it;
+}
+
+void megamol::core::MegaMolGraph::unindex_call(CallList_t::iterator call_it) {
+    auto it = call_index_.find({clean(call_it->request.from), clean(call_it->request.to)});
+    if (it != call_index_.end() && it->second == call_it)
+        call_index_.erase(it);
+}
+
+void megamol::core::MegaMolGraph::clear_indices() {
+    module_index_.clear();
+    module_id_index_.clear();
+    call_index_.clear();
+    param_slot_cache_.clear();
 }
 
 
@@ -225,6 +269,11 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
         return false;
     }
 
+    if (find_module(request.id) != this->module_list_.end()) {
+        log_error("error. could not create module, a module named " + request.id + " already exists");
+        return false;
+    }
+
     const auto module_name = vislib::StringA(request.id.c_str());
 
     Module::ptr_type module_ptr = Module::ptr_type(module_description->CreateModule(module_name));
@@ -269,6 +318,9 @@ bool megamol::core::MegaMolGraph::add_module(ModuleInstantiationRequest_t const&
 
     if (!isCreateOk) {
         this->module_list_.pop_front();
+    } else {
+        index_module(this->module_list_.begin());
+        param_slot_cache_.clear();
     }
 
     return isCreateOk;
@@ -360,12 +412,13 @@ bool megamol::core::MegaMolGraph::add_call(CallInstantiationRequest_t const& req
 
     log("create call: " + request.from + " -> " + request.to + " (" + std::string(call_description->ClassName()) + ")");
     this->call_list_.emplace_front(CallInstance_t{call, request});
+    index_call(this->call_list_.begin());
 
     return true;
 }
 
 static std::list<megamol::core::CallList_t::iterator> find_all_of(
-    megamol::core::CallList_t list,
+    megamol::core::CallList_t& list,
     std::function<bool(megamol::core::CallInstance_t const&)> const& func) {
 
     std::list<megamol::core::CallList_t::iterator> result;
@@ -413,6 +466,8 @@ bool megamol::core::MegaMolGraph::delete_module(ModuleDeletionRequest_t const& r
 
     release_module(module_it->lifetime_resources);
 
+    unindex_module(module_it);
+    param_slot_cache_.clear();
     this->module_list_.erase(module_it);
 
     return true;
@@ -442,6 +497,7 @@ bool megamol::core::MegaMolGraph::delete_call(CallDeletionRequest_t const& reque
     source->PerformCleanup();  // does nothing
     target->DisconnectCalls(); // does nothing
 
+    unindex_call(call_it);
     this->call_list_.erase(call_it);
 
     return true;
@@ -470,24 +526,36 @@ megamol::core::Call::ptr_type megamol::core::MegaMolGraph::FindCall(
     return call_it->callPtr;
 }
 
-static const auto check_module_is_prefix = [](std::string const& request, auto const& module) {
-        const auto& module_name = module.request.id;
-        const auto substring = request.substr(0, module_name.size());
-        return (module_name == substring) && // module name is prefix of request
-            (request.size() == module_name.size() // module name matches whole request
-            || (request.size() >= module_name.size()+2 && request.substr(module_name.size(), 2) == "::")); // OR request has :: after module name
-    };
-
 // find module where module name is prefix of request
+// candidates are the whole request and every part of it that is followed by '::', longest first
 megamol::core::ModuleList_t::iterator megamol::core::MegaMolGraph::find_module_by_prefix(std::string const& request) {
-    return std::find_if(module_list_.begin(), module_list_.end(), [&](auto const& module){ return check_module_is_prefix(request, module); });
+    auto it = module_id_index_.find(request);
+    if (it != module_id_index_.end())
+        return it->second;
+
+    for (auto pos = request.rfind("::"); pos != std::string::npos && pos > 0; pos = request.rfind("::", pos - 1)) {
+        it = module_id_index_.find(request.substr(0, pos));
+        if (it != module_id_index_.end())
+            return it->second;
+    }
+
+    return module_list_.end();
 }
 
 megamol::core::ModuleList_t::const_iterator megamol::core::MegaMolGraph::find_module_by_prefix(std::string const& request) const {
-    return std::find_if(module_list_.begin(), module_list_.end(), [&](auto const& module){ return check_module_is_prefix(request, module); });
+    return const_cast<MegaMolGraph*>(this)->find_module_by_prefix(request);
 }
 
 megamol::core::param::ParamSlot* megamol::core::MegaMolGraph::FindParameterSlot(std::string const& paramName) const {
+    auto cached_it = param_slot_cache_.find(paramName);
+    if (cached_it != param_slot_cache_.end()) {
+        // slots are owned by their module, a deleted module or an unavailable slot invalidates the entry
+        auto const& cached = cached_it->second;
+        if (!cached.module.expired() && cached.slot->GetStatus() != AbstractSlot::STATUS_UNAVAILABLE)
+            return cached.slot;
+        param_slot_cache_.erase(cached_it);
+    }
+
     // match module where module name is prefix of parameter slot name
     auto module_it = find_module_by_prefix(paramName);
 
@@ -508,6 +576,8 @@ megamol::core::param::ParamSlot* megamol::core::MegaMolGraph::FindParameterSlot(
         return nullptr;
     }
 
+    param_slot_cache_.emplace(paramName, CachedParamSlot{module_it->modulePtr, param_slot_ptr});
+
     return param_slot_ptr;
 }
 
@@ -671,6 +741,7 @@ void megamol::core::MegaMolGraph::Clear() {
     // therefore it is ok for us to clear all entry points if the graph shuts down
     m_image_presentation->clear_entry_points();
     graph_entry_points.clear();
+    clear_indices();
     call_list_.clear();
     module_list_.clear();
 }
@@ -8,6 +8,7 @@
 #include "stdafx.h"
 #include "mmcore/misc/VolumetricDataCall.h"
 
+#include <cstring>
 #include <utility>
 
 #include "vislib/OutOfRangeException.h"
@@ -80,6 +81,34 @@ bool megamol::core::misc::VolumetricDataCall::GetMetadata(
 }
 
 
+/*
+ * megamol::core::misc::VolumetricDataCall::GetRanges
+ */
+bool megamol::core::misc::VolumetricDataCall::GetRanges(
+        core::misc::VolumetricDataCall& call) {
+    using core::misc::VolumetricDataCall;
+    using megamol::core::utility::log::Log;
+
+    call.SetRanges(nullptr);
+    if (!call(VolumetricDataCall::IDX_GET_RANGES)) {
+        return false;
+    }
+
+    if (call.GetRanges() == nullptr) {
+        /* Second chance: the source computes the ranges while loading. */
+        if (!call(VolumetricDataCall::IDX_GET_DATA)
+                || !call(VolumetricDataCall::IDX_GET_RANGES)) {
+            Log::DefaultLog.WriteError("%hs::%hs failed.",
+                VolumetricDataCall::ClassName(),
+                VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_RANGES));
+            return false;
+        }
+    }
+
+    return (call.GetRanges() != nullptr);
+}
+
+
 /*
  * megamol::core::misc::VolumetricDataCall::IDX_GET_DATA
  */
@@ -117,11 +146,26 @@ const unsigned int megamol::core::misc::VolumetricDataCall::IDX_TRY_GET_DATA
     = 5;
 
 
+/*
+ * megamol::core::misc::VolumetricDataCall::IDX_GET_RANGES
+ */
+const unsigned int megamol::core::misc::VolumetricDataCall::IDX_GET_RANGES = 6;
+
+
+/*
+ * megamol::core::misc::VolumetricDataCall::IDX_GET_REGION
+ */
+const unsigned int megamol::core::misc::VolumetricDataCall::IDX_GET_REGION = 7;
+
+
 /*
  * megamol::core::misc::VolumetricDataCall::VolumetricDataCall
  */
 megamol::core::misc::VolumetricDataCall::VolumetricDataCall(void)
-        : data(nullptr), metadata(nullptr), vram_volume_name(0) {
+        : data(nullptr), vram_volume_name(0), metadata(nullptr), ranges(nullptr),
+        regionLevel(0) {
+    ::memset(this->regionOrigin, 0, sizeof(this->regionOrigin));
+    ::memset(this->regionSize, 0, sizeof(this->regionSize));
 }
 
 
@@ -129,7 +173,8 @@ megamol::core::misc::VolumetricDataCall::VolumetricDataCall(void)
  * megamol::core::misc::VolumetricDataCall::VolumetricDataCall
  */
 megamol::core::misc::VolumetricDataCall::VolumetricDataCall(
-        const VolumetricDataCall& rhs) : data(nullptr), metadata(nullptr), vram_volume_name(0) {
+        const VolumetricDataCall& rhs) : data(nullptr), vram_volume_name(0), metadata(nullptr), ranges(nullptr),
+        regionLevel(0) {
     *this = rhs;
 }
 
@@ -331,6 +376,17 @@ bool megamol::core::misc::VolumetricDataCall::IsUniform(const int axis) const {
 }
 
 
+/*
+ * megamol::core::misc::VolumetricDataCall::SetRegion
+ */
+void megamol::core::misc::VolumetricDataCall::SetRegion(const size_t origin[3],
+        const size_t size[3], const unsigned int level) {
+    ::memcpy(this->regionOrigin, origin, sizeof(this->regionOrigin));
+    ::memcpy(this->regionSize, size, sizeof(this->regionSize));
+    this->regionLevel = level;
+}
+
+
 /*
  * megamol::core::misc::VolumetricDataCall::SetMetadata
  */
@@ -349,6 +405,10 @@ megamol::core::misc::VolumetricDataCall::operator =(const VolumetricDataCall& rh
         Base::operator =(rhs);
         this->data = rhs.data;
         this->metadata = rhs.metadata;
+        this->ranges = rhs.ranges;
+        this->regionLevel = rhs.regionLevel;
+        ::memcpy(this->regionOrigin, rhs.regionOrigin, sizeof(this->regionOrigin));
+        ::memcpy(this->regionSize, rhs.regionSize, sizeof(this->regionSize));
     }
     return *this;
 }
@@ -363,5 +423,7 @@ const char *megamol::core::misc::VolumetricDataCall::FUNCTIONS[] = {
     "GetMetadata",
     "StartAsync",
     "StopAsync",
-    "TryGetData"
+    "TryGetData",
+    "GetRanges",
+    "GetRegion"
 };
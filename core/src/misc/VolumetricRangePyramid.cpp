@@ -0,0 +1,558 @@
+/*
+ * VolumetricRangePyramid.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "mmcore/misc/VolumetricRangePyramid.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+
+
+namespace {
+
+    /** Header of a sidecar file, followed by one record per frame. */
+    struct SidecarHeader {
+        char Magic[8];
+        uint32_t Version;
+        uint32_t ScalarType;
+        uint64_t ScalarLength;
+        uint64_t Components;
+        uint64_t Resolution[3];
+        uint64_t BrickSize;
+        uint64_t Bins;
+        uint64_t Frames;
+    };
+
+    const char SIDECAR_MAGIC[8] = { 'M', 'M', 'V', 'R', 'A', 'N', 'G', 'E' };
+
+    const uint32_t SIDECAR_VERSION = 1;
+
+    /** Marks a completely written record, unwritten records read as zero. */
+    const uint64_t RECORD_VALID = 0x5641494C44524543ull;
+
+    /**
+     * Calls 'func' with a value of the C++ type matching the given scalar
+     * format.
+     */
+    template<class F>
+    bool dispatchScalar(const megamol::core::misc::ScalarType_t type,
+            const size_t length, F&& func) {
+        using namespace megamol::core::misc;
+        switch (type) {
+            case SIGNED_INTEGER:
+                switch (length) {
+                    case 1: func(int8_t()); return true;
+                    case 2: func(int16_t()); return true;
+                    case 4: func(int32_t()); return true;
+                    case 8: func(int64_t()); return true;
+                    default: return false;
+                }
+
+            case UNSIGNED_INTEGER:
+                switch (length) {
+                    case 1: func(uint8_t()); return true;
+                    case 2: func(uint16_t()); return true;
+                    case 4: func(uint32_t()); return true;
+                    case 8: func(uint64_t()); return true;
+                    default: return false;
+                }
+
+            case FLOATING_POINT:
+                switch (length) {
+                    case 4: func(float()); return true;
+                    case 8: func(double()); return true;
+                    default: return false;
+                }
+
+            default:
+                return false;
+        }
+    }
+
+    /** Number of bricks covering the cells along an axis. */
+    inline size_t bricksOnAxis(const size_t resolution, const size_t brickSize) {
+        return (resolution > 1)
+            ? (resolution - 2) / brickSize + 1
+            : 1;
+    }
+
+    /** Answer whether 'path' was written before any of 'references'. */
+    bool isOlder(const std::string& path,
+            const std::vector<std::string>& references) {
+        std::error_code ec;
+        auto pathTime = std::filesystem::last_write_time(path, ec);
+        if (ec) return true;
+        for (auto& r : references) {
+            auto referenceTime = std::filesystem::last_write_time(r, ec);
+            if (!ec && (pathTime < referenceTime)) return true;
+        }
+        return false;
+    }
+
+    template<class T>
+    inline bool readArray(std::istream& stream, std::vector<T>& dst) {
+        stream.read(reinterpret_cast<char *>(dst.data()), dst.size() * sizeof(T));
+        return stream.good();
+    }
+
+    template<class T>
+    inline void writeArray(std::ostream& stream, const std::vector<T>& src) {
+        stream.write(reinterpret_cast<const char *>(src.data()), src.size() * sizeof(T));
+    }
+
+} /* end namespace */
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::DEFAULT_BINS
+ */
+const size_t megamol::core::misc::VolumetricRangePyramid::DEFAULT_BINS = 32;
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::DEFAULT_BRICK_SIZE
+ */
+const size_t megamol::core::misc::VolumetricRangePyramid::DEFAULT_BRICK_SIZE
+    = 32;
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::SidecarPath
+ */
+std::string megamol::core::misc::VolumetricRangePyramid::SidecarPath(
+        const std::string& datFile) {
+    return datFile + ".ranges";
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::ComputeMinMax
+ */
+bool megamol::core::misc::VolumetricRangePyramid::ComputeMinMax(
+        const void *data, const size_t resolution[3], const size_t components,
+        const ScalarType_t type, const size_t length,
+        std::vector<double>& outMins, std::vector<double>& outMaxes) {
+    const auto cntVoxels = static_cast<int64_t>(std::max<size_t>(resolution[0], 1)
+        * std::max<size_t>(resolution[1], 1) * std::max<size_t>(resolution[2], 1));
+
+    outMins.assign(components, std::numeric_limits<double>::max());
+    outMaxes.assign(components, std::numeric_limits<double>::lowest());
+
+    return dispatchScalar(type, length, [&](auto tag) {
+        using T = decltype(tag);
+        auto vol = static_cast<const T *>(data);
+
+#pragma omp parallel
+        {
+            std::vector<double> mins(components, std::numeric_limits<double>::max());
+            std::vector<double> maxes(components, std::numeric_limits<double>::lowest());
+
+#pragma omp for schedule(static)
+            for (int64_t i = 0; i < cntVoxels; ++i) {
+                for (size_t c = 0; c < components; ++c) {
+                    const auto v = static_cast<double>(vol[i * components + c]);
+                    if (v < mins[c]) mins[c] = v;
+                    if (v > maxes[c]) maxes[c] = v;
+                }
+            }
+
+#pragma omp critical
+            for (size_t c = 0; c < components; ++c) {
+                outMins[c] = std::min(outMins[c], mins[c]);
+                outMaxes[c] = std::max(outMaxes[c], maxes[c]);
+            }
+        }
+    });
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::VolumetricRangePyramid
+ */
+megamol::core::misc::VolumetricRangePyramid::VolumetricRangePyramid(void)
+        : bins(DEFAULT_BINS), brickSize(DEFAULT_BRICK_SIZE), components(0),
+        frameID(0) {
+    ::memset(this->resolution, 0, sizeof(this->resolution));
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::Compute
+ */
+bool megamol::core::misc::VolumetricRangePyramid::Compute(const void *data,
+        const size_t resolution[3], const size_t components,
+        const ScalarType_t type, const size_t length,
+        const unsigned int frameID, const size_t brickSize,
+        const size_t bins) {
+    for (int a = 0; a < 3; ++a) {
+        this->resolution[a] = std::max<size_t>(resolution[a], 1);
+    }
+    this->components = components;
+    this->brickSize = std::max<size_t>(brickSize, 1);
+    this->bins = std::max<size_t>(bins, 1);
+    this->frameID = frameID;
+    this->allocate();
+
+    const auto& res = this->resolution;
+    const auto cntBricks = static_cast<int64_t>(this->levels[0].Mins.size()
+        / std::max<size_t>(components, 1));
+
+    auto retval = dispatchScalar(type, length, [&](auto tag) {
+        using T = decltype(tag);
+        auto vol = static_cast<const T *>(data);
+        auto& l = this->levels[0];
+        const auto edge = this->brickSize;
+
+        // Pass 1: ranges of the bricks including the shared border voxels.
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t i = 0; i < cntBricks; ++i) {
+            const size_t b[3] = { i % l.Bricks[0], (i / l.Bricks[0]) % l.Bricks[1],
+                i / (l.Bricks[0] * l.Bricks[1]) };
+            size_t first[3], last[3];
+            for (int a = 0; a < 3; ++a) {
+                first[a] = b[a] * edge;
+                last[a] = std::min((b[a] + 1) * edge, res[a] - 1);
+            }
+
+            auto mins = l.Mins.data() + i * components;
+            auto maxes = l.Maxes.data() + i * components;
+            for (size_t z = first[2]; z <= last[2]; ++z) {
+                for (size_t y = first[1]; y <= last[1]; ++y) {
+                    auto row = vol + ((z * res[1] + y) * res[0]) * components;
+                    for (size_t x = first[0]; x <= last[0]; ++x) {
+                        for (size_t c = 0; c < components; ++c) {
+                            const auto v = static_cast<double>(row[x * components + c]);
+                            if (v < mins[c]) mins[c] = v;
+                            if (v > maxes[c]) maxes[c] = v;
+                        }
+                    }
+                }
+            }
+        }
+
+        // The histograms of all bricks share the range of the frame.
+        std::vector<double> globalMins(components, std::numeric_limits<double>::max());
+        std::vector<double> globalMaxes(components, std::numeric_limits<double>::lowest());
+        std::vector<double> scales(components);
+        for (int64_t i = 0; i < cntBricks; ++i) {
+            for (size_t c = 0; c < components; ++c) {
+                globalMins[c] = std::min(globalMins[c], l.Mins[i * components + c]);
+                globalMaxes[c] = std::max(globalMaxes[c], l.Maxes[i * components + c]);
+            }
+        }
+        for (size_t c = 0; c < components; ++c) {
+            scales[c] = (globalMaxes[c] > globalMins[c])
+                ? static_cast<double>(this->bins) / (globalMaxes[c] - globalMins[c])
+                : 0.0;
+        }
+        auto binOf = [this](const double v, const double min, const double scale) {
+            return std::min(static_cast<size_t>((v - min) * scale), this->bins - 1);
+        };
+
+        // Pass 2: histograms of the voxels owned by the bricks.
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t i = 0; i < cntBricks; ++i) {
+            const size_t b[3] = { i % l.Bricks[0], (i / l.Bricks[0]) % l.Bricks[1],
+                i / (l.Bricks[0] * l.Bricks[1]) };
+            size_t first[3], end[3];
+            for (int a = 0; a < 3; ++a) {
+                first[a] = b[a] * edge;
+                end[a] = (b[a] + 1 == l.Bricks[a]) ? res[a] : (b[a] + 1) * edge;
+            }
+            const uint64_t cntOwned = (end[0] - first[0]) * (end[1] - first[1])
+                * (end[2] - first[2]);
+
+            auto mins = l.Mins.data() + i * components;
+            auto maxes = l.Maxes.data() + i * components;
+            auto hist = l.Histograms.data() + i * components * this->bins;
+
+            // Constant bricks, eg empty space, need not be visited again.
+            bool isConstant = true;
+            for (size_t c = 0; c < components; ++c) {
+                if (mins[c] == maxes[c]) {
+                    hist[c * this->bins + binOf(mins[c], globalMins[c], scales[c])] = cntOwned;
+                } else {
+                    isConstant = false;
+                }
+            }
+            if (isConstant) continue;
+
+            for (size_t z = first[2]; z < end[2]; ++z) {
+                for (size_t y = first[1]; y < end[1]; ++y) {
+                    auto row = vol + ((z * res[1] + y) * res[0]) * components;
+                    for (size_t x = first[0]; x < end[0]; ++x) {
+                        for (size_t c = 0; c < components; ++c) {
+                            if (mins[c] == maxes[c]) continue;
+                            const auto t = (static_cast<double>(row[x * components + c])
+                                - globalMins[c]) * scales[c];
+                            if (!(t >= 0.0)) continue; // NaN
+                            ++hist[c * this->bins + std::min(static_cast<size_t>(t), this->bins - 1)];
+                        }
+                    }
+                }
+            }
+        }
+    });
+
+    if (!retval) {
+        this->Clear();
+        return false;
+    }
+
+    for (size_t level = 1; level < this->levels.size(); ++level) {
+        this->merge(level);
+    }
+    return true;
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::Clear
+ */
+void megamol::core::misc::VolumetricRangePyramid::Clear(void) {
+    this->levels.clear();
+    this->components = 0;
+    ::memset(this->resolution, 0, sizeof(this->resolution));
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::QueryRange
+ */
+void megamol::core::misc::VolumetricRangePyramid::QueryRange(
+        const size_t lo[3], const size_t hi[3], const size_t c,
+        double& outMin, double& outMax) const {
+    outMin = std::numeric_limits<double>::max();
+    outMax = std::numeric_limits<double>::lowest();
+    if (!this->IsValid()) return;
+
+    auto& l = this->levels[0];
+    size_t first[3], last[3];
+    for (int a = 0; a < 3; ++a) {
+        first[a] = std::min(lo[a] / this->brickSize, l.Bricks[a] - 1);
+        last[a] = std::min(hi[a] / this->brickSize, l.Bricks[a] - 1);
+    }
+
+    for (size_t z = first[2]; z <= last[2]; ++z) {
+        for (size_t y = first[1]; y <= last[1]; ++y) {
+            for (size_t x = first[0]; x <= last[0]; ++x) {
+                auto i = this->brickIndex(l, x, y, z) * this->components + c;
+                outMin = std::min(outMin, l.Mins[i]);
+                outMax = std::max(outMax, l.Maxes[i]);
+            }
+        }
+    }
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::Load
+ */
+bool megamol::core::misc::VolumetricRangePyramid::Load(
+        const std::string& path, const std::vector<std::string>& sources,
+        const size_t resolution[3], const size_t components,
+        const ScalarType_t type, const size_t length, const size_t frames,
+        const unsigned int frameID, const size_t brickSize,
+        const size_t bins) {
+    if (frameID >= frames || isOlder(path, sources)) {
+        return false;
+    }
+
+    std::ifstream stream(path, std::ios::binary);
+    SidecarHeader header;
+    if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header))) {
+        return false;
+    }
+
+    bool isMatch = (::memcmp(header.Magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC)) == 0)
+        && (header.Version == SIDECAR_VERSION)
+        && (header.ScalarType == static_cast<uint32_t>(type))
+        && (header.ScalarLength == length)
+        && (header.Components == components)
+        && (header.BrickSize == std::max<size_t>(brickSize, 1))
+        && (header.Bins == std::max<size_t>(bins, 1))
+        && (header.Frames == frames);
+    for (int a = 0; a < 3; ++a) {
+        isMatch = isMatch && (header.Resolution[a] == std::max<size_t>(resolution[a], 1));
+    }
+    if (!isMatch) {
+        return false;
+    }
+
+    // Read into a separate instance such that a miss keeps the current data.
+    VolumetricRangePyramid loaded;
+    for (int a = 0; a < 3; ++a) {
+        loaded.resolution[a] = static_cast<size_t>(header.Resolution[a]);
+    }
+    loaded.components = components;
+    loaded.brickSize = static_cast<size_t>(header.BrickSize);
+    loaded.bins = static_cast<size_t>(header.Bins);
+    loaded.frameID = frameID;
+    loaded.allocate();
+
+    size_t recordSize = sizeof(uint64_t);
+    for (auto& l : loaded.levels) {
+        recordSize += (l.Mins.size() + l.Maxes.size()) * sizeof(double)
+            + l.Histograms.size() * sizeof(uint64_t);
+    }
+
+    uint64_t marker = 0;
+    stream.seekg(sizeof(header) + frameID * recordSize);
+    bool retval = static_cast<bool>(stream.read(reinterpret_cast<char *>(&marker), sizeof(marker)))
+        && (marker == RECORD_VALID);
+    for (auto& l : loaded.levels) {
+        retval = retval && readArray(stream, l.Mins) && readArray(stream, l.Maxes)
+            && readArray(stream, l.Histograms);
+    }
+
+    if (retval) {
+        *this = std::move(loaded);
+    }
+    return retval;
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::Save
+ */
+bool megamol::core::misc::VolumetricRangePyramid::Save(
+        const std::string& path, const std::vector<std::string>& sources,
+        const ScalarType_t type, const size_t length,
+        const size_t frames) const {
+    if (!this->IsValid() || (this->frameID >= frames)) {
+        return false;
+    }
+
+    SidecarHeader expected;
+    ::memset(&expected, 0, sizeof(expected));
+    ::memcpy(expected.Magic, SIDECAR_MAGIC, sizeof(SIDECAR_MAGIC));
+    expected.Version = SIDECAR_VERSION;
+    expected.ScalarType = static_cast<uint32_t>(type);
+    expected.ScalarLength = length;
+    expected.Components = this->components;
+    for (int a = 0; a < 3; ++a) {
+        expected.Resolution[a] = this->resolution[a];
+    }
+    expected.BrickSize = this->brickSize;
+    expected.Bins = this->bins;
+    expected.Frames = frames;
+
+    // Keep the records of other frames if the file is still valid.
+    std::fstream stream;
+    if (!isOlder(path, sources)) {
+        stream.open(path, std::ios::in | std::ios::out | std::ios::binary);
+        SidecarHeader header;
+        if (!stream.read(reinterpret_cast<char *>(&header), sizeof(header))
+                || (::memcmp(&header, &expected, sizeof(header)) != 0)) {
+            stream.close();
+        }
+    }
+    if (!stream.is_open()) {
+        stream.clear();
+        stream.open(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!stream.write(reinterpret_cast<const char *>(&expected), sizeof(expected))) {
+            return false;
+        }
+    }
+
+    size_t recordSize = sizeof(uint64_t);
+    for (auto& l : this->levels) {
+        recordSize += (l.Mins.size() + l.Maxes.size()) * sizeof(double)
+            + l.Histograms.size() * sizeof(uint64_t);
+    }
+    const auto offset = sizeof(expected) + this->frameID * recordSize;
+
+    // The record is only marked valid once it was written completely.
+    uint64_t marker = 0;
+    stream.seekp(offset);
+    stream.write(reinterpret_cast<const char *>(&marker), sizeof(marker));
+    for (auto& l : this->levels) {
+        writeArray(stream, l.Mins);
+        writeArray(stream, l.Maxes);
+        writeArray(stream, l.Histograms);
+    }
+    stream.flush();
+
+    marker = RECORD_VALID;
+    stream.seekp(offset);
+    stream.write(reinterpret_cast<const char *>(&marker), sizeof(marker));
+    stream.flush();
+
+    return stream.good();
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::allocate
+ */
+void megamol::core::misc::VolumetricRangePyramid::allocate(void) {
+    this->levels.clear();
+
+    Level level;
+    for (int a = 0; a < 3; ++a) {
+        level.Bricks[a] = bricksOnAxis(this->resolution[a], this->brickSize);
+    }
+
+    while (true) {
+        const auto cnt = level.Bricks[0] * level.Bricks[1] * level.Bricks[2]
+            * this->components;
+        level.Mins.assign(cnt, std::numeric_limits<double>::max());
+        level.Maxes.assign(cnt, std::numeric_limits<double>::lowest());
+        level.Histograms.assign(cnt * this->bins, 0);
+        this->levels.push_back(level);
+
+        if ((level.Bricks[0] == 1) && (level.Bricks[1] == 1)
+                && (level.Bricks[2] == 1)) {
+            break;
+        }
+        for (int a = 0; a < 3; ++a) {
+            level.Bricks[a] = (level.Bricks[a] + 1) / 2;
+        }
+    }
+}
+
+
+/*
+ * megamol::core::misc::VolumetricRangePyramid::merge
+ */
+void megamol::core::misc::VolumetricRangePyramid::merge(const size_t level) {
+    auto& src = this->levels[level - 1];
+    auto& dst = this->levels[level];
+    const auto cnt = static_cast<int64_t>(dst.Bricks[0] * dst.Bricks[1]
+        * dst.Bricks[2]);
+    const auto comps = this->components;
+    const auto bins = this->bins;
+
+#pragma omp parallel for schedule(static)
+    for (int64_t i = 0; i < cnt; ++i) {
+        const size_t b[3] = { i % dst.Bricks[0], (i / dst.Bricks[0]) % dst.Bricks[1],
+            i / (dst.Bricks[0] * dst.Bricks[1]) };
+        const size_t last[3] = { std::min(2 * b[0] + 1, src.Bricks[0] - 1),
+            std::min(2 * b[1] + 1, src.Bricks[1] - 1),
+            std::min(2 * b[2] + 1, src.Bricks[2] - 1) };
+
+        for (size_t z = 2 * b[2]; z <= last[2]; ++z) {
+            for (size_t y = 2 * b[1]; y <= last[1]; ++y) {
+                for (size_t x = 2 * b[0]; x <= last[0]; ++x) {
+                    const auto j = this->brickIndex(src, x, y, z);
+                    for (size_t c = 0; c < comps; ++c) {
+                        auto& mn = dst.Mins[i * comps + c];
+                        auto& mx = dst.Maxes[i * comps + c];
+                        mn = std::min(mn, src.Mins[j * comps + c]);
+                        mx = std::max(mx, src.Maxes[j * comps + c]);
+                    }
+                    for (size_t h = 0; h < comps * bins; ++h) {
+                        dst.Histograms[i * comps * bins + h] += src.Histograms[j * comps * bins + h];
+                    }
+                }
+            }
+        }
+    }
+}
@@ -16,6 +16,17 @@
 #include "vislib/sys/FastFile.h"
 #include "vislib/String.h"
 #include "mmcore/utility/sys/SystemInformation.h"
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+
+#ifdef _WIN32
+#include <windows.h>
+#else /* _WIN32 */
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif /* _WIN32 */
 
 using namespace megamol::core;
 
@@ -34,7 +45,7 @@ using namespace megamol::core;
  * moldyn::MMPLDDataSource::Frame::Frame
  */
 moldyn::MMPLDDataSource::Frame::Frame(view::AnimDataModule& owner)
-        : view::AnimDataModule::Frame(owner), dat() {
+        : view::AnimDataModule::Frame(owner), dat(), mapped(nullptr), mappedSize(0) {
     // intentionally empty
 }
 
@@ -53,16 +64,30 @@ moldyn::MMPLDDataSource::Frame::~Frame() {
 bool moldyn::MMPLDDataSource::Frame::LoadFrame(vislib::sys::File *file, unsigned int idx, UINT64 size, unsigned int version) {
     this->frame = idx;
     this->fileVersion = version;
+    this->mapped = nullptr;
+    this->mappedSize = 0;
     this->dat.EnforceSize(static_cast<SIZE_T>(size));
     return (file->Read(this->dat, size) == size);
 }
 
 
+/*
+ * moldyn::MMPLDDataSource::Frame::MapFrame
+ */
+void moldyn::MMPLDDataSource::Frame::MapFrame(const void *data, unsigned int idx, UINT64 size, unsigned int version) {
+    this->frame = idx;
+    this->fileVersion = version;
+    this->dat.EnforceSize(0);
+    this->mapped = static_cast<const unsigned char *>(data);
+    this->mappedSize = size;
+}
+
+
 /*
  * moldyn::MMPLDDataSource::Frame::SetData
  */
 void moldyn::MMPLDDataSource::Frame::SetData(MultiParticleDataCall& call, vislib::math::Cuboid<float> const& bbox, bool overrideBBox) {
-    if (this->dat.IsEmpty()) {
+    if (!this->hasData()) {
         call.SetParticleListCount(0);
         return;
     }
@@ -72,17 +97,17 @@ void moldyn::MMPLDDataSource::Frame::SetData(MultiParticleDataCall& call, vislib
     // HAZARD for megamol up to fc4e784dae531953ad4cd3180f424605474dd18b this reads == 102
     // which means that many MMPLDs out there with version 103 are written wrongly (no timestamp)!
     if (this->fileVersion >= 102) {
-        timestamp = *this->dat.AsAt<float>(p);
+        timestamp = *this->dataAt<float>(p);
         p += sizeof(float);
     }
-    UINT32 plc = *this->dat.AsAt<UINT32>(p);
+    UINT32 plc = *this->dataAt<UINT32>(p);
     p += sizeof(UINT32);
     call.SetParticleListCount(plc);
     for (UINT32 i = 0; i < plc; i++) {
         MultiParticleDataCall::Particles &pts = call.AccessParticles(i);
 
-        UINT8 vrtType = *this->dat.AsAt<UINT8>(p); p += 1;
-        UINT8 colType = *this->dat.AsAt<UINT8>(p); p += 1;
+        UINT8 vrtType = *this->dataAt<UINT8>(p); p += 1;
+        UINT8 colType = *this->dataAt<UINT8>(p); p += 1;
         MultiParticleDataCall::Particles::VertexDataType vrtDatType;
         MultiParticleDataCall::Particles::ColourDataType colDatType;
         SIZE_T vrtSize = 0;
@@ -115,32 +140,32 @@ void moldyn::MMPLDDataSource::Frame::SetData(MultiParticleDataCall& call, vislib
         unsigned int stride = static_cast<unsigned int>(vrtSize + colSize);
 
         if ((vrtType == 1) || (vrtType == 3) || (vrtType == 4)) {
-            pts.SetGlobalRadius(*this->dat.AsAt<float>(p)); p += 4;
+            pts.SetGlobalRadius(*this->dataAt<float>(p)); p += 4;
         } else {
             pts.SetGlobalRadius(0.05f);
         }
 
         if (colType == 0) {
-            pts.SetGlobalColour(*this->dat.AsAt<UINT8>(p),
-                *this->dat.AsAt<UINT8>(p + 1),
-                *this->dat.AsAt<UINT8>(p + 2));
+            pts.SetGlobalColour(*this->dataAt<UINT8>(p),
+                *this->dataAt<UINT8>(p + 1),
+                *this->dataAt<UINT8>(p + 2));
             p += 4;
         } else {
             pts.SetGlobalColour(192, 192, 192);
             if (colType == 3 || colType == 7) {
                 pts.SetColourMapIndexValues(
-                    *this->dat.AsAt<float>(p),
-                    *this->dat.AsAt<float>(p + 4));
+                    *this->dataAt<float>(p),
+                    *this->dataAt<float>(p + 4));
                 p += 8;
             } else {
                 pts.SetColourMapIndexValues(0.0f, 1.0f);
             }
         }
 
-        pts.SetCount(*this->dat.AsAt<UINT64>(p)); p += 8;
+        pts.SetCount(*this->dataAt<UINT64>(p)); p += 8;
 
         if (this->fileVersion >= 103) {
-            auto const box = this->dat.AsAt<float>(p);
+            auto const box = this->dataAt<float>(p);
             vislib::math::Cuboid<float> bbox;
             bbox.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
             pts.SetBBox(bbox);
@@ -150,18 +175,18 @@ void moldyn::MMPLDDataSource::Frame::SetData(MultiParticleDataCall& call, vislib
             pts.SetBBox(bbox);
         }
 
-        pts.SetVertexData(vrtDatType, this->dat.At(p), stride);
-        pts.SetColourData(colDatType, this->dat.At(p + vrtSize), stride);
+        pts.SetVertexData(vrtDatType, this->dataAt<unsigned char>(p), stride);
+        pts.SetColourData(colDatType, this->dataAt<unsigned char>(p + vrtSize), stride);
 
         p += static_cast<SIZE_T>(stride * pts.GetCount());
 
         if (this->fileVersion == 101) {
             // TODO: who deletes this?
             SimpleSphericalParticles::ClusterInfos *ci = new SimpleSphericalParticles::ClusterInfos();
-            ci->numClusters = *this->dat.AsAt<unsigned int>(p); p += sizeof(unsigned int);
-            ci->sizeofPlainData = *this->dat.AsAt<size_t>(p); p += sizeof(size_t);
+            ci->numClusters = *this->dataAt<unsigned int>(p); p += sizeof(unsigned int);
+            ci->sizeofPlainData = *this->dataAt<size_t>(p); p += sizeof(size_t);
             ci->plainData = (unsigned int*)malloc(ci->sizeofPlainData);
-            memcpy(ci->plainData, this->dat.At(p), ci->sizeofPlainData); p += ci->sizeofPlainData;
+            memcpy(ci->plainData, this->dataAt<unsigned char>(p), ci->sizeofPlainData); p += ci->sizeofPlainData;
             pts.SetClusterInfos(ci);
         }
     }
@@ -179,8 +204,10 @@ moldyn::MMPLDDataSource::MMPLDDataSource(void) : view::AnimDataModule(),
         limitMemorySlot("limitMemory", "Limits the memory cache size"),
         limitMemorySizeSlot("limitMemorySize", "Specifies the size limit (in MegaBytes) of the memory cache"),
         overrideBBoxSlot("overrideLocalBBox", "Override local bbox"),
+        useMMapSlot("useMMap", "Memory-maps the file and points the particle lists directly into the mapped pages"),
+        prefetchFramesSlot("prefetchFrames", "Number of frames following the requested one to be read ahead when memory-mapping"),
         getData("getdata", "Slot to request data from this data source."),
-        file(NULL), frameIdx(NULL), bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f),
+        file(NULL), frameIdx(NULL), mappedData(nullptr), mappedSize(0), bbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f),
         clipbox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f), data_hash(0) {
 
     this->filename.SetParameter(new param::FilePathParam(""));
@@ -202,6 +229,13 @@ moldyn::MMPLDDataSource::MMPLDDataSource(void) : view::AnimDataModule(),
     this->overrideBBoxSlot << new param::BoolParam(false);
     this->MakeSlotAvailable(&this->overrideBBoxSlot);
 
+    this->useMMapSlot << new param::BoolParam(false);
+    this->useMMapSlot.SetUpdateCallback(&MMPLDDataSource::filenameChanged);
+    this->MakeSlotAvailable(&this->useMMapSlot);
+
+    this->prefetchFramesSlot << new param::IntParam(2, 0);
+    this->MakeSlotAvailable(&this->prefetchFramesSlot);
+
     this->getData.SetCallback("MultiParticleDataCall", "GetData", &MMPLDDataSource::getDataCallback);
     this->getData.SetCallback("MultiParticleDataCall", "GetExtent", &MMPLDDataSource::getExtentCallback);
     this->MakeSlotAvailable(&this->getData);
@@ -252,6 +286,18 @@ void moldyn::MMPLDDataSource::loadFrame(view::AnimDataModule::Frame *frame,
     //printf("Requesting frame %u of %u frames\n", idx, this->FrameCount());
     //Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "Requesting frame %u of %u frames\n", idx, this->FrameCount());
     ASSERT(idx < this->FrameCount());
+    if (this->mappedData != nullptr) {
+        if (this->frameIdx[idx + 1] > this->mappedSize) {
+            Log::DefaultLog.WriteMsg(Log::LEVEL_ERROR, "Frame %d exceeds the mapped MMPLD file\n", idx);
+            f->Clear();
+            return;
+        }
+        f->MapFrame(this->mappedData + this->frameIdx[idx], idx, this->frameIdx[idx + 1] - this->frameIdx[idx],
+            this->fileVersion);
+        this->prefetchFrames(idx, 1 + static_cast<unsigned int>(
+            vislib::math::Max(0, this->prefetchFramesSlot.Param<param::IntParam>()->Value())));
+        return;
+    }
     this->file->Seek(this->frameIdx[idx]);
     if (!f->LoadFrame(this->file, idx, this->frameIdx[idx + 1] - this->frameIdx[idx], this->fileVersion)) {
         // failed
@@ -265,6 +311,7 @@ void moldyn::MMPLDDataSource::loadFrame(view::AnimDataModule::Frame *frame,
  */
 void moldyn::MMPLDDataSource::release(void) {
     this->resetFrameCache();
+    this->unmapFile();
     if (this->file != NULL) {
         vislib::sys::File *f = this->file;
         this->file = NULL;
@@ -283,6 +330,7 @@ bool moldyn::MMPLDDataSource::filenameChanged(param::ParamSlot& slot) {
     using megamol::core::utility::log::Log;
     using vislib::sys::File;
     this->resetFrameCache();
+    this->unmapFile();
     this->bbox.Set(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
     this->clipbox = this->bbox;
     this->data_hash++;
@@ -350,6 +398,20 @@ bool moldyn::MMPLDDataSource::filenameChanged(param::ParamSlot& slot) {
     size /= static_cast<double>(frmCnt);
     size *= CACHE_FRAME_FACTOR;
 
+    if (this->useMMapSlot.Param<param::BoolParam>()->Value()) {
+        if (this->mapFile()) {
+            // frames are only views into the mapping, the page cache does the caching
+            Log::DefaultLog.WriteMsg(Log::LEVEL_INFO, "MMPLD file memory-mapped; frame cache size set to %i.\n",
+                CACHE_SIZE_MIN);
+            this->setFrameCount(frmCnt);
+            // mapping frames is reentrant, so several frames may be prefetched at once
+            this->setLoaderThreadCount(std::max(1u, std::min(4u, std::thread::hardware_concurrency())));
+            this->initFrameCache(CACHE_SIZE_MIN);
+            return true;
+        }
+        Log::DefaultLog.WriteMsg(Log::LEVEL_WARN, "Unable to memory-map MMPLD file. Falling back to reading frames.");
+    }
+
     UINT64 mem = vislib::sys::SystemInformation::AvailableMemorySize();
     if (this->limitMemorySlot.Param<param::BoolParam>()->Value()) {
         mem = vislib::math::Min(mem, 
@@ -374,6 +436,8 @@ bool moldyn::MMPLDDataSource::filenameChanged(param::ParamSlot& slot) {
     }
 
     this->setFrameCount(frmCnt);
+    // all frames are read through the one file handle
+    this->setLoaderThreadCount(1);
     this->initFrameCache(cacheSize);
 
 #undef _ASSERT_READFILE
@@ -422,3 +486,75 @@ bool moldyn::MMPLDDataSource::getExtentCallback(Call& caller) {
 
     return false;
 }
+
+
+/*
+ * moldyn::MMPLDDataSource::mapFile
+ */
+bool moldyn::MMPLDDataSource::mapFile(void) {
+    ASSERT(this->mappedData == nullptr);
+    if ((this->file == NULL) || !this->file->IsOpen()) return false;
+
+    UINT64 size = this->file->GetSize();
+    if ((size == 0) || (size > static_cast<UINT64>(SIZE_MAX))) return false;
+
+#ifdef _WIN32
+    HANDLE fh = ::CreateFileW(vislib::StringW(this->filename.Param<param::FilePathParam>()->Value()).PeekBuffer(),
+        GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS, NULL);
+    if (fh == INVALID_HANDLE_VALUE) return false;
+    HANDLE mh = ::CreateFileMappingW(fh, NULL, PAGE_READONLY, 0, 0, NULL);
+    ::CloseHandle(fh);
+    if (mh == NULL) return false;
+    void *view = ::MapViewOfFile(mh, FILE_MAP_READ, 0, 0, 0);
+    // the view keeps the mapping alive
+    ::CloseHandle(mh);
+    if (view == NULL) return false;
+#else /* _WIN32 */
+    int fd = ::open(vislib::StringA(this->filename.Param<param::FilePathParam>()->Value()).PeekBuffer(), O_RDONLY);
+    if (fd < 0) return false;
+    void *view = ::mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping keeps the file referenced
+    ::close(fd);
+    if (view == MAP_FAILED) return false;
+    // frames are accessed in playback order, not necessarily linearly through the file
+    ::madvise(view, static_cast<size_t>(size), MADV_RANDOM);
+#endif /* _WIN32 */
+
+    this->mappedData = static_cast<unsigned char *>(view);
+    this->mappedSize = size;
+    return true;
+}
+
+
+/*
+ * moldyn::MMPLDDataSource::unmapFile
+ */
+void moldyn::MMPLDDataSource::unmapFile(void) {
+    if (this->mappedData == nullptr) return;
+#ifdef _WIN32
+    ::UnmapViewOfFile(this->mappedData);
+#else /* _WIN32 */
+    ::munmap(this->mappedData, static_cast<size_t>(this->mappedSize));
+#endif /* _WIN32 */
+    this->mappedData = nullptr;
+    this->mappedSize = 0;
+}
+
+
+/*
+ * moldyn::MMPLDDataSource::prefetchFrames
+ */
+void moldyn::MMPLDDataSource::prefetchFrames(unsigned int first, unsigned int cnt) {
+    if ((this->mappedData == nullptr) || (first >= this->FrameCount())) return;
+    unsigned int last = vislib::math::Min(first + cnt, this->FrameCount());
+    UINT64 begin = this->frameIdx[first];
+    UINT64 end = vislib::math::Min(this->frameIdx[last], this->mappedSize);
+    if (end <= begin) return;
+#ifdef _WIN32
+    // PrefetchVirtualMemory is not available on all supported systems; rely on the page cache
+#else /* _WIN32 */
+    static const UINT64 pageSize = static_cast<UINT64>(::sysconf(_SC_PAGESIZE));
+    begin -= begin % pageSize;
+    ::madvise(this->mappedData + begin, static_cast<size_t>(end - begin), MADV_WILLNEED);
+#endif /* _WIN32 */
+}
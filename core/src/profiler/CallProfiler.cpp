@@ -0,0 +1,331 @@
+/*
+ * profiler/CallProfiler.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+#include "mmcore/profiler/CallProfiler.h"
+#include "mmcore/AbstractNamedObject.h"
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/utility/log/Log.h"
+
+#include <algorithm>
+#include <fstream>
+#include <typeinfo>
+
+using namespace megamol;
+using namespace megamol::core;
+
+namespace {
+
+/** Events each thread buffer can hold between two Collect() calls */
+constexpr size_t threadBufferSize = 1 << 16;
+
+/** Events kept for the trace export */
+constexpr size_t maxTraceEvents = 1 << 22;
+
+/** Escapes a string for use in a JSON string literal */
+std::string jsonEscape(const char* str) {
+    std::string res;
+    for (const char* c = str; *c != '\0'; ++c) {
+        switch (*c) {
+        case '"': res += "\\\""; break;
+        case '\\': res += "\\\\"; break;
+        case '\n': res += "\\n"; break;
+        case '\t': res += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(*c) >= 0x20) res += *c;
+        }
+    }
+    return res;
+}
+
+} // namespace
+
+
+/*
+ * profiler::CallProfiler::Scope::begin
+ */
+void profiler::CallProfiler::Scope::begin(Call& call, unsigned int func) {
+    CallProfiler& prof = CallProfiler::Instance();
+    this->name = prof.nameOf(call, func);
+    prof.threadBuffer().childTime.push_back(0);
+    this->start = prof.now();
+}
+
+
+/*
+ * profiler::CallProfiler::Scope::end
+ */
+void profiler::CallProfiler::Scope::end(void) {
+    CallProfiler& prof = CallProfiler::Instance();
+    const uint64_t duration = prof.now() - this->start;
+    ThreadBuffer& buf = prof.threadBuffer();
+    const uint64_t children = buf.childTime.back();
+    buf.childTime.pop_back();
+    if (!buf.childTime.empty()) {
+        buf.childTime.back() += duration;
+    }
+    buf.Push(Event{this->name, this->start, duration, (duration > children) ? (duration - children) : 0, buf.id});
+}
+
+
+/*
+ * profiler::CallProfiler::ThreadBuffer::ThreadBuffer
+ */
+profiler::CallProfiler::ThreadBuffer::ThreadBuffer(uint32_t id)
+        : ring(threadBufferSize), head(0), tail(0), dropped(0), childTime(), id(id) {
+    this->childTime.reserve(64);
+}
+
+
+/*
+ * profiler::CallProfiler::ThreadBuffer::Push
+ */
+void profiler::CallProfiler::ThreadBuffer::Push(Event const& e) {
+    const uint64_t h = this->head.load(std::memory_order_relaxed);
+    if (h - this->tail.load(std::memory_order_acquire) >= this->ring.size()) {
+        this->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    this->ring[h % this->ring.size()] = e;
+    this->head.store(h + 1, std::memory_order_release);
+}
+
+
+/*
+ * profiler::CallProfiler::Instance
+ */
+profiler::CallProfiler& profiler::CallProfiler::Instance(void) {
+    static CallProfiler prof;
+    return prof;
+}
+
+
+/*
+ * profiler::CallProfiler::SetEnabled
+ */
+void profiler::CallProfiler::SetEnabled(bool enable) {
+    if (this->enabled.exchange(enable) != enable) {
+        megamol::core::utility::log::Log::DefaultLog.WriteInfo("Call profiling %s", enable ? "enabled" : "disabled");
+    }
+}
+
+
+/*
+ * profiler::CallProfiler::Collect
+ */
+void profiler::CallProfiler::Collect(void) {
+    std::lock_guard<std::mutex> lock(this->collectLock);
+    this->collect();
+}
+
+
+/*
+ * profiler::CallProfiler::GetStatistics
+ */
+std::vector<profiler::CallProfiler::Statistics> profiler::CallProfiler::GetStatistics(void) {
+    std::lock_guard<std::mutex> lock(this->collectLock);
+    this->collect();
+    std::vector<Statistics> res;
+    res.reserve(this->statistics.size());
+    for (auto const& s : this->statistics) {
+        res.push_back(s.second);
+    }
+    std::sort(res.begin(), res.end(), [](Statistics const& l, Statistics const& r) { return l.self_ms > r.self_ms; });
+    return res;
+}
+
+
+/*
+ * profiler::CallProfiler::DroppedEvents
+ */
+uint64_t profiler::CallProfiler::DroppedEvents(void) const {
+    uint64_t res = 0;
+    std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(this->bufferLock));
+    for (auto const& b : this->buffers) {
+        res += b->dropped.load(std::memory_order_relaxed);
+    }
+    return res;
+}
+
+
+/*
+ * profiler::CallProfiler::WriteChromeTrace
+ */
+bool profiler::CallProfiler::WriteChromeTrace(std::string const& path) {
+    std::lock_guard<std::mutex> lock(this->collectLock);
+    this->collect();
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file.is_open()) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "Call profiling: could not open trace file \"%s\"", path.c_str());
+        return false;
+    }
+
+    // timestamps and durations are microseconds in the trace format
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (auto const& e : this->events) {
+        if (!first) file << ",\n";
+        first = false;
+        file << "{\"name\":\"" << jsonEscape(e.name) << "\",\"cat\":\"call\",\"ph\":\"X\",\"pid\":0,\"tid\":" << e.thread
+             << ",\"ts\":" << (e.start / 1000.0) << ",\"dur\":" << (e.duration / 1000.0)
+             << ",\"args\":{\"self_us\":" << (e.self / 1000.0) << "}}";
+    }
+    file << "\n]}\n";
+    file.close();
+
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo("Call profiling: wrote %zu events to \"%s\"",
+        this->events.size(), path.c_str());
+    if (this->droppedTrace > 0) {
+        megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+            "Call profiling: %llu events exceeded the trace capacity and are missing",
+            static_cast<unsigned long long>(this->droppedTrace));
+    }
+    return !file.fail();
+}
+
+
+/*
+ * profiler::CallProfiler::Reset
+ */
+void profiler::CallProfiler::Reset(void) {
+    std::lock_guard<std::mutex> lock(this->collectLock);
+    this->collect();
+    this->events.clear();
+    this->statistics.clear();
+    this->droppedTrace = 0;
+}
+
+
+/*
+ * profiler::CallProfiler::CallProfiler
+ */
+profiler::CallProfiler::CallProfiler(void)
+        : enabled(false)
+        , epoch(std::chrono::steady_clock::now())
+        , bufferLock()
+        , buffers()
+        , nameLock()
+        , names()
+        , nameGeneration(0)
+        , collectLock()
+        , events()
+        , statistics()
+        , droppedTrace(0) {
+    // intentionally empty
+}
+
+
+/*
+ * profiler::CallProfiler::~CallProfiler
+ */
+profiler::CallProfiler::~CallProfiler(void) {
+    this->enabled = false;
+}
+
+
+/*
+ * profiler::CallProfiler::threadBuffer
+ */
+profiler::CallProfiler::ThreadBuffer& profiler::CallProfiler::threadBuffer(void) {
+    // the profiler keeps a reference, so events of finished threads can still be collected
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(this->bufferLock);
+        buffer = std::make_shared<ThreadBuffer>(static_cast<uint32_t>(this->buffers.size()));
+        this->buffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+
+/*
+ * profiler::CallProfiler::InvalidateNames
+ */
+void profiler::CallProfiler::InvalidateNames(void) {
+    this->nameGeneration.fetch_add(1, std::memory_order_acq_rel);
+}
+
+
+/*
+ * profiler::CallProfiler::nameOf
+ */
+const char* profiler::CallProfiler::nameOf(Call& call, unsigned int func) {
+    // the cache of a call is only touched by the thread issuing it, and the
+    // names it points to are never released, so a hit needs no lock
+    const uint64_t generation = this->nameGeneration.load(std::memory_order_acquire);
+    if ((call.profilingNamesGeneration == generation) && (func < call.profilingNames.size())
+            && (call.profilingNames[func] != nullptr)) {
+        return call.profilingNames[func];
+    }
+
+    std::string name;
+    if (call.callee != nullptr) {
+        auto parent = call.callee->Parent();
+        if (parent) {
+            name = parent->FullName().PeekBuffer();
+        }
+    }
+    name += "::";
+    name += (call.ClassName() != nullptr) ? call.ClassName() : typeid(call).name();
+    name += "::";
+    const unsigned int mapped = (call.funcMap != nullptr) ? call.funcMap[func] : func;
+    if ((call.callee != nullptr) && (mapped < call.callee->GetCallbackCount())) {
+        name += call.callee->GetCallbackFuncName(mapped);
+    } else {
+        name += std::to_string(func);
+    }
+
+    // stamped with the generation read before the name was built, so a rename
+    // in between makes the next call rebuild it
+    if (call.profilingNamesGeneration != generation) {
+        call.profilingNames.clear();
+        call.profilingNamesGeneration = generation;
+    }
+    if (func >= call.profilingNames.size()) {
+        call.profilingNames.resize(func + 1, nullptr);
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->nameLock);
+        call.profilingNames[func] = this->names.insert(name).first->c_str();
+    }
+    return call.profilingNames[func];
+}
+
+
+/*
+ * profiler::CallProfiler::collect
+ */
+void profiler::CallProfiler::collect(void) {
+    std::vector<std::shared_ptr<ThreadBuffer>> bufs;
+    {
+        std::lock_guard<std::mutex> lock(this->bufferLock);
+        bufs = this->buffers;
+    }
+
+    for (auto& b : bufs) {
+        const uint64_t h = b->head.load(std::memory_order_acquire);
+        for (uint64_t t = b->tail.load(std::memory_order_relaxed); t < h; ++t) {
+            Event const& e = b->ring[t % b->ring.size()];
+
+            auto& s = this->statistics[e.name];
+            if (s.count == 0) s.name = e.name;
+            ++s.count;
+            s.total_ms += e.duration * 1.0e-6;
+            s.self_ms += e.self * 1.0e-6;
+            s.max_ms = std::max(s.max_ms, e.duration * 1.0e-6);
+
+            if (this->events.size() < maxTraceEvents) {
+                this->events.push_back(e);
+            } else {
+                ++this->droppedTrace;
+            }
+        }
+        b->tail.store(h, std::memory_order_release);
+    }
+}
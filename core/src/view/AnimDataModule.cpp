@@ -10,7 +10,9 @@
 #include "vislib/assert.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmcore/utility/sys/Thread.h"
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 
 using namespace megamol::core;
 
@@ -21,8 +23,9 @@ using namespace megamol::core;
  * view::AnimDataModule::AnimDataModule
  */
 view::AnimDataModule::AnimDataModule(void) : Module(), frameCnt(0),
-        loader(loaderFunction), frameCache(NULL), cacheSize(0),
-        stateLock(), lastRequested(0) {
+        loaders(), loaderCnt(1), frameCache(NULL), cacheSize(0),
+        stateLock(), loaderCond(), availableCond(), lastRequested(0),
+        playDirection(1), playStep(1), lastStepDirection(1) {
     this->isRunning.store(false);
 }
 
@@ -34,11 +37,7 @@ view::AnimDataModule::~AnimDataModule(void) {
     this->Release();
 
     Frame ** frames = this->frameCache;
-//    this->frameCache = NULL;
-    this->isRunning.store(false);
-    if (this->loader.IsRunning()) {
-        this->loader.Join();
-    }
+    this->stopLoaders();
     this->frameCache = NULL;
     if (frames != NULL) {
         for (unsigned int i = 0; i < this->cacheSize; i++) {
@@ -54,7 +53,7 @@ view::AnimDataModule::~AnimDataModule(void) {
  * view::AnimDataModule::initframeCache
  */
 void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
-    ASSERT(this->loader.IsRunning() == false);
+    ASSERT(this->loaders.empty());
     ASSERT(cacheSize > 0);
     ASSERT(this->frameCnt > 0);
 
@@ -87,12 +86,11 @@ void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
         this->loadFrame(this->frameCache[0], 0); // load first frame directly.
         this->frameCache[0]->state = Frame::STATE_AVAILABLE;
         this->lastRequested = 0;
+        this->playDirection = 1;
+        this->playStep = 1;
+        this->lastStepDirection = 1;
 
-        this->isRunning.store(true);
-        this->loader.Start(this);
-        // XXX Is there a race condition that requires higher sleep time (value originally was 250)?
-        // XXX Reduced for faster module creation, because called in ctor.
-        vislib::sys::Thread::Sleep(10); 
+        this->startLoaders();
     } else {
         megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_ERROR,
             "Unable to create frame data cache ('constructFrame' returned 'NULL').");
@@ -105,16 +103,41 @@ void view::AnimDataModule::initFrameCache(unsigned int cacheSize) {
  */
 view::AnimDataModule::Frame * view::AnimDataModule::requestLockedFrame(unsigned int idx) {
     Frame *retval = NULL;
-    int dist, minDist = this->frameCnt;
+    unsigned int dist, minDist = this->frameCnt;
     static bool deadlockwarning = true;
 
-    this->stateLock.Lock();
-    this->lastRequested = idx; // TODO: choose better caching strategy!!!
+    std::unique_lock<std::mutex> lock(this->stateLock);
+
+    // track playback direction and speed to steer the loaders
+    unsigned int req = (idx < this->frameCnt) ? idx : (this->frameCnt - 1);
+    if ((this->frameCnt > 0) && (req != this->lastRequested)) {
+        int64_t stride = static_cast<int64_t>(req) - static_cast<int64_t>(this->lastRequested);
+        const int64_t half = static_cast<int64_t>(this->frameCnt / 2);
+        if (stride > half) {
+            stride -= static_cast<int64_t>(this->frameCnt);
+        } else if (stride < -half) {
+            stride += static_cast<int64_t>(this->frameCnt);
+        }
+        int dir = (stride < 0) ? -1 : 1;
+        unsigned int len = static_cast<unsigned int>((stride < 0) ? -stride : stride);
+        // only follow a direction change if it is confirmed by the next request,
+        // since consumers interpolating between two frames request them alternately
+        if (dir == this->lastStepDirection) {
+            this->playDirection = dir;
+            // large jumps are scrubbing, not playback
+            this->playStep = ((len > 0) && (len < this->cacheSize)) ? len : 1;
+        }
+        this->lastStepDirection = dir;
+        this->lastRequested = req;
+        this->loaderCond.notify_all();
+    }
+
     for (unsigned int i = 0; i < this->cacheSize; i++) {
         if ((this->frameCache[i]->state == Frame::STATE_AVAILABLE)
                 || (this->frameCache[i]->state == Frame::STATE_INUSE)) {
             // note: do not wrap distance around!
-            dist = labs(this->frameCache[i]->frame - idx);
+            dist = (this->frameCache[i]->frame > idx) ? (this->frameCache[i]->frame - idx)
+                                                      : (idx - this->frameCache[i]->frame);
             if (dist == 0) {
                 retval = this->frameCache[i];
                 break;
@@ -127,7 +150,6 @@ view::AnimDataModule::Frame * view::AnimDataModule::requestLockedFrame(unsigned
     if (retval != NULL) {
         retval->state = Frame::STATE_INUSE;
     }
-    this->stateLock.Unlock();
 
     if (deadlockwarning
 #if !(defined(DEBUG) || defined(_DEBUG))
@@ -160,25 +182,31 @@ view::AnimDataModule::Frame * view::AnimDataModule::requestLockedFrame(unsigned
  */
 view::AnimDataModule::Frame * view::AnimDataModule::requestLockedFrame(unsigned int idx, bool forceIdx) {
     Frame *f = this->requestLockedFrame(idx);
-    if ((f->FrameNumber() == idx) || (!forceIdx)) return f;
+    if ((f != NULL) && ((f->FrameNumber() == idx) || (!forceIdx))) return f;
+    if ((f == NULL) && !forceIdx) return f;
     // wrong frame number and frame is forced
 
     // clamp idx
     if (idx >= this->frameCnt) {
         idx = this->frameCnt - 1;
-        f->Unlock();
-        f = this->requestLockedFrame(idx);
     }
-
-    // wait for the new frame
-    while (idx != f->FrameNumber()) {
+    if (f != NULL) {
         f->Unlock();
+    }
 
-        // HAZARD: This will wait for all eternity if the requested frame is never loaded
-
-        vislib::sys::Thread::Sleep(100); // time for the loader thread to load
-        f = this->requestLockedFrame(idx);
+    // wait for the loaders to provide the new frame
+    // HAZARD: This will wait for all eternity if the requested frame is never loaded
+    std::unique_lock<std::mutex> lock(this->stateLock);
+    this->availableCond.wait(lock, [this, idx, &f]() {
+        f = this->findCachedFrame(idx, false);
+        return (f != NULL) || !this->isRunning.load();
+    });
+    if (f == NULL) {
+        // loaders have been stopped
+        lock.unlock();
+        return this->requestLockedFrame(idx);
     }
+    f->state = Frame::STATE_INUSE;
 
     return f;
 }
@@ -189,11 +217,7 @@ view::AnimDataModule::Frame * view::AnimDataModule::requestLockedFrame(unsigned
  */
 void view::AnimDataModule::resetFrameCache(void) {
     Frame ** frames = this->frameCache;
-//    this->frameCache = NULL;
-    this->isRunning.store(false);
-    if (this->loader.IsRunning()) {
-        this->loader.Join();
-    }
+    this->stopLoaders();
     this->frameCache = NULL;
     if (frames != NULL) {
         for (unsigned int i = 0; i < this->cacheSize; i++) {
@@ -204,6 +228,9 @@ void view::AnimDataModule::resetFrameCache(void) {
     this->frameCnt = 0;
     this->cacheSize = 0;
     this->lastRequested = 0;
+    this->playDirection = 1;
+    this->playStep = 1;
+    this->lastStepDirection = 1;
 }
 
 
@@ -211,149 +238,120 @@ void view::AnimDataModule::resetFrameCache(void) {
  * view::AnimDataModule::setFrameCount
  */
 void view::AnimDataModule::setFrameCount(unsigned int cnt) {
-    ASSERT(this->loader.IsRunning() == false);
+    ASSERT(this->loaders.empty());
     ASSERT(cnt > 0);
     this->frameCnt = cnt;
 }
 
 
+/*
+ * view::AnimDataModule::setLoaderThreadCount
+ */
+void view::AnimDataModule::setLoaderThreadCount(unsigned int cnt) {
+    ASSERT(this->loaders.empty());
+    ASSERT(cnt > 0);
+    this->loaderCnt = (cnt > 0) ? cnt : 1;
+}
+
+
 /*
  * view::AnimDataModule::loaderFunction
  */
-DWORD view::AnimDataModule::loaderFunction(void *userData) {
-    AnimDataModule *This = static_cast<AnimDataModule*>(userData);
-    ASSERT(This != NULL);
-    unsigned int index, i, j, req;
-#ifdef _LOADING_REPORTING
-    unsigned int l;
-#endif /* _LOADING_REPORTING */
+void view::AnimDataModule::loaderFunction(void) {
+    unsigned int index, i, k, rank, maxRank;
     Frame *frame;
-    vislib::StringA fullName(This->FullName());
+    vislib::StringA fullName(this->FullName());
 
     std::chrono::high_resolution_clock::duration accumDuration = std::chrono::seconds(0);
     unsigned int accumCount = 0;
     std::chrono::system_clock::time_point lastReportTime = std::chrono::system_clock::now();
     const std::chrono::system_clock::duration lastReportDistance = std::chrono::seconds(3);
 
-    while (This->isRunning.load()) {
-        // sleep to enforce thread changes
-        vislib::sys::Thread::Sleep(1);
-        if (!This->isRunning.load()) break;
+    std::unique_lock<std::mutex> lock(this->stateLock);
+    while (this->isRunning.load()) {
 
         // idea:
-        //  1. search for the most important frame to be loaded.
+        //  1. search for the most important frame to be loaded along the
+        //     predicted playback path.
         //  2. search for the best cached frame to be overwritten.
-        //  3. load the frame
+        //  3. load the frame without holding the lock, so that other loaders
+        //     and consumers can proceed.
 
         // 1.
-        // Note: we do not need to lock here, because we won't change the frame
-        // state now, and the different states that can be set outside this
-        // thread are aquivalent for us.
-        index = req = This->lastRequested;
-        for (j = 0; j < This->cacheSize; j++) {
-            for (i = 0; i < This->cacheSize; i++) {
-                if (!This->isRunning.load()) break;
-                if (((This->frameCache[i]->state == Frame::STATE_AVAILABLE)
-                        || (This->frameCache[i]->state == Frame::STATE_INUSE)) 
-                        && (This->frameCache[i]->frame == index)) {
-                    break;
-                }
-            }
-            if (!This->isRunning.load()) break;
-            if (i >= This->cacheSize) {
+        frame = NULL;
+        index = 0;
+        for (k = 0; k < this->cacheSize; k++) {
+            index = this->predictFrame(k);
+            if (this->findCachedFrame(index, true) == NULL) {
                 break;
             }
-            index = (index + 1) % This->frameCnt;
-        }
-        if (!This->isRunning.load()) break;
-        if (j >= This->cacheSize) {
-            if (j >= This->frameCnt) {
-                ASSERT(This->frameCnt == This->cacheSize);
-                megamol::core::utility::log::Log::DefaultLog.WriteMsg(megamol::core::utility::log::Log::LEVEL_INFO,
-                    "All frames of the dataset loaded into cache. Terminating loading Thread.");
-                break;
-            }
-            continue;
         }
 
         // 2.
-        // Note: We now need to lock, because we must synchronise against 
-        // frames changing from 'STATE_AVAILABLE' to 'STATE_INUSE'.
-        This->stateLock.Lock();
-        // core idea: search for the frame with the largest distance to the requested frame
-        frame = NULL; // the frame to be overwritten
-        j = 0; // the distance to the found frame to be overwritten
-        for (i = 0; i < This->cacheSize; i++) {
-            if (This->frameCache[i]->state == Frame::STATE_INVALID) {
-                frame = This->frameCache[i];
-                // j = UINT_MAX; // not required, since we instantly leave the loop
-#ifdef _LOADING_REPORTING
-                l = i;
-#endif /* _LOADING_REPORTING */
-                break;
-            } else if (This->frameCache[i]->state == Frame::STATE_AVAILABLE) {
-                // distance to the frame[i];
-                long ld = static_cast<long>(This->frameCache[i]->frame) - static_cast<long>(req);
-                if (ld < 0) {
-                    if (ld < (static_cast<long>(This->frameCnt)) / 10) {
-                        ld += static_cast<long>(This->frameCnt);
-                        if (ld < 0) ld = 0; // should never happen
-                    } else {
-                        ld = -10 * ld;
+        // core idea: overwrite the frame ranking highest for eviction, but
+        // only if it is less important than the frame to be loaded
+        if (k < this->cacheSize) {
+            rank = this->evictionRank(index);
+            maxRank = rank;
+            for (i = 0; i < this->cacheSize; i++) {
+                if (this->frameCache[i]->state == Frame::STATE_INVALID) {
+                    frame = this->frameCache[i];
+                    break;
+                } else if (this->frameCache[i]->state == Frame::STATE_AVAILABLE) {
+                    unsigned int r = this->evictionRank(this->frameCache[i]->frame);
+                    if (r > maxRank) {
+                        frame = this->frameCache[i];
+                        maxRank = r;
                     }
                 }
-
-                if (j < static_cast<unsigned int>(ld)) {
-                    frame = This->frameCache[i];
-                    j = static_cast<unsigned int>(ld);
-#ifdef _LOADING_REPORTING
-                    l = i;
-#endif /* _LOADING_REPORTING */
-                }
             }
-            if (!This->isRunning.load()) break;
         }
 
-        // 3.
-        if (frame != NULL) {
-            frame->state = Frame::STATE_LOADING;
+        // if frame is NULL either all predicted frames are cached or no
+        // suitable cache buffer was found for loading. The latter is mostly
+        // the case if the cache is too small or if the data source locks too
+        // many frames. Wait for a new request or an unlocked frame.
+        if (frame == NULL) {
+            this->loaderCond.wait(lock);
+            continue;
         }
-        // if frame is NULL no suitable cache buffer found for loading. This is
-        // mostly the case if the cache is too small or if the data source 
-        // locks too much frames.
-        This->stateLock.Unlock();
 
-        if ((frame != NULL) && This->isRunning.load()) {
+        // 3.
+        frame->state = Frame::STATE_LOADING;
+        frame->frame = index;
+        lock.unlock();
+
 #ifdef _LOADING_REPORTING
-            printf("Loading frame %i into cache %i\n", index, l);
+        printf("Loading frame %i\n", index);
 #endif /* _LOADING_REPORTING */
 
-            std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+        std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
 
-            This->loadFrame(frame, index);
+        this->loadFrame(frame, index);
 
-            std::chrono::high_resolution_clock::duration duration = std::chrono::high_resolution_clock::now() - start;
-            accumDuration += duration;
-            accumCount++;
+        std::chrono::high_resolution_clock::duration duration = std::chrono::high_resolution_clock::now() - start;
+        accumDuration += duration;
+        accumCount++;
 
-            std::chrono::system_clock::time_point reportTime = std::chrono::system_clock::now();
-            if ((reportTime - lastReportTime) > lastReportDistance) {
-                lastReportTime = reportTime;
-                if (accumCount > 0) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteInfo(100, "[%s] Loading speed: %f ms/f (%u)",
-                        fullName.PeekBuffer(),
-                        1000.0 * std::chrono::duration_cast<std::chrono::duration<double>>(accumDuration).count() / static_cast<double>(accumCount),
-                        static_cast<unsigned int>(accumCount)
-                        );
-                }
+        std::chrono::system_clock::time_point reportTime = std::chrono::system_clock::now();
+        if ((reportTime - lastReportTime) > lastReportDistance) {
+            lastReportTime = reportTime;
+            if (accumCount > 0) {
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo(100, "[%s] Loading speed: %f ms/f (%u)",
+                    fullName.PeekBuffer(),
+                    1000.0 * std::chrono::duration_cast<std::chrono::duration<double>>(accumDuration).count() / static_cast<double>(accumCount),
+                    static_cast<unsigned int>(accumCount)
+                    );
             }
-
-            // we no not need to lock here, because this transition from 
-            // 'STATE_LOADING' to 'STATE_AVAILABLE' is safe for the using 
-            // thread.
-            frame->state = Frame::STATE_AVAILABLE;
         }
+
+        lock.lock();
+        frame->state = Frame::STATE_AVAILABLE;
+        this->availableCond.notify_all();
+        // the new frame might be a better eviction candidate for other loaders
+        this->loaderCond.notify_all();
     }
+    lock.unlock();
 
     if (accumCount > 0) {
         megamol::core::utility::log::Log::DefaultLog.WriteInfo(100, "[%s] Loading speed: %f ms/f (%u)",
@@ -364,7 +362,80 @@ DWORD view::AnimDataModule::loaderFunction(void *userData) {
     }
 
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("The loader thread is exiting.");
-    return 0;
+}
+
+
+/*
+ * view::AnimDataModule::predictFrame
+ */
+unsigned int view::AnimDataModule::predictFrame(unsigned int step) const {
+    const int64_t cnt = static_cast<int64_t>(this->frameCnt);
+    int64_t idx = static_cast<int64_t>(this->lastRequested)
+        + static_cast<int64_t>(this->playDirection) * static_cast<int64_t>(step) * static_cast<int64_t>(this->playStep);
+    idx %= cnt;
+    if (idx < 0) idx += cnt;
+    return static_cast<unsigned int>(idx);
+}
+
+
+/*
+ * view::AnimDataModule::evictionRank
+ */
+unsigned int view::AnimDataModule::evictionRank(unsigned int idx) const {
+    const int64_t cnt = static_cast<int64_t>(this->frameCnt);
+    int64_t ahead = (static_cast<int64_t>(idx) - static_cast<int64_t>(this->lastRequested))
+        * static_cast<int64_t>(this->playDirection);
+    ahead %= cnt;
+    if (ahead < 0) ahead += cnt;
+    int64_t behind = (ahead == 0) ? 0 : (cnt - ahead);
+    // frames right behind the playhead might still be used for interpolation
+    return static_cast<unsigned int>(std::min(ahead / static_cast<int64_t>(this->playStep), 2 * behind));
+}
+
+
+/*
+ * view::AnimDataModule::findCachedFrame
+ */
+view::AnimDataModule::Frame *view::AnimDataModule::findCachedFrame(unsigned int idx, bool includeLoading) const {
+    for (unsigned int i = 0; i < this->cacheSize; i++) {
+        Frame *f = this->frameCache[i];
+        if ((f->frame == idx) && ((f->state == Frame::STATE_AVAILABLE) || (f->state == Frame::STATE_INUSE)
+                || (includeLoading && (f->state == Frame::STATE_LOADING)))) {
+            return f;
+        }
+    }
+    return NULL;
+}
+
+
+/*
+ * view::AnimDataModule::startLoaders
+ */
+void view::AnimDataModule::startLoaders(void) {
+    ASSERT(this->loaders.empty());
+    this->isRunning.store(true);
+    for (unsigned int i = 0; i < this->loaderCnt; i++) {
+        this->loaders.emplace_back(&AnimDataModule::loaderFunction, this);
+    }
+}
+
+
+/*
+ * view::AnimDataModule::stopLoaders
+ */
+void view::AnimDataModule::stopLoaders(void) {
+    {
+        std::lock_guard<std::mutex> lock(this->stateLock);
+        this->isRunning.store(false);
+    }
+    this->loaderCond.notify_all();
+    this->availableCond.notify_all();
+    for (auto& l : this->loaders) {
+        if (l.joinable()) {
+            l.join();
+        }
+    }
+    this->loaders.clear();
 }
 
 
@@ -374,7 +445,8 @@ DWORD view::AnimDataModule::loaderFunction(void *userData) {
 void view::AnimDataModule::unlock(view::AnimDataModule::Frame *frame) {
     ASSERT(&frame->owner == this);
     ASSERT(frame->state == Frame::STATE_INUSE);
-    this->stateLock.Lock();
+    std::lock_guard<std::mutex> lock(this->stateLock);
     frame->state = Frame::STATE_AVAILABLE;
-    this->stateLock.Unlock();
+    // the frame may now be overwritten
+    this->loaderCond.notify_all();
 }
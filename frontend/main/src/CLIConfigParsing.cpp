@@ -87,6 +87,7 @@ static std::string nocursor_option      = "nocursor";
 static std::string interactive_option   = "i,interactive";
 static std::string guishow_option       = "guishow";
 static std::string guiscale_option      = "guiscale";
+static std::string calltrace_option     = "profile-calls";
 static std::string help_option          = "h,help";
 
 static void files_exist(std::vector<std::string> vec, std::string const& type) {
@@ -114,6 +115,11 @@ static void guiscale_handler(std::string const& option_name, cxxopts::ParseResul
     config.gui_scale = parsed_options[option_name].as<float>();
 };
 
+static void calltrace_handler(std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config)
+{
+    config.call_trace_file = parsed_options[option_name].as<std::string>();
+};
+
 static void config_handler(std::string const& option_name, cxxopts::ParseResult const& parsed_options, RuntimeConfig& config)
 {
     // is already done by first CLI pass which checks config files before running them through Lua
@@ -287,6 +293,7 @@ std::vector<OptionsListEntry> cli_options_list =
         , {project_files_option, "Project file(s) to load at startup",                                              cxxopts::value<std::vector<std::string>>(), project_handler}
         , {guishow_option,       "Render GUI overlay, use '=false' to disable",                                     cxxopts::value<bool>(),                     guishow_handler}
         , {guiscale_option,      "Set scale of GUI, expects float >= 1.0. e.g. 1.0 => 100%, 2.1 => 210%",           cxxopts::value<float>(),                    guiscale_handler}
+        , {calltrace_option,     "Record timings of all graph calls, write Chrome trace JSON to given file on exit",  cxxopts::value<std::string>(),              calltrace_handler}
         , {help_option,          "Print help message",                                                              cxxopts::value<bool>(),                     empty_handler}
     };
 
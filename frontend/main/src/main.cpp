@@ -104,6 +104,7 @@ int main(const int argc, const char** argv) {
 
     megamol::frontend::FrameStatistics_Service framestatistics_service;
     megamol::frontend::FrameStatistics_Service::Config framestatisticsConfig;
+    framestatisticsConfig.call_trace_file = config.call_trace_file;
     // needs to execute before gl_service at frame start, after gl service at frame end
     framestatistics_service.setPriority(1);
 
@@ -0,0 +1,37 @@
+/*
+ * CallProfiling.h
+ *
+ * Copyright (C) 2021 by VISUS (Universitaet Stuttgart).
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace megamol {
+namespace frontend_resources {
+
+// timings of the graph calls, aggregated per "module::call::callback"
+// the statistics are refreshed once per frame while profiling is enabled
+struct CallProfiling {
+    struct Entry {
+        std::string name;
+        size_t count = 0;
+        double total_ms = 0.0;
+        double self_ms = 0.0;
+        double max_ms = 0.0;
+    };
+
+    bool enabled = false;
+    std::vector<Entry> statistics; // sorted by descending self time
+
+    std::function<void(bool)> set_enabled;
+    std::function<bool(std::string const& /*path*/)> write_trace; // Chrome trace/Perfetto JSON
+    std::function<void()> reset;
+};
+
+} /* end namespace frontend_resources */
+} /* end namespace megamol */
@@ -9,6 +9,8 @@
 // you should also delete the FAQ comments in these template files after you read and understood them
 #include "FrameStatistics_Service.hpp"
 
+#include "mmcore/profiler/CallProfiler.h"
+
 #include <numeric>
 
 
@@ -47,16 +49,39 @@ bool FrameStatistics_Service::init(const Config& config) {
 
     m_program_start_time = std::chrono::high_resolution_clock::now();
 
+    using megamol::core::profiler::CallProfiler;
+    m_call_profiling.set_enabled = [&](bool enable) {
+        CallProfiler::Instance().SetEnabled(enable);
+        m_call_profiling.enabled = enable;
+    };
+    m_call_profiling.write_trace = [](std::string const& path) -> bool {
+        return CallProfiler::Instance().WriteChromeTrace(path);
+    };
+    m_call_profiling.reset = [&]() {
+        CallProfiler::Instance().Reset();
+        m_call_profiling.statistics.clear();
+    };
+
+    m_call_trace_file = config.call_trace_file;
+    if (!m_call_trace_file.empty()) {
+        m_call_profiling.set_enabled(true);
+    }
+
     log("initialized successfully");
     return true;
 }
 
 void FrameStatistics_Service::close() {
+    if (!m_call_trace_file.empty()) {
+        m_call_profiling.write_trace(m_call_trace_file);
+    }
+    m_call_profiling.set_enabled(false);
 }
 
 std::vector<FrontendResource>& FrameStatistics_Service::getProvidedResources() {
     m_providedResourceReferences = {
-        {"FrameStatistics", m_statistics}
+        {"FrameStatistics", m_statistics},
+        {"CallProfiling", m_call_profiling}
     };
 
     return m_providedResourceReferences;
@@ -111,6 +136,28 @@ void FrameStatistics_Service::finish_frame() {
 
     m_statistics.last_averaged_mspf = std::accumulate(m_frame_times_micro.begin(), m_frame_times_micro.end(), 0) / m_frame_times_micro.size() / static_cast<double>(1000);
     m_statistics.last_averaged_fps = 1000.0 / m_statistics.last_averaged_mspf;
+
+    collect_call_profiling();
+}
+
+void FrameStatistics_Service::collect_call_profiling() {
+    using megamol::core::profiler::CallProfiler;
+    auto& profiler = CallProfiler::Instance();
+    m_call_profiling.enabled = profiler.IsEnabled();
+    if (!m_call_profiling.enabled)
+        return;
+
+    // draining once per frame keeps the per-thread ring buffers from overflowing
+    auto stats = profiler.GetStatistics();
+    m_call_profiling.statistics.resize(stats.size());
+    for (size_t i = 0; i < stats.size(); ++i) {
+        auto& entry = m_call_profiling.statistics[i];
+        entry.name = stats[i].name;
+        entry.count = stats[i].count;
+        entry.total_ms = stats[i].total_ms;
+        entry.self_ms = stats[i].self_ms;
+        entry.max_ms = stats[i].max_ms;
+    }
 }
 
 } // namespace frontend
@@ -10,6 +10,7 @@
 #include "AbstractFrontendService.hpp"
 
 #include "FrameStatistics.h"
+#include "CallProfiling.h"
 
 #include <chrono>
 #include <array>
@@ -21,6 +22,8 @@ class FrameStatistics_Service final : public AbstractFrontendService {
 public:
 
     struct Config {
+        // if set, call profiling starts enabled and the Chrome trace is written here on shutdown
+        std::string call_trace_file = "";
     };
 
     std::string serviceName() const override { return "FrameStatistics_Service"; }
@@ -62,6 +65,8 @@ public:
 
 private:
     megamol::frontend_resources::FrameStatistics m_statistics;
+    megamol::frontend_resources::CallProfiling m_call_profiling;
+    std::string m_call_trace_file;
 
     std::chrono::high_resolution_clock::time_point m_program_start_time;
     std::chrono::high_resolution_clock::time_point m_frame_start_time;
@@ -71,6 +76,7 @@ private:
 
     void start_frame();
     void finish_frame();
+    void collect_call_profiling();
 
     std::vector<FrontendResource> m_providedResourceReferences;
     std::vector<std::string> m_requestedResourcesNames;
@@ -14,6 +14,7 @@
 
 #include "Screenshots.h"
 #include "FrameStatistics.h"
+#include "CallProfiling.h"
 #include "WindowManipulation.h"
 #include "GUIState.h"
 #include "GlobalValueStore.h"
@@ -99,7 +100,8 @@ bool Lua_Service_Wrapper::init(const Config& config) {
         "GUIResource", // propagate GUI state and visibility
         "MegaMolGraph", // LuaAPI manipulates graph
         "RenderNextFrame", // LuaAPI can render one frame
-        "GlobalValueStore" // LuaAPI can read and set global values
+        "GlobalValueStore", // LuaAPI can read and set global values
+        "CallProfiling" // for call timings
     }; //= {"ZMQ_Context"};
 
     m_network_host_pimpl = std::unique_ptr<void, std::function<void(void*)>>(
@@ -254,6 +256,28 @@ void Lua_Service_Wrapper::fill_frontend_resources_callbacks(void* callbacks_coll
             return DoubleResult{frame_statistics.last_rendered_frame_time_milliseconds};
         }});
 
+    callbacks.add<VoidResult, bool>(
+        "mmSetCallProfiling",
+        "(bool state)\n\tStart (true) or stop (false) recording the timings of all graph calls.",
+        {[&](bool state) -> VoidResult
+        {
+            auto& call_profiling = m_requestedResourceReferences[8].getResource<megamol::frontend_resources::CallProfiling>();
+            call_profiling.set_enabled(state);
+            return VoidResult{};
+        }});
+
+    callbacks.add<VoidResult, std::string>(
+        "mmWriteCallTrace",
+        "(string filename)\n\tWrite the recorded call timings as Chrome trace JSON to 'filename'.",
+        {[&](std::string file) -> VoidResult
+        {
+            auto& call_profiling = m_requestedResourceReferences[8].getResource<megamol::frontend_resources::CallProfiling>();
+            if (!call_profiling.write_trace(file)) {
+                return Error{"could not write call trace to " + file};
+            }
+            return VoidResult{};
+        }});
+
     callbacks.add<VoidResult, int, int>(
         "mmSetFramebufferSize",
         "(int width, int height)\n\tSet framebuffer dimensions to width x height.",
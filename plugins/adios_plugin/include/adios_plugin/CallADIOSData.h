@@ -7,8 +7,13 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <string>
+#include <type_traits>
+#include <typeindex>
+#include <typeinfo>
 #include <vector>
 #include "mmcore/Call.h"
 #include "mmcore/factories/CallAutoDescription.h"
@@ -18,6 +23,32 @@ namespace megamol {
 namespace adios {
 
 
+/**
+ * Read-only view of contiguous values.
+ * The view does not own the values, it is only valid as long as the container it was taken from.
+ */
+template<class T>
+class containerView {
+public:
+    typedef T value_type;
+
+    containerView() : ptr(nullptr), cnt(0) {}
+    containerView(const T* data, size_t size) : ptr(data), cnt(size) {}
+
+    const T* data() const { return ptr; }
+    size_t size() const { return cnt; }
+    bool empty() const { return cnt == 0; }
+
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + cnt; }
+
+    const T& operator[](size_t idx) const { return ptr[idx]; }
+
+private:
+    const T* ptr;
+    size_t cnt;
+};
+
 class abstractContainer {
 public:
     virtual ~abstractContainer() = default;
@@ -42,8 +73,65 @@ public:
         return shape;
     }
 
+    /** Answers the type of the stored values */
+    virtual std::type_index getValueType() const = 0;
+
+    /** Answers the address of the first stored value */
+    virtual const void* getRawData() const = 0;
+
+    /**
+     * Answers the values as type R without copying them if they are stored as R.
+     * Otherwise the values are converted on the first request and the result is kept with the container,
+     * so further requests do not convert again. Not thread-safe.
+     */
+    template<class R>
+    containerView<R> GetView() {
+        if (this->getValueType() == std::type_index(typeid(R))) {
+            return containerView<R>(static_cast<const R*>(this->getRawData()), this->size());
+        }
+        auto& converted = this->conversions[std::type_index(typeid(R))];
+        if (converted == nullptr) {
+            converted = std::make_shared<std::vector<R>>(this->convertTo<R>());
+        }
+        const auto& vec = *std::static_pointer_cast<const std::vector<R>>(converted);
+        return containerView<R>(vec.data(), vec.size());
+    }
+
+    /** Answers the stored values as bytes, e.g. for interleaving them into vertex data (not for strings) */
+    containerView<unsigned char> GetRawBytes() {
+        return containerView<unsigned char>(
+            static_cast<const unsigned char*>(this->getRawData()), this->size() * this->getTypeSize());
+    }
+
     std::vector<size_t> shape;
     bool singleValue = false;
+
+protected:
+    /** Cached conversions of the values, cleared whenever the values can change */
+    std::map<std::type_index, std::shared_ptr<void>> conversions;
+
+private:
+    template<class R>
+    std::vector<R> convertTo() {
+        if constexpr (std::is_same<R, float>::value) {
+            return this->GetAsFloat();
+        } else if constexpr (std::is_same<R, double>::value) {
+            return this->GetAsDouble();
+        } else if constexpr (std::is_same<R, int32_t>::value) {
+            return this->GetAsInt32();
+        } else if constexpr (std::is_same<R, uint64_t>::value) {
+            return this->GetAsUInt64();
+        } else if constexpr (std::is_same<R, uint32_t>::value) {
+            return this->GetAsUInt32();
+        } else if constexpr (std::is_same<R, char>::value) {
+            return this->GetAsChar();
+        } else if constexpr (std::is_same<R, unsigned char>::value) {
+            return this->GetAsUChar();
+        } else {
+            static_assert(std::is_same<R, std::string>::value, "[CallADIOSData] Conversion not supported.");
+            return this->GetAsString();
+        }
+    }
 };
 
 class DoubleContainer : public abstractContainer {
@@ -60,8 +148,11 @@ public:
     std::vector<std::string> GetAsString() override {return this->getAs<std::string>();}
 
     std::vector<value_type>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override { return dataVec.size(); }
     const std::string getType() override { return "double"; }
     const size_t getTypeSize() override {
@@ -113,8 +204,11 @@ public:
     std::vector<std::string> GetAsString() override {return this->getAs<std::string>();}
 
     std::vector<value_type>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override { return dataVec.size(); }
     const std::string getType() override { return "float"; }
     const size_t getTypeSize() override {
@@ -166,8 +260,11 @@ public:
     std::vector<std::string> GetAsString() override {return this->getAs<std::string>();}
 
     std::vector<int32_t>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override { return dataVec.size(); }
     const std::string getType() override { return "int32_t"; }
     const size_t getTypeSize() override {
@@ -219,8 +316,11 @@ public:
     std::vector<std::string> GetAsString() override {return this->getAs<std::string>();}
 
     std::vector<value_type>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override { return dataVec.size(); }
     const std::string getType() override { return "uint64_t"; }
     const size_t getTypeSize() override {
@@ -272,8 +372,11 @@ public:
     std::vector<std::string> GetAsString() override {return this->getAs<std::string>();}
 
     std::vector<value_type>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override { return dataVec.size(); }
     const std::string getType() override { return "uint32_t"; }
     const size_t getTypeSize() override {
@@ -325,8 +428,11 @@ class UCharContainer : public abstractContainer {
     std::vector<std::string> GetAsString() override {return this->getAs<std::string>();}
 
     std::vector<value_type>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override { return dataVec.size(); }
     const std::string getType() override { return "unsigned char"; }
     const size_t getTypeSize() override {
@@ -392,8 +498,11 @@ public:
     }
 
     std::vector<value_type>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override {
         return dataVec.size();
     }
@@ -450,8 +559,11 @@ public:
     std::vector<std::string> GetAsString() override {return this->getAs<std::string>();}
 
     std::vector<value_type>& getVec() {
+        this->conversions.clear();
         return dataVec;
     }
+    std::type_index getValueType() const override { return typeid(value_type); }
+    const void* getRawData() const override { return dataVec.data(); }
     size_t size() override {return dataVec.size();}
     const std::string getType() override {return "string";}
     const size_t getTypeSize() override {
@@ -481,6 +593,12 @@ private:
 
 typedef std::map<std::string, std::shared_ptr<abstractContainer>> adiosDataMap;
 
+/** Box selections (start, count) per variable */
+typedef std::map<std::string, std::pair<std::vector<size_t>, std::vector<size_t>>> adiosSelectionMap;
+
+/** Block selections per variable */
+typedef std::map<std::string, size_t> adiosBlockSelectionMap;
+
 class CallADIOSData : public megamol::core::Call {
 public:
     /**
@@ -562,6 +680,31 @@ public:
 
     bool isInVars(std::string);
 
+    /**
+     * Restricts the read of a global array to a sub-box.
+     * Replaces a block selection of the same variable.
+     *
+     * @param varname The name of the variable.
+     * @param start The first index per dimension.
+     * @param count The number of elements per dimension.
+     */
+    void setSelection(const std::string& varname, const std::vector<size_t>& start, const std::vector<size_t>& count);
+
+    /**
+     * Restricts the read of a variable to one of the blocks written in the step.
+     * Replaces a box selection of the same variable.
+     *
+     * @param varname The name of the variable.
+     * @param blockID The index of the block.
+     */
+    void setBlockSelection(const std::string& varname, size_t blockID);
+
+    /** Removes all box and block selections, so variables are read completely. */
+    void clearSelections();
+
+    const adiosSelectionMap& getSelections() const { return this->selections; }
+    const adiosBlockSelectionMap& getBlockSelections() const { return this->blockSelections; }
+
 private:
     size_t dataHash;
     float time;
@@ -569,6 +712,8 @@ private:
     size_t frameIDtoLoad;
     std::vector<std::string> inqVars;
     std::vector<std::string> availableVars;
+    adiosSelectionMap selections;
+    adiosBlockSelectionMap blockSelections;
 
     std::shared_ptr<adiosDataMap> dataptr;
 };
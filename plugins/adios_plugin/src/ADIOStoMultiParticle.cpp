@@ -113,13 +113,14 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
                 return false;
             }
 
-            std::vector<unsigned char> X;
-            std::vector<unsigned char> Y;
-            std::vector<unsigned char> Z;
+            // views of the raw bytes, the data stays in the containers of the call
+            containerView<unsigned char> X;
+            containerView<unsigned char> Y;
+            containerView<unsigned char> Z;
 
             stride = 0;
             if (cad->isInVars("xyz")) {
-                X = cad->getData("xyz")->GetAsUChar();
+                X = cad->getData("xyz")->GetRawBytes();
                 stride += 3 * cad->getData("xyz")->getTypeSize();
                 if (cad->getData("xyz")->getTypeSize() == 4) {
                     vertType = core::moldyn::SimpleSphericalParticles::VERTDATA_FLOAT_XYZ;
@@ -127,9 +128,9 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
                     vertType = core::moldyn::SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ;
                 }
             } else if (cad->isInVars("x") && cad->isInVars("y") && cad->isInVars("z")) {
-                X = cad->getData("x")->GetAsUChar();
-                Y = cad->getData("y")->GetAsUChar();
-                Z = cad->getData("z")->GetAsUChar();
+                X = cad->getData("x")->GetRawBytes();
+                Y = cad->getData("y")->GetRawBytes();
+                Z = cad->getData("z")->GetRawBytes();
                 stride += 3 * cad->getData("x")->getTypeSize();
                 if (cad->getData("x")->getTypeSize() == 4) {
                     vertType = core::moldyn::SimpleSphericalParticles::VERTDATA_FLOAT_XYZ;
@@ -141,16 +142,16 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
                     "ADIOStoMultiParticle: No particle positions found");
                 return false;
             }
-            std::vector<float> box = cad->getData("global_box")->GetAsFloat();
+            auto box = cad->getData("global_box")->GetView<float>();
 
-            auto p_count = cad->getData("count")->GetAsUInt64();
-            std::vector<unsigned char> radius;
-            std::vector<unsigned char> r;
-            std::vector<unsigned char> g;
-            std::vector<unsigned char> b;
-            std::vector<unsigned char> a;
-            std::vector<unsigned char> id;
-            std::vector<unsigned char> intensity;
+            auto p_count = cad->getData("count")->GetView<uint64_t>();
+            containerView<unsigned char> radius;
+            containerView<unsigned char> r;
+            containerView<unsigned char> g;
+            containerView<unsigned char> b;
+            containerView<unsigned char> a;
+            containerView<unsigned char> id;
+            containerView<unsigned char> intensity;
 
             // list_box
             if (cad->isInVars("list_box")) {
@@ -158,23 +159,18 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
             }
             // Radius
             if (cad->isInVars("radius")) {
-                radius = cad->getData("radius")->GetAsUChar();
+                radius = cad->getData("radius")->GetRawBytes();
                 stride += 3 * cad->getData("radius")->getTypeSize();
             }
             // Colors
             if (cad->isInVars("r")) {
-                r = cad->getData("r")->GetAsUChar();
-                g = cad->getData("g")->GetAsUChar();
-                b = cad->getData("b")->GetAsUChar();
-                a = cad->getData("a")->GetAsUChar();
+                r = cad->getData("r")->GetRawBytes();
+                g = cad->getData("g")->GetRawBytes();
+                b = cad->getData("b")->GetRawBytes();
+                a = cad->getData("a")->GetRawBytes();
                 stride += 4 * cad->getData("r")->getTypeSize();
-            } else if (cad->isInVars("global_r")) {
-                r = cad->getData("global_r")->GetAsUChar();
-                g = cad->getData("global_g")->GetAsUChar();
-                b = cad->getData("global_b")->GetAsUChar();
-                a = cad->getData("global_a")->GetAsUChar();
             } else if (cad->isInVars("i")) {
-                intensity = cad->getData("i")->GetAsUChar();
+                intensity = cad->getData("i")->GetRawBytes();
                 stride += cad->getData("i")->getTypeSize();
                 // normalizing intentsity to [0,1]
                 // std::vector<float>::iterator minIt = std::min_element(std::begin(intensity), std::end(intensity));
@@ -187,7 +183,7 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
             }
             // ID
             if (cad->isInVars("id")) {
-                id = cad->getData("id")->GetAsUChar();
+                id = cad->getData("id")->GetRawBytes();
                 stride += cad->getData("id")->getTypeSize();
             }
 
@@ -235,7 +231,7 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
                 idType = core::moldyn::SimpleSphericalParticles::IDDATA_NONE;
 
                 if (cad->isInVars("global_radius")) {
-                    auto flt_radius = cad->getData("global_radius")->GetAsFloat();
+                    auto flt_radius = cad->getData("global_radius")->GetView<float>();
                     mpdc->AccessParticles(k).SetGlobalRadius(flt_radius[0]);
                 } else if (cad->isInVars("radius")) {
                     vertType = core::moldyn::SimpleSphericalParticles::VERTDATA_FLOAT_XYZR;
@@ -243,11 +239,12 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
                     mpdc->AccessParticles(k).SetGlobalRadius(1.0f);
                 }
                 if (cad->isInVars("global_r")) {
-                    auto flt_r = reinterpret_cast<std::vector<float>&>(r);
-                    auto flt_g = reinterpret_cast<std::vector<float>&>(g);
-                    auto flt_b = reinterpret_cast<std::vector<float>&>(b);
-                    auto flt_a = reinterpret_cast<std::vector<float>&>(a);
-                    mpdc->AccessParticles(k).SetGlobalColour(r[0] * 255, g[0] * 255, b[0] * 255, a[0] * 255);
+                    auto flt_r = cad->getData("global_r")->GetView<float>();
+                    auto flt_g = cad->getData("global_g")->GetView<float>();
+                    auto flt_b = cad->getData("global_b")->GetView<float>();
+                    auto flt_a = cad->getData("global_a")->GetView<float>();
+                    mpdc->AccessParticles(k).SetGlobalColour(
+                        flt_r[0] * 255, flt_g[0] * 255, flt_b[0] * 255, flt_a[0] * 255);
                 } else if (cad->isInVars("r")) {
                     if (cad->getData("r")->getType() == "float") {
                         colType = core::moldyn::SimpleSphericalParticles::COLDATA_FLOAT_RGBA;
@@ -299,9 +296,8 @@ bool ADIOStoMultiParticle::getDataCallback(core::Call& call) {
                         mix[k].insert(mix[k].end(), Z.begin() + pos_size * i, Z.begin() + pos_size * (i + 1));
                     }
                     if (have_radius) {
-                        std::vector<unsigned char> tmp_radius = reinterpret_cast<std::vector<unsigned char>&>(radius);
-                        mix[k].insert(mix[k].end(), tmp_radius.begin() + radius_size * i,
-                            tmp_radius.begin() + radius_size * (i + 1));
+                        mix[k].insert(mix[k].end(), radius.begin() + radius_size * i,
+                            radius.begin() + radius_size * (i + 1));
                     }
                     if (have_colors) {
                         mix[k].insert(mix[k].end(), r.begin() + col_size * i, r.begin() + col_size * (i + 1));
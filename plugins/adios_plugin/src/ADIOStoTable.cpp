@@ -70,10 +70,11 @@ bool ADIOStoTable::getData(core::Call& call) {
 
         _cols = availVars.size();
         _colinfo.resize(_cols);
-        std::vector<std::vector<float>> raw_data(_cols);
+        // float columns are read in place, others are converted once by their container
+        std::vector<containerView<float>> raw_data(_cols);
         for (int i = 0; i < availVars.size(); ++i) {
             _rows = std::max(_rows, cad->getData(availVars[i])->size());
-            raw_data[i] = cad->getData(availVars[i])->GetAsFloat();
+            raw_data[i] = cad->getData(availVars[i])->GetView<float>();
             float min = std::numeric_limits<float>::max();
             float max = std::numeric_limits<float>::min();
             for (int j = 0; j < raw_data[i].size(); ++j) {
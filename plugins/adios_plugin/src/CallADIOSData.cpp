@@ -86,5 +86,21 @@ bool CallADIOSData::isInVars(std::string var) {
     return std::find(this->availableVars.begin(), this->availableVars.end(), var) != this->availableVars.end();
 }
 
+void CallADIOSData::setSelection(
+    const std::string& varname, const std::vector<size_t>& start, const std::vector<size_t>& count) {
+    this->blockSelections.erase(varname);
+    this->selections[varname] = std::make_pair(start, count);
+}
+
+void CallADIOSData::setBlockSelection(const std::string& varname, size_t blockID) {
+    this->selections.erase(varname);
+    this->blockSelections[varname] = blockID;
+}
+
+void CallADIOSData::clearSelections() {
+    this->selections.clear();
+    this->blockSelections.clear();
+}
+
 } // end namespace adios
 } // end namespace megamol
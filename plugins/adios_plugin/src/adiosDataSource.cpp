@@ -1,8 +1,11 @@
 #include "stdafx.h"
 #include "adiosDataSource.h"
 #include <algorithm>
+#include <chrono>
 #include <numeric>
+#include <type_traits>
 #include "mmcore/cluster/mpi/MpiCall.h"
+#include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FilePathParam.h"
 #include "mmcore/utility/log/Log.h"
 #include "mmcore/utility/sys/SystemInformation.h"
@@ -17,12 +20,16 @@ namespace adios {
 adiosDataSource::adiosDataSource()
     : callRequestMpi("requestMpi", "Requests initialization of MPI and the communicator for the view.")
     , getData("getdata", "Slot to request data from this data source.")
-    , filenameSlot("filename", "The path to the ADIOS-based file to load.") {
+    , filenameSlot("filename", "The path to the ADIOS-based file to load.")
+    , randomAccessSlot("randomAccess", "Select steps directly on a persistent engine instead of stepping through the file") {
 
     this->filenameSlot.SetParameter(new core::param::FilePathParam(""));
     this->filenameSlot.SetUpdateCallback(&adiosDataSource::filenameChanged);
     this->MakeSlotAvailable(&this->filenameSlot);
 
+    this->randomAccessSlot.SetParameter(new core::param::BoolParam(true));
+    this->randomAccessSlot.SetUpdateCallback(&adiosDataSource::filenameChanged);
+    this->MakeSlotAvailable(&this->randomAccessSlot);
 
     this->getData.SetCallback("CallADIOSData", "GetData", &adiosDataSource::getDataCallback);
     this->getData.SetCallback("CallADIOSData", "GetHeader", &adiosDataSource::getHeaderCallback);
@@ -116,176 +123,100 @@ bool adiosDataSource::getDataCallback(core::Call& caller) {
         }
     }
 
-    if (dataHashChanged || inquireChanged || loadedFrameID != cad->getFrameIDtoLoad()) {
+    const bool selectionChanged = (this->loadedSelections != cad->getSelections()) ||
+                                  (this->loadedBlockSelections != cad->getBlockSelections());
+
+    if (dataHashChanged || inquireChanged || selectionChanged || loadedFrameID != cad->getFrameIDtoLoad()) {
+        // only variables read for this step and selection may be handed out
+        this->dataMap.clear();
 
         try {
-            std::string fname = std::string(T2A(this->filenameSlot.Param<core::param::FilePathParam>()->Value()));
+            const bool randomAccess = this->randomAccessSlot.Param<core::param::BoolParam>()->Value();
+            const size_t step = cad->getFrameIDtoLoad();
+            const auto t1 = std::chrono::high_resolution_clock::now();
+
+            if (randomAccess) {
+                // the engine opened with the header stays open, the step is selected per variable
+                if (!this->reader || this->dataHashChanged) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteError(
+                        "[adiosDataSource] Header has to be read before data.");
+                    return false;
+                }
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                    "[adiosDataSource] Selecting step: %d", step);
+            } else {
+                std::string fname = std::string(T2A(this->filenameSlot.Param<core::param::FilePathParam>()->Value()));
 #ifdef _WIN32
-            std::replace(fname.begin(), fname.end(), '/', '\\');
+                std::replace(fname.begin(), fname.end(), '/', '\\');
 #endif
-            if (this->reader) {
-                this->reader->Close();
-                io->RemoveAllVariables();
-            }
-            this->reader = std::make_shared<adios2::Engine>(adiosInst->AtIO("Input").Open(fname, adios2::Mode::Read));
+                if (this->reader) {
+                    this->reader->Close();
+                    io->RemoveAllVariables();
+                }
+                this->reader = std::make_shared<adios2::Engine>(adiosInst->AtIO("Input").Open(fname, adios2::Mode::Read));
 
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo(
-                "[adiosDataSource] Stepping to frame number: %d", cad->getFrameIDtoLoad());
-            if (cad->getFrameIDtoLoad() != 0) {
-                for (auto i = 0; i < cad->getFrameIDtoLoad(); i++) {
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                    "[adiosDataSource] Stepping to frame number: %d", step);
+                for (size_t i = 0; i < step; i++) {
                     reader->BeginStep();
                     reader->EndStep();
                 }
-            }
 
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] Beginning step");
-            const adios2::StepStatus status = reader->BeginStep();
-            if (status != adios2::StepStatus::OK) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError("[adiosDataSource] BeginStep returned an error.");
-                return false;
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] Beginning step");
+                const adios2::StepStatus status = reader->BeginStep();
+                if (status != adios2::StepStatus::OK) {
+                    megamol::core::utility::log::Log::DefaultLog.WriteError("[adiosDataSource] BeginStep returned an error.");
+                    return false;
+                }
             }
 
-
             auto varsToInquire = cad->getVarsToInquire();
             if (varsToInquire.empty()) {
                 megamol::core::utility::log::Log::DefaultLog.WriteError("[adiosDataSource] varsToInquire is empty.");
+                if (!randomAccess) reader->EndStep();
                 return false;
             }
 
             for (auto toInq : varsToInquire) {
-                for (auto var : variables) {
-                    if (var.first == toInq) {
-                        std::vector<size_t> shape(1);
-                        bool singleValue = true;
-                        if (var.second["SingleValue"] != std::string("true")) {
-                            // num = std::stoi(var.second["Shape"]);
-                            singleValue = false;
-                        }
-                        auto num = 1;
-                        if (var.second["Type"] == "float") {
-
-                            auto fc = std::make_shared<FloatContainer>(FloatContainer());
-                            fc->singleValue = singleValue;
-                            std::vector<float>& tmp_vec = fc->getVec();
-                            adios2::Variable<float> advar = io->InquireVariable<float>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<float>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-
-                        } else if (var.second["Type"] == "double") {
-
-                            auto fc = std::make_shared<DoubleContainer>(DoubleContainer());
-                            fc->singleValue = singleValue;
-                            std::vector<double>& tmp_vec = fc->getVec();
-
-                            adios2::Variable<double> advar = io->InquireVariable<double>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<double>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-
-                        } else if (var.second["Type"] == "int32_t") {
-
-                            auto fc = std::make_shared<Int32Container>(Int32Container());
-                            fc->singleValue = singleValue;
-                            std::vector<int32_t>& tmp_vec = fc->getVec();
-
-                            adios2::Variable<int32_t> advar = io->InquireVariable<int32_t>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<int32_t>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-                        } else if (var.second["Type"] == "int8_t" || var.second["Type"] == "char") {
-
-                            auto fc = std::make_shared<CharContainer>(CharContainer());
-                            fc->singleValue = singleValue;
-                            std::vector<char>& tmp_vec = fc->getVec();
-
-                            adios2::Variable<char> advar = io->InquireVariable<char>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<char>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-                        } else if (var.second["Type"] == "uint64_t") {
-                            auto fc = std::make_shared<UInt64Container>(UInt64Container());
-                            fc->singleValue = singleValue;
-                            std::vector<uint64_t>& tmp_vec = fc->getVec();
-
-                            adios2::Variable<uint64_t> advar =
-                                io->InquireVariable<uint64_t>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<uint64_t>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-                        } else if ((var.second["Type"] == "unsigned char")
-                            || (var.second["Type"] == "uint8_t")) {
-                            auto fc = std::make_shared<UCharContainer>(UCharContainer());
-                            fc->singleValue = singleValue;
-                            std::vector<unsigned char>& tmp_vec = fc->getVec();
-
-                            adios2::Variable<unsigned char> advar = io->InquireVariable<unsigned char>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<unsigned char>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-                        } else if (var.second["Type"] == "uint32_t") {
-                            auto fc = std::make_shared<UInt32Container>(UInt32Container());
-                            fc->singleValue = singleValue;
-                            std::vector<unsigned int>& tmp_vec = fc->getVec();
-
-                            adios2::Variable<unsigned int> advar = io->InquireVariable<unsigned int>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<unsigned int>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-                        } else if (var.second["Type"] == "string") {
-
-                            auto fc = std::make_shared<StringContainer>(StringContainer());
-                            fc->singleValue = singleValue;
-                            std::vector<std::string>& tmp_vec = fc->getVec();
-
-                            adios2::Variable<std::string> advar = io->InquireVariable<std::string>(var.first);
-                            auto info = reader->BlocksInfo(advar, cad->getFrameIDtoLoad());
-                            fc->shape = info[0].Count;
-                            std::for_each(fc->shape.begin(), fc->shape.end(), [&](decltype(num) n) { num *= n; });
-                            tmp_vec.resize(num);
-
-                            reader->Get<std::string>(advar, tmp_vec);
-                            dataMap[var.first] = std::move(fc);
-                        }
-                    }
+                auto var = this->variables.find(toInq);
+                if (var == this->variables.end()) continue;
+
+                const bool singleValue = (var->second["SingleValue"] == std::string("true"));
+                const std::string& type = var->second["Type"];
+                if (type == "float") {
+                    this->readVariable<FloatContainer>(var->first, singleValue, *cad, step, randomAccess);
+                } else if (type == "double") {
+                    this->readVariable<DoubleContainer>(var->first, singleValue, *cad, step, randomAccess);
+                } else if (type == "int32_t") {
+                    this->readVariable<Int32Container>(var->first, singleValue, *cad, step, randomAccess);
+                } else if (type == "int8_t" || type == "char") {
+                    this->readVariable<CharContainer>(var->first, singleValue, *cad, step, randomAccess);
+                } else if (type == "uint64_t") {
+                    this->readVariable<UInt64Container>(var->first, singleValue, *cad, step, randomAccess);
+                } else if ((type == "unsigned char") || (type == "uint8_t")) {
+                    this->readVariable<UCharContainer>(var->first, singleValue, *cad, step, randomAccess);
+                } else if (type == "uint32_t") {
+                    this->readVariable<UInt32Container>(var->first, singleValue, *cad, step, randomAccess);
+                } else if (type == "string") {
+                    this->readVariable<StringContainer>(var->first, singleValue, *cad, step, randomAccess);
                 }
             }
-            megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] EndStep");
-            const auto t1 = std::chrono::high_resolution_clock::now();
-            reader->EndStep();
+
+            // all reads are deferred, so the engine can fetch them in one go
+            if (randomAccess) {
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] PerformGets");
+                reader->PerformGets();
+            } else {
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] EndStep");
+                reader->EndStep();
+            }
             const auto t2 = std::chrono::high_resolution_clock::now();
             const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] Time spent for reading frame: %d ms", duration);
 
-            loadedFrameID = cad->getFrameIDtoLoad();
+            loadedFrameID = step;
+            this->loadedSelections = cad->getSelections();
+            this->loadedBlockSelections = cad->getBlockSelections();
             // here data is loaded
         } catch (std::invalid_argument& e) {
 #ifdef WITH_MPI
@@ -324,6 +255,53 @@ bool adiosDataSource::getDataCallback(core::Call& caller) {
 }
 
 
+/*
+ * adiosDataSource::readVariable
+ */
+template<class C>
+void adiosDataSource::readVariable(
+    const std::string& name, bool singleValue, const CallADIOSData& cad, size_t step, bool randomAccess) {
+    typedef typename std::remove_reference<decltype(std::declval<C&>().getVec())>::type::value_type value_type;
+
+    auto fc = std::make_shared<C>();
+    fc->singleValue = singleValue;
+    std::vector<value_type>& tmp_vec = fc->getVec();
+
+    adios2::Variable<value_type> advar = io->InquireVariable<value_type>(name);
+    if (!advar) {
+        throw std::invalid_argument("Variable " + name + " is not available.");
+    }
+    if (randomAccess) {
+        advar.SetStepSelection({step, 1});
+    }
+    // blocks are numbered per step, BlocksInfo answers the blocks of 'step' independent of the step selection
+    auto info = reader->BlocksInfo(advar, step);
+
+    auto const box = cad.getSelections().find(name);
+    auto const block = cad.getBlockSelections().find(name);
+    if (block != cad.getBlockSelections().end()) {
+        advar.SetBlockSelection(block->second);
+        fc->shape = info.at(block->second).Count;
+    } else if (box != cad.getSelections().end()) {
+        advar.SetSelection({box->second.first, box->second.second});
+        fc->shape = box->second.second;
+    } else {
+        if (!advar.Shape().empty()) {
+            // reset a selection of an earlier read on the persistent engine
+            advar.SetSelection({adios2::Dims(advar.Shape().size(), 0), advar.Shape()});
+        }
+        fc->shape = info.empty() ? advar.Shape() : info[0].Count;
+    }
+
+    size_t num = 1;
+    std::for_each(fc->shape.begin(), fc->shape.end(), [&](size_t n) { num *= n; });
+    tmp_vec.resize(num);
+
+    reader->Get<value_type>(advar, tmp_vec);
+    dataMap[name] = std::move(fc);
+}
+
+
 /*
  * adiosDataSource::filenameChanged
  */
@@ -340,8 +318,10 @@ bool adiosDataSource::getHeaderCallback(core::Call& caller) {
     CallADIOSData* cad = dynamic_cast<CallADIOSData*>(&caller);
     if (cad == nullptr) return false;
 
-    if (dataHashChanged || loadedFrameID != cad->getFrameIDtoLoad()) {
-        if (loadedFrameID != cad->getFrameIDtoLoad()) this->dataMap.clear();
+    if (dataHashChanged) {
+        // the engine stays open for all steps, data is reloaded once the file changed
+        this->dataMap.clear();
+        this->loadedFrameID = -1;
 
         try {
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] Setting Engine");
@@ -361,7 +341,12 @@ bool adiosDataSource::getHeaderCallback(core::Call& caller) {
                 this->reader->Close();
                 this->adiosInst->AtIO("Input").RemoveAllVariables();
             }
-            this->reader = std::make_shared<adios2::Engine>(adiosInst->AtIO("Input").Open(fname, adios2::Mode::Read));
+            adios2::Mode mode = adios2::Mode::Read;
+#if (ADIOS2_VERSION_MAJOR > 2) || ((ADIOS2_VERSION_MAJOR == 2) && (ADIOS2_VERSION_MINOR >= 8))
+            // newer versions only allow step selections on engines opened for random access
+            if (this->randomAccessSlot.Param<core::param::BoolParam>()->Value()) mode = adios2::Mode::ReadRandomAccess;
+#endif
+            this->reader = std::make_shared<adios2::Engine>(adiosInst->AtIO("Input").Open(fname, mode));
 
             // megamol::core::utility::log::Log::DefaultLog.WriteInfo("ADIOS2: Reading available attributes");
             // auto availAttrib =io->AvailableAttributes();
@@ -371,6 +356,7 @@ bool adiosDataSource::getHeaderCallback(core::Call& caller) {
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("[adiosDataSource] Number of variables %d", variables.size());
 
 
+            availVars.clear();
             availVars.reserve(variables.size());
 
             timesteps.clear();
@@ -427,7 +413,6 @@ bool adiosDataSource::getHeaderCallback(core::Call& caller) {
 
     cad->setDataHash(this->data_hash);
     dataHashChanged = false;
-    loadedFrameID = cad->getFrameIDtoLoad();
 
     return true;
 }
@@ -82,6 +82,19 @@ private:
     vislib::StringA getCommandLine(void);
     bool filenameChanged(core::param::ParamSlot& slot);
 
+    /**
+     * Schedules the read of a variable of the given step into a new container of 'dataMap'.
+     * The data is available after the next PerformGets() or EndStep().
+     *
+     * @param name The name of the variable.
+     * @param singleValue Whether the variable is a single value.
+     * @param cad The call holding the selections.
+     * @param step The step to read.
+     * @param randomAccess Whether the step is selected directly instead of through BeginStep().
+     */
+    template<class C>
+    void readVariable(const std::string& name, bool singleValue, const CallADIOSData& cad, size_t step, bool randomAccess);
+
     /** The slot for requesting data */
     core::CalleeSlot getData;
 
@@ -96,6 +109,9 @@ private:
     /** The file name */
     core::param::ParamSlot filenameSlot;
 
+    /** Whether steps are selected directly on a persistent engine */
+    core::param::ParamSlot randomAccessSlot;
+
     size_t frameCount = 0;
     long long int loadedFrameID = -1;
 
@@ -105,6 +121,8 @@ private:
     std::shared_ptr<adios2::Engine> reader;
     std::map<std::string, adios2::Params> variables;
     adiosDataMap dataMap;
+    adiosSelectionMap loadedSelections;
+    adiosBlockSelectionMap loadedBlockSelections;
 
     std::vector<std::size_t> timesteps;
     std::vector<std::string> availVars;
@@ -6,6 +6,7 @@
 
 #include <atomic>
 #include <fstream>
+#include <mutex>
 #include <random>
 
 #include "mmcore/param/BoolParam.h"
@@ -14,6 +15,8 @@
 
 #include "mmcore/utility/sys/ConsoleProgressBar.h"
 
+#include "mmstd_datatools/VolumeBricking.h"
+
 #include "omp.h"
 
 #include "simultaneous_sort.h"
@@ -75,6 +78,12 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
     this->volume_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
         core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_TRY_GET_DATA),
         &SpectralIntensityVolume::dummyCallback);
+    this->volume_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_RANGES),
+        &SpectralIntensityVolume::dummyCallback);
+    this->volume_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_REGION),
+        &SpectralIntensityVolume::dummyCallback);
     this->MakeSlotAvailable(&this->volume_out_slot_);
 
     this->lsu_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
@@ -95,6 +104,12 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
     this->lsu_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
         core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_TRY_GET_DATA),
         &SpectralIntensityVolume::dummyCallback);
+    this->lsu_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_RANGES),
+        &SpectralIntensityVolume::dummyCallback);
+    this->lsu_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_REGION),
+        &SpectralIntensityVolume::dummyCallback);
     this->MakeSlotAvailable(&this->lsu_out_slot_);
 
     this->absorption_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
@@ -115,6 +130,12 @@ megamol::astro::SpectralIntensityVolume::SpectralIntensityVolume()
     this->absorption_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
         core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_TRY_GET_DATA),
         &SpectralIntensityVolume::dummyCallback);
+    this->absorption_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_RANGES),
+        &SpectralIntensityVolume::dummyCallback);
+    this->absorption_out_slot_.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_REGION),
+        &SpectralIntensityVolume::dummyCallback);
     this->MakeSlotAvailable(&this->absorption_out_slot_);
 
     this->xResSlot << new core::param::IntParam(16);
@@ -282,7 +303,7 @@ bool megamol::astro::SpectralIntensityVolume::getDataCallback(core::Call& c) {
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = core::misc::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -415,7 +436,7 @@ bool megamol::astro::SpectralIntensityVolume::getLSUDataCallback(core::Call& c)
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = core::misc::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -548,7 +569,7 @@ bool megamol::astro::SpectralIntensityVolume::getAbsorptionDataCallback(core::Ca
     }
 
     // TODO set data
-    outVol->SetData(this->vol_[0].data());
+    outVol->SetData(this->vol_.data());
     metadata.Components = 1; //< TODO Maybe we want several wavelengths simultaneously
     metadata.GridType = core::misc::GridType_t::CARTESIAN;
     metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -606,12 +627,7 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
 
     auto const numCells = sx * sy * sz;
 
-    vol_.resize(omp_get_max_threads());
-#pragma omp parallel for
-    for (int init = 0; init < omp_get_max_threads(); ++init) {
-        vol_[init].resize(numCells);
-        std::fill(vol_[init].begin(), vol_[init].end(), 0.0f);
-    }
+    vol_.assign(numCells, 0.0f);
 
     auto const cycl_x = this->cyclXSlot.Param<core::param::BoolParam>()->Value();
     auto const cycl_y = this->cyclYSlot.Param<core::param::BoolParam>()->Value();
@@ -857,7 +873,6 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
     }*/
 
     std::uniform_real_distribution<> distr(0.0, 1.0);
-    std::mt19937_64 rng(42);
 
     // Implements the Bump Function from
     // https://en.wikipedia.org/wiki/Radial_basis_function
@@ -871,122 +886,130 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
     auto const cone_factor = std::tan(coneAngleDeg * M_PI / 180.0f);
     auto const cone_angle = coneAngleDeg * M_PI / 180.0;
 
-#    pragma omp parallel for
-    for (int64_t idx = 0; idx < positions.size(); ++idx) {
-        auto const pos = positions[idx];
-        /*auto x_base = pos.x;
-        auto x = voxel_idx[idx].x;
-        auto y_base = pos.y;
-        auto y = voxel_idx[idx].y;
-        auto z_base = pos.z;
-        auto z = voxel_idx[idx].z;*/
-        auto const rad = sl[idx];
+    // rays deposit into a few private bricks per thread, written back brick-wise instead of one volume per thread
+    stdplugin::datatools::VolumeBricking const bricking(sx, sy, sz, 16);
+    std::vector<std::mutex> brick_locks(bricking.Count());
+
+#    pragma omp parallel
+    {
+        std::mt19937_64 rng;
+        stdplugin::datatools::BrickCache cache(bricking, vol_.data(), brick_locks);
+
+#        pragma omp for
+        for (int64_t idx = 0; idx < positions.size(); ++idx) {
+            // seeded per particle, so the rays do not depend on the thread count or schedule
+            rng.seed(42 + idx);
+            auto const pos = positions[idx];
+            /*auto x_base = pos.x;
+            auto x = voxel_idx[idx].x;
+            auto y_base = pos.y;
+            auto y = voxel_idx[idx].y;
+            auto z_base = pos.z;
+            auto z = voxel_idx[idx].z;*/
+            auto const rad = sl[idx];
 
         
 
-        for (int iter = 0; iter < numSamples; ++iter) {
-            // https://corysimon.github.io/articles/uniformdistn-on-sphere/
-            auto phi = 2.0 * M_PI * distr(rng);
-            auto theta = std::acos(1.0 - 2.0 * distr(rng));
-            glm::vec3 dir = glm::vec3(
-                rad * std::sin(theta) * std::cos(phi), rad * std::sin(theta) * std::sin(phi), rad * std::cos(theta));
-            glm::vec3 org = pos + dir;
-            dir = glm::normalize(dir);
-            auto org_dir = dir;
-
-            for (int cone_idx = 0; cone_idx < numConeSamples; ++cone_idx) {
-                auto e = radiance[idx];
-
-                // modify dir
-                // https://stackoverflow.com/questions/38997302/create-random-unit-vector-inside-a-defined-conical-region
-                try {
-                    auto const z = distr(rng) * (1.0 - std::cos(cone_angle)) + std::cos(cone_angle);
-                    auto const phi = distr(rng) * 2.0 * M_PI;
-                    auto const y = std::sqrt(1.0 - z * z) * sin(phi);
-                    auto const x = std::sqrt(1.0 - z * z) * cos(phi);
-                    glm::vec3 rand(x, y, z);
-                    glm::vec3 base(0, 0, 1);
-                    auto const quat = core::thecam::math::quaternion<glm::quat>::from_vectors(base, org_dir);
-                    dir = core::thecam::math::rotate(rand, quat);
-                } catch (...) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteError("SpectralIntensityVolume: Math gone wrong");
-                }
-
-                //double att = 0.0;
-                float t = 0.0f;
-                float t_max = std::sqrt(rangeOSx * rangeOSx + rangeOSy * rangeOSy + rangeOSz * rangeOSz);
-                float t_step = min_vol_dis;
-                while (t <= t_max && e > 0.0) {
-                    glm::vec3 const curr = org + t * dir;
-
-                    auto ax = static_cast<int>((curr.x - vol_orgx) / vol_disx);
-                    auto ay = static_cast<int>((curr.y - vol_orgy) / vol_disy);
-                    auto az = static_cast<int>((curr.z - vol_orgz) / vol_disz);
-
-                    ax = (ax + 4 * vol_sx) % vol_sx;
-                    ay = (ay + 4 * vol_sy) % vol_sy;
-                    az = (az + 4 * vol_sz) % vol_sz;
-
-                    double aps = optical[(az * vol_sy + ay) * vol_sx + ax];
-
-                    auto vx = static_cast<int>((curr.x - minOSx) / sliceDistX);
-                    auto vy = static_cast<int>((curr.y - minOSy) / sliceDistY);
-                    auto vz = static_cast<int>((curr.z - minOSz) / sliceDistZ);
-
-                    vx = (vx + 4 * sx) % sx;
-                    vy = (vy + 4 * sy) % sy;
-                    vz = (vz + 4 * sz) % sz;
-
-                    e -= e * aps;
-                    // att += aps * (1.0 - att);
-
-                    vol_[omp_get_thread_num()][(vz * sy + vy) * sx + vx] += e;
-
-                    /*auto const cone = cone_factor * t;
-                    auto const voxel_diff_x = static_cast<int>(cone / sliceDistX);
-                    auto const voxel_diff_y = static_cast<int>(cone / sliceDistY);
-                    auto const voxel_diff_z = static_cast<int>(cone / sliceDistZ);
-                    for (int vvz = vz - voxel_diff_z; vvz < vz + voxel_diff_z; ++vvz) {
-                        for (int vvy = vy - voxel_diff_y; vvy < vy + voxel_diff_y; ++vvy) {
-                            for (int vvx = vx - voxel_diff_x; vvx < vx + voxel_diff_x; ++vvx) {
-                                float const tmp_dis_x = sliceDistX * static_cast<float>(std::abs(vvx - vx));
-                                float const tmp_dis_y = sliceDistY * static_cast<float>(std::abs(vvy - vy));
-                                float const tmp_dis_z = sliceDistZ * static_cast<float>(std::abs(vvz - vz));
-                                auto const distance =
-                                    std::sqrt(tmp_dis_x * tmp_dis_x + tmp_dis_y * tmp_dis_y + tmp_dis_z * tmp_dis_z);
-                                auto const hvx = (vvx + 2 * sx) % sx;
-                                auto const hvy = (vvy + 2 * sy) % sy;
-                                auto const hvz = (vvz + 2 * sz) % sz;
-                                vol_[omp_get_thread_num()][(hvz * sy + hvy) * sx + hvx] += e * rbf(distance, cone);
+            for (int iter = 0; iter < numSamples; ++iter) {
+                // https://corysimon.github.io/articles/uniformdistn-on-sphere/
+                auto phi = 2.0 * M_PI * distr(rng);
+                auto theta = std::acos(1.0 - 2.0 * distr(rng));
+                glm::vec3 dir = glm::vec3(
+                    rad * std::sin(theta) * std::cos(phi), rad * std::sin(theta) * std::sin(phi), rad * std::cos(theta));
+                glm::vec3 org = pos + dir;
+                dir = glm::normalize(dir);
+                auto org_dir = dir;
+
+                for (int cone_idx = 0; cone_idx < numConeSamples; ++cone_idx) {
+                    auto e = radiance[idx];
+
+                    // modify dir
+                    // https://stackoverflow.com/questions/38997302/create-random-unit-vector-inside-a-defined-conical-region
+                    try {
+                        auto const z = distr(rng) * (1.0 - std::cos(cone_angle)) + std::cos(cone_angle);
+                        auto const phi = distr(rng) * 2.0 * M_PI;
+                        auto const y = std::sqrt(1.0 - z * z) * sin(phi);
+                        auto const x = std::sqrt(1.0 - z * z) * cos(phi);
+                        glm::vec3 rand(x, y, z);
+                        glm::vec3 base(0, 0, 1);
+                        auto const quat = core::thecam::math::quaternion<glm::quat>::from_vectors(base, org_dir);
+                        dir = core::thecam::math::rotate(rand, quat);
+                    } catch (...) {
+                        megamol::core::utility::log::Log::DefaultLog.WriteError("SpectralIntensityVolume: Math gone wrong");
+                    }
+
+                    //double att = 0.0;
+                    float t = 0.0f;
+                    float t_max = std::sqrt(rangeOSx * rangeOSx + rangeOSy * rangeOSy + rangeOSz * rangeOSz);
+                    float t_step = min_vol_dis;
+                    while (t <= t_max && e > 0.0) {
+                        glm::vec3 const curr = org + t * dir;
+
+                        auto ax = static_cast<int>((curr.x - vol_orgx) / vol_disx);
+                        auto ay = static_cast<int>((curr.y - vol_orgy) / vol_disy);
+                        auto az = static_cast<int>((curr.z - vol_orgz) / vol_disz);
+
+                        ax = (ax + 4 * vol_sx) % vol_sx;
+                        ay = (ay + 4 * vol_sy) % vol_sy;
+                        az = (az + 4 * vol_sz) % vol_sz;
+
+                        double aps = optical[(az * vol_sy + ay) * vol_sx + ax];
+
+                        auto vx = static_cast<int>((curr.x - minOSx) / sliceDistX);
+                        auto vy = static_cast<int>((curr.y - minOSy) / sliceDistY);
+                        auto vz = static_cast<int>((curr.z - minOSz) / sliceDistZ);
+
+                        vx = (vx + 4 * sx) % sx;
+                        vy = (vy + 4 * sy) % sy;
+                        vz = (vz + 4 * sz) % sz;
+
+                        e -= e * aps;
+                        // att += aps * (1.0 - att);
+
+                        cache.Add(vx, vy, vz, e);
+
+                        /*auto const cone = cone_factor * t;
+                        auto const voxel_diff_x = static_cast<int>(cone / sliceDistX);
+                        auto const voxel_diff_y = static_cast<int>(cone / sliceDistY);
+                        auto const voxel_diff_z = static_cast<int>(cone / sliceDistZ);
+                        for (int vvz = vz - voxel_diff_z; vvz < vz + voxel_diff_z; ++vvz) {
+                            for (int vvy = vy - voxel_diff_y; vvy < vy + voxel_diff_y; ++vvy) {
+                                for (int vvx = vx - voxel_diff_x; vvx < vx + voxel_diff_x; ++vvx) {
+                                    float const tmp_dis_x = sliceDistX * static_cast<float>(std::abs(vvx - vx));
+                                    float const tmp_dis_y = sliceDistY * static_cast<float>(std::abs(vvy - vy));
+                                    float const tmp_dis_z = sliceDistZ * static_cast<float>(std::abs(vvz - vz));
+                                    auto const distance =
+                                        std::sqrt(tmp_dis_x * tmp_dis_x + tmp_dis_y * tmp_dis_y + tmp_dis_z * tmp_dis_z);
+                                    auto const hvx = (vvx + 2 * sx) % sx;
+                                    auto const hvy = (vvy + 2 * sy) % sy;
+                                    auto const hvz = (vvz + 2 * sz) % sz;
+                                    cache.Add(hvx, hvy, hvz, e * rbf(distance, cone));
+                                }
                             }
-                        }
-                    }*/
+                        }*/
 
-                    t += t_step;
+                        t += t_step;
+                    }
                 }
             }
-        }
 
-        ++counter;
-        if (omp_get_thread_num() == 0) {
-            cpb.Set(counter.load());
+            ++counter;
+            if (omp_get_thread_num() == 0) {
+                cpb.Set(counter.load());
+            }
         }
     }
     cpb.Stop();
 #endif
 
-    for (int i = 1; i < omp_get_max_threads(); ++i) {
-        std::transform(vol_[i].begin(), vol_[i].end(), vol_[0].begin(), vol_[0].begin(), std::plus<>());
-    }
-
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
@@ -995,14 +1018,11 @@ bool megamol::astro::SpectralIntensityVolume::createVolumeCPU(core::misc::Volume
 //#define SIV_DEBUG_OUTPUT
 #ifdef SIV_DEBUG_OUTPUT
     std::ofstream raw_file{"int.raw", std::ios::binary};
-    raw_file.write(reinterpret_cast<char const*>(vol_[0].data()), vol_[0].size() * sizeof(float));
+    raw_file.write(reinterpret_cast<char const*>(vol_.data()), vol_.size() * sizeof(float));
     raw_file.close();
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("SpectralIntensityVolume: Debug file written\n");
 #endif
 
-    // Cleanup
-    vol_.resize(1);
-
     return true;
 }
 
@@ -1064,19 +1084,18 @@ bool megamol::astro::SpectralIntensityVolume::createBremsstrahlungVolume(core::m
     numCells = vol_sx * vol_sy * vol_sz;
 
     auto const cell_vol = vol_disx * vol_disy * vol_disz;
-    vol_.resize(1);
-    vol_[0].resize(numCells);
-    std::transform(density, density + numCells, temperature, vol_[0].begin(),
+    vol_.resize(numCells);
+    std::transform(density, density + numCells, temperature, vol_.begin(),
         [cell_vol](float d, float t) { return d * d * std::sqrt(t) * cell_vol; });
 
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
@@ -1155,26 +1174,25 @@ bool megamol::astro::SpectralIntensityVolume::createAbsorptionVolume(core::misc:
     numCells = vol_sx * vol_sy * vol_sz;
 
     auto const cell_vol = vol_disx * vol_disy * vol_disz;
-    vol_.resize(1);
-    vol_[0].resize(numCells);
-    std::transform(mw, mw + numCells, temperature, vol_[0].begin(), [](float mw, float t) {
+    vol_.resize(numCells);
+    std::transform(mw, mw + numCells, temperature, vol_.begin(), [](float mw, float t) {
         return 0.018 * std::pow(static_cast<double>(t), -1.5) * 0.0134 * 0.0134 * static_cast<double>(mw) * 1.2;
     });
-    std::transform(mass, mass + numCells, vol_[0].cbegin(), vol_[0].begin(), [](float m, double o) { return o / m; });
-    auto const minmax_optical = std::minmax_element(vol_[0].cbegin(), vol_[0].cend());
+    std::transform(mass, mass + numCells, vol_.cbegin(), vol_.begin(), [](float m, double o) { return o / m; });
+    auto const minmax_optical = std::minmax_element(vol_.cbegin(), vol_.cend());
     auto const min_optical = *minmax_optical.first;
     auto const minmax_optical_rcp = 1.0 / (*minmax_optical.second - min_optical);
-    std::transform(vol_[0].cbegin(), vol_[0].cend(), vol_[0].begin(),
+    std::transform(vol_.cbegin(), vol_.cend(), vol_.begin(),
         [min_optical, minmax_optical_rcp](float o) { return (o - min_optical) * minmax_optical_rcp; });
 
-    max_dens_ = *std::max_element(vol_[0].begin(), vol_[0].end());
-    min_dens_ = *std::min_element(vol_[0].begin(), vol_[0].end());
+    max_dens_ = *std::max_element(vol_.begin(), vol_.end());
+    min_dens_ = *std::min_element(vol_.begin(), vol_.end());
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
         "SpectralIntensityVolume: Captured intensity %f -> %f", min_dens_, max_dens_);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (max_dens_ - min_dens_);
-        std::transform(vol_[0].begin(), vol_[0].end(), vol_[0].begin(),
+        std::transform(vol_.begin(), vol_.end(), vol_.begin(),
             [this, rcpValRange](float const& a) { return (a - min_dens_) * rcpValRange; });
         min_dens_ = 0.0f;
         max_dens_ = 1.0f;
@@ -111,7 +111,7 @@ private:
 
     // core::param::ParamSlot wavelength_slot_;
 
-    std::vector<std::vector<float>> vol_;
+    std::vector<float> vol_;
 
     float max_dens_ = 0.0f;
     float min_dens_ = std::numeric_limits<float>::max();
@@ -33,6 +33,10 @@ megamol::astro::VolumetricGlobalMinMax::VolumetricGlobalMinMax(void) : Module(),
             megamol::core::misc::VolumetricDataCall::FunctionName(megamol::core::misc::VolumetricDataCall::IDX_STOP_ASYNC), &VolumetricGlobalMinMax::onUnsupportedCallback);
     this->slotVolumetricDataOut.SetCallback(megamol::core::misc::VolumetricDataCall::ClassName(),
             megamol::core::misc::VolumetricDataCall::FunctionName(megamol::core::misc::VolumetricDataCall::IDX_TRY_GET_DATA), &VolumetricGlobalMinMax::onUnsupportedCallback);
+    this->slotVolumetricDataOut.SetCallback(megamol::core::misc::VolumetricDataCall::ClassName(),
+            megamol::core::misc::VolumetricDataCall::FunctionName(megamol::core::misc::VolumetricDataCall::IDX_GET_RANGES), &VolumetricGlobalMinMax::onGetRanges);
+    this->slotVolumetricDataOut.SetCallback(megamol::core::misc::VolumetricDataCall::ClassName(),
+            megamol::core::misc::VolumetricDataCall::FunctionName(megamol::core::misc::VolumetricDataCall::IDX_GET_REGION), &VolumetricGlobalMinMax::onGetRegion);
     this->MakeSlotAvailable(&this->slotVolumetricDataOut);
 }
 
@@ -67,6 +71,14 @@ bool megamol::astro::VolumetricGlobalMinMax::onGetMetadata(megamol::core::Call &
     return pipeVolumetricDataCall(call, megamol::core::misc::VolumetricDataCall::IDX_GET_METADATA);
 }
 
+bool megamol::astro::VolumetricGlobalMinMax::onGetRanges(megamol::core::Call &call) {
+    return pipeVolumetricDataCall(call, megamol::core::misc::VolumetricDataCall::IDX_GET_RANGES);
+}
+
+bool megamol::astro::VolumetricGlobalMinMax::onGetRegion(megamol::core::Call &call) {
+    return pipeVolumetricDataCall(call, megamol::core::misc::VolumetricDataCall::IDX_GET_REGION);
+}
+
 bool megamol::astro::VolumetricGlobalMinMax::onUnsupportedCallback(megamol::core::Call &call) {
     return false;
 }
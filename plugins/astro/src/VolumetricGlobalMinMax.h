@@ -60,6 +60,10 @@ namespace astro {
 
         bool onGetMetadata(core::Call& call);
 
+        bool onGetRanges(core::Call& call);
+
+        bool onGetRegion(core::Call& call);
+
         bool onUnsupportedCallback(core::Call& call);
 
         bool pipeVolumetricDataCall(core::Call& call, unsigned int funcIdx);
@@ -0,0 +1,492 @@
+#include "stdafx.h"
+#include "BarnesHutTSNE.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+
+#include <nanoflann.hpp>
+#include "omp.h"
+
+using namespace megamol::infovis;
+
+
+namespace {
+
+/** Row major input points exposed to nanoflann */
+struct RowMajorPoints {
+    double const* data;
+    size_t rows;
+    size_t cols;
+
+    inline size_t kdtree_get_point_count() const {
+        return rows;
+    }
+
+    inline double kdtree_get_pt(size_t idx, size_t dim) const {
+        return data[idx * cols + dim];
+    }
+
+    template <class BBOX> bool kdtree_get_bbox(BBOX&) const {
+        return false;
+    }
+};
+
+typedef nanoflann::KDTreeSingleIndexAdaptor<nanoflann::L2_Adaptor<double, RowMajorPoints>, RowMajorPoints, -1, size_t>
+    InputTree;
+
+constexpr int stopLyingIter = 250;
+constexpr int momSwitchIter = 250;
+constexpr double earlyExaggeration = 12.0;
+constexpr double initialMomentum = 0.5;
+constexpr double finalMomentum = 0.8;
+constexpr double learningRate = 200.0;
+
+/** Tree nodes with at most this many points are not split further */
+constexpr size_t leafCapacity = 4;
+
+/** Guards against endless splitting of coincident points */
+constexpr int maxDepth = 48;
+
+inline double sign(double x) {
+    return (x == 0.0) ? 0.0 : ((x < 0.0) ? -1.0 : 1.0);
+}
+
+} // namespace
+
+
+BarnesHutTSNE::BarnesHutTSNE(int dims, double perplexity, double theta, std::atomic<bool> const* abort)
+        : dims(std::max(dims, 1)), perplexity(perplexity), theta(theta), abort(abort), rows(0), iter(0) {}
+
+
+bool BarnesHutTSNE::Initialize(float const* data, size_t rows, size_t cols, unsigned int seed) {
+    auto const aborted = [this]() { return (this->abort != nullptr) && this->abort->load(); };
+    auto const d = static_cast<size_t>(this->dims);
+    this->rows = rows;
+    this->iter = 0;
+    if (rows < 2 || cols < 1 || static_cast<double>(rows - 1) < 3.0 * this->perplexity) {
+        return false;
+    }
+    auto const k = std::max<size_t>(1, static_cast<size_t>(3.0 * this->perplexity));
+
+    // zero mean, scaled to a maximum absolute value of one
+    std::vector<double> x(data, data + rows * cols);
+    std::vector<double> mean(cols, 0.0);
+#pragma omp parallel
+    {
+        std::vector<double> local(cols, 0.0);
+#pragma omp for
+        for (int64_t i = 0; i < static_cast<int64_t>(rows); ++i) {
+            for (size_t c = 0; c < cols; ++c) local[c] += x[i * cols + c];
+        }
+#pragma omp critical
+        for (size_t c = 0; c < cols; ++c) mean[c] += local[c];
+    }
+    double maxAbs = 0.0;
+#pragma omp parallel for reduction(max : maxAbs)
+    for (int64_t i = 0; i < static_cast<int64_t>(rows); ++i) {
+        for (size_t c = 0; c < cols; ++c) {
+            x[i * cols + c] -= mean[c] / static_cast<double>(rows);
+            maxAbs = std::max(maxAbs, std::abs(x[i * cols + c]));
+        }
+    }
+    if (maxAbs > 0.0) {
+#pragma omp parallel for
+        for (int64_t i = 0; i < static_cast<int64_t>(rows * cols); ++i) x[i] /= maxAbs;
+    }
+
+    // conditional distributions over the k nearest neighbours
+    std::vector<uint32_t> nnIdx(rows * k);
+    std::vector<double> nnVal(rows * k);
+    RowMajorPoints const points{x.data(), rows, cols};
+    InputTree tree(static_cast<int>(cols), points, nanoflann::KDTreeSingleIndexAdaptorParams(10));
+    tree.buildIndex();
+#pragma omp parallel
+    {
+        std::vector<size_t> idx(k + 1);
+        std::vector<double> dist(k + 1);
+#pragma omp for schedule(dynamic, 256)
+        for (int64_t i = 0; i < static_cast<int64_t>(rows); ++i) {
+            if (aborted()) continue;
+            nanoflann::KNNResultSet<double> result(k + 1);
+            result.init(idx.data(), dist.data());
+            tree.findNeighbors(result, x.data() + i * cols, nanoflann::SearchParams());
+            size_t n = 0;
+            for (size_t m = 0; m < result.size() && n < k; ++m) {
+                if (idx[m] == static_cast<size_t>(i)) continue;
+                nnIdx[i * k + n] = static_cast<uint32_t>(idx[m]);
+                nnVal[i * k + n] = dist[m];
+                ++n;
+            }
+            this->gaussianRow(nnVal.data() + i * k, n);
+        }
+    }
+    if (aborted()) return false;
+    x.clear();
+    x.shrink_to_fit();
+
+    // symmetrize, P = (P + P^T) / 2N
+    std::vector<size_t> rowPtr(rows + 1, 0);
+    for (size_t e = 0; e < rows * k; ++e) ++rowPtr[nnIdx[e] + 1];
+    for (size_t i = 0; i < rows; ++i) rowPtr[i + 1] += rowPtr[i] + k;
+    std::vector<uint32_t> col(rowPtr[rows]);
+    std::vector<float> val(rowPtr[rows]);
+    std::vector<size_t> cursor(rows);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(rows); ++i) {
+        std::copy_n(nnIdx.begin() + i * k, k, col.begin() + rowPtr[i]);
+        std::copy_n(nnVal.begin() + i * k, k, val.begin() + rowPtr[i]);
+        cursor[i] = rowPtr[i] + k;
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t m = 0; m < k; ++m) {
+            auto const j = nnIdx[i * k + m];
+            col[cursor[j]] = static_cast<uint32_t>(i);
+            val[cursor[j]++] = static_cast<float>(nnVal[i * k + m]);
+        }
+    }
+    nnIdx.clear();
+    nnIdx.shrink_to_fit();
+    nnVal.clear();
+    nnVal.shrink_to_fit();
+
+    // merge p_ij and p_ji
+    auto const norm = 1.0f / static_cast<float>(2 * rows);
+    std::vector<size_t> merged(rows + 1, 0);
+#pragma omp parallel
+    {
+        std::vector<std::pair<uint32_t, float>> entries;
+#pragma omp for schedule(dynamic, 1024)
+        for (int64_t i = 0; i < static_cast<int64_t>(rows); ++i) {
+            entries.clear();
+            for (size_t e = rowPtr[i]; e < rowPtr[i + 1]; ++e) entries.emplace_back(col[e], val[e]);
+            std::sort(entries.begin(), entries.end(),
+                [](std::pair<uint32_t, float> const& l, std::pair<uint32_t, float> const& r) {
+                    return l.first < r.first;
+                });
+            size_t out = rowPtr[i];
+            for (size_t e = 0; e < entries.size(); ++e) {
+                if (e > 0 && entries[e].first == entries[e - 1].first) {
+                    val[out - 1] += entries[e].second * norm;
+                } else {
+                    col[out] = entries[e].first;
+                    val[out++] = entries[e].second * norm;
+                }
+            }
+            merged[i + 1] = out - rowPtr[i];
+        }
+    }
+    for (size_t i = 0; i < rows; ++i) merged[i + 1] += merged[i];
+    this->pRowPtr = merged;
+    this->pCol.resize(merged[rows]);
+    this->pVal.resize(merged[rows]);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(rows); ++i) {
+        auto const cnt = merged[i + 1] - merged[i];
+        std::copy_n(col.begin() + rowPtr[i], cnt, this->pCol.begin() + merged[i]);
+        std::copy_n(val.begin() + rowPtr[i], cnt, this->pVal.begin() + merged[i]);
+    }
+
+    // random initial embedding
+    std::mt19937 gen(seed);
+    std::normal_distribution<double> dist(0.0, 1e-4);
+    this->y.resize(rows * d);
+    for (auto& v : this->y) v = dist(gen);
+    this->uy.assign(rows * d, 0.0);
+    this->gains.assign(rows * d, 1.0);
+    this->posF.resize(rows * d);
+    this->negF.resize(rows * d);
+    this->sumQ.resize(rows);
+
+    return true;
+}
+
+
+void BarnesHutTSNE::Step(void) {
+    auto const n = this->rows;
+    auto const d = static_cast<size_t>(this->dims);
+    auto const exaggeration = (this->iter < stopLyingIter) ? earlyExaggeration : 1.0;
+    auto const momentum = (this->iter < momSwitchIter) ? initialMomentum : finalMomentum;
+
+    this->buildTree();
+
+#pragma omp parallel
+    {
+        std::vector<int64_t> stack;
+#pragma omp for schedule(dynamic, 256)
+        for (int64_t i = 0; i < static_cast<int64_t>(n); ++i) {
+            auto* pos = this->posF.data() + i * d;
+            auto* neg = this->negF.data() + i * d;
+            std::fill_n(pos, d, 0.0);
+            std::fill_n(neg, d, 0.0);
+            this->repulsion(i, neg, this->sumQ[i], stack);
+
+            auto const* yi = this->y.data() + i * d;
+            for (size_t e = this->pRowPtr[i]; e < this->pRowPtr[i + 1]; ++e) {
+                auto const* yj = this->y.data() + this->pCol[e] * d;
+                double d2 = 1.0;
+                for (size_t c = 0; c < d; ++c) d2 += (yi[c] - yj[c]) * (yi[c] - yj[c]);
+                auto const mult = this->pVal[e] / d2;
+                for (size_t c = 0; c < d; ++c) pos[c] += mult * (yi[c] - yj[c]);
+            }
+        }
+    }
+
+    // summed in a fixed order, so the result does not depend on the thread count
+    auto const totalQ = std::accumulate(this->sumQ.begin(), this->sumQ.end(), 0.0);
+
+#pragma omp parallel for
+    for (int64_t e = 0; e < static_cast<int64_t>(n * d); ++e) {
+        auto const grad = exaggeration * this->posF[e] - this->negF[e] / totalQ;
+        this->gains[e] = (sign(grad) != sign(this->uy[e])) ? (this->gains[e] + 0.2) : (this->gains[e] * 0.8);
+        this->gains[e] = std::max(this->gains[e], 0.01);
+        this->uy[e] = momentum * this->uy[e] - learningRate * this->gains[e] * grad;
+        this->y[e] += this->uy[e];
+    }
+
+    std::vector<double> mean(d, 0.0);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < d; ++c) mean[c] += this->y[i * d + c];
+    }
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(n); ++i) {
+        for (size_t c = 0; c < d; ++c) this->y[i * d + c] -= mean[c] / static_cast<double>(n);
+    }
+
+    ++this->iter;
+}
+
+
+void BarnesHutTSNE::gaussianRow(double* vals, size_t cnt) const {
+    std::vector<double> dist(vals, vals + cnt);
+    auto const target = std::log(this->perplexity);
+    double beta = 1.0;
+    double minBeta = -DBL_MAX;
+    double maxBeta = DBL_MAX;
+    double sum = DBL_MIN;
+    for (int it = 0; it < 200; ++it) {
+        sum = DBL_MIN;
+        double h = 0.0;
+        for (size_t m = 0; m < cnt; ++m) {
+            vals[m] = std::exp(-beta * dist[m]);
+            sum += vals[m];
+            h += beta * dist[m] * vals[m];
+        }
+        h = h / sum + std::log(sum);
+        auto const diff = h - target;
+        if (std::abs(diff) < 1e-5) break;
+        if (diff > 0.0) {
+            minBeta = beta;
+            beta = (maxBeta == DBL_MAX) ? (beta * 2.0) : ((beta + maxBeta) / 2.0);
+        } else {
+            maxBeta = beta;
+            beta = (minBeta == -DBL_MAX) ? (beta / 2.0) : ((beta + minBeta) / 2.0);
+        }
+    }
+    for (size_t m = 0; m < cnt; ++m) vals[m] /= sum;
+}
+
+
+void BarnesHutTSNE::buildTree(void) {
+    auto const n = this->rows;
+    auto const d = static_cast<size_t>(this->dims);
+
+    // bounding box, lower corner followed by upper corner
+    std::vector<double> box(2 * d);
+    std::fill_n(box.begin(), d, std::numeric_limits<double>::max());
+    std::fill_n(box.begin() + d, d, std::numeric_limits<double>::lowest());
+#pragma omp parallel
+    {
+        std::vector<double> local(box);
+#pragma omp for
+        for (int64_t i = 0; i < static_cast<int64_t>(n); ++i) {
+            for (size_t c = 0; c < d; ++c) {
+                local[c] = std::min(local[c], this->y[i * d + c]);
+                local[d + c] = std::max(local[d + c], this->y[i * d + c]);
+            }
+        }
+#pragma omp critical
+        for (size_t c = 0; c < d; ++c) {
+            box[c] = std::min(box[c], local[c]);
+            box[d + c] = std::max(box[d + c], local[d + c]);
+        }
+    }
+    double width = 0.0;
+    for (size_t c = 0; c < d; ++c) width = std::max(width, box[d + c] - box[c]);
+
+    this->perm.resize(n);
+    std::iota(this->perm.begin(), this->perm.end(), 0);
+    this->nodes.clear();
+    this->nodes.push_back(TreeNode{0, n, -1, 0, width});
+
+    // split the top levels sequentially until there are enough independent subtrees
+    struct Pending {
+        size_t node;
+        int depth;
+        std::vector<double> box;
+    };
+    std::vector<Pending> frontier{{0, 0, box}};
+    std::vector<Pending> next;
+    std::vector<double> childBoxes;
+    size_t const target = 4 * static_cast<size_t>(omp_get_max_threads());
+    while (!frontier.empty() && frontier.size() < target) {
+        next.clear();
+        for (auto const& f : frontier) {
+            this->splitNode(this->nodes, f.node, f.box.data(), f.depth, childBoxes);
+            auto const& node = this->nodes[f.node];
+            for (int ch = 0; ch < node.numChildren; ++ch) {
+                next.push_back(Pending{static_cast<size_t>(node.firstChild + ch), f.depth + 1,
+                    std::vector<double>(childBoxes.begin() + ch * 2 * d, childBoxes.begin() + (ch + 1) * 2 * d)});
+            }
+        }
+        frontier.swap(next);
+    }
+
+    std::vector<std::vector<TreeNode>> subtrees(frontier.size());
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t f = 0; f < static_cast<int64_t>(frontier.size()); ++f) {
+        subtrees[f].push_back(this->nodes[frontier[f].node]);
+        this->splitRecursive(subtrees[f], 0, frontier[f].box.data(), frontier[f].depth);
+    }
+
+    // append the subtrees, their root replaces the frontier node
+    for (size_t f = 0; f < frontier.size(); ++f) {
+        auto const offset = static_cast<int64_t>(this->nodes.size());
+        auto const relocate = [offset](int64_t idx) { return (idx < 0) ? idx : offset + idx - 1; };
+        this->nodes[frontier[f].node] = subtrees[f][0];
+        this->nodes[frontier[f].node].firstChild = relocate(subtrees[f][0].firstChild);
+        for (size_t s = 1; s < subtrees[f].size(); ++s) {
+            this->nodes.push_back(subtrees[f][s]);
+            this->nodes.back().firstChild = relocate(subtrees[f][s].firstChild);
+        }
+    }
+
+    this->invPerm.resize(n);
+#pragma omp parallel for
+    for (int64_t p = 0; p < static_cast<int64_t>(n); ++p) this->invPerm[this->perm[p]] = p;
+
+    // centres of mass, children are always stored behind their parent
+    this->com.assign(this->nodes.size() * d, 0.0);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t idx = 0; idx < static_cast<int64_t>(this->nodes.size()); ++idx) {
+        auto const& node = this->nodes[idx];
+        if (node.firstChild >= 0) continue;
+        for (size_t p = node.begin; p < node.end; ++p) {
+            for (size_t c = 0; c < d; ++c) this->com[idx * d + c] += this->y[this->perm[p] * d + c];
+        }
+        for (size_t c = 0; c < d; ++c) this->com[idx * d + c] /= static_cast<double>(node.end - node.begin);
+    }
+    for (auto idx = static_cast<int64_t>(this->nodes.size()) - 1; idx >= 0; --idx) {
+        auto const& node = this->nodes[idx];
+        if (node.firstChild < 0) continue;
+        for (int ch = 0; ch < node.numChildren; ++ch) {
+            auto const& child = this->nodes[node.firstChild + ch];
+            auto const weight = static_cast<double>(child.end - child.begin);
+            for (size_t c = 0; c < d; ++c) this->com[idx * d + c] += weight * this->com[(node.firstChild + ch) * d + c];
+        }
+        for (size_t c = 0; c < d; ++c) this->com[idx * d + c] /= static_cast<double>(node.end - node.begin);
+    }
+}
+
+
+void BarnesHutTSNE::splitNode(
+    std::vector<TreeNode>& nodes, size_t node, double const* box, int depth, std::vector<double>& childBoxes) {
+    auto const d = static_cast<size_t>(this->dims);
+    auto const begin = nodes[node].begin;
+    auto const end = nodes[node].end;
+    childBoxes.clear();
+    if (end - begin <= leafCapacity || depth >= maxDepth) return;
+
+    // partition along one dimension after the other, empty cells are dropped
+    std::vector<std::pair<size_t, size_t>> ranges{{begin, end}};
+    std::vector<std::pair<size_t, size_t>> split;
+    for (size_t c = 0; c < d; ++c) {
+        auto const mid = 0.5 * (box[c] + box[d + c]);
+        split.clear();
+        for (auto const& r : ranges) {
+            auto const it = std::partition(this->perm.begin() + r.first, this->perm.begin() + r.second,
+                [this, c, d, mid](size_t p) { return this->y[p * d + c] < mid; });
+            auto const s = static_cast<size_t>(it - this->perm.begin());
+            if (s > r.first) split.emplace_back(r.first, s);
+            if (s < r.second) split.emplace_back(s, r.second);
+        }
+        ranges.swap(split);
+    }
+
+    nodes[node].firstChild = static_cast<int64_t>(nodes.size());
+    nodes[node].numChildren = static_cast<int>(ranges.size());
+    childBoxes.resize(ranges.size() * 2 * d);
+    for (size_t ch = 0; ch < ranges.size(); ++ch) {
+        auto* cb = childBoxes.data() + ch * 2 * d;
+        auto const p = this->perm[ranges[ch].first];
+        double width = 0.0;
+        for (size_t c = 0; c < d; ++c) {
+            auto const mid = 0.5 * (box[c] + box[d + c]);
+            auto const lower = this->y[p * d + c] < mid;
+            cb[c] = lower ? box[c] : mid;
+            cb[d + c] = lower ? mid : box[d + c];
+            width = std::max(width, cb[d + c] - cb[c]);
+        }
+        nodes.push_back(TreeNode{ranges[ch].first, ranges[ch].second, -1, 0, width});
+    }
+}
+
+
+void BarnesHutTSNE::splitRecursive(std::vector<TreeNode>& nodes, size_t node, double const* box, int depth) {
+    std::vector<double> childBoxes;
+    this->splitNode(nodes, node, box, depth, childBoxes);
+    auto const first = nodes[node].firstChild;
+    auto const cnt = nodes[node].numChildren;
+    for (int ch = 0; ch < cnt; ++ch) {
+        this->splitRecursive(nodes, first + ch, childBoxes.data() + ch * 2 * this->dims, depth + 1);
+    }
+}
+
+
+void BarnesHutTSNE::repulsion(size_t i, double* neg, double& sumQ, std::vector<int64_t>& stack) const {
+    auto const d = static_cast<size_t>(this->dims);
+    auto const* yi = this->y.data() + i * d;
+    auto const pos = this->invPerm[i];
+    auto const theta2 = this->theta * this->theta;
+    sumQ = 0.0;
+    stack.clear();
+    stack.push_back(0);
+    while (!stack.empty()) {
+        auto const idx = stack.back();
+        stack.pop_back();
+        auto const& node = this->nodes[idx];
+
+        // a cell far enough away acts as one point at its centre of mass, unless it contains i itself
+        if (pos < node.begin || pos >= node.end) {
+            auto const* cm = this->com.data() + idx * d;
+            double d2 = 0.0;
+            for (size_t c = 0; c < d; ++c) d2 += (yi[c] - cm[c]) * (yi[c] - cm[c]);
+            if (node.width * node.width < theta2 * d2) {
+                auto const q = 1.0 / (1.0 + d2);
+                auto const mult = static_cast<double>(node.end - node.begin) * q;
+                sumQ += mult;
+                for (size_t c = 0; c < d; ++c) neg[c] += mult * q * (yi[c] - cm[c]);
+                continue;
+            }
+        }
+
+        if (node.firstChild < 0) {
+            for (size_t p = node.begin; p < node.end; ++p) {
+                auto const j = this->perm[p];
+                if (j == i) continue;
+                auto const* yj = this->y.data() + j * d;
+                double d2 = 0.0;
+                for (size_t c = 0; c < d; ++c) d2 += (yi[c] - yj[c]) * (yi[c] - yj[c]);
+                auto const q = 1.0 / (1.0 + d2);
+                sumQ += q;
+                for (size_t c = 0; c < d; ++c) neg[c] += q * q * (yi[c] - yj[c]);
+            }
+        } else {
+            for (int ch = 0; ch < node.numChildren; ++ch) stack.push_back(node.firstChild + ch);
+        }
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef MEGAMOL_INFOVIS_BARNESHUTTSNE_H_INCLUDED
+#define MEGAMOL_INFOVIS_BARNESHUTTSNE_H_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+namespace megamol {
+namespace infovis {
+
+    /**
+     * Barnes-Hut t-SNE (van der Maaten, JMLR 2014) that is advanced one gradient step at a time, so the caller can
+     * observe intermediate embeddings. The input similarities, the space partitioning tree and both force terms are
+     * computed in parallel. Uses the same optimization schedule as the reference implementation (early
+     * exaggeration and momentum switch after 250 iterations, learning rate 200, adaptive gains).
+     */
+    class BarnesHutTSNE {
+    public:
+        /**
+         * Ctor.
+         *
+         * @param dims       Number of dimensions of the embedding.
+         * @param perplexity Perplexity of the conditional input distributions.
+         * @param theta      Barnes-Hut accuracy, 0 computes the exact repulsive forces.
+         * @param abort      Optional flag that makes Initialize() return early.
+         */
+        BarnesHutTSNE(int dims, double perplexity, double theta, std::atomic<bool> const* abort = nullptr);
+
+        /**
+         * Computes the sparse input similarities and a random initial embedding.
+         *
+         * @param data Row major input, rows * cols values.
+         * @param rows Number of points.
+         * @param cols Number of input dimensions.
+         * @param seed Seed of the initial embedding.
+         *
+         * @return False if the perplexity is too large for the number of points or if aborted.
+         */
+        bool Initialize(float const* data, size_t rows, size_t cols, unsigned int seed);
+
+        /** Performs one gradient descent step */
+        void Step(void);
+
+        /** Answer the number of steps performed so far */
+        int Iteration(void) const {
+            return this->iter;
+        }
+
+        /** Answer the number of points */
+        size_t Rows(void) const {
+            return this->rows;
+        }
+
+        /** Answer the number of dimensions of the embedding */
+        int Dims(void) const {
+            return this->dims;
+        }
+
+        /** Answer the current embedding, Rows() * Dims() values in row major order */
+        std::vector<double> const& Embedding(void) const {
+            return this->y;
+        }
+
+    private:
+        /** Node of the space partitioning tree over the embedding */
+        struct TreeNode {
+            /** Range of the node's points in perm */
+            size_t begin, end;
+
+            /** Index of the first of numChildren contiguous children, -1 for a leaf */
+            int64_t firstChild;
+
+            int numChildren;
+
+            /** Largest edge length of the node's cell */
+            double width;
+        };
+
+        /** Turns squared distances into a conditional distribution of the given perplexity, in place */
+        void gaussianRow(double* vals, size_t cnt) const;
+
+        /** Builds the tree over the current embedding, including the centres of mass */
+        void buildTree(void);
+
+        /** Splits a node one level, writing the children's cells to childBoxes */
+        void splitNode(std::vector<TreeNode>& nodes, size_t node, double const* box, int depth,
+            std::vector<double>& childBoxes);
+
+        /** Recursively splits a node and all its descendants */
+        void splitRecursive(std::vector<TreeNode>& nodes, size_t node, double const* box, int depth);
+
+        /** Accumulates the unnormalized repulsive force on point i */
+        void repulsion(size_t i, double* neg, double& sumQ, std::vector<int64_t>& stack) const;
+
+        int dims;
+
+        double perplexity;
+
+        double theta;
+
+        std::atomic<bool> const* abort;
+
+        size_t rows;
+
+        int iter;
+
+        /** Symmetric input similarities in CSR layout */
+        std::vector<size_t> pRowPtr;
+        std::vector<uint32_t> pCol;
+        std::vector<float> pVal;
+
+        /** Embedding, its velocity and the adaptive gains */
+        std::vector<double> y, uy, gains;
+
+        /** Per point attractive and repulsive forces and normalization terms */
+        std::vector<double> posF, negF, sumQ;
+
+        /** Tree over the embedding, the points sorted by node and the centres of mass */
+        std::vector<TreeNode> nodes;
+        std::vector<size_t> perm, invPerm;
+        std::vector<double> com;
+    };
+
+} // namespace infovis
+} // namespace megamol
+
+#endif // MEGAMOL_INFOVIS_BARNESHUTTSNE_H_INCLUDED
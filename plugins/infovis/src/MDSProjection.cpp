@@ -2,11 +2,17 @@
 #include "PCAProjection.h"
 
 #include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 #include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
 #include <Eigen/SVD>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
 #include <set>
 #include <sstream>
 #include "MDSProjection.h"
@@ -16,12 +22,19 @@ using namespace megamol;
 using namespace megamol::infovis;
 using namespace Eigen;
 
+enum MDSMode { CLASSIC_MDS = 0, LANDMARK_MDS };
+
+enum LandmarkSelection { RANDOM_LANDMARKS = 0, MAXMIN_LANDMARKS };
+
 
 MDSProjection::MDSProjection(void)
         : megamol::core::Module()
         , dataOutSlot("dataOut", "Ouput")
         , dataInSlot("dataIn", "Input")
         , reduceToNSlot("nComponents", "Number of components (dimensions) to keep")
+        , modeSlot("mode", "Classic MDS of the full distance matrix, or landmark MDS for large row counts")
+        , landmarkCountSlot("landmarks", "Number of landmarks for landmark MDS")
+        , landmarkSelectionSlot("landmarkSelection", "How the landmarks for landmark MDS are chosen")
         , datahash(0)
         , dataInHash(0)
         , columnInfos() {
@@ -37,6 +50,21 @@ MDSProjection::MDSProjection(void)
 
     reduceToNSlot << new ::megamol::core::param::IntParam(2);
     this->MakeSlotAvailable(&reduceToNSlot);
+
+    auto modes = new ::megamol::core::param::EnumParam(CLASSIC_MDS);
+    modes->SetTypePair(CLASSIC_MDS, "Classic");
+    modes->SetTypePair(LANDMARK_MDS, "Landmark");
+    modeSlot << modes;
+    this->MakeSlotAvailable(&modeSlot);
+
+    landmarkCountSlot << new ::megamol::core::param::IntParam(1000, 3);
+    this->MakeSlotAvailable(&landmarkCountSlot);
+
+    auto selections = new ::megamol::core::param::EnumParam(MAXMIN_LANDMARKS);
+    selections->SetTypePair(RANDOM_LANDMARKS, "Random");
+    selections->SetTypePair(MAXMIN_LANDMARKS, "MaxMin");
+    landmarkSelectionSlot << selections;
+    this->MakeSlotAvailable(&landmarkSelectionSlot);
 }
 
 MDSProjection::~MDSProjection(void) {
@@ -119,7 +147,8 @@ bool MDSProjection::getHashCallback(core::Call& c) {
 bool megamol::infovis::MDSProjection::dataProjection(megamol::stdplugin::datatools::table::TableDataCall* inCall) {
     // Test if inData has changed and if slots have changed
     if (this->dataInHash == inCall->DataHash()) {
-        if (!reduceToNSlot.IsDirty()) {
+        if (!reduceToNSlot.IsDirty() && !modeSlot.IsDirty() && !landmarkCountSlot.IsDirty() &&
+            !landmarkSelectionSlot.IsDirty()) {
             return true; // Nothing to do
         }
     }
@@ -136,19 +165,32 @@ bool megamol::infovis::MDSProjection::dataProjection(megamol::stdplugin::datatoo
         return false;
     }
 
-    // Load data in a Matrix
-    Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
-    for (int row = 0; row < rowsCount; row++) {
-        for (int col = 0; col < columnCount; col++) {
-            inDataMat(row, col) = inData[row * columnCount + col];
+    Eigen::MatrixXd result;
+    if (this->modeSlot.Param<core::param::EnumParam>()->Value() == LANDMARK_MDS) {
+        int const landmarkCount = this->landmarkCountSlot.Param<core::param::IntParam>()->Value();
+        if (std::min<size_t>(landmarkCount, rowsCount) <= static_cast<size_t>(outputDimCount)) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                _T("%hs: Landmark MDS needs more landmarks (and rows) than output dimensions\n"), ClassName());
+            return false;
+        }
+        // the row major table is one point per column, so no copy is needed
+        Eigen::Map<const Eigen::MatrixXf> const points(inData, columnCount, rowsCount);
+        result = landmarkMds(points, outputDimCount, landmarkCount,
+            this->landmarkSelectionSlot.Param<core::param::EnumParam>()->Value() == MAXMIN_LANDMARKS);
+    } else {
+        // Load data in a Matrix
+        Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
+        for (int row = 0; row < rowsCount; row++) {
+            for (int col = 0; col < columnCount; col++) {
+                inDataMat(row, col) = inData[row * columnCount + col];
+            }
         }
+        // generate dissimilarity Matrix( squared euclidean Distance matrix)
+        Eigen::MatrixXd delta2 = euclideanDissimilarityMatrix(inDataMat).array().pow(2);
+        // compute MDS
+        result = classicMds(delta2, outputDimCount);
     }
 
-    // generate dissimilarity Matrix( squared euclidean Distance matrix)
-    Eigen::MatrixXd delta2 = euclideanDissimilarityMatrix(inDataMat).array().pow(2);
-    // compute MDS
-    Eigen::MatrixXd result = classicMds(delta2, outputDimCount);
-
     // generate new columns
     this->columnInfos.clear();
     this->columnInfos.resize(outputDimCount);
@@ -173,6 +215,9 @@ bool megamol::infovis::MDSProjection::dataProjection(megamol::stdplugin::datatoo
     this->dataInHash = inCall->DataHash();
     this->datahash++;
     reduceToNSlot.ResetDirty();
+    modeSlot.ResetDirty();
+    landmarkCountSlot.ResetDirty();
+    landmarkSelectionSlot.ResetDirty();
 
     return true;
 }
@@ -231,6 +276,110 @@ Eigen::MatrixXd megamol::infovis::MDSProjection::classicMds(
     return result;
 }
 
+Eigen::MatrixXd megamol::infovis::MDSProjection::landmarkMds(
+    Eigen::Ref<const Eigen::MatrixXf> const& points, int outputDimension, int landmarkCount, bool maxMinLandmarks) {
+    // one point per column, so the distance computations walk contiguous memory
+    int64_t const nPoints = points.cols();
+    int const k = static_cast<int>(std::min<int64_t>(landmarkCount, nPoints));
+    if (nPoints == 0 || k <= outputDimension) {
+        return Eigen::MatrixXd();
+    }
+
+    std::mt19937 rng(1337); // same seed as the iterative variants
+    std::vector<int64_t> landmarks;
+    landmarks.reserve(k);
+    if (maxMinLandmarks) {
+        // farthest point selection: each new landmark maximizes the distance to the ones chosen so far
+        std::vector<double> minDist(nPoints, std::numeric_limits<double>::max());
+        int64_t next = std::uniform_int_distribution<int64_t>(0, nPoints - 1)(rng);
+        while (static_cast<int>(landmarks.size()) < k) {
+            landmarks.push_back(next);
+            Eigen::VectorXd const landmark = points.col(next).cast<double>();
+            double bestDist = -1.0;
+            int64_t best = 0;
+#pragma omp parallel
+            {
+                double threadBestDist = -1.0;
+                int64_t threadBest = 0;
+#pragma omp for nowait
+                for (int64_t i = 0; i < nPoints; ++i) {
+                    minDist[i] = std::min(minDist[i], (points.col(i).cast<double>() - landmark).squaredNorm());
+                    if (minDist[i] > threadBestDist) {
+                        threadBestDist = minDist[i];
+                        threadBest = i;
+                    }
+                }
+#pragma omp critical
+                if (threadBestDist > bestDist || (threadBestDist == bestDist && threadBest < best)) {
+                    bestDist = threadBestDist;
+                    best = threadBest;
+                }
+            }
+            next = best;
+        }
+    } else {
+        // partial Fisher-Yates shuffle
+        std::vector<int64_t> indices(nPoints);
+        std::iota(indices.begin(), indices.end(), 0);
+        for (int i = 0; i < k; ++i) {
+            std::swap(indices[i], indices[std::uniform_int_distribution<int64_t>(i, nPoints - 1)(rng)]);
+        }
+        landmarks.assign(indices.begin(), indices.begin() + k);
+    }
+    std::sort(landmarks.begin(), landmarks.end());
+
+    Eigen::MatrixXd landmarkPoints(points.rows(), k);
+    for (int i = 0; i < k; ++i) {
+        landmarkPoints.col(i) = points.col(landmarks[i]).cast<double>();
+    }
+
+    // classic MDS of the landmarks
+    Eigen::MatrixXd delta2(k, k);
+#pragma omp parallel for
+    for (int64_t i = 0; i < k; ++i) {
+        for (int j = 0; j < k; ++j) {
+            delta2(i, j) = (landmarkPoints.col(i) - landmarkPoints.col(j)).squaredNorm();
+        }
+    }
+    Eigen::VectorXd const meanDelta2 = delta2.rowwise().mean();
+    // double centering
+    Eigen::MatrixXd B = delta2;
+    B.colwise() -= meanDelta2;
+    B.rowwise() -= meanDelta2.transpose();
+    B.array() += meanDelta2.mean();
+    B *= -0.5;
+    SelfAdjointEigenSolver<MatrixXd> eigSolver(B);
+
+    // eigenvalues come in ascending order, keep the largest ones; the pseudo inverse transpose of the landmark
+    // embedding maps squared distances to the landmarks onto coordinates
+    Eigen::MatrixXd pseudoInverse = Eigen::MatrixXd::Zero(outputDimension, k);
+    for (int i = 0; i < outputDimension; ++i) {
+        int const col = k - 1 - i;
+        double const eigVal = eigSolver.eigenvalues()(col);
+        if (eigVal > 0.0) {
+            pseudoInverse.row(i) = eigSolver.eigenvectors().col(col).transpose() / std::sqrt(eigVal);
+        }
+    }
+
+    // distance based triangulation of all points, landmarks included
+    Eigen::MatrixXd result(nPoints, outputDimension);
+#pragma omp parallel
+    {
+        Eigen::VectorXd point(points.rows());
+        Eigen::VectorXd pointDelta2(k);
+#pragma omp for
+        for (int64_t i = 0; i < nPoints; ++i) {
+            point = points.col(i).cast<double>();
+            for (int j = 0; j < k; ++j) {
+                pointDelta2(j) = (point - landmarkPoints.col(j)).squaredNorm();
+            }
+            result.row(i) = (-0.5 * pseudoInverse * (pointDelta2 - meanDelta2)).transpose();
+        }
+    }
+
+    return result;
+}
+
 Eigen::MatrixXd megamol::infovis::MDSProjection::bMatrix(
     Eigen::MatrixXd X, Eigen::MatrixXd W, Eigen::MatrixXd dissimilarityMatrix) {
     assert(X.rows() == W.rows());
@@ -43,6 +43,21 @@ namespace infovis {
 
         static Eigen::MatrixXd classicMds(Eigen::MatrixXd squaredDissimilarityMatrix, int outputDimension);
 
+        /**
+         * Landmark MDS (de Silva and Tenenbaum): classic MDS of k landmarks, all other points are placed by distance
+         * based triangulation against the landmarks. Needs O(k^2 + n) memory and O(n k d + k^3) time.
+         *
+         * @param points          The data, one point per column, e.g. a row major table mapped in place.
+         * @param outputDimension The number of output dimensions.
+         * @param landmarkCount   The number of landmarks, clamped to the number of points.
+         * @param maxMinLandmarks Pick landmarks by MaxMin (farthest point) selection instead of at random.
+         *
+         * @return The embedding, one point per row, or an empty matrix if there are no points or the (clamped)
+         *         landmark count does not exceed the output dimension.
+         */
+        static Eigen::MatrixXd landmarkMds(Eigen::Ref<const Eigen::MatrixXf> const& points, int outputDimension,
+            int landmarkCount, bool maxMinLandmarks);
+
         static Eigen::MatrixXd smacofMds(Eigen::MatrixXd squaredDissimilarityMatrix, int outputDimension = 2,
             int countSteps = 100, Eigen::MatrixXd weightsMatrix = Eigen::MatrixXd::Ones(1, 1), double tolerance = 1e-3);
 
@@ -80,6 +95,15 @@ namespace infovis {
         /** Parameter slot for target number of dimensions */
         ::megamol::core::param::ParamSlot reduceToNSlot;
 
+        /** Parameter slot for the MDS variant */
+        ::megamol::core::param::ParamSlot modeSlot;
+
+        /** Parameter slot for the number of landmarks */
+        ::megamol::core::param::ParamSlot landmarkCountSlot;
+
+        /** Parameter slot for the landmark selection */
+        ::megamol::core::param::ParamSlot landmarkSelectionSlot;
+
         /** ID of the current frame */
         // int frameID; //TODO: unknown
 
@@ -2,11 +2,17 @@
 #include "PCAProjection.h"
 
 #include "mmcore/param/BoolParam.h"
+#include "mmcore/param/EnumParam.h"
 #include "mmcore/param/IntParam.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 #include <Eigen/Dense>
+#include <Eigen/Eigenvalues>
+#include <Eigen/QR>
 #include <Eigen/SVD>
+#include <algorithm>
+#include <limits>
+#include <random>
 #include <sstream>
 
 
@@ -14,6 +20,8 @@ using namespace megamol;
 using namespace megamol::infovis;
 using namespace Eigen;
 
+enum PCAMethod { EXACT_PCA = 0, RANDOMIZED_PCA };
+
 
 PCAProjection::PCAProjection(void)
         : megamol::core::Module()
@@ -22,6 +30,11 @@ PCAProjection::PCAProjection(void)
         , reduceToNSlot("nComponents", "Number of components (dimensions) to keep")
         , scaleSlot("scale", "Set to scale each column to unit variance")
         , centerSlot("center", "Set to shift the mean centroid to the origin")
+        , methodSlot("method", "Exact eigendecomposition of the covariance matrix, or randomized PCA for large tables")
+        , oversamplingSlot("oversampling", "Randomized PCA: additional directions tracked beyond nComponents")
+        , powerIterationsSlot("powerIterations", "Randomized PCA: number of subspace iterations after the range finder pass")
+        , blockRowsSlot("blockRows", "Randomized PCA: number of rows processed at once per thread")
+        , warmStartSlot("warmStart", "Randomized PCA: start from the basis of the previous frame")
         , datahash(0)
         , dataInHash(0)
         , columnInfos() {
@@ -43,6 +56,24 @@ PCAProjection::PCAProjection(void)
 
     scaleSlot << new ::megamol::core::param::BoolParam(false);
     this->MakeSlotAvailable(&scaleSlot);
+
+    auto methods = new ::megamol::core::param::EnumParam(EXACT_PCA);
+    methods->SetTypePair(EXACT_PCA, "Exact");
+    methods->SetTypePair(RANDOMIZED_PCA, "Randomized");
+    methodSlot << methods;
+    this->MakeSlotAvailable(&methodSlot);
+
+    oversamplingSlot << new ::megamol::core::param::IntParam(10, 0);
+    this->MakeSlotAvailable(&oversamplingSlot);
+
+    powerIterationsSlot << new ::megamol::core::param::IntParam(2, 0);
+    this->MakeSlotAvailable(&powerIterationsSlot);
+
+    blockRowsSlot << new ::megamol::core::param::IntParam(4096, 1);
+    this->MakeSlotAvailable(&blockRowsSlot);
+
+    warmStartSlot << new ::megamol::core::param::BoolParam(true);
+    this->MakeSlotAvailable(&warmStartSlot);
 }
 
 
@@ -128,7 +159,9 @@ bool megamol::infovis::PCAProjection::project(megamol::stdplugin::datatools::tab
 
     // check if inData has changed and if Slots have changed
     if (this->dataInHash == inCall->DataHash()) {
-        if (!reduceToNSlot.IsDirty() && !scaleSlot.IsDirty() && !centerSlot.IsDirty()) {
+        if (!reduceToNSlot.IsDirty() && !scaleSlot.IsDirty() && !centerSlot.IsDirty() && !methodSlot.IsDirty() &&
+            !oversamplingSlot.IsDirty() && !powerIterationsSlot.IsDirty() && !blockRowsSlot.IsDirty() &&
+            !warmStartSlot.IsDirty()) {
             return true; // Nothing to do
         }
     }
@@ -150,6 +183,23 @@ bool megamol::infovis::PCAProjection::project(megamol::stdplugin::datatools::tab
         return false;
     }
 
+    if (this->methodSlot.Param<core::param::EnumParam>()->Value() == RANDOMIZED_PCA) {
+        this->projectRandomized(inData, rowsCount, columnCount, outputDimCount, center, scale);
+
+        this->dataInHash = inCall->DataHash();
+        this->datahash++;
+        reduceToNSlot.ResetDirty();
+        scaleSlot.ResetDirty();
+        centerSlot.ResetDirty();
+        methodSlot.ResetDirty();
+        oversamplingSlot.ResetDirty();
+        powerIterationsSlot.ResetDirty();
+        blockRowsSlot.ResetDirty();
+        warmStartSlot.ResetDirty();
+        return true;
+    }
+    this->basis.resize(0, 0);
+
     // Load data in a Matrix
     Eigen::MatrixXd inDataMat = Eigen::MatrixXd(rowsCount, columnCount);
     for (int row = 0; row < rowsCount; row++) {
@@ -263,6 +313,145 @@ bool megamol::infovis::PCAProjection::project(megamol::stdplugin::datatools::tab
     reduceToNSlot.ResetDirty();
     scaleSlot.ResetDirty();
     centerSlot.ResetDirty();
+    methodSlot.ResetDirty();
+    oversamplingSlot.ResetDirty();
+    powerIterationsSlot.ResetDirty();
+    blockRowsSlot.ResetDirty();
+    warmStartSlot.ResetDirty();
 
     return true;
 }
+
+void megamol::infovis::PCAProjection::projectRandomized(float const* inData, size_t rowsCount, size_t columnCount,
+    unsigned int outputDimCount, bool center, bool scale) {
+    // without warm start the previous basis is dropped, so a random one is used
+    if (!this->warmStartSlot.Param<core::param::BoolParam>()->Value()) {
+        this->basis.resize(0, 0);
+    }
+    Eigen::MatrixXd const range = randomizedPca(inData, rowsCount, columnCount, outputDimCount, center, scale,
+        this->oversamplingSlot.Param<core::param::IntParam>()->Value(),
+        this->powerIterationsSlot.Param<core::param::IntParam>()->Value(),
+        this->blockRowsSlot.Param<core::param::IntParam>()->Value(), this->basis, this->data);
+
+    this->columnInfos.clear();
+    this->columnInfos.resize(outputDimCount);
+    for (unsigned int indexX = 0; indexX < outputDimCount; indexX++) {
+        columnInfos[indexX]
+            .SetName("PC" + std::to_string(indexX))
+            .SetType(megamol::stdplugin::datatools::table::TableDataCall::ColumnType::QUANTITATIVE)
+            .SetMinimumValue(range(0, indexX))
+            .SetMaximumValue(range(1, indexX));
+    }
+}
+
+Eigen::MatrixXd megamol::infovis::PCAProjection::randomizedPca(float const* inData, size_t rowsCount,
+    size_t columnCount, unsigned int outputDimCount, bool center, bool scale, int oversampling, int powerIterations,
+    int blockRows, Eigen::MatrixXd& basis, std::vector<float>& outData) {
+    using RowBlock = Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor> const>;
+
+    auto const d = static_cast<int>(columnCount);
+    auto const l = std::min(d, static_cast<int>(outputDimCount) + oversampling);
+    auto const blockCount = static_cast<int64_t>((rowsCount + blockRows - 1) / blockRows);
+
+    // runs op(first row, block) for all row blocks in parallel, with one accumulator per thread summed up afterwards
+    auto forBlocks = [&](Eigen::MatrixXd& sum, auto const& op) {
+        Eigen::MatrixXd const zero = Eigen::MatrixXd::Zero(sum.rows(), sum.cols());
+        sum = zero;
+#pragma omp parallel
+        {
+            Eigen::MatrixXd local = zero;
+#pragma omp for schedule(dynamic)
+            for (int64_t b = 0; b < blockCount; ++b) {
+                auto const first = b * blockRows;
+                auto const rows = std::min<int64_t>(blockRows, rowsCount - first);
+                op(first, RowBlock(inData + first * columnCount, rows, d), local);
+            }
+#pragma omp critical
+            sum += local;
+        }
+    };
+
+    // column statistics, the transformed data is (x - shift) * invScale
+    Eigen::MatrixXd colSum(1, d);
+    forBlocks(colSum, [](int64_t, RowBlock const& block, Eigen::MatrixXd& acc) {
+        acc += block.cast<double>().colwise().sum();
+    });
+    Eigen::RowVectorXd const shift =
+        (center && rowsCount > 0) ? Eigen::RowVectorXd(colSum / static_cast<double>(rowsCount))
+                                  : Eigen::RowVectorXd::Zero(d);
+    Eigen::RowVectorXd invScale = Eigen::RowVectorXd::Ones(d);
+    if (scale) {
+        Eigen::MatrixXd sqSum(1, d);
+        forBlocks(sqSum, [&shift](int64_t, RowBlock const& block, Eigen::MatrixXd& acc) {
+            acc += (block.cast<double>().rowwise() - shift).array().square().matrix().colwise().sum();
+        });
+        invScale = (sqSum.array() / static_cast<double>(rowsCount - 1)).sqrt().inverse().matrix();
+    }
+    auto transform = [&shift, &invScale](RowBlock const& block) -> Eigen::MatrixXd {
+        return ((block.cast<double>().rowwise() - shift).array().rowwise() * invScale.array()).matrix();
+    };
+
+    // start basis: random, or the given one, e.g. the previous frame's basis for time-varying tables
+    Eigen::MatrixXd Q;
+    if (basis.rows() == d && basis.cols() == l) {
+        Q = basis;
+    } else {
+        // local generator, so the projection is reproducible without reseeding the process-wide rand()
+        std::mt19937 rng(1337);
+        std::uniform_real_distribution<double> dist(-1.0, 1.0);
+        const Eigen::MatrixXd omega = Eigen::MatrixXd::NullaryExpr(d, l, [&]() { return dist(rng); });
+        Q = Eigen::HouseholderQR<Eigen::MatrixXd>(omega).householderQ() * Eigen::MatrixXd::Identity(d, l);
+    }
+
+    // subspace iteration with the implicit covariance A^T A; the first pass is the range finder (A^T A Omega) and
+    // always runs, so neither the random nor the warm start basis is ever used without looking at the data
+    Eigen::MatrixXd Z(d, l);
+    for (int it = 0; it <= powerIterations; ++it) {
+        forBlocks(Z, [&transform, &Q](int64_t, RowBlock const& block, Eigen::MatrixXd& acc) {
+            Eigen::MatrixXd const A = transform(block);
+            acc.noalias() += A.transpose() * (A * Q);
+        });
+        Q = Eigen::HouseholderQR<Eigen::MatrixXd>(Z).householderQ() * Eigen::MatrixXd::Identity(d, l);
+    }
+    basis = Q;
+
+    // Rayleigh-Ritz: principal directions within the subspace
+    Eigen::MatrixXd M(l, l);
+    forBlocks(M, [&transform, &Q](int64_t, RowBlock const& block, Eigen::MatrixXd& acc) {
+        Eigen::MatrixXd const AQ = transform(block) * Q;
+        acc.noalias() += AQ.transpose() * AQ;
+    });
+    SelfAdjointEigenSolver<MatrixXd> eigSolver(M);
+    Eigen::MatrixXd eigVecBasis(d, outputDimCount);
+    for (unsigned int i = 0; i < outputDimCount; ++i) {
+        // eigenvalues are sorted ascending
+        eigVecBasis.col(i) = Q * eigSolver.eigenvectors().col(l - 1 - i);
+    }
+
+    // project
+    outData.resize(rowsCount * outputDimCount);
+    Eigen::MatrixXd range(2, outputDimCount);
+    range.row(0).setConstant(std::numeric_limits<double>::max());
+    range.row(1).setConstant(std::numeric_limits<double>::lowest());
+#pragma omp parallel
+    {
+        Eigen::MatrixXd localRange = range;
+#pragma omp for schedule(dynamic)
+        for (int64_t b = 0; b < blockCount; ++b) {
+            auto const first = b * blockRows;
+            auto const rows = std::min<int64_t>(blockRows, rowsCount - first);
+            Eigen::MatrixXd const result = transform(RowBlock(inData + first * columnCount, rows, d)) * eigVecBasis;
+            Eigen::Map<Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>>(
+                outData.data() + first * outputDimCount, rows, outputDimCount) = result.cast<float>();
+            localRange.row(0) = localRange.row(0).cwiseMin(result.colwise().minCoeff());
+            localRange.row(1) = localRange.row(1).cwiseMax(result.colwise().maxCoeff());
+        }
+#pragma omp critical
+        {
+            range.row(0) = range.row(0).cwiseMin(localRange.row(0));
+            range.row(1) = range.row(1).cwiseMax(localRange.row(1));
+        }
+    }
+
+    return range;
+}
@@ -1,6 +1,7 @@
 #ifndef MEGAMOL_PRINCIPAL_COMPONENT_ANALYSIS_H_INCLUDED
 #define MEGAMOL_PRINCIPAL_COMPONENT_ANALYSIS_H_INCLUDED
 
+#include <Eigen/Dense>
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
@@ -36,6 +37,30 @@ namespace infovis {
         /** Destructor */
         virtual ~PCAProjection(void);
 
+        /**
+         * Randomized PCA by subspace iteration on the implicit covariance matrix. The table is streamed in row blocks,
+         * neither a copy of the table nor the full covariance matrix are formed, only nComponents plus oversampling
+         * directions are tracked.
+         *
+         * @param inData          The table, row major.
+         * @param rowsCount       The number of rows.
+         * @param columnCount     The number of columns.
+         * @param outputDimCount  The number of principal components, at most columnCount.
+         * @param center          Subtract the column means first.
+         * @param scale           Divide by the column standard deviations first.
+         * @param oversampling    The number of directions tracked in addition to the components.
+         * @param powerIterations The number of subspace iterations after the range finder pass.
+         * @param blockRows       The number of rows per block.
+         * @param basis           The start basis if it has one column per tracked direction, a random one is used
+         *                        otherwise. Receives the basis of this run.
+         * @param outData         Receives the projected table, row major.
+         *
+         * @return The value range of the components, minima in the first row and maxima in the second.
+         */
+        static Eigen::MatrixXd randomizedPca(float const* inData, size_t rowsCount, size_t columnCount,
+            unsigned int outputDimCount, bool center, bool scale, int oversampling, int powerIterations, int blockRows,
+            Eigen::MatrixXd& basis, std::vector<float>& outData);
+
     protected:
         /** Lazy initialization of the module */
         virtual bool create(void);
@@ -51,6 +76,10 @@ namespace infovis {
 
         bool project(megamol::stdplugin::datatools::table::TableDataCall* inCall);
 
+        /** Randomized PCA with the parameters of this module, see randomizedPca */
+        void projectRandomized(float const* inData, size_t rowsCount, size_t columnCount, unsigned int outputDimCount,
+            bool center, bool scale);
+
         /** Data output slot */
         CalleeSlot dataOutSlot;
 
@@ -61,6 +90,11 @@ namespace infovis {
         ::megamol::core::param::ParamSlot reduceToNSlot;
         ::megamol::core::param::ParamSlot scaleSlot;
         ::megamol::core::param::ParamSlot centerSlot;
+        ::megamol::core::param::ParamSlot methodSlot;
+        ::megamol::core::param::ParamSlot oversamplingSlot;
+        ::megamol::core::param::ParamSlot powerIterationsSlot;
+        ::megamol::core::param::ParamSlot blockRowsSlot;
+        ::megamol::core::param::ParamSlot warmStartSlot;
 
         /** ID of the current frame */
         // int frameID; //TODO: unknown
@@ -69,6 +103,9 @@ namespace infovis {
         size_t datahash;
         size_t dataInHash;
 
+        /** Orthonormal basis of the last randomized run, start of the next one if warm start is enabled */
+        Eigen::MatrixXd basis;
+
         /** Vector storing information about columns */
         std::vector<megamol::stdplugin::datatools::table::TableDataCall::ColumnInfo> columnInfos;
 
@@ -6,8 +6,11 @@
 #include "mmcore/param/IntParam.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
-#include <sstream>
-#include <tsne.h>
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "BarnesHutTSNE.h"
 
 using namespace megamol;
 using namespace megamol::infovis;
@@ -22,11 +25,13 @@ TSNEProjection::TSNEProjection(void)
               "theta = 0 corresponds to standard, slow t-SNE, while theta = 1 corresponds to very crude approximations")
         , maxIterSlot("maxIter", "Set the maximum Iterations")
         , perplexitySlot("perplexity", "Set the Perplexity")
+        , publishIntervalSlot("publishInterval", "Publish the intermediate embedding every n iterations")
         , datahash(0)
         , dataInHash(0)
-        , columnInfos() {
-
-    TSNE* tsne = new TSNE(); // lib load test
+        , columnInfos()
+        , abortWorker(false)
+        , publishInterval(50)
+        , hasPublished(false) {
 
     this->dataInSlot.SetCompatibleCall<megamol::stdplugin::datatools::table::TableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataInSlot);
@@ -51,6 +56,9 @@ TSNEProjection::TSNEProjection(void)
 
     thetaSlot << new ::megamol::core::param::FloatParam(0.5);
     this->MakeSlotAvailable(&thetaSlot);
+
+    publishIntervalSlot << new ::megamol::core::param::IntParam(50, 1);
+    this->MakeSlotAvailable(&publishIntervalSlot);
 }
 
 TSNEProjection::~TSNEProjection(void) {
@@ -61,7 +69,9 @@ bool TSNEProjection::create(void) {
     return true;
 }
 
-void TSNEProjection::release(void) {}
+void TSNEProjection::release(void) {
+    this->stopWorker();
+}
 
 bool TSNEProjection::getDataCallback(core::Call& c) {
     try {
@@ -82,6 +92,7 @@ bool TSNEProjection::getDataCallback(core::Call& c) {
         bool finished = project(inCall);
         if (finished == false)
             return false;
+        this->fetchPublished();
 
         outCall->SetFrameCount(inCall->GetFrameCount());
         outCall->SetDataHash(this->datahash);
@@ -118,6 +129,7 @@ bool TSNEProjection::getHashCallback(core::Call& c) {
         inCall->SetFrameID(outCall->GetFrameID());
         if (!(*inCall)(1))
             return false;
+        this->fetchPublished();
 
         outCall->SetFrameCount(inCall->GetFrameCount());
         outCall->SetDataHash(this->datahash);
@@ -131,6 +143,9 @@ bool TSNEProjection::getHashCallback(core::Call& c) {
 }
 
 bool megamol::infovis::TSNEProjection::project(megamol::stdplugin::datatools::table::TableDataCall* inCall) {
+    // the running worker picks up a new interval without restarting
+    this->publishInterval = this->publishIntervalSlot.Param<core::param::IntParam>()->Value();
+
     // check if inData has changed and if Slots have changed
     if (this->dataInHash == inCall->DataHash()) {
         if (!reduceToNSlot.IsDirty() && !maxIterSlot.IsDirty() && !thetaSlot.IsDirty() && !perplexitySlot.IsDirty() &&
@@ -157,85 +172,97 @@ bool megamol::infovis::TSNEProjection::project(megamol::stdplugin::datatools::ta
         return false;
     }
 
-    // Load data in a double Array
-    double* inputData = (double*) malloc(columnCount * rowsCount * sizeof(double));
-    for (int col = 0; col < columnCount; col++) {
-        for (int row = 0; row < rowsCount; row++) {
-            inputData[row * columnCount + col] = inData[row * columnCount + col];
-            // inputData[col*rowsCount + row] = inData[row * columnCount + col];
-        }
-    }
-
+    // the worker owns a copy, the input call may drop its data at any time
+    this->stopWorker();
+    std::vector<float> input(inData, inData + rowsCount * columnCount);
+    unsigned int seed = (randomSeed < 0) ? std::random_device()() : static_cast<unsigned int>(randomSeed);
+    this->abortWorker = false;
+    this->worker = std::thread(&TSNEProjection::embed, this, std::move(input), rowsCount, columnCount,
+        outputColumnCount, perplexity, theta, seed, maxIter);
 
-    TSNE* tsne = new TSNE();
+    // the old embedding does not match the new input anymore
+    this->columnInfos.clear();
+    this->data.clear();
 
-    double* result = (double*) malloc(rowsCount * outputColumnCount * sizeof(double));
-    // void run(double* X, int N, int D, double* Y, int no_dims, double perplexity, double theta, int rand_seed,
-    // bool skip_random_init, int max_iter = 1000, int stop_lying_iter = 250, int mom_switch_iter = 250);
-    tsne->run(
-        inputData, rowsCount, columnCount, result, outputColumnCount, perplexity, theta, randomSeed, false, maxIter);
+    this->dataInHash = inCall->DataHash();
+    this->datahash++;
+    reduceToNSlot.ResetDirty();
+    maxIterSlot.ResetDirty();
+    randomSeedSlot.ResetDirty();
+    thetaSlot.ResetDirty();
+    perplexitySlot.ResetDirty();
 
-    double* maximas = new double[outputColumnCount];
-    double* minimas = new double[outputColumnCount];
+    return true;
+}
 
-    for (int col = 0; col < outputColumnCount; col++) {
-        maximas[col] = result[col];
-        minimas[col] = result[col];
+void TSNEProjection::embed(std::vector<float> input, size_t rowsCount, size_t columnCount,
+    unsigned int outputColumnCount, double perplexity, double theta, unsigned int randomSeed, int maxIter) {
+    BarnesHutTSNE tsne(outputColumnCount, perplexity, theta, &this->abortWorker);
+    if (!tsne.Initialize(input.data(), rowsCount, columnCount, randomSeed)) {
+        if (!this->abortWorker) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                _T("%hs: Perplexity %f is too large for %u rows\n"), ClassName(), perplexity,
+                static_cast<unsigned int>(rowsCount));
+        }
+        return;
     }
-
-    for (int col = 0; col < outputColumnCount; col++) {
-        for (int row = 1; row < rowsCount; row++) {
-            double value = result[row * outputColumnCount + col];
-            if (maximas[col] < value)
-                maximas[col] = value;
-            if (minimas[col] > value)
-                minimas[col] = value;
+    input.clear();
+    input.shrink_to_fit();
+
+    this->publish(tsne.Embedding(), outputColumnCount);
+    while (tsne.Iteration() < maxIter && !this->abortWorker) {
+        tsne.Step();
+        if (tsne.Iteration() % this->publishInterval == 0 || tsne.Iteration() == maxIter) {
+            this->publish(tsne.Embedding(), outputColumnCount);
         }
     }
+}
 
+void TSNEProjection::publish(std::vector<double> const& embedding, unsigned int outputColumnCount) {
+    std::vector<float> result(embedding.begin(), embedding.end());
+    std::vector<float> minimas(outputColumnCount, std::numeric_limits<float>::max());
+    std::vector<float> maximas(outputColumnCount, std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < result.size(); ++i) {
+        auto const col = i % outputColumnCount;
+        minimas[col] = std::min(minimas[col], result[i]);
+        maximas[col] = std::max(maximas[col], result[i]);
+    }
 
-    // std::stringstream debug;
-    // debug << std::endl << result << std::endl;
-    // megamol::core::utility::log::Log::DefaultLog.WriteInfo(debug.str().c_str());
+    std::lock_guard<std::mutex> lock(this->publishedMutex);
+    this->publishedData.swap(result);
+    this->publishedMin.swap(minimas);
+    this->publishedMax.swap(maximas);
+    this->hasPublished = true;
+}
+
+bool TSNEProjection::fetchPublished(void) {
+    std::lock_guard<std::mutex> lock(this->publishedMutex);
+    if (!this->hasPublished) return false;
 
     // generate new columns
     this->columnInfos.clear();
-    this->columnInfos.resize(outputColumnCount);
+    this->columnInfos.resize(this->publishedMin.size());
 
-    for (int indexX = 0; indexX < outputColumnCount; indexX++) {
+    for (int indexX = 0; indexX < this->columnInfos.size(); indexX++) {
         this->columnInfos[indexX]
             .SetName("TSNE" + std::to_string(indexX))
             .SetType(megamol::stdplugin::datatools::table::TableDataCall::ColumnType::QUANTITATIVE)
-            .SetMinimumValue(minimas[indexX])
-            .SetMaximumValue(maximas[indexX]);
-    }
-
-    // Result Matrix into Output
-    this->data.clear();
-    this->data.reserve(rowsCount * outputColumnCount);
-
-
-    for (size_t row = 0; row < rowsCount; row++) {
-        for (size_t col = 0; col < outputColumnCount; col++)
-            this->data.push_back(result[row * outputColumnCount + col]);
+            .SetMinimumValue(this->publishedMin[indexX])
+            .SetMaximumValue(this->publishedMax[indexX]);
     }
 
-
-    this->dataInHash = inCall->DataHash();
+    this->data.swap(this->publishedData);
+    this->hasPublished = false;
     this->datahash++;
-    reduceToNSlot.ResetDirty();
-    maxIterSlot.ResetDirty();
-    randomSeedSlot.ResetDirty();
-    thetaSlot.ResetDirty();
-    perplexitySlot.ResetDirty();
-
-    free(result);
-    result = NULL;
-    free(inputData);
-    inputData = NULL;
-    delete (tsne);
-    delete[] maximas;
-    delete[] minimas;
 
     return true;
 }
+
+void TSNEProjection::stopWorker(void) {
+    this->abortWorker = true;
+    if (this->worker.joinable()) {
+        this->worker.join();
+    }
+    std::lock_guard<std::mutex> lock(this->publishedMutex);
+    this->hasPublished = false;
+}
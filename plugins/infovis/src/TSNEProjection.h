@@ -1,6 +1,10 @@
 #ifndef MEGAMOL_TSNE_MODULE_H_INCLUDED
 #define MEGAMOL_TSNE_MODULE_H_INCLUDED
 
+#include <atomic>
+#include <mutex>
+#include <thread>
+
 #include "mmcore/CalleeSlot.h"
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
@@ -52,6 +56,19 @@ namespace infovis {
 
         bool project(megamol::stdplugin::datatools::table::TableDataCall* inCall);
 
+        /** Runs the embedding, publishing every publishIntervalSlot iterations */
+        void embed(std::vector<float> input, size_t rowsCount, size_t columnCount, unsigned int outputColumnCount,
+            double perplexity, double theta, unsigned int randomSeed, int maxIter);
+
+        /** Hands the current embedding of the worker over to the main thread */
+        void publish(std::vector<double> const& embedding, unsigned int outputColumnCount);
+
+        /** Moves a published embedding to the output, answers true if there was one */
+        bool fetchPublished(void);
+
+        /** Aborts and joins the worker */
+        void stopWorker(void);
+
         /** Data output slot */
         CalleeSlot dataOutSlot;
 
@@ -64,6 +81,7 @@ namespace infovis {
         ::megamol::core::param::ParamSlot thetaSlot;
         ::megamol::core::param::ParamSlot perplexitySlot;
         ::megamol::core::param::ParamSlot maxIterSlot;
+        ::megamol::core::param::ParamSlot publishIntervalSlot;
 
         /** ID of the current frame */
         // int frameID; //TODO: unknown
@@ -77,6 +95,23 @@ namespace infovis {
 
         /** Vector stroing the actual float data */
         std::vector<float> data;
+
+        /** Background thread computing the embedding */
+        std::thread worker;
+
+        /** Tells the worker to stop */
+        std::atomic<bool> abortWorker;
+
+        /** Current value of publishIntervalSlot for the worker */
+        std::atomic<int> publishInterval;
+
+        /** Guards the published embedding */
+        std::mutex publishedMutex;
+
+        /** Embedding published by the worker and not yet fetched */
+        std::vector<float> publishedData;
+        std::vector<float> publishedMin, publishedMax;
+        bool hasPublished;
     };
 
 } // namespace infovis
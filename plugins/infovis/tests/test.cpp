@@ -0,0 +1,55 @@
+/*
+ * test.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include <cstring>
+#include <iostream>
+
+/* include test implementations */
+#include "testbarneshuttsne.h"
+#include "testhelper.h"
+#include "testlandmarkmds.h"
+#include "testrandomizedpca.h"
+
+
+/* type for test functions */
+typedef void (*InfovisTestFunction)(void);
+
+/* type for test manager structure */
+typedef struct _InfovisTest_t {
+    const char *testName; // the tests name. Used as command line argument to select this test.
+    InfovisTestFunction testFunc; // the function called when this test is selected.
+    const char *testDesc; // the description of this test. Used for the online help.
+} InfovisTest;
+
+
+/* all available tests, run in this order if none is selected */
+InfovisTest tests[] = {
+    {"LandmarkMds", ::TestLandmarkMds, "Tests landmark MDS on points with a planar embedding."},
+    {"RandomizedPca", ::TestRandomizedPca, "Tests the randomized PCA against an exact SVD."},
+    {"BarnesHutTSNE", ::TestBarnesHutTSNE, "Tests that Barnes-Hut t-SNE keeps separated clusters apart."},
+    {nullptr, nullptr, nullptr}
+};
+
+
+/*
+ * main
+ */
+int main(int argc, char **argv) {
+    for (InfovisTest *t = tests; t->testName != nullptr; ++t) {
+        bool isSelected = (argc < 2);
+        for (int i = 1; i < argc; ++i) {
+            isSelected = isSelected || (::strcmp(argv[i], t->testName) == 0);
+        }
+        if (isSelected) {
+            std::cout << std::endl << t->testName << ": " << t->testDesc << std::endl;
+            t->testFunc();
+        }
+    }
+
+    ::OutputAssertTestSummary();
+    return 0;
+}
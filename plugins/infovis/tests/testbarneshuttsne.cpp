@@ -0,0 +1,84 @@
+/*
+ * testbarneshuttsne.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testbarneshuttsne.h"
+#include "testhelper.h"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "BarnesHutTSNE.h"
+
+using megamol::infovis::BarnesHutTSNE;
+
+
+/*
+ * ::TestBarnesHutTSNE
+ */
+void TestBarnesHutTSNE(void) {
+    const size_t rows = 200;
+    const size_t cols = 10;
+
+    // two well separated gaussian clusters, the first half of the points in the first one
+    std::mt19937 rng(42);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<float> data(rows * cols);
+    for (size_t r = 0; r < rows; ++r) {
+        for (size_t c = 0; c < cols; ++c) {
+            data[r * cols + c] = noise(rng) + (r < rows / 2 ? -10.0f : 10.0f);
+        }
+    }
+
+    BarnesHutTSNE tooFew(2, 30.0, 0.5);
+    AssertFalse("Perplexity too large for the points", tooFew.Initialize(data.data(), 50, cols, 1));
+    AssertFalse("No points", tooFew.Initialize(data.data(), 0, cols, 1));
+
+    BarnesHutTSNE tsne(2, 10.0, 0.5);
+    AssertTrue("Initialize succeeds", tsne.Initialize(data.data(), rows, cols, 1));
+    AssertEqual("Rows are taken from the input", tsne.Rows(), rows);
+    AssertEqual("Dimensions are taken from the ctor", tsne.Dims(), 2);
+    AssertEqual("Embedding has one point per row", tsne.Embedding().size(), rows * 2);
+    AssertEqual("No steps performed yet", tsne.Iteration(), 0);
+
+    BarnesHutTSNE same(2, 10.0, 0.5);
+    same.Initialize(data.data(), rows, cols, 1);
+    for (int i = 0; i < 500; ++i) {
+        tsne.Step();
+    }
+    for (int i = 0; i < 500; ++i) {
+        same.Step();
+    }
+    AssertEqual("Steps are counted", tsne.Iteration(), 500);
+    AssertTrue("Same seed gives the same embedding", tsne.Embedding() == same.Embedding());
+
+    // every point must be closer to the centroid of its own cluster than to the other one, stragglers need some
+    // steps after the early exaggeration to get there
+    auto const& y = tsne.Embedding();
+    double centroid[2][2] = {{0.0, 0.0}, {0.0, 0.0}};
+    bool isFinite = true;
+    for (size_t r = 0; r < rows; ++r) {
+        for (int d = 0; d < 2; ++d) {
+            isFinite = isFinite && std::isfinite(y[r * 2 + d]);
+            centroid[r < rows / 2 ? 0 : 1][d] += y[r * 2 + d] / static_cast<double>(rows / 2);
+        }
+    }
+    AssertTrue("Embedding is finite", isFinite);
+    bool isSeparated = true;
+    for (size_t r = 0; r < rows; ++r) {
+        double dist[2];
+        for (int c = 0; c < 2; ++c) {
+            dist[c] = std::hypot(y[r * 2] - centroid[c][0], y[r * 2 + 1] - centroid[c][1]);
+        }
+        isSeparated = isSeparated && (r < rows / 2 ? dist[0] < dist[1] : dist[1] < dist[0]);
+    }
+    AssertTrue("Clusters stay separated", isSeparated);
+
+    BarnesHutTSNE other(2, 10.0, 0.5);
+    other.Initialize(data.data(), rows, cols, 2);
+    AssertFalse("Other seed gives another start", other.Embedding() == same.Embedding());
+}
@@ -0,0 +1,14 @@
+/*
+ * testbarneshuttsne.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef INFOVIS_TEST_TESTBARNESHUTTSNE_H_INCLUDED
+#define INFOVIS_TEST_TESTBARNESHUTTSNE_H_INCLUDED
+#pragma once
+
+void TestBarnesHutTSNE(void);
+
+#endif /* INFOVIS_TEST_TESTBARNESHUTTSNE_H_INCLUDED */
@@ -0,0 +1,73 @@
+/*
+ * testlandmarkmds.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testlandmarkmds.h"
+#include "testhelper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <Eigen/Dense>
+
+#include "MDSProjection.h"
+
+using megamol::infovis::MDSProjection;
+
+
+/*
+ * ::TestLandmarkMds
+ */
+void TestLandmarkMds(void) {
+    const int n = 200;
+
+    // points on a tilted plane in 3D, one point per column
+    srand(42);
+    Eigen::MatrixXf const plane = Eigen::MatrixXf::Random(2, n) * 5.0f;
+    Eigen::MatrixXf const axes = Eigen::HouseholderQR<Eigen::MatrixXf>(Eigen::MatrixXf::Random(3, 3)).householderQ() *
+                                 Eigen::MatrixXf::Identity(3, 2);
+    Eigen::MatrixXf const points = (axes * plane).colwise() + Eigen::Vector3f(1.0f, -2.0f, 3.0f);
+
+    AssertEqual("No points give no embedding", MDSProjection::landmarkMds(Eigen::MatrixXf(3, 0), 2, 10, true).size(),
+        static_cast<Eigen::Index>(0));
+    AssertEqual("Too few landmarks give no embedding", MDSProjection::landmarkMds(points, 2, 2, true).size(),
+        static_cast<Eigen::Index>(0));
+    AssertEqual("Landmarks are clamped to the point count",
+        MDSProjection::landmarkMds(points.leftCols(2), 2, 10, true).size(), static_cast<Eigen::Index>(0));
+
+    for (bool maxMin : {true, false}) {
+        Eigen::MatrixXd const embedding = MDSProjection::landmarkMds(points, 2, 20, maxMin);
+        AssertEqual("Embedding has one row per point", embedding.rows(), static_cast<Eigen::Index>(n));
+        AssertEqual("Embedding has the output dimension", embedding.cols(), static_cast<Eigen::Index>(2));
+
+        // planar data has an exact 2D embedding, so all pairwise distances survive
+        double maxError = 0.0;
+        for (int i = 0; i < n; ++i) {
+            for (int j = i + 1; j < n; ++j) {
+                double const orig = (points.col(i) - points.col(j)).cast<double>().norm();
+                double const emb = (embedding.row(i) - embedding.row(j)).norm();
+                maxError = std::max(maxError, std::abs(orig - emb));
+            }
+        }
+        AssertTrue(maxMin ? "MaxMin landmarks preserve distances" : "Random landmarks preserve distances",
+            maxError < 1e-3);
+    }
+
+    // a full landmark set is classic MDS
+    Eigen::MatrixXd const full = MDSProjection::landmarkMds(points.leftCols(30), 2, 30, true);
+    Eigen::MatrixXd const dist = MDSProjection::euclideanDissimilarityMatrix(points.leftCols(30).transpose().cast<double>());
+    Eigen::MatrixXd const classic = MDSProjection::classicMds(dist.array().square().matrix(), 2);
+    bool isSameGeometry = full.rows() == 30 && classic.rows() == 30;
+    for (int i = 0; isSameGeometry && i < 30; ++i) {
+        for (int j = i + 1; j < 30; ++j) {
+            isSameGeometry = isSameGeometry &&
+                             std::abs((full.row(i) - full.row(j)).norm() - (classic.row(i) - classic.row(j)).norm()) <
+                                 1e-3;
+        }
+    }
+    AssertTrue("All landmarks match classic MDS", isSameGeometry);
+}
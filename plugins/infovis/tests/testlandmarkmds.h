@@ -0,0 +1,14 @@
+/*
+ * testlandmarkmds.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef INFOVIS_TEST_TESTLANDMARKMDS_H_INCLUDED
+#define INFOVIS_TEST_TESTLANDMARKMDS_H_INCLUDED
+#pragma once
+
+void TestLandmarkMds(void);
+
+#endif /* INFOVIS_TEST_TESTLANDMARKMDS_H_INCLUDED */
@@ -0,0 +1,100 @@
+/*
+ * testrandomizedpca.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testrandomizedpca.h"
+#include "testhelper.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <Eigen/Dense>
+
+#include "PCAProjection.h"
+
+using megamol::infovis::PCAProjection;
+using RowMatrixXf = Eigen::Matrix<float, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+
+namespace {
+
+/** Largest deviation of the projection from the exact one, columns may differ in sign */
+double projectionError(std::vector<float> const& data, Eigen::MatrixXd const& exact) {
+    Eigen::Map<RowMatrixXf const> const proj(data.data(), exact.rows(), exact.cols());
+    double error = 0.0;
+    for (Eigen::Index c = 0; c < exact.cols(); ++c) {
+        Eigen::VectorXd const col = proj.col(c).cast<double>();
+        double const sign = col.dot(exact.col(c)) < 0.0 ? -1.0 : 1.0;
+        error = std::max(error, (sign * col - exact.col(c)).cwiseAbs().maxCoeff());
+    }
+    return error;
+}
+
+} // namespace
+
+
+/*
+ * ::TestRandomizedPca
+ */
+void TestRandomizedPca(void) {
+    const int rows = 300;
+    const int cols = 12;
+    const unsigned int dims = 3;
+
+    // rank 3 table with distinct variances plus column offsets and a little noise
+    srand(42);
+    Eigen::MatrixXd const factors = Eigen::MatrixXd::Random(rows, dims) * Eigen::Vector3d(8.0, 4.0, 2.0).asDiagonal();
+    Eigen::MatrixXd const loadings =
+        Eigen::HouseholderQR<Eigen::MatrixXd>(Eigen::MatrixXd::Random(cols, cols)).householderQ() *
+        Eigen::MatrixXd::Identity(cols, dims);
+    Eigen::MatrixXd const table = (factors * loadings.transpose() + 1e-4 * Eigen::MatrixXd::Random(rows, cols))
+                                      .rowwise() +
+                                  Eigen::RowVectorXd::LinSpaced(cols, -5.0, 5.0);
+    RowMatrixXf const tableF = table.cast<float>();
+
+    // exact PCA of the centered table
+    Eigen::MatrixXd const centered = tableF.cast<double>().rowwise() - tableF.cast<double>().colwise().mean();
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(centered, Eigen::ComputeThinV);
+    Eigen::MatrixXd const exact = centered * svd.matrixV().leftCols(dims);
+
+    std::vector<float> data;
+    Eigen::MatrixXd basis;
+    Eigen::MatrixXd range = PCAProjection::randomizedPca(
+        tableF.data(), rows, cols, dims, true, false, 5, 0, 1000, basis, data);
+    AssertEqual("One value per row and component", data.size(), static_cast<size_t>(rows * dims));
+    AssertEqual("Basis has the oversampled directions", basis.cols(), static_cast<Eigen::Index>(dims + 5));
+    AssertTrue("Range finder alone finds the components", projectionError(data, exact) < 1e-2);
+
+    Eigen::Map<RowMatrixXf const> const proj(data.data(), rows, dims);
+    AssertTrue("Range holds the minima",
+        (range.row(0) - proj.colwise().minCoeff().cast<double>()).cwiseAbs().maxCoeff() < 1e-4);
+    AssertTrue("Range holds the maxima",
+        (range.row(1) - proj.colwise().maxCoeff().cast<double>()).cwiseAbs().maxCoeff() < 1e-4);
+
+    // power iterations, small blocks and no oversampling must not change the result
+    basis.resize(0, 0);
+    PCAProjection::randomizedPca(tableF.data(), rows, cols, dims, true, false, 0, 2, 7, basis, data);
+    AssertEqual("Basis without oversampling", basis.cols(), static_cast<Eigen::Index>(dims));
+    AssertTrue("Power iterations in small blocks find the components", projectionError(data, exact) < 1e-2);
+
+    // the basis of the last run is a valid start basis
+    Eigen::MatrixXd const warmBasis = basis;
+    PCAProjection::randomizedPca(tableF.data(), rows, cols, dims, true, false, 0, 0, 64, basis, data);
+    AssertTrue("Warm start keeps the subspace",
+        (basis * basis.transpose() - warmBasis * warmBasis.transpose()).cwiseAbs().maxCoeff() < 1e-4);
+    AssertTrue("Warm start finds the components", projectionError(data, exact) < 1e-2);
+
+    // scaling divides by the column standard deviations
+    Eigen::RowVectorXd const stdDev =
+        (centered.array().square().colwise().sum() / static_cast<double>(rows - 1)).sqrt();
+    Eigen::MatrixXd const standardized = centered.array().rowwise() / stdDev.array();
+    Eigen::JacobiSVD<Eigen::MatrixXd> svdScaled(standardized, Eigen::ComputeThinV);
+    basis.resize(0, 0);
+    PCAProjection::randomizedPca(tableF.data(), rows, cols, dims, true, true, 5, 2, 1000, basis, data);
+    AssertTrue("Scaled table matches the exact PCA",
+        projectionError(data, standardized * svdScaled.matrixV().leftCols(dims)) < 1e-2);
+}
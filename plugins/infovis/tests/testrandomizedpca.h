@@ -0,0 +1,14 @@
+/*
+ * testrandomizedpca.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef INFOVIS_TEST_TESTRANDOMIZEDPCA_H_INCLUDED
+#define INFOVIS_TEST_TESTRANDOMIZEDPCA_H_INCLUDED
+#pragma once
+
+void TestRandomizedPca(void);
+
+#endif /* INFOVIS_TEST_TESTRANDOMIZEDPCA_H_INCLUDED */
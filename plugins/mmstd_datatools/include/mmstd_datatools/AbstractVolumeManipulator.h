@@ -107,6 +107,12 @@ namespace datatools {
 
         bool tryGetDataCallback(megamol::core::Call& c);
 
+        /** The ranges of the input do not describe the manipulated data, so this always fails */
+        bool getRangesCallback(megamol::core::Call& c);
+
+        /** Regions are read from files, which manipulators do not have */
+        bool getRegionCallback(megamol::core::Call& c);
+
         /** The slot providing access to the manipulated data */
         megamol::core::CalleeSlot outDataSlot;
 
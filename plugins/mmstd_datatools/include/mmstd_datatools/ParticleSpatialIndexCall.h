@@ -0,0 +1,151 @@
+/*
+ * ParticleSpatialIndexCall.h
+ *
+ * Copyright (C) 2020 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_PARTICLESPATIALINDEXCALL_H_INCLUDED
+#define MEGAMOL_DATATOOLS_PARTICLESPATIALINDEXCALL_H_INCLUDED
+#pragma once
+
+#include "mmcore/AbstractGetData3DCall.h"
+#include "mmcore/factories/CallAutoDescription.h"
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+
+    /**
+     * Immutable spatial search structure over the positions of all particles
+     * of one frame of a MultiParticleDataCall.
+     *
+     * Particles are addressed by a global index running over all indexed
+     * lists in list order, i.e. the particle j of list i has the index
+     * ListOffset(i) + j. All queries are const and may be issued
+     * concurrently from any number of threads.
+     */
+    class AbstractSpatialIndex {
+    public:
+
+        /** Pairs of global particle index and squared distance */
+        typedef std::vector<std::pair<size_t, float>> match_list;
+
+        virtual ~AbstractSpatialIndex(void) = default;
+
+        /** Answer the data hash of the particle data the index was built from */
+        virtual size_t DataHash(void) const = 0;
+
+        /** Answer the frame the index was built from */
+        virtual unsigned int FrameID(void) const = 0;
+
+        /** Answer the number of indexed particles */
+        virtual size_t Count(void) const = 0;
+
+        /** Answer the number of particle lists the index was built from */
+        virtual unsigned int ListCount(void) const = 0;
+
+        /**
+         * Answer the global index of the first particle of a list.
+         * Lists that have not been indexed span an empty range.
+         *
+         * @param list The particle list, may be equal to ListCount()
+         */
+        virtual size_t ListOffset(unsigned int list) const = 0;
+
+        /** Answer the (packed) position of a particle */
+        virtual const float *Position(size_t idx) const = 0;
+
+        /**
+         * Searches the k nearest particles to 'query'. The results are not
+         * sorted.
+         *
+         * @param query The query position (3 floats)
+         * @param k The number of particles to search
+         * @param idx Receives at least k global particle indices
+         * @param distSqr Receives at least k squared distances
+         *
+         * @return The number of particles found
+         */
+        virtual size_t KNearest(const float *query, size_t k, size_t *idx, float *distSqr) const = 0;
+
+        /**
+         * Searches all particles closer than sqrt(radiusSqr) to 'query'.
+         *
+         * @param query The query position (3 floats)
+         * @param radiusSqr The squared search radius
+         * @param matches Receives the matches, previous content is discarded
+         * @param sorted Sort the matches by ascending distance
+         *
+         * @return The number of particles found
+         */
+        virtual size_t RadiusSearch(const float *query, float radiusSqr, match_list& matches,
+            bool sorted = false) const = 0;
+
+    };
+
+    /**
+     * Call handing out a shared spatial index over particle data, so several
+     * neighbourhood-based modules can reuse one search structure per frame.
+     * The index stays valid as long as the receiver holds on to it.
+     */
+    class ParticleSpatialIndexCall : public core::AbstractGetData3DCall {
+    public:
+
+        /** Call function names */
+        enum CallFunctionNames : int {
+            GET_DATA = 0,
+            GET_EXTENT = 1
+        };
+
+        /** factory info */
+        static const char *ClassName(void) {
+            return "ParticleSpatialIndexCall";
+        }
+        static const char *Description(void) {
+            return "Call to get a shared spatial search structure over particle data";
+        }
+        static unsigned int FunctionCount(void) {
+            return 2;
+        }
+        static const char * FunctionName(unsigned int idx) {
+            switch (idx) {
+            case GET_DATA: return "GetData";
+            case GET_EXTENT: return "GetExtent";
+            }
+            return "";
+        }
+
+        /** ctor */
+        ParticleSpatialIndexCall(void);
+        /** dtor */
+        virtual ~ParticleSpatialIndexCall(void);
+
+        /** Answer the spatial index, may be nullptr */
+        inline std::shared_ptr<const AbstractSpatialIndex> GetIndex(void) const {
+            return this->index;
+        }
+
+        /** Sets the spatial index */
+        inline void SetIndex(std::shared_ptr<const AbstractSpatialIndex> index) {
+            this->index = std::move(index);
+        }
+
+    private:
+
+        std::shared_ptr<const AbstractSpatialIndex> index;
+
+    };
+
+    /** Description typedef */
+    typedef core::factories::CallAutoDescription<ParticleSpatialIndexCall> ParticleSpatialIndexCallDescription;
+
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_PARTICLESPATIALINDEXCALL_H_INCLUDED */
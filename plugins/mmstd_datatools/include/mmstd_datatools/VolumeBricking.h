@@ -0,0 +1,302 @@
+/*
+ * VolumeBricking.h
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+#ifndef MEGAMOL_DATATOOLS_VOLUMEBRICKING_H_INCLUDED
+#define MEGAMOL_DATATOOLS_VOLUMEBRICKING_H_INCLUDED
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "omp.h"
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+
+    /**
+     * Partition of a sx * sy * sz voxel grid into cubic bricks.
+     *
+     * Splatting modules bin their input to bricks first and then let exactly one thread accumulate each brick
+     * directly into the output volume. Compared to one private volume per thread, memory does not grow with the
+     * thread count and the writes of a thread stay within a cache friendly region.
+     */
+    class VolumeBricking {
+    public:
+        /** Default brick edge length in voxels */
+        static constexpr int DefaultEdge = 32;
+
+        /**
+         * Ctor.
+         *
+         * @param sx   Volume resolution in x.
+         * @param sy   Volume resolution in y.
+         * @param sz   Volume resolution in z.
+         * @param edge Brick edge length in voxels, bricks at the upper borders may be smaller.
+         */
+        VolumeBricking(int sx, int sy, int sz, int edge = DefaultEdge)
+                : edge(std::max(edge, 1)), size{sx, sy, sz} {
+            for (int d = 0; d < 3; ++d) {
+                this->count[d] = (this->size[d] + this->edge - 1) / this->edge;
+            }
+        }
+
+        /** Answer the brick edge length in voxels */
+        int Edge(void) const {
+            return this->edge;
+        }
+
+        /** Answer the volume resolution along dimension d */
+        int Size(int d) const {
+            return this->size[d];
+        }
+
+        /** Answer the number of bricks */
+        int Count(void) const {
+            return this->count[0] * this->count[1] * this->count[2];
+        }
+
+        /** Answer the number of bricks along dimension d */
+        int Count(int d) const {
+            return this->count[d];
+        }
+
+        /** Answer the brick coordinate of voxel coordinate v */
+        int BrickCoord(int v) const {
+            return v / this->edge;
+        }
+
+        /** Answer the brick containing the voxel */
+        int BrickOf(int x, int y, int z) const {
+            return this->Index(x / this->edge, y / this->edge, z / this->edge);
+        }
+
+        /** Answer the brick index from brick coordinates */
+        int Index(int bx, int by, int bz) const {
+            return (bz * this->count[1] + by) * this->count[0] + bx;
+        }
+
+        /**
+         * Answer the voxel range [lo, hi) covered by a brick.
+         *
+         * @param brick The brick index.
+         * @param lo    Receives the first voxel of the brick.
+         * @param hi    Receives the voxel behind the last voxel of the brick.
+         */
+        void Extent(int brick, int lo[3], int hi[3]) const {
+            int const b[3] = {brick % this->count[0], (brick / this->count[0]) % this->count[1],
+                brick / (this->count[0] * this->count[1])};
+            for (int d = 0; d < 3; ++d) {
+                lo[d] = b[d] * this->edge;
+                hi[d] = std::min(lo[d] + this->edge, this->size[d]);
+            }
+        }
+
+        /**
+         * Bins items to bricks with a parallel counting sort.
+         *
+         * Afterwards the items touching brick b are items[offsets[b]] to items[offsets[b + 1] - 1], in ascending
+         * order, so accumulating a brick always sums in the same order regardless of the thread count.
+         *
+         * @param num_items Number of items.
+         * @param bricks_of Callable (int64_t item, std::vector<int>& bricks) that appends the bricks touched by an
+         *                  item, each brick at most once. It is called twice per item and must be thread safe.
+         * @param offsets   Receives Count() + 1 offsets into items.
+         * @param items     Receives the item indices sorted by brick.
+         */
+        template <typename F, typename T>
+        void Bin(int64_t num_items, F const& bricks_of, std::vector<size_t>& offsets, std::vector<T>& items) const {
+            auto const num_bricks = static_cast<size_t>(this->Count());
+            // contiguous item ranges, one per chunk, so the chunks concatenate in ascending item order
+            int64_t const num_chunks = std::max<int64_t>(1, std::min<int64_t>(omp_get_max_threads(), num_items));
+            auto const chunk_begin = [num_items, num_chunks](int64_t c) { return num_items * c / num_chunks; };
+            // per chunk and brick first the count, then the write position
+            std::vector<std::vector<size_t>> cursor(num_chunks, std::vector<size_t>(num_bricks, 0));
+
+#pragma omp parallel for
+            for (int64_t c = 0; c < num_chunks; ++c) {
+                std::vector<int> bricks;
+                for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+                    bricks.clear();
+                    bricks_of(i, bricks);
+                    for (auto const b : bricks) ++cursor[c][b];
+                }
+            }
+
+            offsets.assign(num_bricks + 1, 0);
+            size_t total = 0;
+            for (size_t b = 0; b < num_bricks; ++b) {
+                offsets[b] = total;
+                for (auto& c : cursor) {
+                    auto const cnt = c[b];
+                    c[b] = total;
+                    total += cnt;
+                }
+            }
+            offsets[num_bricks] = total;
+            items.resize(total);
+
+#pragma omp parallel for
+            for (int64_t c = 0; c < num_chunks; ++c) {
+                std::vector<int> bricks;
+                for (int64_t i = chunk_begin(c); i < chunk_begin(c + 1); ++i) {
+                    bricks.clear();
+                    bricks_of(i, bricks);
+                    for (auto const b : bricks) items[cursor[c][b]++] = static_cast<T>(i);
+                }
+            }
+        }
+
+    private:
+        /** Brick edge length */
+        int edge;
+
+        /** Volume resolution */
+        int size[3];
+
+        /** Number of bricks per dimension */
+        int count[3];
+    };
+
+
+    /**
+     * Per thread write-back cache of bricks for scattered accumulation into a shared volume.
+     *
+     * Used when the footprint of an input element cannot be known in advance, e.g. for marched rays. Values are
+     * summed into a few private bricks, an evicted brick is added to the volume while holding the lock of that
+     * brick, so every brick of the volume is written by one thread at a time. Memory per thread is bounded by the
+     * number of slots and does not depend on the volume resolution.
+     *
+     * The slots are set associative with LRU replacement, and each slot remembers the voxels it touched, so an
+     * eviction only writes back (and clears) those voxels instead of the whole brick. Sparse footprints like rays
+     * therefore cost a few adds per eviction rather than edge^3.
+     */
+    class BrickCache {
+    public:
+        /** Number of slots per set */
+        static constexpr int Ways = 4;
+
+        /**
+         * Ctor.
+         *
+         * @param bricking The brick partition of the volume.
+         * @param volume   The shared volume, sx * sy * sz floats in x-fastest order.
+         * @param locks    One lock per brick, shared by all caches writing to the volume.
+         * @param slots    Number of cached bricks, rounded up to a multiple of Ways.
+         */
+        BrickCache(VolumeBricking const& bricking, float* volume, std::vector<std::mutex>& locks, int slots = 64)
+                : bricking(bricking), volume(volume), locks(locks)
+                , sets(static_cast<size_t>((std::max(slots, 1) + Ways - 1) / Ways))
+                , cells(static_cast<size_t>(bricking.Edge()) * bricking.Edge() * bricking.Edge())
+                , tags(sets * Ways, -1), lastUse(sets * Ways, 0), useCounter(0)
+                , data(tags.size() * cells, 0.0f), touched(tags.size()) {}
+
+        /** Dtor, writes back all cached bricks */
+        ~BrickCache(void) {
+            this->Flush();
+        }
+
+        BrickCache(BrickCache const& rhs) = delete;
+
+        BrickCache& operator=(BrickCache const& rhs) = delete;
+
+        /** Adds a value to a voxel */
+        void Add(int x, int y, int z, float val) {
+            if (val == 0.0f) return;
+            auto const edge = this->bricking.Edge();
+            auto const slot = this->slotOf(this->bricking.BrickOf(x, y, z));
+            auto const local = static_cast<uint32_t>(((z % edge) * edge + (y % edge)) * edge + (x % edge));
+            auto& cell = this->data[slot * this->cells + local];
+            if (cell == 0.0f) {
+                // lists a voxel twice if its sum returned to zero, flushSlot clears each voxel as it goes
+                this->touched[slot].push_back(local);
+            }
+            cell += val;
+        }
+
+        /** Writes back all cached bricks */
+        void Flush(void) {
+            for (size_t slot = 0; slot < this->tags.size(); ++slot) {
+                this->flushSlot(slot);
+            }
+        }
+
+    private:
+        /** Answers the slot holding a brick, evicting the least recently used slot of its set on a miss */
+        size_t slotOf(int brick) {
+            auto const first = (static_cast<size_t>(brick) % this->sets) * Ways;
+            size_t victim = first;
+            for (size_t slot = first; slot < first + Ways; ++slot) {
+                if (this->tags[slot] == brick) {
+                    this->lastUse[slot] = ++this->useCounter;
+                    return slot;
+                }
+                if (this->lastUse[slot] < this->lastUse[victim]) victim = slot;
+            }
+            this->flushSlot(victim);
+            this->tags[victim] = brick;
+            this->lastUse[victim] = ++this->useCounter;
+            return victim;
+        }
+
+        void flushSlot(size_t slot) {
+            auto const brick = this->tags[slot];
+            if (brick < 0) return;
+            auto const edge = this->bricking.Edge();
+            int lo[3], hi[3];
+            this->bricking.Extent(brick, lo, hi);
+            auto* src = this->data.data() + slot * this->cells;
+            auto& list = this->touched[slot];
+            {
+                std::lock_guard<std::mutex> guard(this->locks[brick]);
+                for (auto const local : list) {
+                    int const x = lo[0] + static_cast<int>(local % edge);
+                    int const y = lo[1] + static_cast<int>((local / edge) % edge);
+                    int const z = lo[2] + static_cast<int>(local / (edge * edge));
+                    this->volume[(static_cast<size_t>(z) * this->bricking.Size(1) + y) * this->bricking.Size(0) + x] +=
+                        src[local];
+                    src[local] = 0.0f;
+                }
+            }
+            list.clear();
+            this->tags[slot] = -1;
+            this->lastUse[slot] = 0;
+        }
+
+        VolumeBricking const& bricking;
+
+        float* volume;
+
+        std::vector<std::mutex>& locks;
+
+        /** Number of sets of Ways slots each */
+        size_t sets;
+
+        /** Voxels per brick */
+        size_t cells;
+
+        /** Brick held by each slot, -1 if empty */
+        std::vector<int> tags;
+
+        /** Use counter value of the last access of each slot, 0 if empty */
+        std::vector<uint64_t> lastUse;
+
+        uint64_t useCounter;
+
+        /** Brick data of all slots, zero outside the touched voxels */
+        std::vector<float> data;
+
+        /** Brick local indices of the voxels written since the last flush, per slot */
+        std::vector<std::vector<uint32_t>> touched;
+    };
+
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_VOLUMEBRICKING_H_INCLUDED */
@@ -0,0 +1,160 @@
+/*
+ * ColumnarTableDataCall.h
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_COLUMNARTABLEDATACALL_H_INCLUDED
+#define MEGAMOL_DATATOOLS_COLUMNARTABLEDATACALL_H_INCLUDED
+#pragma once
+
+#include "mmcore/AbstractGetDataCall.h"
+#include "mmcore/factories/CallAutoDescription.h"
+#include "mmstd_datatools/table/TableDataCall.h"
+#include <cassert>
+#include <memory>
+#include <vector>
+#include "vislib/macro_utils.h"
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+namespace table {
+
+    /**
+     * Call for passing around tabular data column by column.
+     *
+     * Every column is an immutable buffer held by a shared pointer. Modules
+     * that only select, reorder or join columns can pass the buffers of their
+     * input on without copying, and modules creating new columns hand out
+     * ownership, so the data stays valid as long as any consumer holds it.
+     * Use TableToColumnar and ColumnarToTable to connect to modules working
+     * on the row-major TableDataCall.
+     */
+    class ColumnarTableDataCall : public core::AbstractGetDataCall {
+    public:
+        typedef TableDataCall::ColumnInfo ColumnInfo;
+        typedef TableDataCall::ColumnType ColumnType;
+
+        /** The values of one column, one per row */
+        typedef std::shared_ptr<const std::vector<float>> Column;
+
+        static const char *ClassName(void) { return "ColumnarTableDataCall"; }
+        static const char *Description(void) { return "Data of a table of floats stored column by column"; }
+        static unsigned int FunctionCount(void) { return 2; }
+        static const char * FunctionName(unsigned int idx) {
+            switch (idx) {
+            case 0: return "GetData";
+            case 1: return "GetHash";
+            }
+            return nullptr;
+        }
+
+        /**
+         * Wraps a vector as column, taking over its memory.
+         *
+         * @param data The values of the column
+         *
+         * @return The column
+         */
+        static inline Column MakeColumn(std::vector<float>&& data) {
+            return std::make_shared<const std::vector<float>>(std::move(data));
+        }
+
+        ColumnarTableDataCall(void);
+        virtual ~ColumnarTableDataCall(void);
+
+        inline size_t GetColumnsCount(void) const {
+            return this->columns.size();
+        }
+
+        inline size_t GetRowsCount(void) const {
+            return this->rows_count;
+        }
+
+        inline const ColumnInfo* GetColumnsInfos(void) const {
+            return this->infos.data();
+        }
+
+        inline const ColumnInfo& GetColumnInfo(size_t col) const {
+            assert(col < this->infos.size());
+            return this->infos[col];
+        }
+
+        inline const Column& GetColumn(size_t col) const {
+            assert(col < this->columns.size());
+            return this->columns[col];
+        }
+
+        inline const float* GetColumnData(size_t col) const {
+            assert(col < this->columns.size());
+            return this->columns[col]->data();
+        }
+
+        inline float GetData(size_t col, size_t row) const {
+            assert(col < this->columns.size());
+            assert(row < this->rows_count);
+            return (*this->columns[col])[row];
+        }
+
+        /**
+         * Sets the table. All columns must hold 'row_cnt' values.
+         *
+         * @param row_cnt The number of rows
+         * @param info The descriptions of the columns
+         * @param cols The columns, one per description
+         */
+        inline void Set(size_t row_cnt, std::vector<ColumnInfo> info, std::vector<Column> cols) {
+            assert(info.size() == cols.size());
+            this->rows_count = row_cnt;
+            this->infos = std::move(info);
+            this->columns = std::move(cols);
+#ifndef NDEBUG
+            for (auto const& c : this->columns) {
+                assert((c != nullptr) && (c->size() == row_cnt));
+            }
+#endif
+        }
+
+        /** Releases the references to all columns */
+        inline void Clear(void) {
+            this->rows_count = 0;
+            this->infos.clear();
+            this->columns.clear();
+        }
+
+        inline void SetFrameCount(const unsigned int frameCount) {
+            this->frameCount = frameCount;
+        }
+
+        inline unsigned int GetFrameCount(void) const {
+            return this->frameCount;
+        }
+
+        inline void SetFrameID(const unsigned int frameID) {
+            this->frameID = frameID;
+        }
+
+        inline unsigned int GetFrameID(void) const {
+            return this->frameID;
+        }
+
+    private:
+        size_t rows_count;
+        VISLIB_MSVC_SUPPRESS_WARNING(4251)
+        std::vector<ColumnInfo> infos;
+        VISLIB_MSVC_SUPPRESS_WARNING(4251)
+        std::vector<Column> columns;
+        unsigned int frameCount;
+        unsigned int frameID;
+    };
+
+    typedef core::factories::CallAutoDescription<ColumnarTableDataCall> ColumnarTableDataCallDescription;
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MEGAMOL_DATATOOLS_COLUMNARTABLEDATACALL_H_INCLUDED */
@@ -38,6 +38,12 @@ datatools::AbstractVolumeManipulator::AbstractVolumeManipulator(const char* outS
     this->outDataSlot.SetCallback(megamol::core::misc::VolumetricDataCall::ClassName(),
         core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_TRY_GET_DATA),
         &AbstractVolumeManipulator::tryGetDataCallback);
+    this->outDataSlot.SetCallback(megamol::core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_RANGES),
+        &AbstractVolumeManipulator::getRangesCallback);
+    this->outDataSlot.SetCallback(megamol::core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_REGION),
+        &AbstractVolumeManipulator::getRegionCallback);
     this->MakeSlotAvailable(&this->outDataSlot);
 
     this->inDataSlot.SetCompatibleCall<core::misc::VolumetricDataCallDescription>();
@@ -223,3 +229,11 @@ bool datatools::AbstractVolumeManipulator::tryGetDataCallback(megamol::core::Cal
 
     return true;
 }
+
+bool datatools::AbstractVolumeManipulator::getRangesCallback(megamol::core::Call& c) {
+    return false;
+}
+
+bool datatools::AbstractVolumeManipulator::getRegionCallback(megamol::core::Call& c) {
+    return false;
+}
@@ -0,0 +1,187 @@
+/*
+ * KDTreeSpatialIndex.cpp
+ *
+ * Copyright (C) 2020 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+#include "KDTreeSpatialIndex.h"
+#include "mmcore/utility/log/Log.h"
+#include <algorithm>
+#include <cfloat>
+#include <cstdint>
+
+using namespace megamol;
+using namespace megamol::stdplugin;
+
+
+/*
+ * datatools::KDTreeSpatialIndex::Build
+ */
+std::shared_ptr<datatools::KDTreeSpatialIndex> datatools::KDTreeSpatialIndex::Build(
+        core::moldyn::MultiParticleDataCall& dat, list_filter const& filter) {
+    std::shared_ptr<KDTreeSpatialIndex> idx(new KDTreeSpatialIndex());
+    idx->dataHash = dat.DataHash();
+    idx->frameID = dat.FrameID();
+
+    const unsigned int plc = dat.GetParticleListCount();
+    idx->offsets.resize(plc + 1);
+    size_t total = 0;
+    for (unsigned int pli = 0; pli < plc; ++pli) {
+        idx->offsets[pli] = total;
+        auto& pl = dat.AccessParticles(pli);
+        if (IsListIndexable(pl) && (!filter || filter(pli))) {
+            total += static_cast<size_t>(pl.GetCount());
+        }
+    }
+    idx->offsets[plc] = total;
+    idx->positions.resize(3 * total);
+
+    // pack the positions in blocks, so that few huge lists are split across
+    // threads just as well as many small ones
+    const int64_t blockSize = 16 * 1024;
+    std::vector<std::pair<unsigned int, int64_t>> blocks;
+    for (unsigned int pli = 0; pli < plc; ++pli) {
+        const int64_t cnt = static_cast<int64_t>(idx->offsets[pli + 1] - idx->offsets[pli]);
+        for (int64_t b = 0; b < cnt; b += blockSize) {
+            blocks.emplace_back(pli, b);
+        }
+    }
+
+    std::array<float, 6> bbox = {FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX, FLT_MAX, -FLT_MAX};
+#pragma omp parallel
+    {
+        std::array<float, 6> localBox = bbox;
+#pragma omp for schedule(dynamic)
+        for (int64_t bi = 0; bi < static_cast<int64_t>(blocks.size()); ++bi) {
+            const unsigned int pli = blocks[bi].first;
+            const size_t begin = static_cast<size_t>(blocks[bi].second);
+            const size_t end = std::min<size_t>(begin + blockSize, idx->offsets[pli + 1] - idx->offsets[pli]);
+            float *dst = idx->positions.data() + 3 * (idx->offsets[pli] + begin);
+            dat.AccessParticles(pli).GetParticleStore().GetPositions(begin, end, dst);
+            for (size_t i = 0; i < end - begin; ++i) {
+                for (int d = 0; d < 3; ++d) {
+                    localBox[2 * d] = std::min(localBox[2 * d], dst[3 * i + d]);
+                    localBox[2 * d + 1] = std::max(localBox[2 * d + 1], dst[3 * i + d]);
+                }
+            }
+        }
+#pragma omp critical
+        {
+            for (int d = 0; d < 3; ++d) {
+                bbox[2 * d] = std::min(bbox[2 * d], localBox[2 * d]);
+                bbox[2 * d + 1] = std::max(bbox[2 * d + 1], localBox[2 * d + 1]);
+            }
+        }
+    }
+    if (total == 0) {
+        bbox.fill(0.0f);
+    }
+    idx->bbox = bbox;
+
+    idx->tree.reset(new tree_type(3 /* dim */, *idx, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */)));
+    idx->tree->buildIndex();
+
+    return idx;
+}
+
+
+/*
+ * datatools::KDTreeSpatialIndex::Acquire
+ */
+std::shared_ptr<const datatools::AbstractSpatialIndex> datatools::KDTreeSpatialIndex::Acquire(
+        core::CallerSlot& indexSlot, core::moldyn::MultiParticleDataCall& dat, list_filter const& filter,
+        const char *logPrefix) {
+    using megamol::core::utility::log::Log;
+
+    auto *indexCall = indexSlot.CallAs<ParticleSpatialIndexCall>();
+    if (indexCall != nullptr) {
+        indexCall->SetFrameID(dat.FrameID(), true);
+        if ((*indexCall)(ParticleSpatialIndexCall::GET_DATA) && (indexCall->GetIndex() != nullptr)
+                && (indexCall->FrameID() == dat.FrameID()) && IsCompatible(*indexCall->GetIndex(), dat, filter)) {
+            return indexCall->GetIndex();
+        }
+        Log::DefaultLog.WriteWarn("%s: shared index does not match the data, building a local one", logPrefix);
+    }
+
+    Log::DefaultLog.WriteInfo("%s: building acceleration structure...", logPrefix);
+    std::shared_ptr<const AbstractSpatialIndex> idx = Build(dat, filter);
+    Log::DefaultLog.WriteInfo("%s: done.", logPrefix);
+    return idx;
+}
+
+
+/*
+ * datatools::KDTreeSpatialIndex::IsCompatible
+ */
+bool datatools::KDTreeSpatialIndex::IsCompatible(AbstractSpatialIndex const& index,
+        core::moldyn::MultiParticleDataCall& dat, list_filter const& filter) {
+    // equal list sizes do not make the positions of another frame valid
+    if ((index.DataHash() != dat.DataHash()) || (index.FrameID() != dat.FrameID())) return false;
+    const unsigned int plc = dat.GetParticleListCount();
+    if (index.ListCount() != plc) return false;
+    size_t total = 0;
+    for (unsigned int pli = 0; pli < plc; ++pli) {
+        if (index.ListOffset(pli) != total) return false;
+        auto& pl = dat.AccessParticles(pli);
+        if (IsListIndexable(pl) && (!filter || filter(pli))) {
+            total += static_cast<size_t>(pl.GetCount());
+        }
+    }
+    return (index.ListOffset(plc) == total) && (index.Count() == total);
+}
+
+
+/*
+ * datatools::KDTreeSpatialIndex::IsListIndexable
+ */
+bool datatools::KDTreeSpatialIndex::IsListIndexable(core::moldyn::SimpleSphericalParticles const& pl) {
+    using core::moldyn::SimpleSphericalParticles;
+    return pl.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZ
+        || pl.GetVertexDataType() == SimpleSphericalParticles::VERTDATA_FLOAT_XYZR;
+}
+
+
+/*
+ * datatools::KDTreeSpatialIndex::KDTreeSpatialIndex
+ */
+datatools::KDTreeSpatialIndex::KDTreeSpatialIndex(void)
+        : dataHash(0), frameID(0), positions(), offsets(1, 0), bbox(), tree() {
+    this->bbox.fill(0.0f);
+}
+
+
+/*
+ * datatools::KDTreeSpatialIndex::~KDTreeSpatialIndex
+ */
+datatools::KDTreeSpatialIndex::~KDTreeSpatialIndex(void) {
+    // the tree references the positions, so it has to go first
+    this->tree.reset();
+}
+
+
+/*
+ * datatools::KDTreeSpatialIndex::KNearest
+ */
+size_t datatools::KDTreeSpatialIndex::KNearest(const float *query, size_t k, size_t *idx, float *distSqr) const {
+    if ((k == 0) || (this->Count() == 0)) return 0;
+    nanoflann::KNNResultSet<float> resultSet(k);
+    resultSet.init(idx, distSqr);
+    nanoflann::SearchParams params;
+    params.sorted = false;
+    this->tree->findNeighbors(resultSet, query, params);
+    return resultSet.size();
+}
+
+
+/*
+ * datatools::KDTreeSpatialIndex::RadiusSearch
+ */
+size_t datatools::KDTreeSpatialIndex::RadiusSearch(const float *query, float radiusSqr, match_list& matches,
+        bool sorted) const {
+    matches.clear();
+    if (this->Count() == 0) return 0;
+    nanoflann::SearchParams params;
+    params.sorted = sorted;
+    return this->tree->radiusSearch(query, radiusSqr, matches, params);
+}
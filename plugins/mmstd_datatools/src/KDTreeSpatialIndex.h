@@ -0,0 +1,157 @@
+/*
+ * KDTreeSpatialIndex.h
+ *
+ * Copyright (C) 2020 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_DATATOOLS_KDTREESPATIALINDEX_H_INCLUDED
+#define MMSTD_DATATOOLS_KDTREESPATIALINDEX_H_INCLUDED
+#pragma once
+
+#include "mmcore/CallerSlot.h"
+#include "mmcore/moldyn/MultiParticleDataCall.h"
+#include "mmstd_datatools/ParticleSpatialIndexCall.h"
+#include <array>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <nanoflann.hpp>
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+
+    /**
+     * Spatial index holding a packed copy of the particle positions and a
+     * nanoflann kd-tree on top of it. Only lists with float positions are
+     * indexed.
+     */
+    class KDTreeSpatialIndex : public AbstractSpatialIndex {
+    public:
+
+        /** Decides whether a particle list takes part in the index */
+        typedef std::function<bool(unsigned int)> list_filter;
+
+        /**
+         * Builds the index over the current data of 'dat'.
+         *
+         * @param dat The particle data, must hold valid data
+         * @param filter Optional additional filter for the particle lists
+         *
+         * @return The new index
+         */
+        static std::shared_ptr<KDTreeSpatialIndex> Build(
+            core::moldyn::MultiParticleDataCall& dat, list_filter const& filter = nullptr);
+
+        /**
+         * Answer the shared index connected to 'indexSlot' if it is
+         * compatible with 'dat' and 'filter' (see IsCompatible), otherwise
+         * builds a local index.
+         *
+         * @param indexSlot Caller slot for a ParticleSpatialIndexCall, may be unconnected
+         * @param dat The particle data, must hold valid data
+         * @param filter Optional additional filter for the particle lists
+         * @param logPrefix Module name prefixed to the log messages
+         *
+         * @return The shared or the new local index
+         */
+        static std::shared_ptr<const AbstractSpatialIndex> Acquire(core::CallerSlot& indexSlot,
+            core::moldyn::MultiParticleDataCall& dat, list_filter const& filter, const char *logPrefix);
+
+        /**
+         * Answer whether 'index' was built from the current data hash and
+         * frame of 'dat' and numbers its particles exactly as
+         * Build(dat, filter) would.
+         */
+        static bool IsCompatible(AbstractSpatialIndex const& index,
+            core::moldyn::MultiParticleDataCall& dat, list_filter const& filter = nullptr);
+
+        /** Answer whether the positions of a particle list can be indexed */
+        static bool IsListIndexable(core::moldyn::SimpleSphericalParticles const& pl);
+
+        virtual ~KDTreeSpatialIndex(void);
+
+        size_t DataHash(void) const override {
+            return this->dataHash;
+        }
+
+        unsigned int FrameID(void) const override {
+            return this->frameID;
+        }
+
+        size_t Count(void) const override {
+            return this->positions.size() / 3;
+        }
+
+        unsigned int ListCount(void) const override {
+            return static_cast<unsigned int>(this->offsets.size() - 1);
+        }
+
+        size_t ListOffset(unsigned int list) const override {
+            return this->offsets[list];
+        }
+
+        const float *Position(size_t idx) const override {
+            return this->positions.data() + 3 * idx;
+        }
+
+        size_t KNearest(const float *query, size_t k, size_t *idx, float *distSqr) const override;
+
+        size_t RadiusSearch(const float *query, float radiusSqr, match_list& matches,
+            bool sorted = false) const override;
+
+        /* nanoflann dataset adaptor interface */
+
+        inline size_t kdtree_get_point_count() const {
+            return this->Count();
+        }
+
+        inline float kdtree_get_pt(const size_t idx, int dim) const {
+            return this->positions[3 * idx + dim];
+        }
+
+        template <class BBOX>
+        bool kdtree_get_bbox(BBOX& bb) const {
+            for (int d = 0; d < 3; ++d) {
+                bb[d].low = this->bbox[2 * d];
+                bb[d].high = this->bbox[2 * d + 1];
+            }
+            return true;
+        }
+
+    private:
+
+        typedef nanoflann::KDTreeSingleIndexAdaptor<
+            nanoflann::L2_Simple_Adaptor<float, KDTreeSpatialIndex>,
+            KDTreeSpatialIndex,
+            3 /* dim */
+        > tree_type;
+
+        KDTreeSpatialIndex(void);
+
+        KDTreeSpatialIndex(KDTreeSpatialIndex const&) = delete;
+        KDTreeSpatialIndex& operator=(KDTreeSpatialIndex const&) = delete;
+
+        /** Data hash and frame of the particle data the index was built from */
+        size_t dataHash;
+        unsigned int frameID;
+
+        /** Packed xyz positions of all indexed particles */
+        std::vector<float> positions;
+
+        /** Global index of the first particle of each list, plus the total count */
+        std::vector<size_t> offsets;
+
+        /** Bounding box of the positions (min x, max x, min y, ...) */
+        std::array<float, 6> bbox;
+
+        std::unique_ptr<tree_type> tree;
+
+    };
+
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MMSTD_DATATOOLS_KDTREESPATIALINDEX_H_INCLUDED */
@@ -2,6 +2,8 @@
 #include "vislib/math/Cuboid.h"
 #include "mmcore/utility/ColourParser.h"
 #include "mmcore/param/ColorParam.h"
+#include <algorithm>
+#include <vector>
 
 namespace megamol {
 namespace stdplugin {
@@ -233,13 +235,22 @@ void LocalBoundingBoxExtractor::calcLocalBox(
     
     if (!(parts.GetCount() > 0)) return;
 
-    for (int i = 0; i < parts.GetCount(); i++) {
-        box.SetLeft(std::min(box.GetLeft(),parts.GetParticleStore().GetXAcc()->Get_f(i)));
-        box.SetRight(std::max(box.GetRight(), parts.GetParticleStore().GetXAcc()->Get_f(i)));
-        box.SetBottom(std::min(box.GetBottom(), parts.GetParticleStore().GetYAcc()->Get_f(i)));
-        box.SetTop(std::max(box.GetTop(), parts.GetParticleStore().GetYAcc()->Get_f(i)));
-        box.SetFront(std::min(box.GetFront(), parts.GetParticleStore().GetZAcc()->Get_f(i)));
-        box.SetBack(std::max(box.GetBack(), parts.GetParticleStore().GetZAcc()->Get_f(i)));
+    // decode positions block-wise instead of three virtual calls per particle
+    constexpr std::size_t block_size = 4096;
+    std::vector<float> xyz(3 * block_size);
+    auto const& store = parts.GetParticleStore();
+    std::size_t const count = parts.GetCount();
+    for (std::size_t begin = 0; begin < count; begin += block_size) {
+        std::size_t const end = std::min(count, begin + block_size);
+        store.GetPositions(begin, end, xyz.data());
+        for (std::size_t i = 0; i < end - begin; i++) {
+            box.SetLeft(std::min(box.GetLeft(), xyz[3 * i + 0]));
+            box.SetRight(std::max(box.GetRight(), xyz[3 * i + 0]));
+            box.SetBottom(std::min(box.GetBottom(), xyz[3 * i + 1]));
+            box.SetTop(std::max(box.GetTop(), xyz[3 * i + 1]));
+            box.SetFront(std::min(box.GetFront(), xyz[3 * i + 2]));
+            box.SetBack(std::max(box.GetBack(), xyz[3 * i + 2]));
+        }
     }
 }
 
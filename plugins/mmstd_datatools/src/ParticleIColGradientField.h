@@ -10,7 +10,10 @@
 #pragma once
 
 #include "mmstd_datatools/AbstractParticleManipulator.h"
+#include "mmstd_datatools/ParticleSpatialIndexCall.h"
+#include "mmcore/CallerSlot.h"
 #include "mmcore/param/ParamSlot.h"
+#include <memory>
 #include <vector>
 
 
@@ -67,11 +70,18 @@ namespace datatools {
         void set_colors(megamol::core::moldyn::MultiParticleDataCall& dat);
 
         core::param::ParamSlot radiusSlot;
+
+        /** The optional slot accessing a shared spatial index of the original data */
+        core::CallerSlot inIndexSlot;
+
         size_t datahash;
         unsigned int time;
         std::vector<float> newColors;
         float maxColor;
 
+        /** The spatial index over the lists with intensity colours */
+        std::shared_ptr<const AbstractSpatialIndex> particleIndex;
+
     };
 
 } /* end namespace datatools */
@@ -6,6 +6,7 @@
  */
 #include "stdafx.h"
 #include "ParticleNeighborhood.h"
+#include "KDTreeSpatialIndex.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
 #include "mmcore/param/IntParam.h"
@@ -32,8 +33,9 @@ datatools::ParticleNeighborhood::ParticleNeighborhood(void)
         particleNumberSlot("idx", "the particle to track"),
         outDataSlot("outData", "Provides colors based on local particle temperature"),
         inDataSlot("inData", "Takes the directional particle data"),
+        inIndexSlot("inIndex", "Optionally takes a shared spatial index of the particle data"),
         datahash(0), lastTime(-1), newColors(), maxDist(0),
-        allParts(), particleTree(nullptr), myPts(nullptr) {
+        particleIndex(nullptr) {
 
     this->cyclXSlot.SetParameter(new core::param::BoolParam(true));
     this->MakeSlotAvailable(&this->cyclXSlot);
@@ -65,6 +67,9 @@ datatools::ParticleNeighborhood::ParticleNeighborhood(void)
 
     this->inDataSlot.SetCompatibleCall<megamol::core::moldyn::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->inDataSlot);
+
+    this->inIndexSlot.SetCompatibleCall<ParticleSpatialIndexCallDescription>();
+    this->MakeSlotAvailable(&this->inIndexSlot);
 }
 
 
@@ -153,30 +158,7 @@ bool datatools::ParticleNeighborhood::assertData(megamol::core::AbstractGetData3
             this->newColors.resize(totalParts);
         }
 
-        allParts.clear();
-        allParts.reserve(totalParts);
-
-        // we could now filter particles according to something. but currently we need not.
-        size_t allpartcnt = 0;
-        for (unsigned int pli = 0; pli < plc; pli++) {
-            if (!isListOK(in, pli)) {
-                continue;
-            }
-
-            UINT64 part_cnt = getListCount(in, pli);
-
-            for (int part_i = 0; part_i < part_cnt; ++part_i) {
-                allParts.push_back(allpartcnt + part_i);
-            }
-            allpartcnt += getListCount(in, pli);
-        }
-
-        // allocate nanoflann data structures for border
-        assert(allpartcnt == totalParts);
-
-        this->myPts = std::make_shared<simplePointcloud>(inMpdc, allParts);
-        particleTree = std::make_shared<my_kd_tree_t>(3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-        particleTree->buildIndex();
+        this->particleIndex = KDTreeSpatialIndex::Acquire(this->inIndexSlot, *inMpdc, nullptr, "ParticleNeighborhood");
         this->datahash = in->DataHash();
         this->lastTime = time;
         this->radiusSlot.ForceSetDirty();
@@ -198,16 +180,13 @@ bool datatools::ParticleNeighborhood::assertData(megamol::core::AbstractGetData3
                 }
             }
 
-            const float *vbase = myPts->get_position(thePart);
+            const float *vbase = particleIndex->Position(thePart);
             float theVertex[3];
             maxDist = 0.0f;
             std::vector<std::pair<size_t, float> > ret_matches;
             std::vector<std::pair<size_t, float> > ret_localMatches;
             std::vector<size_t> ret_index(theNumber);
             std::vector<float> out_dist_sqr(theNumber);
-            nanoflann::KNNResultSet<float> resultSet(theNumber);
-            nanoflann::SearchParams params;
-            params.sorted = false;
 
             // final computation
             bool cycl_x = this->cyclXSlot.Param<megamol::core::param::BoolParam>()->Value();
@@ -232,12 +211,12 @@ bool datatools::ParticleNeighborhood::assertData(megamol::core::AbstractGetData3
                         if (z_s > 0) theVertex[2] = theVertex[2] + ((theVertex[2] > bbox_cntr.Z()) ? -bbox.Depth() : bbox.Depth());
 
                         if (theSearchType == searchTypeEnum::RADIUS) {
-                            particleTree->radiusSearch(theVertex, theRadius, ret_localMatches, params);
+                            particleIndex->RadiusSearch(theVertex, theRadius, ret_localMatches);
                             ret_matches.insert(ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
                         } else {
-                            resultSet.init(ret_index.data(), out_dist_sqr.data());
-                            particleTree->findNeighbors(resultSet, theVertex, params);
-                            for (size_t i = 0; i < resultSet.size(); ++i) {
+                            const size_t found = particleIndex->KNearest(
+                                theVertex, theNumber, ret_index.data(), out_dist_sqr.data());
+                            for (size_t i = 0; i < found; ++i) {
                                 ret_matches.push_back(std::pair<size_t, float>(ret_index[i], out_dist_sqr[i]));
                             }
                         }
@@ -14,9 +14,9 @@
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/moldyn/MultiParticleDataCall.h"
-#include "PointcloudHelpers.h"
+#include "mmstd_datatools/ParticleSpatialIndexCall.h"
+#include <memory>
 #include <vector>
-#include <nanoflann.hpp>
 
 namespace megamol {
 namespace stdplugin {
@@ -94,17 +94,10 @@ namespace datatools {
         size_t datahash;
         int lastTime;
         std::vector<float> newColors;
-        std::vector<size_t> allParts;
         float maxDist;
 
-        typedef nanoflann::KDTreeSingleIndexAdaptor<
-            nanoflann::L2_Simple_Adaptor<float, simplePointcloud>,
-            simplePointcloud,
-            3 /* dim */
-        > my_kd_tree_t;
-
-        std::shared_ptr<my_kd_tree_t> particleTree;
-        std::shared_ptr<simplePointcloud> myPts;
+        /** The spatial index, either shared via inIndexSlot or built locally */
+        std::shared_ptr<const AbstractSpatialIndex> particleIndex;
 
         /** The slot providing access to the manipulated data */
         megamol::core::CalleeSlot outDataSlot;
@@ -112,6 +105,9 @@ namespace datatools {
         /** The slot accessing the original data */
         megamol::core::CallerSlot inDataSlot;
 
+        /** The optional slot accessing a shared spatial index of the original data */
+        megamol::core::CallerSlot inIndexSlot;
+
     };
 
 } /* end namespace datatools */
@@ -4,7 +4,8 @@
 #include "mmstd_datatools/GraphDataCall.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
-#include "mmstd_datatools/MultiParticleDataAdaptor.h"
+#include "KDTreeSpatialIndex.h"
+#include <algorithm>
 #include <random>
 #include "vislib/math/ShallowPoint.h"
 #include "vislib/math/ShallowVector.h"
@@ -13,7 +14,6 @@
 #include "mmcore/param/IntParam.h"
 #include <chrono>
 #include <omp.h>
-#include <set>
 
 using namespace megamol;
 using namespace megamol::stdplugin::datatools;
@@ -30,6 +30,7 @@ ParticleNeighborhoodGraph::ParticleNeighborhoodGraph() : Module(),
         boundaryXCyclicSlot("boundary::XCyclic", "Activates connection over cyclic boundary conditions in x direction"),
         boundaryYCyclicSlot("boundary::YCyclic", "Activates connection over cyclic boundary conditions in y direction"),
         boundaryZCyclicSlot("boundary::ZCyclic", "Activates connection over cyclic boundary conditions in z direction"),
+        inIndexSlot("inIndex", "Optionally takes a shared spatial index of the particle data"),
         frameId(0), inDataHash(0), outDataHash(0), edges() {
 
     static_assert(sizeof(index_t) * 2 == sizeof(GraphDataCall::edge), "Index type error.");
@@ -41,6 +42,9 @@ ParticleNeighborhoodGraph::ParticleNeighborhoodGraph() : Module(),
     inParticleDataSlot.SetCompatibleCall<core::moldyn::MultiParticleDataCallDescription>();
     MakeSlotAvailable(&inParticleDataSlot);
 
+    inIndexSlot.SetCompatibleCall<ParticleSpatialIndexCallDescription>();
+    MakeSlotAvailable(&inIndexSlot);
+
     autoRadiusSlot.SetParameter(new core::param::BoolParam(true));
     MakeSlotAvailable(&autoRadiusSlot);
 
@@ -175,18 +179,33 @@ namespace {
 }
 
 void ParticleNeighborhoodGraph::calcData(core::moldyn::MultiParticleDataCall* data) {
-    stdplugin::datatools::MultiParticleDataAdaptor d(*data);
-    if (d.get_count() < 1) return;
+    using megamol::core::moldyn::MultiParticleDataCall;
 
     using std::chrono::high_resolution_clock;
     high_resolution_clock::time_point start = high_resolution_clock::now(), end;
 
+    // edges address the particles of all lists with float positions and float or no colours
+    std::shared_ptr<const AbstractSpatialIndex> index = KDTreeSpatialIndex::Acquire(this->inIndexSlot, *data,
+        [data](unsigned int pli) {
+            auto const& pl = data->AccessParticles(pli);
+            return (pl.GetColourDataType() == MultiParticleDataCall::Particles::COLDATA_NONE)
+                || (pl.GetColourDataType() == MultiParticleDataCall::Particles::COLDATA_FLOAT_RGB)
+                || (pl.GetColourDataType() == MultiParticleDataCall::Particles::COLDATA_FLOAT_RGBA)
+                || (pl.GetColourDataType() == MultiParticleDataCall::Particles::COLDATA_FLOAT_I);
+        }, "PNhG");
+    const size_t partCnt = index->Count();
+    if (partCnt < 1) return;
+
+    end = high_resolution_clock::now();
+    megamol::core::utility::log::Log::DefaultLog.WriteInfo("PNhG search index acquired in %u ms", std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
+    start = end;
+
     float neiRad = this->radiusSlot.Param<core::param::FloatParam>()->Value();
     if (this->autoRadiusSlot.Param<core::param::BoolParam>()->Value()) {
         // automatically select a neighborhood radius
 
         std::default_random_engine rnd_eng(autoRadiusSampleRndSeedSlot.Param<core::param::IntParam>()->Value());
-        std::uniform_int_distribution<size_t> rnd_dist(0, d.get_count() - 1);
+        std::uniform_int_distribution<size_t> rnd_dist(0, partCnt - 1);
 
         int sample_cnt = autoRadiusSamplesSlot.Param<core::param::IntParam>()->Value();
         megamol::core::utility::log::Log::DefaultLog.WriteInfo("PNhG detecting radius from %d samples...", sample_cnt);
@@ -195,15 +214,16 @@ void ParticleNeighborhoodGraph::calcData(core::moldyn::MultiParticleDataCall* da
 
         for (int sample = 0; sample < sample_cnt; ++sample) {
             size_t sample_idx = rnd_dist(rnd_eng);
-            vislib::math::ShallowPoint<float, 3> sample_pt(const_cast<float*>(d.get_position(sample_idx)));
 
-            float min_dist = FLT_MAX;
+            // the nearest particle is usually the sample itself
+            size_t nei_idx[2];
+            float nei_dist[2];
+            const size_t found = index->KNearest(index->Position(sample_idx), 2, nei_idx, nei_dist);
 
-            for (size_t i = 0; i < d.get_count(); ++i) {
-                if (i == sample_idx) continue;
-                vislib::math::ShallowPoint<float, 3> pt(const_cast<float*>(d.get_position(i)));
-                float dist = (pt - sample_pt).SquareLength();
-                if (dist < min_dist) min_dist = dist;
+            float min_dist = FLT_MAX;
+            for (size_t i = 0; i < found; ++i) {
+                if (nei_idx[i] == sample_idx) continue;
+                if (nei_dist[i] < min_dist) min_dist = nei_dist[i];
             }
 
             if (min_dist == FLT_MAX) continue;
@@ -224,136 +244,36 @@ void ParticleNeighborhoodGraph::calcData(core::moldyn::MultiParticleDataCall* da
     }
     float neiRadSq = neiRad * neiRad;
 
-    vislib::math::Cuboid<float> box(
-        vislib::math::ShallowPoint<float, 3>(const_cast<float*>(d.get_position(0))),
-        vislib::math::Dimension<float, 3>(0.0f, 0.0f, 0.0f));
-    for (size_t i = 1; i < d.get_count(); ++i) {
-        box.GrowToPoint(
-            vislib::math::ShallowPoint<float, 3>(const_cast<float*>(d.get_position(i)))
-            );
-    }
-
-    unsigned int x_size = static_cast<unsigned int>(std::ceil(box.Width() / neiRad));
-    unsigned int y_size = static_cast<unsigned int>(std::ceil(box.Height() / neiRad));
-    unsigned int z_size = static_cast<unsigned int>(std::ceil(box.Depth() / neiRad));
-
     auto const& bboxR = data->AccessBoundingBoxes().ObjectSpaceBBox();
     auto const bboxCent = bboxR.CalcCenter();
     float bboxCentX = bboxCent.X();
     float bboxCentY = bboxCent.Y();
     float bboxCentZ = bboxCent.Z();
 
-#define _COORD(x, y, z) ((x) + ((y) + ((z) * y_size)) * x_size)
-
-    std::vector<size_t> grid(d.get_count());
-    std::vector<size_t*> gridCell(x_size * y_size * z_size);
-
-    megamol::core::utility::log::Log::DefaultLog.WriteInfo("PNhG search grid : (%u, %u, %u)", x_size, y_size, z_size);
-
-    std::vector<vislib::math::Vector<unsigned int, 3> > cell(d.get_count());
-    for (size_t i = 0; i < d.get_count(); ++i) {
-        vislib::math::Vector<float, 3> c = vislib::math::ShallowPoint<float, 3>(const_cast<float*>(d.get_position(i))) - box.GetLeftBottomBack();
-        cell[i] = c / neiRad;
-        if (cell[i].X() >= x_size) cell[i].SetX(x_size - 1);
-        if (cell[i].Y() >= y_size) cell[i].SetY(y_size - 1);
-        if (cell[i].Z() >= z_size) cell[i].SetZ(z_size - 1);
-        //assert(cell[i].X() < x_size);
-        //assert(cell[i].Y() < y_size);
-        //assert(cell[i].Z() < z_size);
-    }
-
-    std::vector<size_t> gridCellSize(x_size * y_size * z_size);
-    std::fill(gridCellSize.begin(), gridCellSize.end(), 0);
-    for (size_t i = 0; i < d.get_count(); ++i) {
-        gridCellSize[_COORD(cell[i].X(), cell[i].Y(), cell[i].Z())]++;
-    }
-
-    size_t * p = grid.data();
-    for (unsigned int gci = 0; gci < x_size * y_size * z_size; ++gci) {
-        if (gridCellSize[gci] == 0) {
-            gridCell[gci] = nullptr;
-        } else {
-            gridCell[gci] = p;
-            p += gridCellSize[gci];
-            gridCellSize[gci] = 0;
-        }
-    }
-    assert((p - grid.data()) == d.get_count());
-
-    for (size_t i = 0; i < d.get_count(); ++i) {
-        size_t idx = _COORD(cell[i].X(), cell[i].Y(), cell[i].Z());
-        *((gridCell[idx]) + gridCellSize[idx]) = i;
-        gridCellSize[idx]++;
-    }
-
-    end = high_resolution_clock::now();
-    megamol::core::utility::log::Log::DefaultLog.WriteInfo("PNhG search grid constructed in %u ms", std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
-    start = end;
-
-    edges.reserve(d.get_count() * 2 * 4); // something
-
     bool cycX = boundaryXCyclicSlot.Param<core::param::BoolParam>()->Value();
     bool cycY = boundaryYCyclicSlot.Param<core::param::BoolParam>()->Value();
     bool cycZ = boundaryZCyclicSlot.Param<core::param::BoolParam>()->Value();
 
-    // iterate over cells
-    int cellCnt = static_cast<int>(x_size * y_size * z_size);
+    float bboxSizeX = bboxR.Width();
+    float bboxSizeY = bboxR.Height();
+    float bboxSizeZ = bboxR.Depth();
+
+    // static schedule: the threads process consecutive particle ranges, so
+    // concatenating the per-thread edges in thread order sorts them by source
     int maxThreads = omp_get_max_threads();
-    std::vector<std::set<int> > neighborCellsMT(maxThreads); // all neighboring cells, from which particles need to be tested.
-    std::vector<std::vector<vislib::math::Point<float, 3> > > testPossMT(maxThreads); // all positions of this one particle to be tested.
-
-    float bboxSizeX = data->AccessBoundingBoxes().ObjectSpaceBBox().Width();
-    float bboxSizeY = data->AccessBoundingBoxes().ObjectSpaceBBox().Height();
-    float bboxSizeZ = data->AccessBoundingBoxes().ObjectSpaceBBox().Depth();
-
-    #pragma omp parallel for
-    for (int cellIdx = 0; cellIdx < cellCnt; ++cellIdx) {
-        int mt = omp_get_thread_num();
-        std::set<int>& neighborCells = neighborCellsMT[mt];
-        std::vector<vislib::math::Point<float, 3> >& testPoss = testPossMT[mt];
-        neighborCells.clear();
-
-        // cell coordinate from cell index
-        int cellX = cellIdx % x_size;
-        int cellZ = (cellIdx - cellX) / x_size;
-        int cellY = cellZ % y_size;
-        cellZ = (cellZ - cellY) / y_size;
-
-        // collect neighboring cells
-        for (int dx = -1; dx <= 1; ++dx) {
-            int x = cellX + dx;
-            if (x < 0) {
-                if (cycX) x = x_size - 1; else continue; // skip this x
-            }
-            if (x >= static_cast<int>(x_size)) {
-                if (cycX) x = 0; else continue; // skip this x
-            }
-            for (int dy = -1; dy <= 1; ++dy) {
-                int y = cellY + dy;
-                if (y < 0) {
-                    if (cycY) y = y_size - 1; else continue; // skip this y
-                }
-                if (y >= static_cast<int>(y_size)) {
-                    if (cycY) y = 0; else continue; // skip this y
-                }
-                for (int dz = -1; dz <= 1; ++dz) {
-                    int z = cellZ + dz;
-                    if (z < 0) {
-                        if (cycZ) z = z_size - 1; else continue; // skip this z
-                    }
-                    if (z >= static_cast<int>(z_size)) {
-                        if (cycZ) z = 0; else continue; // skip this z
-                    }
-                    neighborCells.insert(_COORD(x, y, z));
-                }
-            }
-        }
+    std::vector<std::vector<index_t> > edgesMT(maxThreads);
 
-        // for all points in the current cell
-        for (size_t locPtIdx = 0; locPtIdx < gridCellSize[cellIdx]; ++locPtIdx) {
+    #pragma omp parallel
+    {
+        std::vector<index_t>& localEdges = edgesMT[omp_get_thread_num()];
+        std::vector<vislib::math::Point<float, 3> > testPoss; // all positions of this one particle to be tested.
+        std::vector<size_t> neighbors;
+        AbstractSpatialIndex::match_list matches;
+
+        #pragma omp for schedule(static)
+        for (int64_t ptIdx = 0; ptIdx < static_cast<int64_t>(partCnt); ++ptIdx) {
             // point position
-            size_t ptIdx = gridCell[cellIdx][locPtIdx];
-            vislib::math::ShallowPoint<float, 3> ptOrigPos(const_cast<float*>(d.get_position(ptIdx)));
+            vislib::math::ShallowPoint<float, 3> ptOrigPos(const_cast<float*>(index->Position(ptIdx)));
             testPoss.clear();
 
             // multiply connections due to cyclic boundary tests
@@ -377,34 +297,30 @@ void ParticleNeighborhoodGraph::calcData(core::moldyn::MultiParticleDataCall* da
                 }
             }
 
-            for (int neiCellIdx : neighborCells) {
-                for (size_t locNPtIdx = 0; locNPtIdx < gridCellSize[neiCellIdx]; ++locNPtIdx) {
-                    // point to test
-                    size_t nPtIdx = gridCell[neiCellIdx][locNPtIdx];
-
-                     if (ptIdx >= nPtIdx) continue; // we only every construct edges from small to large indices
-
-                    vislib::math::ShallowPoint<float, 3> nPtPos(const_cast<float*>(d.get_position(nPtIdx)));
-                    for (vislib::math::Point<float, 3>& pt : testPoss) {
-                        float sqDist = pt.SquareDistance(nPtPos);
-                        if (sqDist < neiRadSq) {
-
-                            #pragma omp critical
-                            {
-                                edges.push_back(static_cast<index_t>(ptIdx));
-                                edges.push_back(static_cast<index_t>(nPtIdx));
-                            }
-
-                            break;
-                        }
-                    }
-
+            neighbors.clear();
+            for (vislib::math::Point<float, 3>& pt : testPoss) {
+                index->RadiusSearch(pt.PeekCoordinates(), neiRadSq, matches);
+                for (auto const& m : matches) {
+                    // we only every construct edges from small to large indices
+                    if (m.first > static_cast<size_t>(ptIdx)) neighbors.push_back(m.first);
                 }
             }
-        }
 
+            // a neighbor found over several boundaries is still connected only once
+            std::sort(neighbors.begin(), neighbors.end());
+            neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+            for (size_t nPtIdx : neighbors) {
+                localEdges.push_back(static_cast<index_t>(ptIdx));
+                localEdges.push_back(static_cast<index_t>(nPtIdx));
+            }
+        }
     }
 
+    size_t edgeValCnt = 0;
+    for (auto const& e : edgesMT) edgeValCnt += e.size();
+    edges.reserve(edgeValCnt);
+    for (auto const& e : edgesMT) edges.insert(edges.end(), e.begin(), e.end());
+
     end = high_resolution_clock::now();
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("PNhG edges computed in %u ms", std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count());
     start = end;
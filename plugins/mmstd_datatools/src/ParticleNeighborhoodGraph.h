@@ -64,6 +64,9 @@ namespace datatools {
         core::param::ParamSlot boundaryYCyclicSlot;
         core::param::ParamSlot boundaryZCyclicSlot;
 
+        /** The optional slot accessing a shared spatial index of the particle data */
+        core::CallerSlot inIndexSlot;
+
         unsigned int frameId;
         size_t inDataHash;
         size_t outDataHash;
@@ -0,0 +1,125 @@
+/*
+ * ParticleSpatialIndex.cpp
+ *
+ * Copyright (C) 2020 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+#include "ParticleSpatialIndex.h"
+#include "KDTreeSpatialIndex.h"
+#include "mmcore/utility/log/Log.h"
+
+using namespace megamol;
+using namespace megamol::stdplugin;
+
+
+/*
+ * datatools::ParticleSpatialIndex::ParticleSpatialIndex
+ */
+datatools::ParticleSpatialIndex::ParticleSpatialIndex(void)
+        : outIndexSlot("outIndex", "Provides the spatial index")
+        , inDataSlot("inData", "Takes the particle data")
+        , index(nullptr)
+        , datahash(0)
+        , frameID(0) {
+
+    this->outIndexSlot.SetCallback(ParticleSpatialIndexCall::ClassName(),
+        ParticleSpatialIndexCall::FunctionName(ParticleSpatialIndexCall::GET_DATA),
+        &ParticleSpatialIndex::getDataCallback);
+    this->outIndexSlot.SetCallback(ParticleSpatialIndexCall::ClassName(),
+        ParticleSpatialIndexCall::FunctionName(ParticleSpatialIndexCall::GET_EXTENT),
+        &ParticleSpatialIndex::getExtentCallback);
+    this->MakeSlotAvailable(&this->outIndexSlot);
+
+    this->inDataSlot.SetCompatibleCall<core::moldyn::MultiParticleDataCallDescription>();
+    this->MakeSlotAvailable(&this->inDataSlot);
+}
+
+
+/*
+ * datatools::ParticleSpatialIndex::~ParticleSpatialIndex
+ */
+datatools::ParticleSpatialIndex::~ParticleSpatialIndex(void) {
+    this->Release();
+}
+
+
+/*
+ * datatools::ParticleSpatialIndex::create
+ */
+bool datatools::ParticleSpatialIndex::create(void) {
+    return true;
+}
+
+
+/*
+ * datatools::ParticleSpatialIndex::release
+ */
+void datatools::ParticleSpatialIndex::release(void) {
+    this->index.reset();
+}
+
+
+/*
+ * datatools::ParticleSpatialIndex::getDataCallback
+ */
+bool datatools::ParticleSpatialIndex::getDataCallback(megamol::core::Call& c) {
+    using core::moldyn::MultiParticleDataCall;
+
+    auto *outCall = dynamic_cast<ParticleSpatialIndexCall*>(&c);
+    if (outCall == nullptr) return false;
+
+    auto *inCall = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (inCall == nullptr) return false;
+
+    const unsigned int time = outCall->FrameID();
+    inCall->SetFrameID(time, true);
+    if (!(*inCall)(1)) return false;
+    inCall->SetFrameID(time, true);
+    if (!(*inCall)(0)) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            "ParticleSpatialIndex: could not get frame (%u)", time);
+        return false;
+    }
+
+    if ((this->index == nullptr) || (this->frameID != inCall->FrameID()) || (this->datahash != inCall->DataHash())) {
+        this->index = KDTreeSpatialIndex::Build(*inCall);
+        this->frameID = inCall->FrameID();
+        this->datahash = inCall->DataHash();
+    }
+
+    outCall->SetFrameCount(inCall->FrameCount());
+    outCall->SetFrameID(this->frameID);
+    outCall->SetDataHash(this->datahash);
+    outCall->AccessBoundingBoxes() = inCall->AccessBoundingBoxes();
+    outCall->SetIndex(this->index);
+
+    // the index holds its own copy of the positions
+    inCall->Unlock();
+
+    return true;
+}
+
+
+/*
+ * datatools::ParticleSpatialIndex::getExtentCallback
+ */
+bool datatools::ParticleSpatialIndex::getExtentCallback(megamol::core::Call& c) {
+    using core::moldyn::MultiParticleDataCall;
+
+    auto *outCall = dynamic_cast<ParticleSpatialIndexCall*>(&c);
+    if (outCall == nullptr) return false;
+
+    auto *inCall = this->inDataSlot.CallAs<MultiParticleDataCall>();
+    if (inCall == nullptr) return false;
+
+    inCall->SetFrameID(outCall->FrameID(), true);
+    if (!(*inCall)(1)) return false;
+
+    outCall->SetFrameCount(inCall->FrameCount());
+    outCall->SetDataHash(inCall->DataHash());
+    outCall->AccessBoundingBoxes() = inCall->AccessBoundingBoxes();
+    inCall->Unlock();
+
+    return true;
+}
@@ -0,0 +1,83 @@
+/*
+ * ParticleSpatialIndex.h
+ *
+ * Copyright (C) 2020 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_DATATOOLS_PARTICLESPATIALINDEX_H_INCLUDED
+#define MMSTD_DATATOOLS_PARTICLESPATIALINDEX_H_INCLUDED
+#pragma once
+
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+#include "mmcore/Module.h"
+#include "mmcore/moldyn/MultiParticleDataCall.h"
+#include "mmstd_datatools/ParticleSpatialIndexCall.h"
+#include <memory>
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+
+    /**
+     * Module building one spatial index per frame over particle data and
+     * sharing it with any number of downstream modules.
+     */
+    class ParticleSpatialIndex : public megamol::core::Module {
+    public:
+
+        /** Return module class name */
+        static const char *ClassName(void) {
+            return "ParticleSpatialIndex";
+        }
+
+        /** Return module class description */
+        static const char *Description(void) {
+            return "Builds a kd-tree over particle positions and shares it for neighbourhood queries.";
+        }
+
+        /** Module is always available */
+        static bool IsAvailable(void) {
+            return true;
+        }
+
+        /** Ctor */
+        ParticleSpatialIndex(void);
+
+        /** Dtor */
+        virtual ~ParticleSpatialIndex(void);
+
+    protected:
+
+        /** Lazy initialization of the module */
+        virtual bool create(void);
+
+        /** Resource release */
+        virtual void release(void);
+
+    private:
+
+        bool getDataCallback(megamol::core::Call& c);
+
+        bool getExtentCallback(megamol::core::Call& c);
+
+        /** The slot providing the index */
+        megamol::core::CalleeSlot outIndexSlot;
+
+        /** The slot accessing the particle data */
+        megamol::core::CallerSlot inDataSlot;
+
+        /** The index of the current frame */
+        std::shared_ptr<const AbstractSpatialIndex> index;
+
+        size_t datahash;
+        unsigned int frameID;
+
+    };
+
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* MMSTD_DATATOOLS_PARTICLESPATIALINDEX_H_INCLUDED */
@@ -0,0 +1,19 @@
+/*
+ * ParticleSpatialIndexCall.cpp
+ *
+ * Copyright (C) 2020 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+#include "mmstd_datatools/ParticleSpatialIndexCall.h"
+
+using namespace megamol;
+using namespace megamol::stdplugin::datatools;
+
+ParticleSpatialIndexCall::ParticleSpatialIndexCall(void) : core::AbstractGetData3DCall(), index(nullptr) {
+    // intentionally empty
+}
+
+ParticleSpatialIndexCall::~ParticleSpatialIndexCall(void) {
+    index.reset();
+}
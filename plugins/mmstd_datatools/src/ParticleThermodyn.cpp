@@ -6,6 +6,7 @@
  */
 #include "stdafx.h"
 #include "ParticleThermodyn.h"
+#include "KDTreeSpatialIndex.h"
 #include <algorithm>
 #include <array>
 #include <cassert>
@@ -52,12 +53,12 @@ datatools::ParticleThermodyn::ParticleThermodyn(void)
     , datahash(0)
     , lastTime(-1)
     , newColors()
-    , allParts()
     , maxDist(0.0f)
-    , particleTree(nullptr)
-    , myPts(nullptr)
+    , particleIndex(nullptr)
+    , velocities()
     , outDataSlot("outData", "Provides intensities based on a local particle metric")
-    , inDataSlot("inData", "Takes the directional particle data") {
+    , inDataSlot("inData", "Takes the directional particle data")
+    , inIndexSlot("inIndex", "Optionally takes a shared spatial index of the particle data") {
 
     this->cyclXSlot.SetParameter(new core::param::BoolParam(true));
     this->MakeSlotAvailable(&this->cyclXSlot);
@@ -130,6 +131,9 @@ datatools::ParticleThermodyn::ParticleThermodyn(void)
 
     this->inDataSlot.SetCompatibleCall<megamol::core::moldyn::MultiParticleDataCallDescription>();
     this->MakeSlotAvailable(&this->inDataSlot);
+
+    this->inIndexSlot.SetCompatibleCall<ParticleSpatialIndexCallDescription>();
+    this->MakeSlotAvailable(&this->inIndexSlot);
 }
 
 
@@ -200,7 +204,8 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
     const auto theFluidDensity = this->fluidDensitySlot.Param<core::param::FloatParam>()->Value();
     size_t allpartcnt = 0;
 
-    if (this->lastTime != time || this->datahash != in->DataHash()) {
+    // the metric decides which lists are used, so changing it renumbers the particles
+    if (this->lastTime != time || this->datahash != in->DataHash() || this->metricsSlot.IsDirty()) {
         in->SetFrameID(time, true);
 
         if (!(*in)(0)) {
@@ -212,8 +217,12 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
         plc = in->GetParticleListCount();
 
         for (unsigned int i = 0; i < plc; i++) {
-            if (isListOK(in, i) && isDirOK(static_cast<metricsEnum>(theMetrics), in, i))
+            if (isListOK(in, i) && isDirOK(static_cast<metricsEnum>(theMetrics), in, i)) {
                 totalParts += in->AccessParticles(i).GetCount();
+            } else {
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "ParticleThermodyn: ignoring list %d because it either has no proper positions or no velocity", i);
+            }
         }
 
         if (theSearchType == searchTypeEnum::RADIUS) {
@@ -222,45 +231,20 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
             this->newColors.resize(totalParts);
         }
 
-        allParts.clear();
-        allParts.reserve(totalParts);
+        // only the lists used for the metric are indexed, so the index numbering is the one of the colours
+        this->particleIndex = KDTreeSpatialIndex::Acquire(this->inIndexSlot, *in,
+            [&](unsigned int pli) { return isDirOK(static_cast<metricsEnum>(theMetrics), in, pli); },
+            "ParticleThermodyn");
 
-        // we could now filter particles according to something. but currently we need not.
-        allpartcnt = 0;
+        // velocities in index numbering, zero for lists without velocity if the metric does not need them
+        this->velocities.resize(3 * this->particleIndex->Count());
         for (unsigned int pli = 0; pli < plc; pli++) {
-            auto& pl = in->AccessParticles(pli);
-            if (!isListOK(in, pli) || !isDirOK(static_cast<metricsEnum>(theMetrics), in, pli)) {
-                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
-                    "ParticleThermodyn: ignoring list %d because it either has no proper positions or no velocity",
-                    pli);
-                continue;
-            }
-
-            // unsigned int vert_stride = 0;
-            // if (pl.GetVertexDataType() == DirectionalParticleDataCall::Particles::VertexDataType::VERTDATA_FLOAT_XYZ)
-            // vert_stride = 12; else if (pl.GetVertexDataType() ==
-            // DirectionalParticleDataCall::Particles::VertexDataType::VERTDATA_FLOAT_XYZR) vert_stride = 16; else
-            // continue; vert_stride = std::max<unsigned int>(vert_stride, pl.GetVertexDataStride()); const unsigned char
-            // *vert = static_cast<const unsigned char*>(pl.GetVertexData());
-
-            UINT64 part_cnt = pl.GetCount();
-
-            for (int part_i = 0; part_i < part_cnt; ++part_i) {
-                allParts.push_back(allpartcnt + part_i);
-            }
-            allpartcnt += pl.GetCount();
+            const size_t begin = this->particleIndex->ListOffset(pli);
+            const size_t cnt = this->particleIndex->ListOffset(pli + 1) - begin;
+            if (cnt == 0) continue;
+            in->AccessParticles(pli).GetParticleStore().GetDirections(0, cnt, this->velocities.data() + 3 * begin);
         }
 
-        // allocate nanoflann data structures for border
-        assert(allpartcnt == totalParts);
-        this->myPts = std::make_shared<simplePointcloud>(in, allParts);
-
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: building acceleration structure...");
-        particleTree = std::make_shared<my_kd_tree_t>(
-            3 /* dim */, *myPts, nanoflann::KDTreeSingleIndexAdaptorParams(10 /* max leaf */));
-        particleTree->buildIndex();
-        megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticleThermodyn: done.");
-
         this->datahash = in->DataHash();
         this->lastTime = time;
         this->radiusSlot.ForceSetDirty();
@@ -298,12 +282,12 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
         auto const T_c = tcSlot.Param<core::param::FloatParam>()->Value();
         auto const rho_c = rhocSlot.Param<core::param::FloatParam>()->Value();
 
-        allpartcnt = 0;
         for (unsigned int pli = 0; pli < plc; pli++) {
             auto& pl = in->AccessParticles(pli);
             if (!isListOK(in, pli) || !isDirOK(static_cast<metricsEnum>(theMetrics), in, pli)) {
                 continue;
             }
+            const size_t indexOffset = this->particleIndex->ListOffset(pli);
 
             int num_thr = omp_get_max_threads();
             INT64 counter = 0;
@@ -323,9 +307,6 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                 std::vector<std::pair<size_t, float>> ret_localMatches;
                 std::vector<size_t> ret_index(theNumber);
                 std::vector<float> out_dist_sqr(theNumber);
-                nanoflann::KNNResultSet<float> resultSet(theNumber);
-                nanoflann::SearchParams params;
-                params.sorted = false;
                 ret_matches.reserve(100);
                 ret_localMatches.reserve(100);
                 int threadIdx = omp_get_thread_num();
@@ -334,10 +315,9 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
 #pragma omp for
                 for (INT64 part_i = 0; part_i < part_cnt; ++part_i) {
 
-                    INT64 myIndex = part_i + allpartcnt;
+                    const size_t myIndex = indexOffset + part_i;
                     ret_matches.clear();
-                    const float* vertexBase = this->myPts->get_position(myIndex);
-                    // const float *velocityBase = this->myPts->get_velocity(myIndex);
+                    const float* vertexBase = this->particleIndex->Position(myIndex);
 
                     for (int x_s = 0; x_s < (cycl_x ? 2 : 1); ++x_s) {
                         for (int y_s = 0; y_s < (cycl_y ? 2 : 1); ++y_s) {
@@ -359,8 +339,8 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                                 if (theSearchType == searchTypeEnum::RADIUS) {
                                     // the documentation says the parameter radius for L2 is squared
                                     // caution: the criterion is < radius, not <= !!!!
-                                    particleTree->radiusSearch(
-                                        theVertex, theSquaredRadius + eps, ret_localMatches, params);
+                                    particleIndex->RadiusSearch(
+                                        theVertex, theSquaredRadius + eps, ret_localMatches);
                                     if (remove_self) {
                                         ret_localMatches.erase(
                                             std::remove_if(ret_localMatches.begin(), ret_localMatches.end(),
@@ -372,9 +352,9 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                                     ret_matches.insert(
                                         ret_matches.end(), ret_localMatches.begin(), ret_localMatches.end());
                                 } else {
-                                    resultSet.init(ret_index.data(), out_dist_sqr.data());
-                                    particleTree->findNeighbors(resultSet, theVertex, params);
-                                    for (size_t i = 0; i < resultSet.size(); ++i) {
+                                    const size_t found = particleIndex->KNearest(
+                                        theVertex, theNumber, ret_index.data(), out_dist_sqr.data());
+                                    for (size_t i = 0; i < found; ++i) {
                                         if (!remove_self || ret_index[i] != myIndex) {
                                             ret_matches.push_back(
                                                 std::pair<size_t, float>(ret_index[i], out_dist_sqr[i]));
@@ -499,7 +479,6 @@ bool datatools::ParticleThermodyn::assertData(core::moldyn::MultiParticleDataCal
                 if (metricMin[i] < theMinTemp) theMinTemp = metricMin[i];
                 if (metricMax[i] > theMaxTemp) theMaxTemp = metricMax[i];
             }
-            allpartcnt += pl.GetCount();
         }
         cpb.Stop();
 
@@ -563,7 +542,7 @@ float megamol::stdplugin::datatools::ParticleThermodyn::computeTemperature(
     std::array<float, 3> sq_sum = {0, 0, 0};
     std::array<float, 3> the_temperature = {0, 0, 0};
     for (size_t i = 0; i < num_matches; ++i) {
-        const float* velo = myPts->get_velocity(matches[i].first);
+        const float* velo = this->velocities.data() + 3 * matches[i].first;
         for (int c = 0; c < 3; ++c) {
             float v = velo[c];
             sum[c] += v;
@@ -591,7 +570,7 @@ float megamol::stdplugin::datatools::ParticleThermodyn::computeFractionalAnisotr
     mat.fill(0.0f);
 
     for (size_t i = 0; i < num_matches; ++i) {
-        const float* velo = myPts->get_velocity(matches[i].first);
+        const float* velo = this->velocities.data() + 3 * matches[i].first;
         for (int x = 0; x < 3; ++x)
             for (int y = 0; y < 3; ++y) mat(x, y) += velo[x] * velo[y];
     }
@@ -621,7 +600,7 @@ float megamol::stdplugin::datatools::ParticleThermodyn::computeDensity(std::vect
     std::vector<float> part;
     part.reserve(num_matches * 4);
     for (size_t i = 0; i < num_matches; ++i) {
-        auto coord = myPts->get_position(matches[i].first);
+        auto coord = particleIndex->Position(matches[i].first);
         part.push_back(
             cycl_x ? coord[0] - bbox.Width() * std::nearbyintf((coord[0] - curPoint[0]) / bbox.Width()) : coord[0]);
         part.push_back(
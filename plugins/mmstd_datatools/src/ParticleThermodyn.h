@@ -14,9 +14,9 @@
 #include "mmcore/CallerSlot.h"
 #include "mmcore/Module.h"
 #include "mmcore/moldyn/MultiParticleDataCall.h"
-#include "PointcloudHelpers.h"
+#include "mmstd_datatools/ParticleSpatialIndexCall.h"
+#include <memory>
 #include <vector>
-#include <nanoflann.hpp>
 #include <Eigen/Eigenvalues>
 
 namespace megamol {
@@ -128,19 +128,15 @@ namespace datatools {
         size_t myHash = 0;
         int lastTime;
         std::vector<float> newColors;
-        std::vector<size_t> allParts;
         float maxDist;
 
         Eigen::SelfAdjointEigenSolver<Eigen::Matrix3f> eigensolver;
 
-        typedef nanoflann::KDTreeSingleIndexAdaptor<
-            nanoflann::L2_Simple_Adaptor<float, simplePointcloud>,
-            simplePointcloud,
-            3 /* dim */
-        > my_kd_tree_t;
+        /** The spatial index, either shared via inIndexSlot or built locally */
+        std::shared_ptr<const AbstractSpatialIndex> particleIndex;
 
-        std::shared_ptr<my_kd_tree_t> particleTree;
-        std::shared_ptr<simplePointcloud> myPts;
+        /** Packed xyz velocities in the numbering of particleIndex */
+        std::vector<float> velocities;
 
         /** The slot providing access to the manipulated data */
         megamol::core::CalleeSlot outDataSlot;
@@ -148,6 +144,9 @@ namespace datatools {
         /** The slot accessing the original data */
         megamol::core::CallerSlot inDataSlot;
 
+        /** The optional slot accessing a shared spatial index of the original data */
+        megamol::core::CallerSlot inIndexSlot;
+
     };
 
 } /* end namespace datatools */
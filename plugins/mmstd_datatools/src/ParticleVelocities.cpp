@@ -8,7 +8,6 @@
 #include "ParticleVelocities.h"
 #include "mmcore/param/BoolParam.h"
 #include "mmcore/param/FloatParam.h"
-#include <nanoflann.hpp>
 #include "mmcore/utility/log/Log.h"
 #include "vislib/math/ShallowVector.h"
 #include "vislib/math/ShallowPoint.h"
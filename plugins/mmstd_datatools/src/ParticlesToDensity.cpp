@@ -15,6 +15,7 @@
 #include "mmcore/param/IntParam.h"
 #include "mmcore/param/FloatParam.h"
 
+#include "mmstd_datatools/VolumeBricking.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 #include "mmcore/utility/log/Log.h"
@@ -112,6 +113,12 @@ datatools::ParticlesToDensity::ParticlesToDensity(void)
     this->outDataSlot.SetCallback(core::misc::VolumetricDataCall::ClassName(),
         core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_TRY_GET_DATA),
         &ParticlesToDensity::dummyCallback);
+    this->outDataSlot.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_RANGES),
+        &ParticlesToDensity::dummyCallback);
+    this->outDataSlot.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+        core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_REGION),
+        &ParticlesToDensity::dummyCallback);
     this->MakeSlotAvailable(&this->outDataSlot);
 
     this->outParticlesSlot.SetCallback(core::moldyn::MultiParticleDataCall::ClassName(),
@@ -245,7 +252,7 @@ bool datatools::ParticlesToDensity::getDataCallback(megamol::core::Call& c) {
     // TODO set data
     if (outVol != nullptr) {
         outVol->SetFrameID(this->time);
-        outVol->SetData(this->vol[0].data());
+        outVol->SetData(this->vol.data());
         metadata.Components = is_vector ? 3 : 1;
         metadata.GridType = core::misc::GridType_t::CARTESIAN;
         metadata.Resolution[0] = static_cast<size_t>(this->xResSlot.Param<core::param::IntParam>()->Value());
@@ -292,7 +299,7 @@ bool datatools::ParticlesToDensity::getDataCallback(megamol::core::Call& c) {
         this->zResSlot.Param<core::param::IntParam>()->Value()); outVol->SetComponents(1);
         outVol->SetMinimumDensity(0.0f);
         outVol->SetMaximumDensity(this->maxDens);
-        outVol->SetVoxelMapPointer(this->vol[0].data());*/
+        outVol->SetVoxelMapPointer(this->vol.data());*/
         // inMpdc->Unlock();
     }
 
@@ -392,16 +399,10 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
 
     bool const is_vector = this->aggregatorSlot.Param<core::param::EnumParam>()->Value() == 2;
 
-    vol.resize(omp_get_max_threads());
-    std::vector<std::vector<float>> weights(omp_get_max_threads());
-#pragma omp parallel for
-    for (int init = 0; init < omp_get_max_threads(); ++init) {
-        vol[init].resize(sx * sy * sz * (is_vector ? 3 : 1));
-        std::fill(vol[init].begin(), vol[init].end(), 0.0f);
-
-        weights[init].resize(sx * sy * sz);
-        std::fill(weights[init].begin(), weights[init].end(), 0.0f);
-    }
+    // a single output volume, the splatting below gives every brick of it to exactly one thread
+    vol.assign(static_cast<size_t>(sx) * sy * sz * (is_vector ? 3 : 1), 0.0f);
+    std::vector<float> weights(is_vector ? static_cast<size_t>(sx) * sy * sz : 0, 0.0f);
+    datatools::VolumeBricking const bricking(sx, sy, sz);
 
     // TODO: the whole code is wrong since we might not have the bounding box for the actual cyclic boundary conditions.
 
@@ -492,11 +493,11 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
                 auto const val_y = dyAcc->Get_f(pidx);
                 auto const val_z = dzAcc->Get_f(pidx);
 
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 0] += rbf(dis, sigma * rad) * val_x;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 1] += rbf(dis, sigma * rad) * val_y;
-                vol[omp_get_thread_num()][(x + (y + z * sy) * sx) * 3 + 2] += rbf(dis, sigma * rad) * val_z;
+                vol[(x + (y + z * sy) * sx) * 3 + 0] += rbf(dis, sigma * rad) * val_x;
+                vol[(x + (y + z * sy) * sx) * 3 + 1] += rbf(dis, sigma * rad) * val_y;
+                vol[(x + (y + z * sy) * sx) * 3 + 2] += rbf(dis, sigma * rad) * val_z;
 
-                weights[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
+                weights[x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
             };
         } break;
         case 1: {
@@ -505,7 +506,7 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
                 if (rad == 0.0f) return;
 
                 auto const val = iAcc->Get_f(pidx);
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad) * val;
+                vol[x + (y + z * sy) * sx] += rbf(dis, sigma * rad) * val;
             };
         } break;
         default:
@@ -514,7 +515,7 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
                         float const dis, float const rad) -> void {
                 if (rad == 0.0f) return;
 
-                vol[omp_get_thread_num()][x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
+                vol[x + (y + z * sy) * sx] += rbf(dis, sigma * rad);
             };
         }
         }
@@ -549,90 +550,129 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
         }
 #endif
 
-#pragma omp parallel for
-        for (int64_t j = 0; j < parts.GetCount(); ++j) {
-            auto const x_base = xAcc->Get_f(j);
-            auto x = static_cast<int>((x_base - minOSx) / sliceDistX);
-            auto const y_base = yAcc->Get_f(j);
-            auto y = static_cast<int>((y_base - minOSy) / sliceDistY);
-            auto const z_base = zAcc->Get_f(j);
-            auto z = static_cast<int>((z_base - minOSz) / sliceDistZ);
+        // inclusive voxel range of the filter footprint of a particle, before wrapping
+        auto const footprint = [&](int64_t const j, int lo[3], int hi[3]) -> float {
             auto rad = globRad;
             if (!useGlobRad) rad = rAcc->Get_f(j);
+            int const center[3] = {static_cast<int>((xAcc->Get_f(j) - minOSx) / sliceDistX),
+                static_cast<int>((yAcc->Get_f(j) - minOSy) / sliceDistY),
+                static_cast<int>((zAcc->Get_f(j) - minOSz) / sliceDistZ)};
+            int const filterSize[3] = {static_cast<int>(std::ceil(rad / sliceDistX)),
+                static_cast<int>(std::ceil(rad / sliceDistY)), static_cast<int>(std::ceil(rad / sliceDistZ))};
+            for (int d = 0; d < 3; ++d) {
+                lo[d] = center[d] - filterSize[d];
+                hi[d] = center[d] + filterSize[d];
+            }
+            return rad;
+        };
 
-            int const filterSizeX = static_cast<int>(std::ceil(rad / sliceDistX));
-            int const filterSizeY = static_cast<int>(std::ceil(rad / sliceDistY));
-            int const filterSizeZ = static_cast<int>(std::ceil(rad / sliceDistZ));
-
-            for (int hz = z - filterSizeZ; hz <= z + filterSizeZ; ++hz) {
-                for (int hy = y - filterSizeY; hy <= y + filterSizeY; ++hy) {
-                    for (int hx = x - filterSizeX; hx <= x + filterSizeX; ++hx) {
-                        auto tmp_hx = hx;
-                        auto tmp_hy = hy;
-                        auto tmp_hz = hz;
-                        if (cycl_x) {
-                            tmp_hx = (hx + 2 * sx) % sx;
-                        } else {
-                            if (hx < 0 || hx > sx - 1) {
-                                continue;
-                            }
-                        }
-                        if (cycl_y) {
-                            tmp_hy = (hy + 2 * sy) % sy;
-                        } else {
-                            if (hy < 0 || hy > sy - 1) {
-                                continue;
-                            }
-                        }
-                        if (cycl_z) {
-                            tmp_hz = (hz + 2 * sz) % sz;
-                        } else {
-                            if (hz < 0 || hz > sz - 1) {
-                                continue;
-                            }
-                        }
+        int const res[3] = {sx, sy, sz};
+        bool const cycl[3] = {cycl_x, cycl_y, cycl_z};
+        auto const wrap = [&res, &cycl](int const d, int const h) { return cycl[d] ? (h + 2 * res[d]) % res[d] : h; };
+
+        // bricks along one axis touched by the voxel range [lo, hi]
+        auto const axisBricks = [&bricking, &res, &cycl](int const d, int lo, int hi, std::vector<int>& out) {
+            out.clear();
+            if (!cycl[d]) {
+                lo = std::max(lo, 0);
+                hi = std::min(hi, res[d] - 1);
+                for (int b = bricking.BrickCoord(lo); lo <= hi && b <= bricking.BrickCoord(hi); ++b) out.push_back(b);
+            } else if (hi - lo + 1 >= res[d]) {
+                for (int b = 0; b < bricking.Count(d); ++b) out.push_back(b);
+            } else {
+                auto const wlo = (lo % res[d] + res[d]) % res[d];
+                auto const whi = wlo + (hi - lo);
+                for (int b = bricking.BrickCoord(wlo); b <= bricking.BrickCoord(std::min(whi, res[d] - 1)); ++b) {
+                    out.push_back(b);
+                }
+                if (whi >= res[d]) {
+                    for (int b = 0; b <= bricking.BrickCoord(whi - res[d]); ++b) {
+                        if (std::find(out.begin(), out.end(), b) == out.end()) out.push_back(b);
+                    }
+                }
+            }
+        };
 
-                        float x_diff = static_cast<float>(hx) * sliceDistX + minOSx;
-                        x_diff = std::fabs(x_diff - x_base);
-                        // if (x_diff > halfRangeOSx) x_diff -= rangeOSx;
+        auto const bricksOf = [&](int64_t const j, std::vector<int>& bricks) {
+            thread_local std::vector<int> axis[3];
+            int lo[3], hi[3];
+            footprint(j, lo, hi);
+            for (int d = 0; d < 3; ++d) {
+                axisBricks(d, lo[d], hi[d], axis[d]);
+            }
+            for (auto const bz : axis[2]) {
+                for (auto const by : axis[1]) {
+                    for (auto const bx : axis[0]) {
+                        bricks.push_back(bricking.Index(bx, by, bz));
+                    }
+                }
+            }
+        };
+
+        std::vector<size_t> brickOffsets;
+        std::vector<int64_t> brickParticles;
+        bricking.Bin(static_cast<int64_t>(parts.GetCount()), bricksOf, brickOffsets, brickParticles);
+
+#pragma omp parallel for schedule(dynamic)
+        for (int64_t b = 0; b < bricking.Count(); ++b) {
+            int brickLo[3], brickHi[3];
+            bricking.Extent(static_cast<int>(b), brickLo, brickHi);
+            // unwrapped voxel coordinates of the footprint which fall into this brick
+            std::vector<int> h[3];
+
+            for (auto k = brickOffsets[b]; k < brickOffsets[b + 1]; ++k) {
+                auto const j = brickParticles[k];
+                auto const x_base = xAcc->Get_f(j);
+                auto const y_base = yAcc->Get_f(j);
+                auto const z_base = zAcc->Get_f(j);
+                int lo[3], hi[3];
+                auto const rad = footprint(j, lo, hi);
+
+                for (int d = 0; d < 3; ++d) {
+                    h[d].clear();
+                    for (int v = lo[d]; v <= hi[d]; ++v) {
+                        auto const w = wrap(d, v);
+                        if (w >= brickLo[d] && w < brickHi[d]) h[d].push_back(v);
+                    }
+                }
+
+                for (auto const hz : h[2]) {
+                    float z_diff = static_cast<float>(hz) * sliceDistZ + minOSz;
+                    z_diff = std::fabs(z_diff - z_base);
+                    for (auto const hy : h[1]) {
                         float y_diff = static_cast<float>(hy) * sliceDistY + minOSy;
                         y_diff = std::fabs(y_diff - y_base);
-                        // if (y_diff > halfRangeOSy) y_diff -= rangeOSy;
-                        float z_diff = static_cast<float>(hz) * sliceDistZ + minOSz;
-                        z_diff = std::fabs(z_diff - z_base);
-                        // if (z_diff > halfRangeOSz) z_diff -= rangeOSz;
-                        float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
+                        for (auto const hx : h[0]) {
+                            float x_diff = static_cast<float>(hx) * sliceDistX + minOSx;
+                            x_diff = std::fabs(x_diff - x_base);
+                            float const dis = std::sqrt(x_diff * x_diff + y_diff * y_diff + z_diff * z_diff);
 
-                        volOp(j, tmp_hx, tmp_hy, tmp_hz, dis, rad);
+                            volOp(j, wrap(0, hx), wrap(1, hy), wrap(2, hz), dis, rad);
+                        }
                     }
                 }
             }
         }
     }
 
-    for (int i = 1; i < omp_get_max_threads(); ++i) {
-        std::transform(vol[i].begin(), vol[i].end(), vol[0].begin(), vol[0].begin(), std::plus<>());
-        std::transform(weights[i].begin(), weights[i].end(), weights[0].begin(), weights[0].begin(), std::plus<>());
-    }
-
     if (is_vector) {
-        this->directions.resize(vol[0].size());
-        this->colors.resize(vol[0].size() / 3);
-        this->densities.resize(vol[0].size() / 3);
+        this->directions.resize(vol.size());
+        this->colors.resize(vol.size() / 3);
+        this->densities.resize(vol.size() / 3);
         maxDens = 0.0f;
         minDens = std::numeric_limits<float>::max();
-        for (std::size_t i = 0; i < vol[0].size() / 3; ++i) {
-            vol[0][i * 3 + 0] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 1] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
-            vol[0][i * 3 + 2] /= weights[0][i] == 0.0f ? 1.0f : weights[0][i];
+        for (std::size_t i = 0; i < vol.size() / 3; ++i) {
+            vol[i * 3 + 0] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[i * 3 + 1] /= weights[i] == 0.0f ? 1.0f : weights[i];
+            vol[i * 3 + 2] /= weights[i] == 0.0f ? 1.0f : weights[i];
 
             const float density =
-                std::sqrt(vol[0][i * 3 + 0] * vol[0][i * 3 + 0] + vol[0][i * 3 + 1] * vol[0][i * 3 + 1] +
-                          vol[0][i * 3 + 2] * vol[0][i * 3 + 2]);
+                std::sqrt(vol[i * 3 + 0] * vol[i * 3 + 0] + vol[i * 3 + 1] * vol[i * 3 + 1] +
+                          vol[i * 3 + 2] * vol[i * 3 + 2]);
 
-            this->directions[i * 3 + 0] = density == 0.0f ? 0.0f : vol[0][i * 3 + 0] / density;
-            this->directions[i * 3 + 1] = density == 0.0f ? 0.0f : vol[0][i * 3 + 1] / density;
-            this->directions[i * 3 + 2] = density == 0.0f ? 0.0f : vol[0][i * 3 + 2] / density;
+            this->directions[i * 3 + 0] = density == 0.0f ? 0.0f : vol[i * 3 + 0] / density;
+            this->directions[i * 3 + 1] = density == 0.0f ? 0.0f : vol[i * 3 + 1] / density;
+            this->directions[i * 3 + 2] = density == 0.0f ? 0.0f : vol[i * 3 + 2] / density;
 
             this->infoData[i * this->info.size() + 3] = this->directions[i * 3 + 0];
             this->infoData[i * this->info.size() + 4] = this->directions[i * 3 + 1];
@@ -641,10 +681,10 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
             maxDens = std::max(maxDens, density);
             minDens = std::min(minDens, density);
         }
-        for (std::size_t i = 0; i < vol[0].size() / 3; ++i) {
+        for (std::size_t i = 0; i < vol.size() / 3; ++i) {
             const float density =
-                std::sqrt(vol[0][i * 3 + 0] * vol[0][i * 3 + 0] + vol[0][i * 3 + 1] * vol[0][i * 3 + 1] +
-                          vol[0][i * 3 + 2] * vol[0][i * 3 + 2]);
+                std::sqrt(vol[i * 3 + 0] * vol[i * 3 + 0] + vol[i * 3 + 1] * vol[i * 3 + 1] +
+                          vol[i * 3 + 2] * vol[i * 3 + 2]);
 
             this->colors[i] = (density - minDens) / (maxDens - minDens);
             this->densities[i] = density;
@@ -656,15 +696,15 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
             }
         }
     } else {
-        maxDens = *std::max_element(vol[0].begin(), vol[0].end());
-        minDens = *std::min_element(vol[0].begin(), vol[0].end());
+        maxDens = *std::max_element(vol.begin(), vol.end());
+        minDens = *std::min_element(vol.begin(), vol.end());
     }
 
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticlesToDensity: Captured density %f -> %f", minDens, maxDens);
 
     if (this->normalizeSlot.Param<core::param::BoolParam>()->Value()) {
         auto const rcpValRange = 1.0f / (maxDens - minDens);
-        std::transform(vol[0].begin(), vol[0].end(), vol[0].begin(),
+        std::transform(vol.begin(), vol.end(), vol.begin(),
             [this, rcpValRange](float const& a) { return (a - minDens) * rcpValRange; });
         minDens = 0.0f;
         maxDens = 1.0f;
@@ -718,14 +758,11 @@ bool datatools::ParticlesToDensity::createVolumeCPU(class megamol::core::moldyn:
 //#define PTD_DEBUG_OUTPUT
 #ifdef PTD_DEBUG_OUTPUT
     std::ofstream raw_file{"bolla.raw", std::ios::binary};
-    raw_file.write(reinterpret_cast<char const*>(vol[0].data()), vol[0].size() * sizeof(float));
+    raw_file.write(reinterpret_cast<char const*>(vol.data()), vol.size() * sizeof(float));
     raw_file.close();
     megamol::core::utility::log::Log::DefaultLog.WriteInfo("ParticlesToDensity: Debug file written\n");
 #endif
 
-    // Cleanup
-    vol.resize(1);
-
     const auto endTime = std::chrono::high_resolution_clock::now();
     std::chrono::duration<float, std::milli> diffMillis = endTime - startTime;
     megamol::core::utility::log::Log::DefaultLog.WriteInfo(
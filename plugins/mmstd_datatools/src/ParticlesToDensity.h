@@ -116,7 +116,7 @@ private:
 
     core::param::ParamSlot surfaceSlot;
 
-    std::vector<std::vector<float>> vol;
+    std::vector<float> vol;
     std::vector<float> directions, colors, densities;
     std::vector<float> grid;
 
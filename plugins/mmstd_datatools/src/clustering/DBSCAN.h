@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 #include "PointcloudHelpers.h"
@@ -25,57 +28,102 @@ template<typename T>
 using search_res_t = std::vector<std::pair<index_t, T>>;
 
 // see https://de.wikipedia.org/wiki/DBSCAN for algorithm
+//
+// The clustering runs in three parallel passes over the points instead of growing clusters one by one:
+// 1. core points are detected by counting neighbours,
+// 2. neighbouring core points are merged in a concurrent union-find forest, border points pick their core
+//    neighbour with the lowest index,
+// 3. clusters are labelled in the order of their lowest core point, so the result does not depend on the
+//    number of threads or the scheduling.
+
+using union_find_t = std::vector<std::atomic<index_t>>;
+
+/** Finds the root of 'x' and halves the path on the way. Roots are always the smallest index of their set. */
+inline index_t uf_find(union_find_t& parent, index_t x) {
+    while (true) {
+        auto p = parent[x].load(std::memory_order_relaxed);
+        if (p == x) return x;
+        auto const gp = parent[p].load(std::memory_order_relaxed);
+        if (p != gp) parent[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+    }
+}
 
-template<typename T, int DIM>
-inline void expand_cluster(std::shared_ptr<kd_tree_t<T, DIM>> const& D, index_t P, search_res_t<T> Nvec, index_t C,
-    T eps, index_t minPts, cluster_result_t& clusters, std::vector<char>& visited,
-    nanoflann::SearchParams const& params) {
-    auto const& data = D->dataset;
-
-    clusters[P] = C;
-
-    search_res_t<T> tmp_res(minPts);
-
-    for (typename search_res_t<T>::size_type vec_idx = 0; vec_idx < Nvec.size(); ++vec_idx) {
-        auto const idx = Nvec[vec_idx].first;
-        if (visited[idx] == 0) {
-            visited[idx] = 1;
-            auto query = data.get_position(idx);
-            auto const N = D->radiusSearch(query, eps, tmp_res, params);
-            if (N >= minPts) {
-                Nvec.insert(Nvec.cend(), tmp_res.cbegin(), tmp_res.cend());
-            }
-        }
-        if (clusters[idx] <= static_cast<cluster_type_ut>(cluster_type::NOISE)) {
-            clusters[idx] = C;
-        }
+/** Merges the sets of 'a' and 'b' by linking the larger root below the smaller one. */
+inline void uf_union(union_find_t& parent, index_t a, index_t b) {
+    while (true) {
+        a = uf_find(parent, a);
+        b = uf_find(parent, b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        auto expected = a;
+        if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
     }
 }
 
 template<typename T, int DIM>
 inline cluster_result_t DBSCAN(std::shared_ptr<kd_tree_t<T, DIM>> const& D, T eps, index_t minPts) {
     auto const& data = D->dataset;
-    auto const num_points = data.kdtree_get_point_count();
-    cluster_result_t clusters(num_points, static_cast<cluster_type_ut>(cluster_type::UNDEFINED));
-    std::vector<char> visited(num_points, 0);
-    nanoflann::SearchParams params;
-    params.sorted = false;
+    auto const num_points = static_cast<int64_t>(data.kdtree_get_point_count());
+    auto const no_core = static_cast<index_t>(num_points);
+    // until the final pass, non-core points store the core point they are attached to
+    cluster_result_t clusters(num_points, no_core);
+    std::vector<char> is_core(num_points, 0);
+    union_find_t parent(num_points);
+
+#pragma omp parallel
+    {
+        nanoflann::SearchParams params;
+        params.sorted = false;
+        search_res_t<T> tmp_res;
+        tmp_res.reserve(minPts);
+
+        // core points
+#pragma omp for schedule(dynamic, 1024)
+        for (int64_t idx = 0; idx < num_points; ++idx) {
+            parent[idx].store(static_cast<index_t>(idx), std::memory_order_relaxed);
+            auto const N = D->radiusSearch(data.get_position(idx), eps, tmp_res, params);
+            if (N >= minPts) is_core[idx] = 1;
+        }
 
-    search_res_t<T> tmp_res(minPts);
+        // merge core points, attach border points
+#pragma omp for schedule(dynamic, 1024)
+        for (int64_t idx = 0; idx < num_points; ++idx) {
+            D->radiusSearch(data.get_position(idx), eps, tmp_res, params);
+            if (is_core[idx]) {
+                for (auto const& n : tmp_res) {
+                    // every pair is seen from both sides, one direction suffices
+                    if (n.first < static_cast<index_t>(idx) && is_core[n.first]) {
+                        uf_union(parent, static_cast<index_t>(idx), n.first);
+                    }
+                }
+            } else {
+                auto core = no_core;
+                for (auto const& n : tmp_res) {
+                    if (is_core[n.first] && n.first < core) core = n.first;
+                }
+                clusters[idx] = core;
+            }
+        }
+    }
 
+    // label the roots in ascending order, the root of a cluster is its lowest core point
     index_t cluster_idx = static_cast<cluster_type_ut>(cluster_type::NOISE);
+    for (int64_t idx = 0; idx < num_points; ++idx) {
+        if (is_core[idx] && parent[idx].load(std::memory_order_relaxed) == static_cast<index_t>(idx)) {
+            clusters[idx] = ++cluster_idx;
+        }
+    }
 
-    for (std::remove_const_t<decltype(num_points)> idx = 0; idx < num_points; ++idx) {
-        if (visited[idx] > 0)
-            continue; 
-        visited[idx] = 1;
-        auto query = data.get_position(idx);
-        auto const N = D->radiusSearch(query, eps, tmp_res, params);
-        if (N < minPts) {
-            clusters[idx] = static_cast<cluster_type_ut>(cluster_type::NOISE);
+#pragma omp parallel for schedule(dynamic, 1024)
+    for (int64_t idx = 0; idx < num_points; ++idx) {
+        if (is_core[idx]) {
+            auto const root = uf_find(parent, static_cast<index_t>(idx));
+            if (root != static_cast<index_t>(idx)) clusters[idx] = clusters[root];
+        } else if (clusters[idx] != no_core) {
+            clusters[idx] = clusters[uf_find(parent, clusters[idx])];
         } else {
-            ++cluster_idx;
-            expand_cluster(D, idx, tmp_res, cluster_idx, eps, minPts, clusters, visited, params);
+            clusters[idx] = static_cast<cluster_type_ut>(cluster_type::NOISE);
         }
     }
 
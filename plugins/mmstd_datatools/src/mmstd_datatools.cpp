@@ -56,6 +56,7 @@
 #include "ParticleNeighborhoodGraph.h"
 #include "ParticleRelaxationModule.h"
 #include "ParticleSortFixHack.h"
+#include "ParticleSpatialIndex.h"
 #include "ParticleThermodyn.h"
 #include "ParticleThinner.h"
 #include "ParticleTranslateRotateScale.h"
@@ -77,12 +78,16 @@
 #include "mmstd_datatools/GraphDataCall.h"
 #include "mmstd_datatools/MultiIndexListDataCall.h"
 #include "mmstd_datatools/ParticleFilterMapDataCall.h"
+#include "mmstd_datatools/ParticleSpatialIndexCall.h"
 #include "mmstd_datatools/table/TableDataCall.h"
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
 #include "table/CSVDataSource.h"
 #include "table/MMFTDataSource.h"
 #include "table/MMFTDataWriter.h"
 #include "table/TableColumnFilter.h"
 #include "table/TableColumnScaler.h"
+#include "table/TableToColumnar.h"
+#include "table/ColumnarToTable.h"
 #include "table/TableFlagFilter.h"
 #include "table/TableJoin.h"
 #include "table/TableObserverPlane.h"
@@ -176,6 +181,8 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::TableSelectionTx>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::TableSort>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::TableWhere>();
+        this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::TableToColumnar>();
+        this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::ColumnarToTable>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleVelocities>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleNeighborhood>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleThermodyn>();
@@ -208,12 +215,15 @@ public:
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::clustering::ParticleIColClustering>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::AddParticleColors>();
         this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ColorToDir>();
+        this->module_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleSpatialIndex>();
 
         // register calls here:
         this->call_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::TableDataCall>();
+        this->call_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::table::ColumnarTableDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleFilterMapDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::GraphDataCall>();
         this->call_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::MultiIndexListDataCall>();
+        this->call_descriptions.RegisterAutoDescription<megamol::stdplugin::datatools::ParticleSpatialIndexCall>();
     }
 };
 } // namespace megamol::stdplugin::datatools
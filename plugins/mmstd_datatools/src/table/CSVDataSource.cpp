@@ -16,13 +16,16 @@
 #include "mmcore/param/IntParam.h"
 #include "mmcore/CoreInstance.h"
 
-#include "mmcore/utility/sys/ASCIIFileBuffer.h"
 #include "vislib/StringTokeniser.h"
+#include "vislib/sys/File.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cstring>
 #include <sstream>
 #include <vector>
-#include <list>
 #include <random>
-#include <map>
+#include <unordered_map>
 #include <limits>
 #include <omp.h>
 
@@ -84,11 +87,88 @@ double parseValue(const char* tokenStart, const char* tokenEnd) {
     return NAN;
 }
 
+namespace {
+
+/** Data larger than this is split into several chunks for parallel parsing */
+constexpr size_t chunkSize = 1 << 22;
+
+/** Maximum number of bytes requested by one read call */
+constexpr size_t maxReadSize = 1 << 30;
+
+/** Answer the end of the line starting at 'p', excluding the line break */
+inline const char *lineEnd(const char *p, const char *end) {
+    while ((p != end) && (*p != '\n') && (*p != '\r')) ++p;
+    return p;
+}
+
+/** Answer the start of the line following the one starting at 'p' ("\n", "\r\n" and "\r" are line breaks) */
+inline const char *nextLine(const char *p, const char *end) {
+    p = lineEnd(p, end);
+    if (p == end) return p;
+    if ((*p == '\r') && (p + 1 != end) && (p[1] == '\n')) return p + 2;
+    return p + 1;
+}
+
+/** Answer the first occurrence of 'sep' in [p, end), or 'end' */
+inline const char *findSep(const char *p, const char *end, const vislib::StringA& sep) {
+    if (sep.Length() == 1) {
+        const char *r = static_cast<const char*>(std::memchr(p, sep[0], static_cast<size_t>(end - p)));
+        return (r != nullptr) ? r : end;
+    }
+    return std::search(p, end, sep.PeekBuffer(), sep.PeekBuffer() + sep.Length());
+}
+
+/**
+ * Calls 'func(col, tokenStart, tokenEnd)' for the first 'maxCnt' fields of the line [p, end).
+ *
+ * @return The number of fields visited
+ */
+template<class F>
+inline size_t forEachField(const char *p, const char *end, const vislib::StringA& sep, size_t maxCnt, F&& func) {
+    if (p == end) return 0;
+    size_t col = 0;
+    while (col < maxCnt) {
+        const char *e = findSep(p, end, sep);
+        func(col++, p, e);
+        if (e == end) break;
+        p = e + sep.Length();
+    }
+    return col;
+}
+
+/** Parses plain numbers without any allocation and falls back to parseValue for everything else */
+double parseNumber(const char *tokenStart, const char *tokenEnd) {
+    while ((tokenStart != tokenEnd) && std::isspace(static_cast<unsigned char>(*tokenStart))) ++tokenStart;
+    while ((tokenStart != tokenEnd) && std::isspace(static_cast<unsigned char>(tokenEnd[-1]))) --tokenEnd;
+    if (tokenStart == tokenEnd) return NAN;
+#if defined(__cpp_lib_to_chars)
+    double number;
+    const char *s = (*tokenStart == '+') ? tokenStart + 1 : tokenStart;
+    auto res = std::from_chars(s, tokenEnd, number);
+    if ((res.ec == std::errc()) && (res.ptr == tokenEnd)) {
+        return number;
+    }
+#endif
+    return parseValue(tokenStart, tokenEnd);
+}
+
+double parseNumber(const char *tokenStart, const char *tokenEnd, DecimalSeparator decType) {
+    if (decType == DecimalSeparator::DE) {
+        std::string token(tokenStart, tokenEnd);
+        std::replace(token.begin(), token.end(), ',', '.');
+        return parseNumber(token.data(), token.data() + token.size());
+    }
+    return parseNumber(tokenStart, tokenEnd);
+}
+
+} // namespace
+
 CSVDataSource::CSVDataSource(void) : core::Module(),
 filenameSlot("filename", "Filename to read from"),
 skipPrefaceSlot("skipPreface", "Number of lines to skip before parsing"),
 headerNamesSlot("headerNames", "Interpret the first data row as column names"),
 headerTypesSlot("headerTypes", "Interpret the second data row as column types (quantitative or categorical)"),
+detectTypesSlot("detectTypes", "Treat columns without any numeric value as categorical (if headerTypes is not set)"),
 commentPrefixSlot("commentPrefix", "Prefix that indicates a line-comment"),
 clearSlot("clear", "Clears the data"),
 colSepSlot("colSep", "The column separator (detected if empty)"),
@@ -108,6 +188,9 @@ dataHash(0), columns(), values() {
     this->headerTypesSlot.SetParameter(new core::param::BoolParam(false));
     this->MakeSlotAvailable(&this->headerTypesSlot);
 
+    this->detectTypesSlot.SetParameter(new core::param::BoolParam(false));
+    this->MakeSlotAvailable(&this->detectTypesSlot);
+
     this->commentPrefixSlot.SetParameter(new core::param::StringParam(""));
     this->MakeSlotAvailable(&this->commentPrefixSlot);
 
@@ -152,6 +235,7 @@ void CSVDataSource::assertData(void) {
         && !this->skipPrefaceSlot.IsDirty()
         && !this->headerNamesSlot.IsDirty()
         && !this->headerTypesSlot.IsDirty()
+        && !this->detectTypesSlot.IsDirty()
         && !this->commentPrefixSlot.IsDirty()
         && !this->colSepSlot.IsDirty()
         && !this->decSepSlot.IsDirty()) {
@@ -167,6 +251,7 @@ void CSVDataSource::assertData(void) {
     this->skipPrefaceSlot.ResetDirty();
     this->headerNamesSlot.ResetDirty();
     this->headerTypesSlot.ResetDirty();
+    this->detectTypesSlot.ResetDirty();
     this->commentPrefixSlot.ResetDirty();
     this->colSepSlot.ResetDirty();
     this->decSepSlot.ResetDirty();
@@ -178,41 +263,49 @@ void CSVDataSource::assertData(void) {
 	auto filename = this->filenameSlot.Param<core::param::FilePathParam>()->Value();
 
     try {
-        vislib::sys::ASCIIFileBuffer file;
-
-        // 1. Load the whole file into memory (FAST!)
+        // 1. Load the whole file into one buffer, lines are never copied
         //////////////////////////////////////////////////////////////////////
-        if (!file.LoadFile(filename, vislib::sys::ASCIIFileBuffer::PARSING_LINES)) throw vislib::Exception(__FILE__, __LINE__);
-        if (file.Count() < 2) throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
+        std::vector<char> buffer;
+        {
+            vislib::sys::File file;
+            if (!file.Open(filename, vislib::sys::File::READ_ONLY, vislib::sys::File::SHARE_READ, vislib::sys::File::OPEN_ONLY)) throw vislib::Exception(__FILE__, __LINE__);
+            buffer.resize(static_cast<size_t>(file.GetSize()));
+            size_t read = 0;
+            while (read < buffer.size()) {
+                const size_t r = static_cast<size_t>(file.Read(buffer.data() + read, std::min<size_t>(buffer.size() - read, maxReadSize)));
+                if (r == 0) break;
+                read += r;
+            }
+            buffer.resize(read);
+            file.Close();
+        }
+        const char *const begin = buffer.data();
+        const char *const end = begin + buffer.size();
 
         // 2. Determine the first row, column separator, and decimal point
         //////////////////////////////////////////////////////////////////////
         int firstHeaRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
-        int firstDatRow = this->skipPrefaceSlot.Param<core::param::IntParam>()->Value();
-        if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) firstDatRow++;
-        if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) firstDatRow++;
+        const char *cur = begin;
+        for (int i = 0; i < firstHeaRow; ++i) cur = nextLine(cur, end);
 
-        auto comment = this->commentPrefixSlot.Param<core::param::StringParam>()->Value();
+        vislib::StringA comment(this->commentPrefixSlot.Param<core::param::StringParam>()->Value());
         if (!comment.IsEmpty()) {
-                // Skip comments at the beginning of the file.
-            while (firstHeaRow < file.Count()) {
-                if (!vislib::StringA(file[firstHeaRow]).StartsWith(comment)) {
-                    break;
-                }
+            // Skip comments at the beginning of the file.
+            while ((static_cast<size_t>(end - cur) >= static_cast<size_t>(comment.Length()))
+                    && (std::memcmp(cur, comment.PeekBuffer(), comment.Length()) == 0)) {
+                cur = nextLine(cur, end);
                 firstHeaRow++;
-                firstDatRow++;
             }
         }
+        if (cur == end) throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
+        const vislib::StringA headerLine(cur, static_cast<vislib::StringA::Size>(lineEnd(cur, end) - cur));
 
         vislib::StringA colSep(this->colSepSlot.Param<core::param::StringParam>()->Value());
         if (colSep.IsEmpty()) {
             // Detect column separator
             const char ColSepCanidates[] = { '\t', ';', ',', '|' };
-            vislib::StringA l1(file[firstHeaRow]);
-            vislib::StringA l2(file[firstHeaRow]);
             for (int i = 0; i < sizeof(ColSepCanidates) / sizeof(char); ++i) {
-                SIZE_T c1 = l1.Count(ColSepCanidates[i]);
-                if ((c1 > 0) && (c1 == l2.Count(ColSepCanidates[i]))) {
+                if (headerLine.Count(ColSepCanidates[i]) > 0) {
                     colSep.Append(ColSepCanidates[i]);
                     break;
                 }
@@ -222,35 +315,14 @@ void CSVDataSource::assertData(void) {
             }
         }
 
-        DecimalSeparator decType = static_cast<DecimalSeparator>(this->decSepSlot.Param<core::param::EnumParam>()->Value());
-        if (decType == DecimalSeparator::Unknown) {
-            // Detect decimal type
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstDatRow], colSep, false));
-            for (SIZE_T i = 0; i < tokens.Count(); i++) {
-                bool hasDot = tokens[i].Contains('.');
-                bool hasComma = tokens[i].Contains(',');
-                if (hasDot && !hasComma) {
-                    decType = DecimalSeparator::US;
-                    break;
-                } else if (hasComma && !hasDot) {
-                    decType = DecimalSeparator::DE;
-                    break;
-                }
-            }
-            if (decType == DecimalSeparator::Unknown) {
-                                // Assume US format if detection failed.
-                decType = DecimalSeparator::US;
-            }
-        }
-
         // 3. Table layout is now clear... determine column headers.
         //////////////////////////////////////////////////////////////////////
-        vislib::Array<vislib::StringA> dimNames;
+        int firstDatRow = firstHeaRow;
+        vislib::Array<vislib::StringA> dimNames(vislib::StringTokeniserA::Split(headerLine, colSep, false));
         if (headerNamesSlot.Param<core::param::BoolParam>()->Value()) {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
-            firstHeaRow++;
+            cur = nextLine(cur, end);
+            firstDatRow++;
         } else {
-            dimNames = vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false);
             for (SIZE_T i = 0; i < dimNames.Count(); ++i) {
                 dimNames[i].Format("Dim %d", static_cast<int>(i));
             }
@@ -259,8 +331,12 @@ void CSVDataSource::assertData(void) {
         this->values.clear();
 
         bool hasCatDims = false;
-        if (headerTypesSlot.Param<core::param::BoolParam>()->Value()) {
-            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(file[firstHeaRow], colSep, false));
+        const bool headerTypes = headerTypesSlot.Param<core::param::BoolParam>()->Value();
+        if (headerTypes) {
+            const vislib::StringA typeLine(cur, static_cast<vislib::StringA::Size>(lineEnd(cur, end) - cur));
+            cur = nextLine(cur, end);
+            firstDatRow++;
+            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(typeLine, colSep, false));
             for (SIZE_T i = 0; i < dimNames.Count(); i++) {
                 TableDataCall::ColumnType type = TableDataCall::ColumnType::QUANTITATIVE;
                 if (tokens.Count() > i && tokens[i].Equals("CATEGORICAL", true)) {
@@ -280,81 +356,143 @@ void CSVDataSource::assertData(void) {
                     .SetMaximumValue(1.0f);
             }
         }
+        if (cur == end) throw vislib::Exception("No data in CSV file", __FILE__, __LINE__);
 
-        // 4. Data format is now clear... finally parse actual data
-        //////////////////////////////////////////////////////////////////////
-        size_t colCnt = static_cast<size_t>(this->columns.size());
-        size_t rowCnt = static_cast<size_t>(file.Count() - firstDatRow);
-        int colSepEnd = colSep.Length() - 1;
-
-        // Test for empty lines at the end
-        for (; rowCnt > 0; --rowCnt) {
-            const char *start = file[firstDatRow + rowCnt - 1];
-            const char *end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos]) colSepPos++; else colSepPos = 0;
-                    ++end;
+        DecimalSeparator decType = static_cast<DecimalSeparator>(this->decSepSlot.Param<core::param::EnumParam>()->Value());
+        if (decType == DecimalSeparator::Unknown) {
+            // Detect decimal type
+            const vislib::StringA dataLine(cur, static_cast<vislib::StringA::Size>(lineEnd(cur, end) - cur));
+            vislib::Array<vislib::StringA> tokens(vislib::StringTokeniserA::Split(dataLine, colSep, false));
+            for (SIZE_T i = 0; i < tokens.Count(); i++) {
+                bool hasDot = tokens[i].Contains('.');
+                bool hasComma = tokens[i].Contains(',');
+                if (hasDot && !hasComma) {
+                    decType = DecimalSeparator::US;
+                    break;
+                } else if (hasComma && !hasDot) {
+                    decType = DecimalSeparator::DE;
+                    break;
                 }
-                col++;
             }
-            if (col >= colCnt) break; // we found the last line containing a full data set
+            if (decType == DecimalSeparator::Unknown) {
+                // Assume US format if detection failed.
+                decType = DecimalSeparator::US;
+            }
         }
 
-        // Parse in parallel, assuming all lines will work
-        std::vector<std::map<std::string, float>> catMaps;
-        int thCnt = omp_get_max_threads();
-        catMaps.resize(colCnt * thCnt);
-        values.resize(colCnt * rowCnt);
-        bool hasInvalids = false;
-
-#pragma omp parallel for
-        for (long long idx = 0; idx < static_cast<long long>(rowCnt); ++idx) {
-            int thId = omp_get_thread_num();
-            const char *start = file[static_cast<size_t>(firstDatRow + idx)];
-            const char *end = start;
-            size_t col = 0;
-            while ((*end != '\0') && (col < colCnt)) {
-                std::map<std::string, float> &catMap = catMaps[thId + col * thCnt];
-                int colSepPos = 0;
-                while ((*end != '\0') && ((*end != colSep[colSepEnd]) || (colSepEnd != colSepPos))) {
-                    if (*end == colSep[colSepPos]) colSepPos++; else colSepPos = 0;
-                    ++end;
-                }
+        // 4. Data format is now clear... finally parse actual data
+        //////////////////////////////////////////////////////////////////////
+        const size_t colCnt = this->columns.size();
+        const char *const dataBegin = cur;
+        const char *dataEnd = end;
+
+        // Drop lines at the end that do not contain a full data set
+        while (dataEnd != dataBegin) {
+            const char *e = dataEnd;
+            if ((e != dataBegin) && (e[-1] == '\n')) --e;
+            if ((e != dataBegin) && (e[-1] == '\r')) --e;
+            const char *s = e;
+            while ((s != dataBegin) && (s[-1] != '\n') && (s[-1] != '\r')) --s;
+            if (forEachField(s, e, colSep, colCnt, [](size_t, const char*, const char*) {}) >= colCnt) break;
+            dataEnd = s;
+        }
 
-                if (this->columns[col].Type() == TableDataCall::ColumnType::QUANTITATIVE) {
-                    if (decType == DecimalSeparator::DE) {
-                        for (char *ez = const_cast<char*>(start); ez != end; ++ez) if (*ez == ',') *ez = '.';
-                    }
-                    double value = parseValue(start, end);
-                    values[static_cast<size_t>(idx * colCnt + col)] = static_cast<float>(value);
-                    if (std::isnan(value)) {
-                        hasInvalids = true;
-                    }
-                } else if (this->columns[col].Type() == TableDataCall::ColumnType::CATEGORICAL) {
-                    assert(hasCatDims);
-                    std::map<std::string, float>::iterator cmi = catMap.find(start);
-                    if (cmi == catMap.end()) {
-                        cmi = catMap.insert(std::pair<std::string, float>(start, static_cast<float>(thId + thCnt * catMap.size()))).first;
+        // Split the data at line breaks into chunks that are parsed independently
+        const size_t dataSize = static_cast<size_t>(dataEnd - dataBegin);
+        const int thCnt = omp_get_max_threads();
+        const size_t chunkCnt = std::min<size_t>(dataSize / chunkSize + 1, 16 * static_cast<size_t>(thCnt));
+        std::vector<const char*> chunkBegin(chunkCnt + 1, dataEnd);
+        chunkBegin[0] = dataBegin;
+        for (size_t i = 1; i < chunkCnt; ++i) {
+            const char *p = std::max(chunkBegin[i - 1], dataBegin + i * (dataSize / chunkCnt));
+            if (p != chunkBegin[i - 1]) p = nextLine(p - 1, dataEnd);
+            chunkBegin[i] = p;
+        }
+
+        // Count the rows of each chunk and, if requested, detect categorical columns
+        const bool detectTypes = !headerTypes && this->detectTypesSlot.Param<core::param::BoolParam>()->Value();
+        std::vector<size_t> chunkRows(chunkCnt + 1, 0);
+        std::vector<char> hasNumber(detectTypes ? chunkCnt * colCnt : 0, 0);
+        std::vector<char> hasText(detectTypes ? chunkCnt * colCnt : 0, 0);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (long long ci = 0; ci < static_cast<long long>(chunkCnt); ++ci) {
+            const char *const chunkEnd = chunkBegin[ci + 1];
+            char *const number = detectTypes ? &hasNumber[ci * colCnt] : nullptr;
+            char *const text = detectTypes ? &hasText[ci * colCnt] : nullptr;
+            size_t rows = 0;
+            for (const char *line = chunkBegin[ci]; line != chunkEnd; line = nextLine(line, chunkEnd)) {
+                ++rows;
+                if (!detectTypes) continue;
+                forEachField(line, lineEnd(line, chunkEnd), colSep, colCnt, [&](size_t col, const char *s, const char *e) {
+                    // one number makes the column quantitative, so it need not be checked any further
+                    if ((s == e) || number[col]) return;
+                    if (std::isnan(parseNumber(s, e, decType))) {
+                        text[col] = 1;
+                    } else {
+                        number[col] = 1;
                     }
-                    values[static_cast<size_t>(idx * colCnt + col)] = cmi->second;
-                } else {
-                    assert(false);
+                });
+            }
+            chunkRows[ci + 1] = rows;
+        }
+        for (size_t ci = 0; ci < chunkCnt; ++ci) {
+            chunkRows[ci + 1] += chunkRows[ci];
+        }
+        if (detectTypes) {
+            for (size_t c = 0; c < colCnt; ++c) {
+                bool number = false, text = false;
+                for (size_t ci = 0; ci < chunkCnt; ++ci) {
+                    number |= (hasNumber[ci * colCnt + c] != 0);
+                    text |= (hasText[ci * colCnt + c] != 0);
                 }
-
-                col++;
-                if (*end != '\0') {
-                    start = end + 1;
-                    end = start;
+                if (text && !number) {
+                    this->columns[c].SetType(TableDataCall::ColumnType::CATEGORICAL);
+                    hasCatDims = true;
                 }
             }
-            for (; col < colCnt; ++col) {
-                values[static_cast<size_t>(idx * colCnt + col)] = std::numeric_limits<float>::quiet_NaN();
-                hasInvalids = true;
+        }
+
+        // Parse in parallel, every chunk writes its rows directly into the final table
+        const size_t rowCnt = chunkRows[chunkCnt];
+        values.resize(colCnt * rowCnt);
+        std::vector<std::vector<std::string>> chunkCats(chunkCnt * colCnt); // categories in order of appearance
+        std::vector<char> chunkInvalids(chunkCnt, 0);
+#pragma omp parallel for schedule(dynamic, 1)
+        for (long long ci = 0; ci < static_cast<long long>(chunkCnt); ++ci) {
+            const char *const chunkEnd = chunkBegin[ci + 1];
+            std::vector<std::unordered_map<std::string, float>> catMaps(hasCatDims ? colCnt : 0);
+            float *row = values.data() + chunkRows[ci] * colCnt;
+            bool invalid = false;
+            for (const char *line = chunkBegin[ci]; line != chunkEnd; line = nextLine(line, chunkEnd), row += colCnt) {
+                size_t fields = forEachField(line, lineEnd(line, chunkEnd), colSep, colCnt, [&](size_t col, const char *s, const char *e) {
+                    if (this->columns[col].Type() == TableDataCall::ColumnType::QUANTITATIVE) {
+                        const double value = parseNumber(s, e, decType);
+                        row[col] = static_cast<float>(value);
+                        if (std::isnan(value)) {
+                            invalid = true;
+                        }
+                    } else if (this->columns[col].Type() == TableDataCall::ColumnType::CATEGORICAL) {
+                        assert(hasCatDims);
+                        std::string key(s, e);
+                        auto cmi = catMaps[col].find(key);
+                        if (cmi == catMaps[col].end()) {
+                            auto& cats = chunkCats[ci * colCnt + col];
+                            cmi = catMaps[col].emplace(key, static_cast<float>(cats.size())).first;
+                            cats.push_back(std::move(key));
+                        }
+                        row[col] = cmi->second;
+                    } else {
+                        assert(false);
+                    }
+                });
+                for (size_t col = fields; col < colCnt; ++col) {
+                    row[col] = std::numeric_limits<float>::quiet_NaN();
+                    invalid = true;
+                }
             }
+            chunkInvalids[ci] = invalid;
         }
+        const bool hasInvalids = std::find(chunkInvalids.begin(), chunkInvalids.end(), 1) != chunkInvalids.end();
 
         // Report invalid data if present (note: do not drop data!)
         if (hasInvalids) {
@@ -380,44 +518,45 @@ void CSVDataSource::assertData(void) {
             }
         }
 
-        // Merge categorical data so that all `value indices` map to one `string key`
+        // Merge categorical data so that all `value indices` map to one `string key`, numbered in order of appearance
+        std::vector<std::vector<float>> catRemaps(hasCatDims ? chunkCnt * colCnt : 0);
         if (hasCatDims) {
             for (size_t c = 0; c < colCnt; ++c) {
                 if (columns[c].Type() != TableDataCall::ColumnType::CATEGORICAL) continue;
-                std::map<int, int> catRemap;
-                std::map<std::string, int> catMap;
-                for (int ci = static_cast<int>(c) * thCnt; ci < static_cast<int>(c + 1) * thCnt; ++ci) {
-                    for (const std::pair<std::string, float>& p : catMaps[ci]) {
-                        int vi = static_cast<int>(p.second + 0.49f);
-                        std::map<std::string, int>::iterator cmi = catMap.find(p.first);
-                        if (cmi == catMap.end()) {
-                            int nv = static_cast<int>(catMap.size());
-                            catMap[p.first] = nv;
-                            catRemap[vi] = nv;
-                        } else {
-                            catRemap[vi] = cmi->second;
-                        }
+                std::unordered_map<std::string, float> catMap;
+                for (size_t ci = 0; ci < chunkCnt; ++ci) {
+                    auto& remap = catRemaps[ci * colCnt + c];
+                    for (const std::string& cat : chunkCats[ci * colCnt + c]) {
+                        remap.push_back(catMap.emplace(cat, static_cast<float>(catMap.size())).first->second);
                     }
                 }
-
-                for (size_t r = 0; r < rowCnt; ++r) {
-                    int vi = static_cast<int>(values[r * colCnt + c] + 0.49f);
-                    values[r * colCnt + c] = static_cast<float>(catRemap[vi]);
-                }
             }
         }
 
-        // Collect min/max
-        std::vector<float> minVals(colCnt, std::numeric_limits<float>::max());
-        std::vector<float> maxVals(colCnt, -std::numeric_limits<float>::max());
-        for (size_t r = 0; r < rowCnt; ++r) {
-            for (size_t c = 0; c < colCnt; ++c) {
-                float f = values[r * colCnt + c];
-                if (f < minVals[c]) minVals[c] = f;
-                if (f > maxVals[c]) maxVals[c] = f;
+        // Remap categories and collect min/max per chunk
+        std::vector<float> minVals(chunkCnt * colCnt, std::numeric_limits<float>::max());
+        std::vector<float> maxVals(chunkCnt * colCnt, -std::numeric_limits<float>::max());
+#pragma omp parallel for schedule(dynamic, 1)
+        for (long long ci = 0; ci < static_cast<long long>(chunkCnt); ++ci) {
+            float *const mins = &minVals[ci * colCnt];
+            float *const maxs = &maxVals[ci * colCnt];
+            for (size_t r = chunkRows[ci]; r < chunkRows[ci + 1]; ++r) {
+                float *const row = values.data() + r * colCnt;
+                for (size_t c = 0; c < colCnt; ++c) {
+                    float f = row[c];
+                    if (hasCatDims && (columns[c].Type() == TableDataCall::ColumnType::CATEGORICAL) && !std::isnan(f)) {
+                        row[c] = f = catRemaps[ci * colCnt + c][static_cast<size_t>(f)];
+                    }
+                    if (f < mins[c]) mins[c] = f;
+                    if (f > maxs[c]) maxs[c] = f;
+                }
             }
         }
         for (size_t c = 0; c < colCnt; ++c) {
+            for (size_t ci = 1; ci < chunkCnt; ++ci) {
+                minVals[c] = std::min(minVals[c], minVals[ci * colCnt + c]);
+                maxVals[c] = std::max(maxVals[c], maxVals[ci * colCnt + c]);
+            }
             columns[c].SetMinimumValue(minVals[c]).SetMaximumValue(maxVals[c]);
         }
 
@@ -49,6 +49,7 @@ namespace table {
 		core::param::ParamSlot skipPrefaceSlot;
 		core::param::ParamSlot headerNamesSlot;
         core::param::ParamSlot headerTypesSlot;
+        core::param::ParamSlot detectTypesSlot;
 		core::param::ParamSlot commentPrefixSlot;
         core::param::ParamSlot clearSlot;
         core::param::ParamSlot colSepSlot;
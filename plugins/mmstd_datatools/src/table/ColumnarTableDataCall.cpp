@@ -0,0 +1,21 @@
+/*
+ * ColumnarTableDataCall.cpp
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+#include "stdafx.h"
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
+
+using namespace megamol::stdplugin::datatools;
+using namespace megamol::stdplugin::datatools::table;
+using namespace megamol;
+
+
+ColumnarTableDataCall::ColumnarTableDataCall(void) : core::AbstractGetDataCall(), rows_count(0), infos(), columns(), frameCount(0), frameID(0) {
+    // intentionally empty
+}
+
+ColumnarTableDataCall::~ColumnarTableDataCall(void) {
+    // the columns are released with the last reference
+}
@@ -0,0 +1,133 @@
+/*
+ * ColumnarToTable.cpp
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "ColumnarToTable.h"
+
+#include "mmcore/utility/log/Log.h"
+#include <cstdint>
+#include <limits>
+
+using namespace megamol::stdplugin::datatools;
+using namespace megamol::stdplugin::datatools::table;
+using namespace megamol;
+
+ColumnarToTable::ColumnarToTable(void) :
+    core::Module(),
+    dataOutSlot("dataOut", "Ouput"),
+    dataInSlot("dataIn", "Input"),
+    frameID(-1),
+    datahash(std::numeric_limits<size_t>::max()),
+    rowsCount(0) {
+
+    this->dataInSlot.SetCompatibleCall<ColumnarTableDataCallDescription>();
+    this->MakeSlotAvailable(&this->dataInSlot);
+
+    this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
+        TableDataCall::FunctionName(0),
+        &ColumnarToTable::processData);
+    this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
+        TableDataCall::FunctionName(1),
+        &ColumnarToTable::getExtent);
+    this->MakeSlotAvailable(&this->dataOutSlot);
+}
+
+ColumnarToTable::~ColumnarToTable(void) {
+    this->Release();
+}
+
+bool ColumnarToTable::create(void) {
+    return true;
+}
+
+void ColumnarToTable::release(void) {
+    this->columnInfos.clear();
+    this->data.clear();
+    this->singleColumn.reset();
+}
+
+bool ColumnarToTable::processData(core::Call &c) {
+    try {
+        TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
+        if (outCall == nullptr) return false;
+
+        ColumnarTableDataCall *inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+        if (inCall == nullptr) return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)(0)) return false;
+
+        if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID()) {
+            this->datahash = inCall->DataHash();
+            this->frameID = inCall->GetFrameID();
+
+            const size_t column_count = inCall->GetColumnsCount();
+            const size_t rows_count = inCall->GetRowsCount();
+
+            this->rowsCount = rows_count;
+            this->columnInfos.assign(inCall->GetColumnsInfos(), inCall->GetColumnsInfos() + column_count);
+            this->data.clear();
+            this->singleColumn.reset();
+
+            if (column_count == 1) {
+                // a single column already is row major
+                this->singleColumn = inCall->GetColumn(0);
+            } else {
+                std::vector<const float *> src(column_count);
+                for (size_t col = 0; col < column_count; ++col) {
+                    src[col] = inCall->GetColumnData(col);
+                }
+                this->data.resize(rows_count * column_count);
+#pragma omp parallel for
+                for (int64_t row = 0; row < static_cast<int64_t>(rows_count); ++row) {
+                    float *dst = this->data.data() + row * column_count;
+                    for (size_t col = 0; col < column_count; ++col) {
+                        dst[col] = src[col][row];
+                    }
+                }
+            }
+        }
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetFrameID(this->frameID);
+        outCall->SetDataHash(this->datahash);
+
+        if (this->columnInfos.empty()) {
+            outCall->Set(0, 0, nullptr, nullptr);
+        } else if (this->singleColumn != nullptr) {
+            outCall->Set(1, this->rowsCount, this->columnInfos.data(), this->singleColumn->data());
+        } else {
+            outCall->Set(this->columnInfos.size(), this->rowsCount, this->columnInfos.data(), this->data.data());
+        }
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("Failed to execute %s::processData\n", ClassName());
+        return false;
+    }
+
+    return true;
+}
+
+bool ColumnarToTable::getExtent(core::Call &c) {
+    try {
+        TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
+        if (outCall == nullptr) return false;
+
+        ColumnarTableDataCall *inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+        if (inCall == nullptr) return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)(1)) return false;
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetDataHash(inCall->DataHash());
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("Failed to execute %s::getExtent\n", ClassName());
+        return false;
+    }
+
+    return true;
+}
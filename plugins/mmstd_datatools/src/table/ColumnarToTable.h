@@ -0,0 +1,94 @@
+/*
+ * ColumnarToTable.h
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_TABLE_COLUMNARTOTABLE_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TABLE_COLUMNARTOTABLE_H_INCLUDED
+
+#include "mmcore/Module.h"
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
+#include "mmstd_datatools/table/TableDataCall.h"
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+namespace table {
+
+/*
+ * Module converting a columnar table into a row-major table.
+ */
+class ColumnarToTable : public core::Module {
+public:
+    /** Return module class name */
+    static const char *ClassName(void) {
+        return "ColumnarToTable";
+    }
+
+    /** Return module class description */
+    static const char *Description(void) {
+        return "Converts a columnar table into a row-major table";
+    }
+
+    /** Module is always available */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor */
+    ColumnarToTable(void);
+
+    /** Dtor */
+    virtual ~ColumnarToTable(void);
+
+protected:
+    /** Lazy initialization of the module */
+    virtual bool create(void);
+
+    /** Resource release */
+    virtual void release(void);
+
+private:
+    /** Data callback */
+    bool processData(core::Call &c);
+
+    /** Extent callback */
+    bool getExtent(core::Call &c);
+
+    /** Data output slot */
+    core::CalleeSlot dataOutSlot;
+
+    /** Data input slot */
+    core::CallerSlot dataInSlot;
+
+    /** ID of the current frame */
+    int frameID;
+
+    /** Hash of the current data */
+    size_t datahash;
+
+    /** Rows of the current data */
+    size_t rowsCount;
+
+    /** Column information of the current data */
+    std::vector<TableDataCall::ColumnInfo> columnInfos;
+
+    /** Interleaved data */
+    std::vector<float> data;
+
+    /** Input column handed out directly if the table has a single column */
+    ColumnarTableDataCall::Column singleColumn;
+}; /* end class ColumnarToTable */
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* end ifndef MEGAMOL_DATATOOLS_TABLE_COLUMNARTOTABLE_H_INCLUDED */
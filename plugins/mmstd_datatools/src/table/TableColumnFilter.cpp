@@ -30,6 +30,7 @@ TableColumnFilter::TableColumnFilter(void) :
     datahash(std::numeric_limits<unsigned long>::max()) {
 
     this->dataInSlot.SetCompatibleCall<TableDataCallDescription>();
+    this->dataInSlot.SetCompatibleCall<ColumnarTableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataInSlot);
 
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
@@ -38,6 +39,12 @@ TableColumnFilter::TableColumnFilter(void) :
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
         TableDataCall::FunctionName(1),
         &TableColumnFilter::getExtent);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(0),
+        &TableColumnFilter::processData);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(1),
+        &TableColumnFilter::getExtent);
     this->MakeSlotAvailable(&this->dataOutSlot);
 
     this->selectionStringSlot << new core::param::StringParam("x; y; z");
@@ -57,6 +64,9 @@ void TableColumnFilter::release(void) {
 
 bool TableColumnFilter::processData(core::Call &c) {
     try {
+        ColumnarTableDataCall *columnarCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+        if (columnarCall != NULL) return this->processColumnarData(*columnarCall);
+
         TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
         if (outCall == NULL) return false;
 
@@ -75,44 +85,19 @@ bool TableColumnFilter::processData(core::Call &c) {
             auto rows_count = inCall->GetRowsCount();
             auto in_data = inCall->GetData();
 
-            auto selectionString = this->selectionStringSlot.Param<core::param::StringParam>()->Value();
-            selectionString.Remove(vislib::TString(" "));
-            auto st = vislib::StringTokeniserW(selectionString, vislib::TString(";"));
-            auto selectors = st.Split(selectionString, vislib::TString(";"));
-
-            if (selectors.Count() == 0) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No valid selectors have been given\n"),
-                    ModuleName.c_str());
-                return false;
-            }
-
-            this->columnInfos.clear();
-            this->columnInfos.reserve(selectors.Count());
-
             std::vector<size_t> indexMask;
-            indexMask.reserve(selectors.Count());
-            for (size_t sel = 0; sel < selectors.Count(); sel++) {
-                for (size_t col = 0; col < column_count; col++) {
-                    if (selectors[sel].CompareInsensitive(vislib::TString(
-                        column_infos[col].Name().c_str()))) {
-                        indexMask.push_back(col);
-                        this->columnInfos.push_back(column_infos[col]);
-                        break;
-                    }
-                }
-                //// if we reach this, no match has been found
-                //megamol::core::utility::log::Log::DefaultLog.WriteInfo(_T("%hs: No match has been found for selector %s\n"),
-                //    ModuleName.c_str(), selectors[sel].PeekBuffer());
-            }
-
-            if (indexMask.size() == 0) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No matches for selectors have been found\n"),
-                    ModuleName.c_str());
+            if (!this->selectColumns(column_count, column_infos, indexMask)) {
                 this->columnInfos.clear();
                 this->data.clear();
                 return false;
             }
 
+            this->columnInfos.clear();
+            this->columnInfos.reserve(indexMask.size());
+            for (auto &cidx : indexMask) {
+                this->columnInfos.push_back(column_infos[cidx]);
+            }
+
             this->data.clear();
             this->data.reserve(rows_count*this->columnInfos.size());
 
@@ -142,8 +127,92 @@ bool TableColumnFilter::processData(core::Call &c) {
     return true;
 }
 
+bool TableColumnFilter::processColumnarData(ColumnarTableDataCall &outCall) {
+    ColumnarTableDataCall *inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+    if (inCall == NULL) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: Columnar output requires columnar input\n"),
+            ModuleName.c_str());
+        return false;
+    }
+
+    inCall->SetFrameID(outCall.GetFrameID());
+    if (!(*inCall)(0)) return false;
+
+    // selecting columns only copies the references to the column buffers
+    std::vector<size_t> indexMask;
+    if (!this->selectColumns(inCall->GetColumnsCount(), inCall->GetColumnsInfos(), indexMask)) {
+        outCall.Clear();
+        return false;
+    }
+    std::vector<ColumnarTableDataCall::ColumnInfo> infos;
+    std::vector<ColumnarTableDataCall::Column> columns;
+    infos.reserve(indexMask.size());
+    columns.reserve(indexMask.size());
+    for (auto &cidx : indexMask) {
+        infos.push_back(inCall->GetColumnInfo(cidx));
+        columns.push_back(inCall->GetColumn(cidx));
+    }
+
+    outCall.SetFrameCount(inCall->GetFrameCount());
+    outCall.SetFrameID(inCall->GetFrameID());
+    outCall.SetDataHash(inCall->DataHash());
+    outCall.Set(inCall->GetRowsCount(), std::move(infos), std::move(columns));
+
+    return true;
+}
+
+bool TableColumnFilter::selectColumns(size_t column_count, const TableDataCall::ColumnInfo *column_infos,
+        std::vector<size_t> &indexMask) const {
+    auto selectionString = this->selectionStringSlot.Param<core::param::StringParam>()->Value();
+    selectionString.Remove(vislib::TString(" "));
+    auto st = vislib::StringTokeniserW(selectionString, vislib::TString(";"));
+    auto selectors = st.Split(selectionString, vislib::TString(";"));
+
+    if (selectors.Count() == 0) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No valid selectors have been given\n"),
+            ModuleName.c_str());
+        return false;
+    }
+
+    indexMask.clear();
+    indexMask.reserve(selectors.Count());
+    for (size_t sel = 0; sel < selectors.Count(); sel++) {
+        for (size_t col = 0; col < column_count; col++) {
+            if (selectors[sel].CompareInsensitive(vislib::TString(
+                column_infos[col].Name().c_str()))) {
+                indexMask.push_back(col);
+                break;
+            }
+        }
+        //// if we reach this, no match has been found
+        //megamol::core::utility::log::Log::DefaultLog.WriteInfo(_T("%hs: No match has been found for selector %s\n"),
+        //    ModuleName.c_str(), selectors[sel].PeekBuffer());
+    }
+
+    if (indexMask.size() == 0) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No matches for selectors have been found\n"),
+            ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
 bool TableColumnFilter::getExtent(core::Call &c) {
 	try {
+		ColumnarTableDataCall *columnarCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+		if (columnarCall != NULL) {
+			ColumnarTableDataCall *inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+			if (inCall == NULL) return false;
+
+			inCall->SetFrameID(columnarCall->GetFrameID());
+			if (!(*inCall)(1)) return false;
+
+			columnarCall->SetFrameCount(inCall->GetFrameCount());
+			columnarCall->SetDataHash(inCall->DataHash());
+			return true;
+		}
+
 		TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
 		if (outCall == NULL) return false;
 
@@ -15,6 +15,7 @@
 
 #include "mmcore/param/ParamSlot.h"
 
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 namespace megamol {
@@ -61,6 +62,21 @@ private:
 
     bool getExtent(core::Call &c);
 
+    /** Data callback for columnar tables, only passes on the selected columns */
+    bool processColumnarData(ColumnarTableDataCall &outCall);
+
+    /**
+     * Matches the selection string against the column names.
+     *
+     * @param column_count The number of columns
+     * @param column_infos The column descriptions
+     * @param indexMask Receives the indices of the selected columns
+     *
+     * @return False if no column is selected
+     */
+    bool selectColumns(size_t column_count, const TableDataCall::ColumnInfo *column_infos,
+        std::vector<size_t> &indexMask) const;
+
     /** Data output slot */
     core::CalleeSlot dataOutSlot;
 
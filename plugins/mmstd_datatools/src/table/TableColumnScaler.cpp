@@ -37,8 +37,10 @@ TableColumnScaler::TableColumnScaler(void) :
     scalingFactorSlot("scalingFactor", "Factor by which the selected column get scaled"),
     columnSelectorSlot("columns", "Select columns to scale separated by \";\""),
     frameID(-1),
-    datahash((std::numeric_limits<size_t>::max)()) {
+    datahash((std::numeric_limits<size_t>::max)()),
+    isColumnar(false) {
     this->dataInSlot.SetCompatibleCall<TableDataCallDescription>();
+    this->dataInSlot.SetCompatibleCall<ColumnarTableDataCallDescription>();
     this->MakeSlotAvailable(&this->dataInSlot);
 
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
@@ -47,6 +49,12 @@ TableColumnScaler::TableColumnScaler(void) :
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
         TableDataCall::FunctionName(1),
         &TableColumnScaler::getExtent);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(0),
+        &TableColumnScaler::processData);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(1),
+        &TableColumnScaler::getExtent);
     this->MakeSlotAvailable(&this->dataOutSlot);
 
     this->scalingFactorSlot << new core::param::FloatParam(1.0f);
@@ -86,6 +94,9 @@ void TableColumnScaler::release(void) {
  */
 bool TableColumnScaler::processData(core::Call &c) {
     try {
+        ColumnarTableDataCall *columnarCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+        if (columnarCall != NULL) return this->processColumnarData(*columnarCall);
+
         TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
         if (outCall == NULL) return false;
 
@@ -95,9 +106,11 @@ bool TableColumnScaler::processData(core::Call &c) {
         inCall->SetFrameID(outCall->GetFrameID());
         if (!(*inCall)()) return false;
 
-        if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID()) {
+        if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID() || this->isColumnar) {
             this->datahash = inCall->DataHash();
             this->frameID = inCall->GetFrameID();
+            this->isColumnar = false;
+            this->columns.clear();
 
             auto rows_count = inCall->GetRowsCount();
             auto column_count = inCall->GetColumnsCount();
@@ -106,35 +119,8 @@ bool TableColumnScaler::processData(core::Call &c) {
 
             auto scalingFactor = this->scalingFactorSlot.Param<core::param::FloatParam>()->Value();
 
-            auto selectionString = this->columnSelectorSlot.Param<core::param::StringParam>()->Value();
-            selectionString.Remove(vislib::TString(" "));
-            auto st = vislib::StringTokeniserW(selectionString, vislib::TString(";"));
-            auto selectors = st.Split(selectionString, vislib::TString(";"));
-
-            if (selectors.Count() == 0) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No valid selectors have been given\n"),
-                    ModuleName.c_str());
-                return false;
-            }
-
             std::vector<size_t> indexMask;
-            indexMask.reserve(selectors.Count());
-            for (size_t sel = 0; sel < selectors.Count(); sel++) {
-                for (size_t col = 0; col < column_count; col++) {
-                    if (selectors[sel].CompareInsensitive(vislib::TString(
-                        column_infos[col].Name().c_str()))) {
-                        indexMask.push_back(col);
-                        break;
-                    }
-                }
-                //// if we reach this, no match has been found
-                //megamol::core::utility::log::Log::DefaultLog.WriteInfo(_T("%hs: No match has been found for selector %s\n"),
-                //    ModuleName.c_str(), selectors[sel].PeekBuffer());
-            }
-
-            if (indexMask.size() == 0) {
-                megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No matches for selectors have been found\n"),
-                    ModuleName.c_str());
+            if (!this->selectColumns(column_count, column_infos, indexMask)) {
                 /*this->columnInfos.clear();
                 this->data.clear();*/
                 return false;
@@ -180,11 +166,132 @@ bool TableColumnScaler::processData(core::Call &c) {
 }
 
 
+/*
+ * TableColumnScaler::processColumnarData
+ */
+bool TableColumnScaler::processColumnarData(ColumnarTableDataCall &outCall) {
+    ColumnarTableDataCall *inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+    if (inCall == NULL) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: Columnar output requires columnar input\n"),
+            ModuleName.c_str());
+        return false;
+    }
+
+    inCall->SetFrameID(outCall.GetFrameID());
+    if (!(*inCall)(0)) return false;
+
+    if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID() || !this->isColumnar) {
+        this->datahash = inCall->DataHash();
+        this->frameID = inCall->GetFrameID();
+        this->isColumnar = true;
+        this->data.clear();
+
+        auto column_count = inCall->GetColumnsCount();
+        auto rows_count = inCall->GetRowsCount();
+        auto column_infos = inCall->GetColumnsInfos();
+
+        auto scalingFactor = this->scalingFactorSlot.Param<core::param::FloatParam>()->Value();
+
+        std::vector<size_t> indexMask;
+        if (!this->selectColumns(column_count, column_infos, indexMask)) {
+            this->columnInfos.clear();
+            this->columns.clear();
+            return false;
+        }
+
+        // columns that are not scaled are passed on by reference
+        this->columnInfos.assign(column_infos, column_infos + column_count);
+        this->columns.clear();
+        this->columns.reserve(column_count);
+        for (size_t col = 0; col < column_count; col++) {
+            this->columns.push_back(inCall->GetColumn(col));
+        }
+
+        for (auto &col : indexMask) {
+            this->columnInfos[col].SetMinimumValue(this->columnInfos[col].MinimumValue()*scalingFactor);
+            this->columnInfos[col].SetMaximumValue(this->columnInfos[col].MaximumValue()*scalingFactor);
+
+            std::vector<float> scaled(rows_count);
+            const float *in_data = inCall->GetColumnData(col);
+            for (size_t row = 0; row < rows_count; row++) {
+                scaled[row] = in_data[row] * scalingFactor;
+            }
+            this->columns[col] = ColumnarTableDataCall::MakeColumn(std::move(scaled));
+        }
+    }
+
+    outCall.SetFrameCount(inCall->GetFrameCount());
+    outCall.SetFrameID(this->frameID);
+    outCall.SetDataHash(this->datahash);
+    if (this->columns.size() != 0) {
+        outCall.Set(inCall->GetRowsCount(), this->columnInfos, this->columns);
+    } else {
+        outCall.Clear();
+    }
+
+    return true;
+}
+
+
+/*
+ * TableColumnScaler::selectColumns
+ */
+bool TableColumnScaler::selectColumns(size_t column_count, const TableDataCall::ColumnInfo *column_infos,
+        std::vector<size_t> &indexMask) const {
+    auto selectionString = this->columnSelectorSlot.Param<core::param::StringParam>()->Value();
+    selectionString.Remove(vislib::TString(" "));
+    auto st = vislib::StringTokeniserW(selectionString, vislib::TString(";"));
+    auto selectors = st.Split(selectionString, vislib::TString(";"));
+
+    if (selectors.Count() == 0) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No valid selectors have been given\n"),
+            ModuleName.c_str());
+        return false;
+    }
+
+    indexMask.clear();
+    indexMask.reserve(selectors.Count());
+    for (size_t sel = 0; sel < selectors.Count(); sel++) {
+        for (size_t col = 0; col < column_count; col++) {
+            if (selectors[sel].CompareInsensitive(vislib::TString(
+                column_infos[col].Name().c_str()))) {
+                indexMask.push_back(col);
+                break;
+            }
+        }
+        //// if we reach this, no match has been found
+        //megamol::core::utility::log::Log::DefaultLog.WriteInfo(_T("%hs: No match has been found for selector %s\n"),
+        //    ModuleName.c_str(), selectors[sel].PeekBuffer());
+    }
+
+    if (indexMask.size() == 0) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: No matches for selectors have been found\n"),
+            ModuleName.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+
 /*
  * TableColumnSelector::getExtent
  */
 bool TableColumnScaler::getExtent(core::Call &c) {
     try {
+        ColumnarTableDataCall *columnarCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+        if (columnarCall != NULL) {
+            ColumnarTableDataCall *inCall = this->dataInSlot.CallAs<ColumnarTableDataCall>();
+            if (inCall == NULL) return false;
+
+            inCall->SetFrameID(columnarCall->GetFrameID());
+            if (!(*inCall)(1)) return false;
+
+            columnarCall->SetFrameCount(inCall->GetFrameCount());
+            columnarCall->SetDataHash(this->datahash);
+            return true;
+        }
+
         TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
         if (outCall == NULL) return false;
 
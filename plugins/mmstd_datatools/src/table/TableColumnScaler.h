@@ -15,6 +15,7 @@
 
 #include "mmcore/param/ParamSlot.h"
 
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 namespace megamol {
@@ -79,6 +80,21 @@ private:
 
     bool getExtent(core::Call &c);
 
+    /** Data callback for columnar tables, only the scaled columns are copied */
+    bool processColumnarData(ColumnarTableDataCall &outCall);
+
+    /**
+     * Matches the column selector against the column names.
+     *
+     * @param column_count The number of columns
+     * @param column_infos The column descriptions
+     * @param indexMask Receives the indices of the selected columns
+     *
+     * @return False if no column is selected
+     */
+    bool selectColumns(size_t column_count, const TableDataCall::ColumnInfo *column_infos,
+        std::vector<size_t> &indexMask) const;
+
     core::CalleeSlot dataOutSlot;
 
     core::CallerSlot dataInSlot;
@@ -94,6 +110,12 @@ private:
     std::vector<TableDataCall::ColumnInfo> columnInfos;
 
     std::vector<float> data;
+
+    /** The columns, if the table was last requested as columnar table */
+    std::vector<ColumnarTableDataCall::Column> columns;
+
+    /** Whether 'columns' instead of 'data' holds the table */
+    bool isColumnar;
 }; /* end class TableColumnScaler */
 
 } /* end namespace table */
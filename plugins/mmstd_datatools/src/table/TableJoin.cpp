@@ -8,8 +8,17 @@
 #include "stdafx.h"
 #include "TableJoin.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <limits>
 
+#include "mmcore/param/EnumParam.h"
+#include "mmcore/param/FlexEnumParam.h"
+
+#include "omp.h"
+
 using namespace megamol::stdplugin::datatools;
 using namespace megamol::stdplugin::datatools::table;
 using namespace megamol;
@@ -22,16 +31,90 @@ size_t hash_combine(size_t lhs, size_t rhs) {
     return lhs;
 }
 
+namespace {
+
+/** answers the bits of a key, so that 0 and -0 compare equal */
+inline uint32_t keyBits(float key) {
+    if (key == 0.0f) key = 0.0f;
+    uint32_t bits;
+    std::memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+/** 64 bit finalizer of splitmix64, the upper bits select the partition, the lower the bucket */
+inline uint64_t keyHash(uint32_t bits) {
+    uint64_t h = bits + 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 30)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 27)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 31);
+}
+
+inline size_t partitionOf(uint64_t hash, size_t partCount) {
+    return static_cast<size_t>(hash >> 40) & (partCount - 1);
+}
+
+/**
+ * Sorts the rows of a table by the partition of their key with a parallel counting sort. Afterwards the rows of
+ * partition p are rows[offsets[p]] to rows[offsets[p + 1] - 1] in ascending order. Rows with a NaN key are omitted.
+ */
+void partitionRows(const float* const table, const size_t rowCount, const size_t columnCount, const size_t key,
+    const size_t partCount, std::vector<size_t>& offsets, std::vector<size_t>& rows) {
+    // contiguous row ranges, one per chunk, so the chunks concatenate in ascending row order
+    const int64_t chunkCount =
+        std::max<int64_t>(1, std::min<int64_t>(omp_get_max_threads(), static_cast<int64_t>(rowCount)));
+    auto chunkBegin = [rowCount, chunkCount](int64_t c) { return rowCount * c / chunkCount; };
+    std::vector<std::vector<size_t>> cursor(chunkCount, std::vector<size_t>(partCount, 0));
+
+#pragma omp parallel for
+    for (int64_t c = 0; c < chunkCount; ++c) {
+        for (size_t row = chunkBegin(c); row < chunkBegin(c + 1); ++row) {
+            const float k = table[row * columnCount + key];
+            if (std::isnan(k)) continue;
+            ++cursor[c][partitionOf(keyHash(keyBits(k)), partCount)];
+        }
+    }
+
+    offsets.assign(partCount + 1, 0);
+    size_t total = 0;
+    for (size_t p = 0; p < partCount; ++p) {
+        offsets[p] = total;
+        for (auto& c : cursor) {
+            const auto cnt = c[p];
+            c[p] = total;
+            total += cnt;
+        }
+    }
+    offsets[partCount] = total;
+    rows.resize(total);
+
+#pragma omp parallel for
+    for (int64_t c = 0; c < chunkCount; ++c) {
+        for (size_t row = chunkBegin(c); row < chunkBegin(c + 1); ++row) {
+            const float k = table[row * columnCount + key];
+            if (std::isnan(k)) continue;
+            rows[cursor[c][partitionOf(keyHash(keyBits(k)), partCount)]++] = row;
+        }
+    }
+}
+
+} // namespace
+
 TableJoin::TableJoin(void) : core::Module(),
     firstTableInSlot("firstTableIn", "First input"),
     secondTableInSlot("secondTableIn", "Second input"),
     dataOutSlot("dataOut", "Output"),
+    joinTypeSlot("joinType", "Concatenate the rows by index or join them on the key columns"),
+    firstKeySlot("firstKey", "Key column of the first table"),
+    secondKeySlot("secondKey", "Key column of the second table"),
     frameID(-1),
-    firstDataHash(std::numeric_limits<unsigned long>::max()), secondDataHash(std::numeric_limits<unsigned long>::max()) {
+    firstDataHash(std::numeric_limits<unsigned long>::max()), secondDataHash(std::numeric_limits<unsigned long>::max()),
+    localHash(0), isColumnar(false) {
     this->firstTableInSlot.SetCompatibleCall<TableDataCallDescription>();
+    this->firstTableInSlot.SetCompatibleCall<ColumnarTableDataCallDescription>();
     this->MakeSlotAvailable(&this->firstTableInSlot);
 
     this->secondTableInSlot.SetCompatibleCall<TableDataCallDescription>();
+    this->secondTableInSlot.SetCompatibleCall<ColumnarTableDataCallDescription>();
     this->MakeSlotAvailable(&this->secondTableInSlot);
 
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
@@ -40,7 +123,27 @@ TableJoin::TableJoin(void) : core::Module(),
     this->dataOutSlot.SetCallback(TableDataCall::ClassName(),
         TableDataCall::FunctionName(1),
         &TableJoin::getExtent);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(0),
+        &TableJoin::processData);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(1),
+        &TableJoin::getExtent);
     this->MakeSlotAvailable(&this->dataOutSlot);
+
+    auto* jt = new core::param::EnumParam(CONCATENATE);
+    jt->SetTypePair(CONCATENATE, "Concatenate");
+    jt->SetTypePair(INNER_JOIN, "Inner");
+    jt->SetTypePair(LEFT_JOIN, "Left");
+    jt->SetTypePair(OUTER_JOIN, "Outer");
+    this->joinTypeSlot << jt;
+    this->MakeSlotAvailable(&this->joinTypeSlot);
+
+    this->firstKeySlot << new core::param::FlexEnumParam("undef");
+    this->MakeSlotAvailable(&this->firstKeySlot);
+
+    this->secondKeySlot << new core::param::FlexEnumParam("undef");
+    this->MakeSlotAvailable(&this->secondKeySlot);
 }
 
 TableJoin::~TableJoin(void) {
@@ -57,6 +160,9 @@ void TableJoin::release(void) {
 
 bool TableJoin::processData(core::Call &c) {
     try {
+        ColumnarTableDataCall *columnarCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+        if (columnarCall != NULL) return this->processColumnarData(*columnarCall);
+
         TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
         if (outCall == NULL) return false;
 
@@ -85,44 +191,56 @@ bool TableJoin::processData(core::Call &c) {
         if (!(*firstInCall)()) return false;
         if (!(*secondInCall)()) return false;
 
+        const bool paramsChanged =
+            this->joinTypeSlot.IsDirty() || this->firstKeySlot.IsDirty() || this->secondKeySlot.IsDirty();
         if (this->firstDataHash != firstInCall->DataHash() || this->secondDataHash != secondInCall->DataHash()
-            || this->frameID != firstInCall->GetFrameID() || this->frameID != secondInCall->GetFrameID()) {
+            || this->frameID != firstInCall->GetFrameID() || this->frameID != secondInCall->GetFrameID()
+            || paramsChanged || this->isColumnar) {
             this->firstDataHash = firstInCall->DataHash();
             this->secondDataHash = secondInCall->DataHash();
             ASSERT(firstInCall->GetFrameID() == secondInCall->GetFrameID());
             this->frameID = firstInCall->GetFrameID();
+            if (paramsChanged) {
+                ++this->localHash;
+                this->joinTypeSlot.ResetDirty();
+                this->firstKeySlot.ResetDirty();
+                this->secondKeySlot.ResetDirty();
+            }
+            this->isColumnar = false;
+            this->columns.clear();
 
             // retrieve data
             auto firstRowsCount = firstInCall->GetRowsCount();
             auto firstColumnCount = firstInCall->GetColumnsCount();
-            auto firstColumnInfos = firstInCall->GetColumnsInfos();
             auto firstData = firstInCall->GetData();
 
             auto secondRowsCount = secondInCall->GetRowsCount();
             auto secondColumnCount = secondInCall->GetColumnsCount();
-            auto secondColumnInfos = secondInCall->GetColumnsInfos();
             auto secondData = secondInCall->GetData();
 
-            // concatenate
-            this->rows_count = std::max(firstRowsCount, secondRowsCount);
-            this->column_count = firstColumnCount + secondColumnCount;
-            this->column_info.clear();
-            this->column_info.resize(this->column_count);
-            memcpy(this->column_info.data(), firstColumnInfos,
-                sizeof(TableDataCall::ColumnInfo)*firstColumnCount);
-            memcpy(&(this->column_info.data()[firstColumnCount]), secondColumnInfos,
-                sizeof(TableDataCall::ColumnInfo)*secondColumnCount);
-            this->data.clear();
-            this->data.resize(this->rows_count * this->column_count);
-
-            this->concatenate(this->data.data(), this->rows_count, this->column_count,
-				firstData, firstRowsCount, firstColumnCount,
-				secondData, secondRowsCount, secondColumnCount);
+            const auto type = static_cast<JoinType>(this->joinTypeSlot.Param<core::param::EnumParam>()->Value());
+            size_t firstKey, secondKey;
+            if (!this->updateColumns(type, firstInCall->GetColumnsInfos(), firstColumnCount,
+                    secondInCall->GetColumnsInfos(), secondColumnCount, firstKey, secondKey)) {
+                this->rows_count = 0;
+                this->data.clear();
+            } else if (type == CONCATENATE) {
+                this->rows_count = std::max(firstRowsCount, secondRowsCount);
+                this->data.clear();
+                this->data.resize(this->rows_count * this->column_count);
+
+                this->concatenate(this->data.data(), this->rows_count, this->column_count,
+                    firstData, firstRowsCount, firstColumnCount,
+                    secondData, secondRowsCount, secondColumnCount);
+            } else {
+                this->rows_count = join(type, firstData, firstRowsCount, firstColumnCount, firstKey,
+                    secondData, secondRowsCount, secondColumnCount, secondKey, this->data);
+            }
         }
 
         outCall->SetFrameCount(firstInCall->GetFrameCount());
         outCall->SetFrameID(this->frameID);
-        outCall->SetDataHash(hash_combine(this->firstDataHash, this->secondDataHash));
+        outCall->SetDataHash(hash_combine(hash_combine(this->firstDataHash, this->secondDataHash), this->localHash));
         outCall->Set(this->column_count, this->rows_count, this->column_info.data(), this->data.data());
     } catch (...) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(_T("Failed to execute %hs::processData\n"),
@@ -133,6 +251,149 @@ bool TableJoin::processData(core::Call &c) {
     return true;
 }
 
+bool TableJoin::processColumnarData(ColumnarTableDataCall &outCall) {
+    ColumnarTableDataCall *firstInCall = this->firstTableInSlot.CallAs<ColumnarTableDataCall>();
+    ColumnarTableDataCall *secondInCall = this->secondTableInSlot.CallAs<ColumnarTableDataCall>();
+    if (firstInCall == NULL || secondInCall == NULL) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: Columnar output requires columnar inputs\n"),
+            ModuleName.c_str());
+        return false;
+    }
+
+    // call getHash before check of frame count
+    if (!(*firstInCall)(1)) return false;
+    if (!(*secondInCall)(1)) return false;
+
+    // check time compatibility
+    if (firstInCall->GetFrameCount() != secondInCall->GetFrameCount()) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(_T("%hs: Cannot join tables. ")
+            _T("They are required to have equal frame count\n"), ModuleName.c_str());
+        return false;
+    }
+
+    firstInCall->SetFrameID(outCall.GetFrameID());
+    secondInCall->SetFrameID(outCall.GetFrameID());
+    if (!(*firstInCall)(0)) return false;
+    if (!(*secondInCall)(0)) return false;
+
+    const bool paramsChanged =
+        this->joinTypeSlot.IsDirty() || this->firstKeySlot.IsDirty() || this->secondKeySlot.IsDirty();
+    if (this->firstDataHash != firstInCall->DataHash() || this->secondDataHash != secondInCall->DataHash()
+        || this->frameID != firstInCall->GetFrameID() || this->frameID != secondInCall->GetFrameID()
+        || paramsChanged || !this->isColumnar) {
+        this->firstDataHash = firstInCall->DataHash();
+        this->secondDataHash = secondInCall->DataHash();
+        ASSERT(firstInCall->GetFrameID() == secondInCall->GetFrameID());
+        this->frameID = firstInCall->GetFrameID();
+        if (paramsChanged) {
+            ++this->localHash;
+            this->joinTypeSlot.ResetDirty();
+            this->firstKeySlot.ResetDirty();
+            this->secondKeySlot.ResetDirty();
+        }
+        this->isColumnar = true;
+        this->data.clear();
+
+        const auto firstRowsCount = firstInCall->GetRowsCount();
+        const auto secondRowsCount = secondInCall->GetRowsCount();
+        std::vector<ColumnarTableDataCall::Column> firstColumns, secondColumns;
+        for (size_t col = 0; col < firstInCall->GetColumnsCount(); ++col) {
+            firstColumns.push_back(firstInCall->GetColumn(col));
+        }
+        for (size_t col = 0; col < secondInCall->GetColumnsCount(); ++col) {
+            secondColumns.push_back(secondInCall->GetColumn(col));
+        }
+
+        const auto type = static_cast<JoinType>(this->joinTypeSlot.Param<core::param::EnumParam>()->Value());
+        size_t firstKey, secondKey;
+        this->columns.clear();
+        if (!this->updateColumns(type, firstInCall->GetColumnsInfos(), firstColumns.size(),
+                secondInCall->GetColumnsInfos(), secondColumns.size(), firstKey, secondKey)) {
+            this->rows_count = 0;
+        } else if (type == CONCATENATE) {
+            // only the columns of the shorter table are copied, to pad them with NaN
+            this->rows_count = std::max(firstRowsCount, secondRowsCount);
+            this->columns.reserve(this->column_count);
+            auto append = [this](const std::vector<ColumnarTableDataCall::Column>& in, size_t rowCount) {
+                for (auto const& col : in) {
+                    if (rowCount == this->rows_count) {
+                        this->columns.push_back(col);
+                    } else {
+                        std::vector<float> values(this->rows_count, NAN);
+                        std::copy(col->begin(), col->end(), values.begin());
+                        this->columns.push_back(ColumnarTableDataCall::MakeColumn(std::move(values)));
+                    }
+                }
+            };
+            append(firstColumns, firstRowsCount);
+            append(secondColumns, secondRowsCount);
+        } else {
+            this->rows_count = joinColumns(type, firstColumns, firstRowsCount, firstKey, secondColumns,
+                secondRowsCount, secondKey, this->columns);
+        }
+    }
+
+    outCall.SetFrameCount(firstInCall->GetFrameCount());
+    outCall.SetFrameID(this->frameID);
+    outCall.SetDataHash(hash_combine(hash_combine(this->firstDataHash, this->secondDataHash), this->localHash));
+    outCall.Set(this->rows_count, this->column_info, this->columns);
+
+    return true;
+}
+
+bool TableJoin::updateColumns(JoinType type, const TableDataCall::ColumnInfo* firstColumnInfos,
+    const size_t firstColumnCount, const TableDataCall::ColumnInfo* secondColumnInfos,
+    const size_t secondColumnCount, size_t& firstKey, size_t& secondKey) {
+    // offer the columns as keys
+    auto firstKeyParam = this->firstKeySlot.Param<core::param::FlexEnumParam>();
+    auto secondKeyParam = this->secondKeySlot.Param<core::param::FlexEnumParam>();
+    firstKeyParam->ClearValues();
+    for (size_t col = 0; col < firstColumnCount; ++col) {
+        firstKeyParam->AddValue(firstColumnInfos[col].Name());
+    }
+    secondKeyParam->ClearValues();
+    for (size_t col = 0; col < secondColumnCount; ++col) {
+        secondKeyParam->AddValue(secondColumnInfos[col].Name());
+    }
+
+    this->column_info.clear();
+    if (type == CONCATENATE) {
+        this->column_count = firstColumnCount + secondColumnCount;
+        this->column_info.reserve(this->column_count);
+        this->column_info.insert(this->column_info.end(), firstColumnInfos, firstColumnInfos + firstColumnCount);
+        this->column_info.insert(this->column_info.end(), secondColumnInfos, secondColumnInfos + secondColumnCount);
+        return true;
+    }
+
+    auto findColumn = [](const TableDataCall::ColumnInfo* infos, size_t count, const std::string& name) {
+        size_t col = 0;
+        while (col < count && infos[col].Name() != name) ++col;
+        return col;
+    };
+    firstKey = findColumn(firstColumnInfos, firstColumnCount, firstKeyParam->Value());
+    secondKey = findColumn(secondColumnInfos, secondColumnCount, secondKeyParam->Value());
+    if (firstKey == firstColumnCount || secondKey == secondColumnCount) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError(
+            _T("%hs: Cannot join tables. Select a key column of each table\n"), ModuleName.c_str());
+        this->column_count = 0;
+        return false;
+    }
+
+    // the key of the second table is redundant, in an outer join it fills the gaps of the first key
+    this->column_count = firstColumnCount + secondColumnCount - 1;
+    this->column_info.reserve(this->column_count);
+    this->column_info.insert(this->column_info.end(), firstColumnInfos, firstColumnInfos + firstColumnCount);
+    for (size_t col = 0; col < secondColumnCount; ++col) {
+        if (col != secondKey) this->column_info.push_back(secondColumnInfos[col]);
+    }
+    if (type == OUTER_JOIN) {
+        auto& keyInfo = this->column_info[firstKey];
+        keyInfo.SetMinimumValue(std::min(keyInfo.MinimumValue(), secondColumnInfos[secondKey].MinimumValue()));
+        keyInfo.SetMaximumValue(std::max(keyInfo.MaximumValue(), secondColumnInfos[secondKey].MaximumValue()));
+    }
+    return true;
+}
+
 void TableJoin::concatenate(
 	float* const out, const size_t rowCount, const size_t columnCount,
 	const float* const first, const size_t firstRowCount, const size_t firstColumnCount, 
@@ -159,8 +420,206 @@ void TableJoin::concatenate(
     }
 }
 
+void TableJoin::matchRows(JoinType type, const float* const first, const size_t firstRowCount,
+    const size_t firstStride, const size_t firstKey, const float* const second, const size_t secondRowCount,
+    const size_t secondStride, const size_t secondKey, std::vector<size_t>& firstRows,
+    std::vector<size_t>& secondRows) {
+    // enough partitions for all threads, each hash table small enough to stay in cache
+    size_t partCount = 1;
+    while (partCount < 4 * static_cast<size_t>(omp_get_max_threads()) || partCount * 8192 < secondRowCount) {
+        partCount <<= 1;
+    }
+    partCount = std::min<size_t>(partCount, 1 << 16);
+
+    std::vector<size_t> firstOffsets, firstPartRows, secondOffsets, secondPartRows;
+    partitionRows(first, firstRowCount, firstStride, firstKey, partCount, firstOffsets, firstPartRows);
+    partitionRows(second, secondRowCount, secondStride, secondKey, partCount, secondOffsets, secondPartRows);
+
+    // chained hash table per partition of the second table, the chains list the rows in ascending order
+    std::vector<size_t> bucketOffsets(partCount + 1, 0);
+    for (size_t p = 0; p < partCount; ++p) {
+        size_t buckets = 1;
+        while (buckets < 2 * (secondOffsets[p + 1] - secondOffsets[p])) buckets <<= 1;
+        bucketOffsets[p + 1] = bucketOffsets[p] + buckets;
+    }
+    std::vector<int64_t> heads(bucketOffsets[partCount], -1);
+    std::vector<int64_t> next(secondPartRows.size(), -1);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t p = 0; p < static_cast<int64_t>(partCount); ++p) {
+        const size_t mask = bucketOffsets[p + 1] - bucketOffsets[p] - 1;
+        for (int64_t e = static_cast<int64_t>(secondOffsets[p + 1]) - 1; e >= static_cast<int64_t>(secondOffsets[p]);
+             --e) {
+            const auto bits = keyBits(second[secondPartRows[e] * secondStride + secondKey]);
+            auto& head = heads[bucketOffsets[p] + (keyHash(bits) & mask)];
+            next[e] = head;
+            head = e;
+        }
+    }
+
+    // calls f(second row) for all matches of a row of the first table
+    auto forMatches = [&](size_t p, size_t firstRow, auto const& f) {
+        const auto bits = keyBits(first[firstRow * firstStride + firstKey]);
+        const size_t mask = bucketOffsets[p + 1] - bucketOffsets[p] - 1;
+        for (auto e = heads[bucketOffsets[p] + (keyHash(bits) & mask)]; e >= 0; e = next[e]) {
+            const auto secondRow = secondPartRows[e];
+            if (keyBits(second[secondRow * secondStride + secondKey]) == bits) f(secondRow);
+        }
+    };
+
+    // count the output rows of each row of the first table
+    std::vector<size_t> outOffsets(firstRowCount + 1, 0);
+    std::vector<char> secondMatched(secondRowCount, 0);
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t p = 0; p < static_cast<int64_t>(partCount); ++p) {
+        for (size_t e = firstOffsets[p]; e < firstOffsets[p + 1]; ++e) {
+            const auto firstRow = firstPartRows[e];
+            forMatches(p, firstRow, [&](size_t secondRow) {
+                ++outOffsets[firstRow + 1];
+                secondMatched[secondRow] = 1;
+            });
+        }
+    }
+    std::vector<char> firstMatched(firstRowCount, 0);
+    for (size_t row = 0; row < firstRowCount; ++row) {
+        firstMatched[row] = (outOffsets[row + 1] > 0);
+        if (!firstMatched[row] && type != INNER_JOIN) outOffsets[row + 1] = 1;
+        outOffsets[row + 1] += outOffsets[row];
+    }
+    std::vector<size_t> secondUnmatched;
+    if (type == OUTER_JOIN) {
+        for (size_t row = 0; row < secondRowCount; ++row) {
+            if (!secondMatched[row]) secondUnmatched.push_back(row);
+        }
+    }
+
+    const size_t rowCount = outOffsets[firstRowCount] + secondUnmatched.size();
+    firstRows.resize(rowCount);
+    secondRows.resize(rowCount);
+
+    // the matches of a row of the first table in the order of the second table
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int64_t p = 0; p < static_cast<int64_t>(partCount); ++p) {
+        for (size_t e = firstOffsets[p]; e < firstOffsets[p + 1]; ++e) {
+            const auto firstRow = firstPartRows[e];
+            auto outRow = outOffsets[firstRow];
+            forMatches(p, firstRow, [&](size_t secondRow) {
+                firstRows[outRow] = firstRow;
+                secondRows[outRow++] = secondRow;
+            });
+        }
+    }
+    if (type != INNER_JOIN) {
+#pragma omp parallel for
+        for (int64_t row = 0; row < static_cast<int64_t>(firstRowCount); ++row) {
+            if (!firstMatched[row]) {
+                firstRows[outOffsets[row]] = row;
+                secondRows[outOffsets[row]] = SIZE_MAX;
+            }
+        }
+    }
+    for (size_t i = 0; i < secondUnmatched.size(); ++i) {
+        firstRows[outOffsets[firstRowCount] + i] = SIZE_MAX;
+        secondRows[outOffsets[firstRowCount] + i] = secondUnmatched[i];
+    }
+}
+
+size_t TableJoin::join(JoinType type, const float* const first, const size_t firstRowCount,
+    const size_t firstColumnCount, const size_t firstKey, const float* const second, const size_t secondRowCount,
+    const size_t secondColumnCount, const size_t secondKey, std::vector<float>& out) {
+    const size_t columnCount = firstColumnCount + secondColumnCount - 1;
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<size_t> firstRows, secondRows;
+    matchRows(type, first, firstRowCount, firstColumnCount, firstKey, second, secondRowCount, secondColumnCount,
+        secondKey, firstRows, secondRows);
+    const size_t rowCount = firstRows.size();
+    out.resize(rowCount * columnCount);
+
+#pragma omp parallel for
+    for (int64_t outRow = 0; outRow < static_cast<int64_t>(rowCount); ++outRow) {
+        const auto firstRow = firstRows[outRow];
+        const auto secondRow = secondRows[outRow];
+        float* dst = out.data() + outRow * columnCount;
+        if (firstRow != SIZE_MAX) {
+            std::copy_n(first + firstRow * firstColumnCount, firstColumnCount, dst);
+        } else {
+            std::fill_n(dst, firstColumnCount, nan);
+            dst[firstKey] = second[secondRow * secondColumnCount + secondKey];
+        }
+        dst += firstColumnCount;
+        if (secondRow != SIZE_MAX) {
+            const float* in = second + secondRow * secondColumnCount;
+            dst = std::copy_n(in, secondKey, dst);
+            std::copy_n(in + secondKey + 1, secondColumnCount - secondKey - 1, dst);
+        } else {
+            std::fill_n(dst, secondColumnCount - 1, nan);
+        }
+    }
+
+    return rowCount;
+}
+
+size_t TableJoin::joinColumns(JoinType type, const std::vector<ColumnarTableDataCall::Column>& first,
+    const size_t firstRowCount, const size_t firstKey, const std::vector<ColumnarTableDataCall::Column>& second,
+    const size_t secondRowCount, const size_t secondKey, std::vector<ColumnarTableDataCall::Column>& out) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<size_t> firstRows, secondRows;
+    matchRows(type, first[firstKey]->data(), firstRowCount, 1, 0, second[secondKey]->data(), secondRowCount, 1, 0,
+        firstRows, secondRows);
+    const size_t rowCount = firstRows.size();
+
+    bool isFirstInPlace = (rowCount == firstRowCount);
+    for (size_t row = 0; isFirstInPlace && (row < rowCount); ++row) {
+        isFirstInPlace = (firstRows[row] == row);
+    }
+
+    // values of a column in output order, missing rows are NaN unless 'fill' holds the key of the second table
+    auto gather = [&](const float* in, const std::vector<size_t>& rows, const float* fill) {
+        std::vector<float> values(rowCount);
+#pragma omp parallel for
+        for (int64_t row = 0; row < static_cast<int64_t>(rowCount); ++row) {
+            if (rows[row] != SIZE_MAX) {
+                values[row] = in[rows[row]];
+            } else {
+                values[row] = (fill != nullptr) ? fill[secondRows[row]] : nan;
+            }
+        }
+        return ColumnarTableDataCall::MakeColumn(std::move(values));
+    };
+
+    out.clear();
+    out.reserve(first.size() + second.size() - 1);
+    for (size_t col = 0; col < first.size(); ++col) {
+        if (isFirstInPlace) {
+            out.push_back(first[col]);
+        } else {
+            out.push_back(gather(first[col]->data(), firstRows, (col == firstKey) ? second[secondKey]->data() : nullptr));
+        }
+    }
+    for (size_t col = 0; col < second.size(); ++col) {
+        if (col != secondKey) out.push_back(gather(second[col]->data(), secondRows, nullptr));
+    }
+
+    return rowCount;
+}
+
 bool TableJoin::getExtent(core::Call &c) {
     try {
+        ColumnarTableDataCall *columnarCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+        if (columnarCall != NULL) {
+            ColumnarTableDataCall *inCall = this->firstTableInSlot.CallAs<ColumnarTableDataCall>();
+            if (inCall == NULL) return false;
+
+            inCall->SetFrameID(columnarCall->GetFrameID());
+            if (!(*inCall)(1)) return false;
+
+            columnarCall->SetFrameCount(inCall->GetFrameCount());
+            columnarCall->SetDataHash(
+                hash_combine(hash_combine(this->firstDataHash, this->secondDataHash), this->localHash));
+            return true;
+        }
+
         TableDataCall *outCall = dynamic_cast<TableDataCall *>(&c);
         if (outCall == NULL) return false;
 
@@ -171,7 +630,7 @@ bool TableJoin::getExtent(core::Call &c) {
         if (!(*inCall)(1)) return false;
 
         outCall->SetFrameCount(inCall->GetFrameCount());
-        outCall->SetDataHash(hash_combine(this->firstDataHash, this->secondDataHash));
+        outCall->SetDataHash(hash_combine(hash_combine(this->firstDataHash, this->secondDataHash), this->localHash));
     }
     catch (...) {
         megamol::core::utility::log::Log::DefaultLog.WriteError(_T("Failed to execute %hs::getExtent\n"), ModuleName.c_str());
@@ -15,6 +15,7 @@
 
 #include "mmcore/param/ParamSlot.h"
 
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 namespace megamol {
@@ -23,10 +24,18 @@ namespace datatools {
 namespace table {
 
 /**
- * This module joins two tables by copying the values together into one matrix
+ * This module joins two tables, either by copying the values together into one matrix row by row or by an equi-join
+ * on a key column of each table
  */
 class TableJoin : public core::Module {
 public:
+    enum JoinType {
+        CONCATENATE = 0,
+        INNER_JOIN = 1,
+        LEFT_JOIN = 2,
+        OUTER_JOIN = 3
+    };
+
     static std::string ModuleName;
 
     /**
@@ -44,7 +53,7 @@ public:
      * @return A human readable description of this module.
      */
     static inline const char *Description(void) {
-        return "Joins two tables (union of columns)";
+        return "Joins two tables, row by row or on key columns";
     }
 
     /**
@@ -66,6 +75,35 @@ public:
      */
     virtual ~TableJoin(void);
 
+    /**
+     * Equi-join of two tables as a parallel partitioned hash join.
+     *
+     * The output contains all columns of the first table followed by the columns of the second table except its
+     * key. Rows appear in the order of the first table, matches of one row in the order of the second table, rows of
+     * the second table without a match (OUTER_JOIN only) at the end. Missing values are NaN, NaN keys never match.
+     *
+     * @param out Receives the joined table, row major.
+     *
+     * @return The number of rows of the joined table.
+     */
+    static size_t join(JoinType type, const float* const first, const size_t firstRowCount,
+        const size_t firstColumnCount, const size_t firstKey, const float* const second, const size_t secondRowCount,
+        const size_t secondColumnCount, const size_t secondKey, std::vector<float>& out);
+
+    /**
+     * Equi-join of two tables stored column by column, with the same output as 'join'.
+     *
+     * If the rows of the first table stay in place, as in a left join on unique keys, its columns are passed on
+     * without copying them.
+     *
+     * @param out Receives the columns of the joined table.
+     *
+     * @return The number of rows of the joined table.
+     */
+    static size_t joinColumns(JoinType type, const std::vector<ColumnarTableDataCall::Column>& first,
+        const size_t firstRowCount, const size_t firstKey, const std::vector<ColumnarTableDataCall::Column>& second,
+        const size_t secondRowCount, const size_t secondKey, std::vector<ColumnarTableDataCall::Column>& out);
+
 protected:
     /**
      * Implementation of 'Create'.
@@ -83,9 +121,30 @@ private:
     /** data callback */
     bool processData(core::Call &c);
 
+    /** data callback for columnar tables */
+    bool processColumnarData(ColumnarTableDataCall &outCall);
+
     /** extent callback */
     bool getExtent(core::Call &c);
 
+    /**
+     * Offers the columns of both tables as keys and sets the column descriptions of the output.
+     *
+     * @return False if a join has no valid key columns, the output is empty then.
+     */
+    bool updateColumns(JoinType type, const TableDataCall::ColumnInfo* firstColumnInfos,
+        const size_t firstColumnCount, const TableDataCall::ColumnInfo* secondColumnInfos,
+        const size_t secondColumnCount, size_t& firstKey, size_t& secondKey);
+
+    /**
+     * Matches the rows of two tables on their keys. The i-th output row of 'join' is made of the rows firstRows[i]
+     * and secondRows[i], SIZE_MAX marks a missing row. The keys are read at table[row * stride + key].
+     */
+    static void matchRows(JoinType type, const float* const first, const size_t firstRowCount,
+        const size_t firstStride, const size_t firstKey, const float* const second, const size_t secondRowCount,
+        const size_t secondStride, const size_t secondKey, std::vector<size_t>& firstRows,
+        std::vector<size_t>& secondRows);
+
     /** concatenates two tables */
     static void concatenate(float* const out, const size_t rowCount, const size_t columnCount,
         const float* const first, const size_t firstRowCount, const size_t firstColumnCount, const float* const second,
@@ -100,6 +159,15 @@ private:
     /** data output */
     core::CalleeSlot dataOutSlot;
 
+    /** concatenation or type of the join */
+    core::param::ParamSlot joinTypeSlot;
+
+    /** key column of the first table */
+    core::param::ParamSlot firstKeySlot;
+
+    /** key column of the second table */
+    core::param::ParamSlot secondKeySlot;
+
     /** frameID */
     int frameID;
 
@@ -107,6 +175,9 @@ private:
     size_t firstDataHash;
     size_t secondDataHash;
 
+    /** incremented on parameter changes */
+    size_t localHash;
+
     /** number of rows of the table */
     size_t rows_count;
 
@@ -118,6 +189,12 @@ private:
 
     /** vector storing the data values of the table */
     std::vector<float> data;
+
+    /** columns of the table, if it was last requested as columnar table */
+    std::vector<ColumnarTableDataCall::Column> columns;
+
+    /** whether 'columns' instead of 'data' holds the table */
+    bool isColumnar;
 }; /* end class TableJoin */
 
 } /* end namespace table */
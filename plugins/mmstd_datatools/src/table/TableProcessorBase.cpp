@@ -11,6 +11,7 @@
 #include <cassert>
 #include <limits>
 
+#include "mmcore/param/FlexEnumParam.h"
 #include "mmcore/utility/log/Log.h"
 
 /*
@@ -21,9 +22,11 @@ megamol::stdplugin::datatools::table::TableProcessorBase::TableProcessorBase(voi
         inputHash(0),
         localHash(0),
         slotInput("input", "The input slot providing the unfiltered data."),
-        slotOutput("output", "The input slot for the filtered data.") {
+        slotOutput("output", "The input slot for the filtered data."),
+        isColumnar(false) {
     /* Export the calls. */
     this->slotInput.SetCompatibleCall<TableDataCallDescription>();
+    this->slotInput.SetCompatibleCall<ColumnarTableDataCallDescription>();
     this->MakeSlotAvailable(&this->slotInput);
 
     this->slotOutput.SetCallback(TableDataCall::ClassName(),
@@ -32,10 +35,69 @@ megamol::stdplugin::datatools::table::TableProcessorBase::TableProcessorBase(voi
     this->slotOutput.SetCallback(TableDataCall::ClassName(),
         TableDataCall::FunctionName(1),
         &TableProcessorBase::getHash);
+    this->slotOutput.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(0),
+        &TableProcessorBase::getData);
+    this->slotOutput.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(1),
+        &TableProcessorBase::getHash);
     this->MakeSlotAvailable(&this->slotOutput);
 }
 
 
+/*
+ * megamol::stdplugin::datatools::table::TableProcessorBase::updateColumns
+ */
+std::size_t megamol::stdplugin::datatools::table::TableProcessorBase::updateColumns(
+        const ColumnInfo *infos, const std::size_t count,
+        core::param::ParamSlot& columnParam) {
+    using namespace core::param;
+
+    /* Copy the column descriptors. */
+    this->columns.resize(count);
+    std::copy(infos, infos + count, this->columns.begin());
+
+    /* Update the column selector. */
+    auto param = columnParam.Param<FlexEnumParam>();
+    param->ClearValues();
+    for (auto& c : this->columns) {
+        param->AddValue(c.Name());
+    }
+
+    /* Determine the index of the selected column. */
+    const auto name = param->Value();
+    std::size_t retval = 0;
+    for (auto& ci : this->columns) {
+        if (ci.Name() == name) {
+            break;
+        }
+        ++retval;
+    }
+
+    return retval;
+}
+
+
+/*
+ * megamol::stdplugin::datatools::table::TableProcessorBase::gatherRows
+ */
+void megamol::stdplugin::datatools::table::TableProcessorBase::gatherRows(
+        ColumnarTableDataCall& src, const std::vector<std::size_t>& rows) {
+    this->columnValues.resize(src.GetColumnsCount());
+
+#pragma omp parallel for
+    for (int c = 0; c < static_cast<int>(this->columnValues.size()); ++c) {
+        const auto data = src.GetColumnData(c);
+        std::vector<float> dst(rows.size());
+        for (std::size_t r = 0; r < rows.size(); ++r) {
+            dst[r] = data[rows[r]];
+        }
+        this->columnValues[c] = ColumnarTableDataCall::MakeColumn(
+            std::move(dst));
+    }
+}
+
+
 /*
  * megamol::stdplugin::datatools::table::TableProcessorBase::getData
  */
@@ -44,6 +106,11 @@ bool megamol::stdplugin::datatools::table::TableProcessorBase::getData(
     using namespace core::param;
     using megamol::core::utility::log::Log;
 
+    auto columnarDst = dynamic_cast<ColumnarTableDataCall *>(&call);
+    if (columnarDst != nullptr) {
+        return this->getColumnarData(*columnarDst);
+    }
+
     auto src = this->slotInput.CallAs<TableDataCall>();
     auto dst = dynamic_cast<TableDataCall *>(&call);
 
@@ -76,12 +143,65 @@ bool megamol::stdplugin::datatools::table::TableProcessorBase::getData(
 }
 
 
+/*
+ * megamol::stdplugin::datatools::table::TableProcessorBase::getColumnarData
+ */
+bool megamol::stdplugin::datatools::table::TableProcessorBase::getColumnarData(
+        ColumnarTableDataCall& dst) {
+    using megamol::core::utility::log::Log;
+
+    auto src = this->slotInput.CallAs<ColumnarTableDataCall>();
+    if (src == nullptr) {
+        Log::DefaultLog.WriteError(_T("The input slot of %hs is invalid, ")
+            _T("columnar output requires columnar input"),
+            ColumnarTableDataCall::ClassName());
+        return false;
+    }
+
+    if (!this->prepareColumnarData(*src, dst.GetFrameID())) {
+        return false;
+    }
+
+    const auto rows = this->columnValues.empty()
+        ? 0 : this->columnValues.front()->size();
+    dst.SetFrameCount(src->GetFrameCount());
+    dst.SetFrameID(this->frameID);
+    dst.SetDataHash(this->getHash());
+    dst.Set(rows, this->columns, this->columnValues);
+
+    return true;
+}
+
+
 /*
  * megamol::stdplugin::datatools::table::TableProcessorBase::getHash
  */
 bool megamol::stdplugin::datatools::table::TableProcessorBase::getHash(
         core::Call& call) {
     using megamol::core::utility::log::Log;
+
+    auto columnarDst = dynamic_cast<ColumnarTableDataCall *>(&call);
+    if (columnarDst != nullptr) {
+        auto src = this->slotInput.CallAs<ColumnarTableDataCall>();
+        if (src == nullptr) {
+            Log::DefaultLog.WriteError("The input slot of type %hs is invalid",
+                ColumnarTableDataCall::ClassName());
+            return false;
+        }
+
+        src->SetFrameID(columnarDst->GetFrameID());
+        if (!(*src)(1)) {
+            Log::DefaultLog.WriteError("The call to %hs of %hs failed.",
+                ColumnarTableDataCall::FunctionName(1),
+                ColumnarTableDataCall::ClassName());
+            return false;
+        }
+
+        columnarDst->SetFrameCount(src->GetFrameCount());
+        columnarDst->SetDataHash(this->getHash());
+        return true;
+    }
+
     auto src = this->slotInput.CallAs<TableDataCall>();
     auto dst = dynamic_cast<TableDataCall *>(&call);
 
@@ -13,6 +13,7 @@
 
 #include "mmcore/param/ParamSlot.h"
 
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
 #include "mmstd_datatools/table/TableDataCall.h"
 
 
@@ -23,6 +24,9 @@ namespace table {
 
     /**
      * A base class for modules processing table data.
+     *
+     * The output serves the row-major TableDataCall and the
+     * ColumnarTableDataCall. Columnar output requires columnar input.
      */
     class TableProcessorBase : public core::Module {
 
@@ -67,6 +71,40 @@ namespace table {
         virtual bool prepareData(TableDataCall& src,
             const unsigned int frameID) = 0;
 
+        /**
+         * Prepares the data requested by a columnar call in 'columnValues'.
+         *
+         * @param src     The call providing the data.
+         * @param frameID The ID of the frame requested by the caller.
+         *
+         * @return true in case of suceess, false otherwise.
+         */
+        virtual bool prepareColumnarData(ColumnarTableDataCall& src,
+            const unsigned int frameID) = 0;
+
+        /**
+         * Copies the column descriptors, offers the column names in the
+         * FlexEnumParam of 'columnParam' and looks up the selected column.
+         *
+         * @param infos       The column descriptors of the input.
+         * @param count       The number of columns of the input.
+         * @param columnParam The slot selecting a column by name.
+         *
+         * @return The index of the selected column, 'count' if it does not
+         *         exist.
+         */
+        std::size_t updateColumns(const ColumnInfo *infos,
+            const std::size_t count, core::param::ParamSlot& columnParam);
+
+        /**
+         * Copies the given rows of all columns of 'src' into 'columnValues'.
+         *
+         * @param src  The call providing the data.
+         * @param rows The indices of the rows to be copied, in output order.
+         */
+        void gatherRows(ColumnarTableDataCall& src,
+            const std::vector<std::size_t>& rows);
+
         /** Holds the columns of the (filtered) table. */
         std::vector<ColumnInfo> columns;
 
@@ -88,10 +126,18 @@ namespace table {
         /** The actual values. */
         std::vector<float> values;
 
+        /** The columns, if the table was last requested as columnar table. */
+        std::vector<ColumnarTableDataCall::Column> columnValues;
+
+        /** Whether 'columnValues' instead of 'values' holds the table. */
+        bool isColumnar;
+
     private:
 
         bool getData(core::Call& call);
 
+        bool getColumnarData(ColumnarTableDataCall& dst);
+
         bool getHash(core::Call& call);
 
     };
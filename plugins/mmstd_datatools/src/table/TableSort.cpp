@@ -77,59 +77,14 @@ bool megamol::stdplugin::datatools::table::TableSort::prepareData(
 
     /* (Re-) Generate the data. */
     if (isParamsChanged || (this->inputHash != src.DataHash())
-            || (this->frameID != src.GetFrameID())) {
-        auto column = 0;
+            || (this->frameID != src.GetFrameID()) || this->isColumnar) {
         const auto data = src.GetData();
-        std::vector<std::size_t> proxy(src.GetRowsCount());
-
-        /* Copy the column descriptors. */
-        this->columns.resize(src.GetColumnsCount());
-        std::copy(src.GetColumnsInfos(),
-            src.GetColumnsInfos() + this->columns.size(),
-            this->columns.begin());
-
-        /* Update the column selector. */
-        {
-            auto param = this->paramColumn.Param<FlexEnumParam>();
-            param->ClearValues();
-            for (auto& c : this->columns) {
-                param->AddValue(c.Name());
-            }
-        }
-
-        /* Determine the index of the reference column. */
-        {
-            auto c = this->paramColumn.Param<FlexEnumParam>()->Value();
-            for (auto& ci : this->columns) {
-                if (ci.Name() == c) {
-                    break;
-                }
-                ++column;
-            }
-
-            if (column == this->columns.size()) {
-                Log::DefaultLog.WriteError("The column \"hs\" cannot be used for "
-                    "sorting, because it does not exist in the source data.",
-                    c.c_str());
-            }
-        }
+        std::vector<std::size_t> proxy;
 
-        /* Sort the index proxy. */
-        std::iota(proxy.begin(), proxy.end(), 0);
-
-        const auto isDesc = this->paramIsDescending.Param<BoolParam>()->Value();
-        auto pred = [this, column, data, isDesc](const std::size_t l,
-                const std::size_t r) {
-            auto lhs = data[l * this->columns.size() + column];
-            auto rhs = data[r * this->columns.size() + column];
-            return isDesc ? (rhs < lhs) : (lhs < rhs);
-        };
-
-        if (this->paramIsStable.Param<BoolParam>()->Value()) {
-            std::stable_sort(proxy.begin(), proxy.end(), pred);
-        } else {
-            std::sort(proxy.begin(), proxy.end(), pred);
-        }
+        auto column = this->updateColumns(src.GetColumnsInfos(),
+            src.GetColumnsCount(), this->paramColumn);
+        this->sortRows((column < this->columns.size()) ? data + column : nullptr,
+            this->columns.size(), src.GetRowsCount(), proxy);
 
         /* Copy the data in sorted order. */
         this->values.resize(src.GetRowsCount() * src.GetColumnsCount());
@@ -142,23 +97,112 @@ bool megamol::stdplugin::datatools::table::TableSort::prepareData(
             dst += this->columns.size();
         }
 
-        /* Persist the state of the data. */
-        this->frameID = frameID;
-        this->inputHash = src.DataHash();
-
-        if (isParamsChanged) {
-            ++this->localHash;
-            this->paramColumn.ResetDirty();
-            this->paramIsDescending.ResetDirty();
-            this->paramIsStable.ResetDirty();
-        }
+        this->isColumnar = false;
+        this->columnValues.clear();
+        this->persist(frameID, src.DataHash(), isParamsChanged);
     } /* end if (selector || (this->inputHash != src->DataHash()) ... */
 
     return true;
 }
 
 
+/*
+ * megamol::stdplugin::datatools::table::TableSort::prepareColumnarData
+ */
+bool megamol::stdplugin::datatools::table::TableSort::prepareColumnarData(
+        ColumnarTableDataCall& src, const unsigned int frameID) {
+    using megamol::core::utility::log::Log;
+
+    /* Request the source data. */
+    src.SetFrameID(frameID);
+    if (!(src)(0)) {
+        Log::DefaultLog.WriteError(_T("The call to %hs failed in %hs."),
+            ColumnarTableDataCall::FunctionName(0),
+            ColumnarTableDataCall::ClassName());
+        return false;
+    }
+
+    auto isParamsChanged = this->paramColumn.IsDirty()
+        || this->paramIsDescending.IsDirty()
+        || this->paramIsStable.IsDirty();
+
+    /* (Re-) Generate the data. */
+    if (isParamsChanged || (this->inputHash != src.DataHash())
+            || (this->frameID != src.GetFrameID()) || !this->isColumnar) {
+        std::vector<std::size_t> proxy;
+
+        auto column = this->updateColumns(src.GetColumnsInfos(),
+            src.GetColumnsCount(), this->paramColumn);
+        this->sortRows((column < this->columns.size())
+            ? src.GetColumnData(column) : nullptr,
+            1, src.GetRowsCount(), proxy);
+
+        /* Copy the data in sorted order. */
+        this->gatherRows(src, proxy);
+
+        this->isColumnar = true;
+        this->values.clear();
+        this->persist(frameID, src.DataHash(), isParamsChanged);
+    }
+
+    return true;
+}
+
+
 /*
  * megamol::stdplugin::datatools::table::TableSort::release
  */
 void megamol::stdplugin::datatools::table::TableSort::release(void) { }
+
+
+/*
+ * megamol::stdplugin::datatools::table::TableSort::sortRows
+ */
+void megamol::stdplugin::datatools::table::TableSort::sortRows(
+        const float *column, const std::size_t stride, const std::size_t rows,
+        std::vector<std::size_t>& proxy) {
+    using namespace core::param;
+    using megamol::core::utility::log::Log;
+
+    proxy.resize(rows);
+    std::iota(proxy.begin(), proxy.end(), 0);
+
+    if (column == nullptr) {
+        Log::DefaultLog.WriteError("The column \"%hs\" cannot be used for "
+            "sorting, because it does not exist in the source data.",
+            this->paramColumn.Param<FlexEnumParam>()->Value().c_str());
+        return;
+    }
+
+    const auto isDesc = this->paramIsDescending.Param<BoolParam>()->Value();
+    auto pred = [column, stride, isDesc](const std::size_t l,
+            const std::size_t r) {
+        auto lhs = column[l * stride];
+        auto rhs = column[r * stride];
+        return isDesc ? (rhs < lhs) : (lhs < rhs);
+    };
+
+    if (this->paramIsStable.Param<BoolParam>()->Value()) {
+        std::stable_sort(proxy.begin(), proxy.end(), pred);
+    } else {
+        std::sort(proxy.begin(), proxy.end(), pred);
+    }
+}
+
+
+/*
+ * megamol::stdplugin::datatools::table::TableSort::persist
+ */
+void megamol::stdplugin::datatools::table::TableSort::persist(
+        const unsigned int frameID, const std::size_t inputHash,
+        const bool isParamsChanged) {
+    this->frameID = frameID;
+    this->inputHash = inputHash;
+
+    if (isParamsChanged) {
+        ++this->localHash;
+        this->paramColumn.ResetDirty();
+        this->paramIsDescending.ResetDirty();
+        this->paramIsStable.ResetDirty();
+    }
+}
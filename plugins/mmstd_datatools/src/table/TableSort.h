@@ -66,10 +66,29 @@ namespace table {
         virtual bool prepareData(TableDataCall& src,
             const unsigned int frameID) override;
 
+        virtual bool prepareColumnarData(ColumnarTableDataCall& src,
+            const unsigned int frameID) override;
+
         virtual void release(void);
 
     private:
 
+        /**
+         * Sorts the row indices by the values of the reference column.
+         *
+         * @param column The reference values, one every 'stride' floats, or
+         *               nullptr to keep the order of the input.
+         * @param stride The distance between the values of two rows.
+         * @param rows   The number of rows.
+         * @param proxy  Receives the row indices in sorted order.
+         */
+        void sortRows(const float *column, const std::size_t stride,
+            const std::size_t rows, std::vector<std::size_t>& proxy);
+
+        /** Resets the parameters if they caused the update of the data. */
+        void persist(const unsigned int frameID, const std::size_t inputHash,
+            const bool isParamsChanged);
+
         core::param::ParamSlot paramColumn;
         core::param::ParamSlot paramIsDescending;
         core::param::ParamSlot paramIsStable;
@@ -0,0 +1,122 @@
+/*
+ * TableToColumnar.cpp
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "TableToColumnar.h"
+
+#include "mmcore/utility/log/Log.h"
+#include <cstdint>
+#include <limits>
+
+using namespace megamol::stdplugin::datatools;
+using namespace megamol::stdplugin::datatools::table;
+using namespace megamol;
+
+TableToColumnar::TableToColumnar(void) :
+    core::Module(),
+    dataOutSlot("dataOut", "Ouput"),
+    dataInSlot("dataIn", "Input"),
+    frameID(-1),
+    datahash(std::numeric_limits<size_t>::max()),
+    rowsCount(0) {
+
+    this->dataInSlot.SetCompatibleCall<TableDataCallDescription>();
+    this->MakeSlotAvailable(&this->dataInSlot);
+
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(0),
+        &TableToColumnar::processData);
+    this->dataOutSlot.SetCallback(ColumnarTableDataCall::ClassName(),
+        ColumnarTableDataCall::FunctionName(1),
+        &TableToColumnar::getExtent);
+    this->MakeSlotAvailable(&this->dataOutSlot);
+}
+
+TableToColumnar::~TableToColumnar(void) {
+    this->Release();
+}
+
+bool TableToColumnar::create(void) {
+    return true;
+}
+
+void TableToColumnar::release(void) {
+    this->columnInfos.clear();
+    this->columns.clear();
+}
+
+bool TableToColumnar::processData(core::Call &c) {
+    try {
+        ColumnarTableDataCall *outCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+        if (outCall == nullptr) return false;
+
+        TableDataCall *inCall = this->dataInSlot.CallAs<TableDataCall>();
+        if (inCall == nullptr) return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)(0)) return false;
+
+        if (this->datahash != inCall->DataHash() || this->frameID != inCall->GetFrameID()) {
+            this->datahash = inCall->DataHash();
+            this->frameID = inCall->GetFrameID();
+
+            const size_t column_count = inCall->GetColumnsCount();
+            const size_t rows_count = inCall->GetRowsCount();
+            const float *in_data = inCall->GetData();
+
+            this->rowsCount = rows_count;
+            this->columnInfos.assign(inCall->GetColumnsInfos(), inCall->GetColumnsInfos() + column_count);
+
+            // allocate all columns first, so the transposition can run over blocks of rows
+            std::vector<std::vector<float>> buffers(column_count, std::vector<float>(rows_count));
+#pragma omp parallel for
+            for (int64_t row = 0; row < static_cast<int64_t>(rows_count); ++row) {
+                const float *src = in_data + row * column_count;
+                for (size_t col = 0; col < column_count; ++col) {
+                    buffers[col][row] = src[col];
+                }
+            }
+
+            this->columns.clear();
+            this->columns.reserve(column_count);
+            for (auto &b : buffers) {
+                this->columns.push_back(ColumnarTableDataCall::MakeColumn(std::move(b)));
+            }
+        }
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetFrameID(this->frameID);
+        outCall->SetDataHash(this->datahash);
+        outCall->Set(this->rowsCount, this->columnInfos, this->columns);
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("Failed to execute %s::processData\n", ClassName());
+        return false;
+    }
+
+    return true;
+}
+
+bool TableToColumnar::getExtent(core::Call &c) {
+    try {
+        ColumnarTableDataCall *outCall = dynamic_cast<ColumnarTableDataCall *>(&c);
+        if (outCall == nullptr) return false;
+
+        TableDataCall *inCall = this->dataInSlot.CallAs<TableDataCall>();
+        if (inCall == nullptr) return false;
+
+        inCall->SetFrameID(outCall->GetFrameID());
+        if (!(*inCall)(1)) return false;
+
+        outCall->SetFrameCount(inCall->GetFrameCount());
+        outCall->SetDataHash(inCall->DataHash());
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("Failed to execute %s::getExtent\n", ClassName());
+        return false;
+    }
+
+    return true;
+}
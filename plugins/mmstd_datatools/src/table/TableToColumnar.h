@@ -0,0 +1,91 @@
+/*
+ * TableToColumnar.h
+ *
+ * Copyright (C) 2021 by VISUS (University of Stuttgart)
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MEGAMOL_DATATOOLS_TABLE_TABLETOCOLUMNAR_H_INCLUDED
+#define MEGAMOL_DATATOOLS_TABLE_TABLETOCOLUMNAR_H_INCLUDED
+
+#include "mmcore/Module.h"
+#include "mmcore/Call.h"
+#include "mmcore/CalleeSlot.h"
+#include "mmcore/CallerSlot.h"
+
+#include "mmstd_datatools/table/ColumnarTableDataCall.h"
+#include "mmstd_datatools/table/TableDataCall.h"
+
+namespace megamol {
+namespace stdplugin {
+namespace datatools {
+namespace table {
+
+/*
+ * Module converting a row-major table into a columnar table.
+ */
+class TableToColumnar : public core::Module {
+public:
+    /** Return module class name */
+    static const char *ClassName(void) {
+        return "TableToColumnar";
+    }
+
+    /** Return module class description */
+    static const char *Description(void) {
+        return "Converts a row-major table into a columnar table";
+    }
+
+    /** Module is always available */
+    static bool IsAvailable(void) {
+        return true;
+    }
+
+    /** Ctor */
+    TableToColumnar(void);
+
+    /** Dtor */
+    virtual ~TableToColumnar(void);
+
+protected:
+    /** Lazy initialization of the module */
+    virtual bool create(void);
+
+    /** Resource release */
+    virtual void release(void);
+
+private:
+    /** Data callback */
+    bool processData(core::Call &c);
+
+    /** Extent callback */
+    bool getExtent(core::Call &c);
+
+    /** Data output slot */
+    core::CalleeSlot dataOutSlot;
+
+    /** Data input slot */
+    core::CallerSlot dataInSlot;
+
+    /** ID of the current frame */
+    int frameID;
+
+    /** Hash of the current data */
+    size_t datahash;
+
+    /** Rows of the current data */
+    size_t rowsCount;
+
+    /** Column information of the current data */
+    std::vector<ColumnarTableDataCall::ColumnInfo> columnInfos;
+
+    /** Columns of the current data */
+    std::vector<ColumnarTableDataCall::Column> columns;
+}; /* end class TableToColumnar */
+
+} /* end namespace table */
+} /* end namespace datatools */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
+
+#endif /* end ifndef MEGAMOL_DATATOOLS_TABLE_TABLETOCOLUMNAR_H_INCLUDED */
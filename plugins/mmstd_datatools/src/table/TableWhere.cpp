@@ -128,194 +128,16 @@ bool megamol::stdplugin::datatools::table::TableWhere::prepareData(
 
     /* (Re-) Generate the data. */
     if (isParamsChanged || (this->inputHash != src.DataHash())
-            || (this->frameID != src.GetFrameID())) {
-        auto column = 0;
+            || (this->frameID != src.GetFrameID()) || this->isColumnar) {
         const auto data = src.GetData();
-        auto isSort = false;
-        std::function<bool(const float)> selector;
-
-        /* Process updates in the configuration. */
-        {
-            auto c = this->paramColumn.Param<FlexEnumParam>()->Value();
-            auto e = this->paramEpsilon.Param<FloatParam>()->Value();
-            auto o = this->paramOperator.Param<EnumParam>()->Value();
-            auto r = this->paramReference.Param<FloatParam>()->Value();
-
-            this->columns.resize(src.GetColumnsCount());
-            std::copy(src.GetColumnsInfos(),
-                src.GetColumnsInfos() + this->columns.size(),
-                this->columns.begin());
-
-            {
-                auto param = this->paramColumn.Param<FlexEnumParam>();
-                param->ClearValues();
-                for (auto& c : this->columns) {
-                    param->AddValue(c.Name());
-                }
-            }
+        std::vector<std::size_t> selection;
 
-            for (auto& ci : this->columns) {
-                if (ci.Name() == c) {
-                    break;
-                }
-                ++column;
-            }
-
-            if (column != this->columns.size()) {
-                auto range = std::make_pair(this->columns[column].MinimumValue(),
-                    this->columns[column].MaximumValue());
-
-                switch (o) {
-                case Operator::Less:
-                    selector = [r](const float v) { return (v < r); };
-                    break;
-
-                case Operator::LessOrEqual:
-                    selector = [r](const float v) { return (v <= r); };
-                    break;
-
-                case Operator::Equal:
-                    selector = [r, e](const float v) {
-                        return (std::abs(v - r) <= e);
-                    };
-                    break;
-
-                case Operator::GreaterOrEqual:
-                    selector = [r](const float v) { return (v >= r); };
-                    break;
-
-                case Operator::Greater:
-                    selector = [r](const float v) { return (v > r); };
-                    break;
-
-                case Operator::NotEqual:
-                    selector = [r, e](const float v) {
-                        return (std::abs(v - r) > e);
-                    };
-                    break;
-
-                case Operator::LowerRange:
-                    selector = [r, range](const float v) {
-                        assert(range.second >= range.first);
-                        auto d = (range.second - range.first) * r;
-                        return (v <= (range.first + d));
-
-                    };
-                    break;
-
-                case Operator::MiddleRange:
-                    selector = [r, range](const float v) {
-                        assert(range.second >= range.first);
-                        auto d = 1.0f - 0.5f * (range.second - range.first) * r;
-                        return ((v >= (range.first + d))
-                            && (v <= (range.second - d)));
-
-                    };
-                    break;
-
-                case Operator::UpperRange:
-                    selector = [r, range](const float v) {
-                        assert(range.second >= range.first);
-                        auto d = (range.second - range.first) * r;
-                        return (v >= (range.second - d));
-
-                    };
-                    break;
-
-                case Operator::LowerPercentile:
-                case Operator::MiddlePercentile:
-                case Operator::UpperPercentile:
-                    isSort = true;
-                    break;
-
-                default:
-                    Log::DefaultLog.WriteError(_T("The comparison operator %d ")
-                        _T("is unsupported."), o);
-                    break;
-                }
-
-            } else {
-                Log::DefaultLog.WriteWarn(_T("The column \"%hs\" to be filtered ")
-                    _T("was not found in the data set. The %hs module will copy ")
-                    _T("all input rows."), c.c_str(), TableWhere::ClassName());
-            }
-        }
-        assert(((column >= 0) && (column < this->columns.size())) || !selector);
-
-        if (selector || isSort) {
-            // Copy selection.
-            std::vector<std::size_t> selection;
-            selection.reserve(src.GetRowsCount());
-
-            if (selector) {
-                // Selection is based on predicate.
-                for (auto r = 0; r < src.GetRowsCount(); ++r) {
-                    if (selector(data[r * this->columns.size() + column])) {
-                        selection.push_back(r);
-                    }
-                }
-            } else {
-                // Selection requires sorting.
-                const auto o = this->paramOperator.Param<EnumParam>()->Value();
-                const auto r = vislib::math::Clamp(
-                    this->paramReference.Param<FloatParam>()->Value(),
-                    0.0f, 1.0f);
-
-                selection.resize(src.GetRowsCount());
-                std::iota(selection.begin(), selection.end(), 0);
-
-                std::stable_sort(selection.begin(), selection.end(),
-                    [this, data, column](const std::size_t l, const std::size_t r) {
-                    auto lhs = data[l * this->columns.size() + column];
-                    auto rhs = data[r * this->columns.size() + column];
-                    return (lhs < rhs);
-                });
-
-                // Compute the number of elements we want to retain.
-                const auto cnt = static_cast<std::size_t>(static_cast<double>(r)
-                    * src.GetRowsCount());
-
-                switch (o) {
-                    case Operator::LowerPercentile:
-                        // Take first 'cnt' values.
-                        selection.resize(cnt);
-                        if (!selection.empty()) {
-                            Log::DefaultLog.WriteWarn(_T("Selected range is ")
-                                _T("within [%f, %f]."),
-                                data[selection.front() * this->columns.size() + column],
-                                data[selection.back() * this->columns.size() + column]);
-                        }
-                        break;
-
-                    case Operator::MiddlePercentile: {
-                        auto c = (src.GetRowsCount() - cnt) / 2;
-                        selection.erase(selection.begin(), selection.begin() + c);
-                        selection.resize(cnt);
-                        if (!selection.empty()) {
-                            Log::DefaultLog.WriteWarn(_T("Selected range is ")
-                                _T("within [%f, %f]."),
-                                data[selection.front() * this->columns.size() + column],
-                                data[selection.back() * this->columns.size() + column]);
-                        }
-                        } break;
-
-                    case Operator::UpperPercentile:
-                        // Remove everything up to last 'cnt' values.
-                        selection.erase(selection.begin(), selection.end() - cnt);
-                        if (!selection.empty()) {
-                            Log::DefaultLog.WriteWarn(_T("Selected range is ")
-                                _T("within [%f, %f]."),
-                                data[selection.front() * this->columns.size() + column],
-                                data[selection.back() * this->columns.size() + column]);
-                        }
-                        break;
-
-                default:
-                    assert(false);
-                    break;
-                }
-            }
+        auto column = this->updateColumns(src.GetColumnsInfos(),
+            src.GetColumnsCount(), this->paramColumn);
 
+        if (this->selectRows((column < this->columns.size())
+                ? data + column : nullptr, this->columns.size(),
+                src.GetRowsCount(), column, selection)) {
             /* Copy the data. */
             this->values.resize(selection.size() * this->columns.size());
             auto d = this->values.data();
@@ -328,46 +150,306 @@ bool megamol::stdplugin::datatools::table::TableWhere::prepareData(
 
             /* Update the min/max range if requested. */
             if (this->paramUpdateRange.Param<BoolParam>()->Value()) {
-                const auto rows = this->values.size() / this->columns.size();
-
                 for (std::size_t c = 0; c < this->columns.size(); ++c) {
-                    auto minimum = (std::numeric_limits<float>::max)();
-                    auto maximum = (std::numeric_limits<float>::min)();
-
-                    for (std::size_t r = 0; r < rows; ++r) {
-                        auto value = this->values[r * this->columns.size() + c];
-                        if (value < minimum) {
-                            minimum = value;
-                        }
-                        if (value > maximum) {
-                            maximum = value;
-                        }
-
-                        this->columns[c].SetMinimumValue(minimum);
-                        this->columns[c].SetMaximumValue(maximum);
-                    }
+                    this->updateRange(c, this->values.data() + c,
+                        this->columns.size(), selection.size());
                 }
-            } /* end if (this->paramUpdateRange.Param<BoolParam>()->Value()) */
+            }
 
         } else {
             // Copy everything.
             this->values.resize(src.GetRowsCount() * this->columns.size());
             std::copy(src.GetData(), src.GetData() + this->values.size(),
                 this->values.begin());
-        } /* end if (selector || isSort) */
-
-        /* Persist the state of the data. */
-        this->frameID = frameID;
-        this->inputHash = src.DataHash();
-
-        if (isParamsChanged) {
-            ++this->localHash;
-            this->paramColumn.ResetDirty();
-            this->paramOperator.ResetDirty();
-            this->paramReference.ResetDirty();
-            this->paramUpdateRange.ResetDirty();
-        }
+        } /* end if (this->selectRows(... */
+
+        this->isColumnar = false;
+        this->columnValues.clear();
+        this->persist(frameID, src.DataHash(), isParamsChanged);
     } /* end if (selector || (this->inputHash != src->DataHash()) ... */
 
     return true;
 }
+
+
+/*
+ * megamol::stdplugin::datatools::table::TableWhere::prepareColumnarData
+ */
+bool megamol::stdplugin::datatools::table::TableWhere::prepareColumnarData(
+        ColumnarTableDataCall& src, const unsigned int frameID) {
+    using namespace core::param;
+    using megamol::core::utility::log::Log;
+
+    /* Request the source data. */
+    src.SetFrameID(frameID);
+    if (!(src)(0)) {
+        Log::DefaultLog.WriteError(_T("The call to %hs failed in %hs."),
+            ColumnarTableDataCall::FunctionName(0),
+            ColumnarTableDataCall::ClassName());
+        return false;
+    }
+
+    auto isParamsChanged = this->paramUpdateRange.IsDirty()
+        || this->paramColumn.IsDirty()
+        || this->paramOperator.IsDirty()
+        || this->paramReference.IsDirty();
+
+    /* (Re-) Generate the data. */
+    if (isParamsChanged || (this->inputHash != src.DataHash())
+            || (this->frameID != src.GetFrameID()) || !this->isColumnar) {
+        std::vector<std::size_t> selection;
+
+        auto column = this->updateColumns(src.GetColumnsInfos(),
+            src.GetColumnsCount(), this->paramColumn);
+
+        if (this->selectRows((column < this->columns.size())
+                ? src.GetColumnData(column) : nullptr, 1,
+                src.GetRowsCount(), column, selection)) {
+            this->gatherRows(src, selection);
+
+            /* Update the min/max range if requested. */
+            if (this->paramUpdateRange.Param<BoolParam>()->Value()) {
+                for (std::size_t c = 0; c < this->columns.size(); ++c) {
+                    this->updateRange(c, this->columnValues[c]->data(), 1,
+                        selection.size());
+                }
+            }
+
+        } else {
+            // Pass on all columns without copying them.
+            this->columnValues.resize(src.GetColumnsCount());
+            for (std::size_t c = 0; c < this->columnValues.size(); ++c) {
+                this->columnValues[c] = src.GetColumn(c);
+            }
+        } /* end if (this->selectRows(... */
+
+        this->isColumnar = true;
+        this->values.clear();
+        this->persist(frameID, src.DataHash(), isParamsChanged);
+    } /* end if (isParamsChanged || (this->inputHash != src.DataHash()) ... */
+
+    return true;
+}
+
+
+/*
+ * megamol::stdplugin::datatools::table::TableWhere::selectRows
+ */
+bool megamol::stdplugin::datatools::table::TableWhere::selectRows(
+        const float *data, const std::size_t stride, const std::size_t rows,
+        const std::size_t column, std::vector<std::size_t>& selection) {
+    using namespace core::param;
+    using megamol::core::utility::log::Log;
+
+    auto isSort = false;
+    std::function<bool(const float)> selector;
+
+    /* Process updates in the configuration. */
+    {
+        auto c = this->paramColumn.Param<FlexEnumParam>()->Value();
+        auto e = this->paramEpsilon.Param<FloatParam>()->Value();
+        auto o = this->paramOperator.Param<EnumParam>()->Value();
+        auto r = this->paramReference.Param<FloatParam>()->Value();
+
+        if (data != nullptr) {
+            auto range = std::make_pair(this->columns[column].MinimumValue(),
+                this->columns[column].MaximumValue());
+
+            switch (o) {
+            case Operator::Less:
+                selector = [r](const float v) { return (v < r); };
+                break;
+
+            case Operator::LessOrEqual:
+                selector = [r](const float v) { return (v <= r); };
+                break;
+
+            case Operator::Equal:
+                selector = [r, e](const float v) {
+                    return (std::abs(v - r) <= e);
+                };
+                break;
+
+            case Operator::GreaterOrEqual:
+                selector = [r](const float v) { return (v >= r); };
+                break;
+
+            case Operator::Greater:
+                selector = [r](const float v) { return (v > r); };
+                break;
+
+            case Operator::NotEqual:
+                selector = [r, e](const float v) {
+                    return (std::abs(v - r) > e);
+                };
+                break;
+
+            case Operator::LowerRange:
+                selector = [r, range](const float v) {
+                    assert(range.second >= range.first);
+                    auto d = (range.second - range.first) * r;
+                    return (v <= (range.first + d));
+
+                };
+                break;
+
+            case Operator::MiddleRange:
+                selector = [r, range](const float v) {
+                    assert(range.second >= range.first);
+                    auto d = 1.0f - 0.5f * (range.second - range.first) * r;
+                    return ((v >= (range.first + d))
+                        && (v <= (range.second - d)));
+
+                };
+                break;
+
+            case Operator::UpperRange:
+                selector = [r, range](const float v) {
+                    assert(range.second >= range.first);
+                    auto d = (range.second - range.first) * r;
+                    return (v >= (range.second - d));
+
+                };
+                break;
+
+            case Operator::LowerPercentile:
+            case Operator::MiddlePercentile:
+            case Operator::UpperPercentile:
+                isSort = true;
+                break;
+
+            default:
+                Log::DefaultLog.WriteError(_T("The comparison operator %d ")
+                    _T("is unsupported."), o);
+                break;
+            }
+
+        } else {
+            Log::DefaultLog.WriteWarn(_T("The column \"%hs\" to be filtered ")
+                _T("was not found in the data set. The %hs module will copy ")
+                _T("all input rows."), c.c_str(), TableWhere::ClassName());
+        }
+    }
+    assert((data != nullptr) || !selector);
+
+    if (!selector && !isSort) {
+        return false;
+    }
+
+    selection.clear();
+    selection.reserve(rows);
+
+    if (selector) {
+        // Selection is based on predicate.
+        for (std::size_t r = 0; r < rows; ++r) {
+            if (selector(data[r * stride])) {
+                selection.push_back(r);
+            }
+        }
+    } else {
+        // Selection requires sorting.
+        const auto o = this->paramOperator.Param<EnumParam>()->Value();
+        const auto r = vislib::math::Clamp(
+            this->paramReference.Param<FloatParam>()->Value(),
+            0.0f, 1.0f);
+
+        selection.resize(rows);
+        std::iota(selection.begin(), selection.end(), 0);
+
+        std::stable_sort(selection.begin(), selection.end(),
+            [data, stride](const std::size_t l, const std::size_t r) {
+            auto lhs = data[l * stride];
+            auto rhs = data[r * stride];
+            return (lhs < rhs);
+        });
+
+        // Compute the number of elements we want to retain.
+        const auto cnt = static_cast<std::size_t>(static_cast<double>(r)
+            * rows);
+
+        switch (o) {
+            case Operator::LowerPercentile:
+                // Take first 'cnt' values.
+                selection.resize(cnt);
+                if (!selection.empty()) {
+                    Log::DefaultLog.WriteWarn(_T("Selected range is ")
+                        _T("within [%f, %f]."),
+                        data[selection.front() * stride],
+                        data[selection.back() * stride]);
+                }
+                break;
+
+            case Operator::MiddlePercentile: {
+                auto c = (rows - cnt) / 2;
+                selection.erase(selection.begin(), selection.begin() + c);
+                selection.resize(cnt);
+                if (!selection.empty()) {
+                    Log::DefaultLog.WriteWarn(_T("Selected range is ")
+                        _T("within [%f, %f]."),
+                        data[selection.front() * stride],
+                        data[selection.back() * stride]);
+                }
+                } break;
+
+            case Operator::UpperPercentile:
+                // Remove everything up to last 'cnt' values.
+                selection.erase(selection.begin(), selection.end() - cnt);
+                if (!selection.empty()) {
+                    Log::DefaultLog.WriteWarn(_T("Selected range is ")
+                        _T("within [%f, %f]."),
+                        data[selection.front() * stride],
+                        data[selection.back() * stride]);
+                }
+                break;
+
+        default:
+            assert(false);
+            break;
+        }
+    }
+
+    return true;
+}
+
+
+/*
+ * megamol::stdplugin::datatools::table::TableWhere::updateRange
+ */
+void megamol::stdplugin::datatools::table::TableWhere::updateRange(
+        const std::size_t column, const float *data, const std::size_t stride,
+        const std::size_t rows) {
+    auto minimum = (std::numeric_limits<float>::max)();
+    auto maximum = (std::numeric_limits<float>::min)();
+
+    for (std::size_t r = 0; r < rows; ++r) {
+        auto value = data[r * stride];
+        if (value < minimum) {
+            minimum = value;
+        }
+        if (value > maximum) {
+            maximum = value;
+        }
+
+        this->columns[column].SetMinimumValue(minimum);
+        this->columns[column].SetMaximumValue(maximum);
+    }
+}
+
+
+/*
+ * megamol::stdplugin::datatools::table::TableWhere::persist
+ */
+void megamol::stdplugin::datatools::table::TableWhere::persist(
+        const unsigned int frameID, const std::size_t inputHash,
+        const bool isParamsChanged) {
+    this->frameID = frameID;
+    this->inputHash = inputHash;
+
+    if (isParamsChanged) {
+        ++this->localHash;
+        this->paramColumn.ResetDirty();
+        this->paramOperator.ResetDirty();
+        this->paramReference.ResetDirty();
+        this->paramUpdateRange.ResetDirty();
+    }
+}
@@ -66,10 +66,37 @@ namespace table {
         virtual bool prepareData(TableDataCall& src,
             const unsigned int frameID) override;
 
+        virtual bool prepareColumnarData(ColumnarTableDataCall& src,
+            const unsigned int frameID) override;
+
         virtual void release(void);
 
     private:
 
+        /**
+         * Selects the rows passing the filter on the reference column.
+         *
+         * @param data      The reference values, one every 'stride' floats,
+         *                  or nullptr if the column does not exist.
+         * @param stride    The distance between the values of two rows.
+         * @param rows      The number of rows.
+         * @param column    The index of the reference column.
+         * @param selection Receives the indices of the selected rows.
+         *
+         * @return false if the filter does not apply and all rows are kept.
+         */
+        bool selectRows(const float *data, const std::size_t stride,
+            const std::size_t rows, const std::size_t column,
+            std::vector<std::size_t>& selection);
+
+        /** Sets the min/max range of a column to the range of its values. */
+        void updateRange(const std::size_t column, const float *data,
+            const std::size_t stride, const std::size_t rows);
+
+        /** Resets the parameters if they caused the update of the data. */
+        void persist(const unsigned int frameID, const std::size_t inputHash,
+            const bool isParamsChanged);
+
         core::param::ParamSlot paramColumn;
         core::param::ParamSlot paramEpsilon;
         core::param::ParamSlot paramOperator;
@@ -0,0 +1,53 @@
+/*
+ * test.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include <cstring>
+#include <iostream>
+
+/* include test implementations */
+#include "testhelper.h"
+#include "testspatialindex.h"
+#include "testtablejoin.h"
+
+
+/* type for test functions */
+typedef void (*DatatoolsTestFunction)(void);
+
+/* type for test manager structure */
+typedef struct _DatatoolsTest_t {
+    const char *testName; // the tests name. Used as command line argument to select this test.
+    DatatoolsTestFunction testFunc; // the function called when this test is selected.
+    const char *testDesc; // the description of this test. Used for the online help.
+} DatatoolsTest;
+
+
+/* all available tests, run in this order if none is selected */
+DatatoolsTest tests[] = {
+    {"SpatialIndex", ::TestSpatialIndex, "Tests the kd-tree spatial index against brute force searches."},
+    {"TableJoin", ::TestTableJoin, "Tests the hash joins against a nested loop join."},
+    {nullptr, nullptr, nullptr}
+};
+
+
+/*
+ * main
+ */
+int main(int argc, char **argv) {
+    for (DatatoolsTest *t = tests; t->testName != nullptr; ++t) {
+        bool isSelected = (argc < 2);
+        for (int i = 1; i < argc; ++i) {
+            isSelected = isSelected || (::strcmp(argv[i], t->testName) == 0);
+        }
+        if (isSelected) {
+            std::cout << std::endl << t->testName << ": " << t->testDesc << std::endl;
+            t->testFunc();
+        }
+    }
+
+    ::OutputAssertTestSummary();
+    return 0;
+}
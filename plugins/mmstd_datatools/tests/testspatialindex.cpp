@@ -0,0 +1,122 @@
+/*
+ * testspatialindex.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testspatialindex.h"
+#include "testhelper.h"
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "KDTreeSpatialIndex.h"
+
+using megamol::core::moldyn::MultiParticleDataCall;
+using megamol::core::moldyn::SimpleSphericalParticles;
+using megamol::stdplugin::datatools::AbstractSpatialIndex;
+using megamol::stdplugin::datatools::KDTreeSpatialIndex;
+
+
+/*
+ * ::TestSpatialIndex
+ */
+void TestSpatialIndex(void) {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> coord(-1.0f, 1.0f);
+
+    // list 0: xyz, list 1: not indexable, list 2: xyzr with the radius in between
+    std::vector<float> xyz(3 * 500);
+    for (auto& v : xyz) v = coord(rng);
+    std::vector<double> dbl(3 * 10, 0.0);
+    std::vector<float> xyzr(4 * 300);
+    for (auto& v : xyzr) v = coord(rng);
+
+    MultiParticleDataCall dat;
+    dat.SetParticleListCount(3);
+    dat.AccessParticles(0).SetCount(500);
+    dat.AccessParticles(0).SetVertexData(SimpleSphericalParticles::VERTDATA_FLOAT_XYZ, xyz.data());
+    dat.AccessParticles(1).SetCount(10);
+    dat.AccessParticles(1).SetVertexData(SimpleSphericalParticles::VERTDATA_DOUBLE_XYZ, dbl.data());
+    dat.AccessParticles(2).SetCount(300);
+    dat.AccessParticles(2).SetVertexData(SimpleSphericalParticles::VERTDATA_FLOAT_XYZR, xyzr.data());
+
+    // reference positions in index order
+    std::vector<float> ref(xyz);
+    for (size_t i = 0; i < 300; ++i) {
+        ref.insert(ref.end(), xyzr.begin() + 4 * i, xyzr.begin() + 4 * i + 3);
+    }
+    auto distSqr = [&ref](const float *q, size_t i) {
+        float d = 0.0f;
+        for (int c = 0; c < 3; ++c) d += (q[c] - ref[3 * i + c]) * (q[c] - ref[3 * i + c]);
+        return d;
+    };
+
+    auto idx = KDTreeSpatialIndex::Build(dat);
+    AssertEqual("Only float lists are indexed", idx->Count(), static_cast<size_t>(800));
+    AssertEqual("Index has one entry per list", idx->ListCount(), 3u);
+    AssertEqual("First list starts at 0", idx->ListOffset(0), static_cast<size_t>(0));
+    AssertEqual("Skipped list is empty", idx->ListOffset(2) - idx->ListOffset(1), static_cast<size_t>(0));
+    AssertEqual("Offsets end with the total", idx->ListOffset(3), static_cast<size_t>(800));
+
+    bool isPacked = true;
+    for (size_t i = 0; i < idx->Count(); ++i) {
+        isPacked = isPacked && std::equal(ref.begin() + 3 * i, ref.begin() + 3 * i + 3, idx->Position(i));
+    }
+    AssertTrue("Positions are packed without radius", isPacked);
+
+    bool isKnnOk = true;
+    bool isRadiusOk = true;
+    const size_t k = 8;
+    const float radiusSqr = 0.05f;
+    for (int q = 0; q < 50; ++q) {
+        const float query[3] = {coord(rng), coord(rng), coord(rng)};
+
+        std::vector<float> brute(idx->Count());
+        for (size_t i = 0; i < brute.size(); ++i) brute[i] = distSqr(query, i);
+        std::vector<float> sorted(brute);
+        std::sort(sorted.begin(), sorted.end());
+
+        size_t found[k];
+        float dists[k];
+        isKnnOk = isKnnOk && (idx->KNearest(query, k, found, dists) == k);
+        for (size_t i = 0; i < k; ++i) {
+            isKnnOk = isKnnOk && vislib::math::IsEqual(dists[i], sorted[i])
+                && vislib::math::IsEqual(brute[found[i]], dists[i]);
+        }
+
+        AbstractSpatialIndex::match_list matches;
+        idx->RadiusSearch(query, radiusSqr, matches);
+        std::vector<size_t> got, expected;
+        for (auto& m : matches) got.push_back(m.first);
+        for (size_t i = 0; i < brute.size(); ++i) {
+            if (brute[i] <= radiusSqr) expected.push_back(i);
+        }
+        std::sort(got.begin(), got.end());
+        isRadiusOk = isRadiusOk && (got == expected);
+    }
+    AssertTrue("KNearest matches brute force", isKnnOk);
+    AssertTrue("RadiusSearch matches brute force", isRadiusOk);
+
+    auto filter = [](unsigned int list) { return list != 0; };
+    auto filtered = KDTreeSpatialIndex::Build(dat, filter);
+    AssertEqual("Filtered lists are not indexed", filtered->Count(), static_cast<size_t>(300));
+    AssertEqual("Filtered list is empty", filtered->ListOffset(1), static_cast<size_t>(0));
+    AssertTrue("Index is compatible with its own filter", KDTreeSpatialIndex::IsCompatible(*filtered, dat, filter));
+    AssertTrue("Index is compatible with the data", KDTreeSpatialIndex::IsCompatible(*idx, dat));
+    AssertFalse("Index is not compatible with another filter", KDTreeSpatialIndex::IsCompatible(*idx, dat, filter));
+
+    dat.SetDataHash(dat.DataHash() + 1);
+    AssertFalse("Index is not compatible with another data hash", KDTreeSpatialIndex::IsCompatible(*idx, dat));
+    dat.SetDataHash(dat.DataHash() - 1);
+    dat.SetFrameID(dat.FrameID() + 1);
+    AssertFalse("Index is not compatible with another frame", KDTreeSpatialIndex::IsCompatible(*idx, dat));
+    dat.SetFrameID(dat.FrameID() - 1);
+    AssertTrue("Index is compatible with the data it was built from", KDTreeSpatialIndex::IsCompatible(*idx, dat));
+
+    dat.AccessParticles(2).SetCount(299);
+    AssertFalse("Index is not compatible with changed data", KDTreeSpatialIndex::IsCompatible(*idx, dat));
+}
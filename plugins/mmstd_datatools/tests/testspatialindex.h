@@ -0,0 +1,14 @@
+/*
+ * testspatialindex.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_DATATOOLS_TEST_TESTSPATIALINDEX_H_INCLUDED
+#define MMSTD_DATATOOLS_TEST_TESTSPATIALINDEX_H_INCLUDED
+#pragma once
+
+void TestSpatialIndex(void);
+
+#endif /* MMSTD_DATATOOLS_TEST_TESTSPATIALINDEX_H_INCLUDED */
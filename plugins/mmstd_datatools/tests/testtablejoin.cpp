@@ -0,0 +1,180 @@
+/*
+ * testtablejoin.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testtablejoin.h"
+#include "testhelper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "table/TableJoin.h"
+
+using megamol::stdplugin::datatools::table::ColumnarTableDataCall;
+using megamol::stdplugin::datatools::table::TableJoin;
+
+
+namespace {
+
+/** Nested loop join with the output order documented for TableJoin::join */
+std::vector<float> nestedLoopJoin(TableJoin::JoinType type, const std::vector<float>& first, size_t firstColumnCount,
+    size_t firstKey, const std::vector<float>& second, size_t secondColumnCount, size_t secondKey) {
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const size_t firstRowCount = first.size() / firstColumnCount;
+    const size_t secondRowCount = second.size() / secondColumnCount;
+    std::vector<float> out;
+    std::vector<bool> secondMatched(secondRowCount, false);
+    auto appendSecond = [&](size_t row) {
+        for (size_t col = 0; col < secondColumnCount; ++col) {
+            if (col != secondKey) out.push_back(second[row * secondColumnCount + col]);
+        }
+    };
+    for (size_t r1 = 0; r1 < firstRowCount; ++r1) {
+        bool isMatched = false;
+        for (size_t r2 = 0; r2 < secondRowCount; ++r2) {
+            if (first[r1 * firstColumnCount + firstKey] == second[r2 * secondColumnCount + secondKey]) {
+                out.insert(out.end(), first.begin() + r1 * firstColumnCount,
+                    first.begin() + (r1 + 1) * firstColumnCount);
+                appendSecond(r2);
+                isMatched = true;
+                secondMatched[r2] = true;
+            }
+        }
+        if (!isMatched && type != TableJoin::INNER_JOIN) {
+            out.insert(out.end(), first.begin() + r1 * firstColumnCount, first.begin() + (r1 + 1) * firstColumnCount);
+            out.insert(out.end(), secondColumnCount - 1, nan);
+        }
+    }
+    if (type == TableJoin::OUTER_JOIN) {
+        for (size_t r2 = 0; r2 < secondRowCount; ++r2) {
+            if (secondMatched[r2]) continue;
+            out.insert(out.end(), firstColumnCount, nan);
+            out[out.size() - firstColumnCount + firstKey] = second[r2 * secondColumnCount + secondKey];
+            appendSecond(r2);
+        }
+    }
+    return out;
+}
+
+/** Compares two tables bitwise, so NaNs must be at the same places */
+bool isSameTable(const std::vector<float>& lhs, const std::vector<float>& rhs) {
+    return lhs.size() == rhs.size() &&
+           std::equal(lhs.begin(), lhs.end(), rhs.begin(), [](float a, float b) {
+               return (std::isnan(a) && std::isnan(b)) || (a == b && std::signbit(a) == std::signbit(b));
+           });
+}
+
+/** Splits a row-major table into columns */
+std::vector<ColumnarTableDataCall::Column> toColumns(const std::vector<float>& table, size_t columnCount) {
+    std::vector<ColumnarTableDataCall::Column> columns;
+    for (size_t col = 0; col < columnCount; ++col) {
+        std::vector<float> values;
+        for (size_t i = col; i < table.size(); i += columnCount) {
+            values.push_back(table[i]);
+        }
+        columns.push_back(ColumnarTableDataCall::MakeColumn(std::move(values)));
+    }
+    return columns;
+}
+
+/** Interleaves columns into a row-major table */
+std::vector<float> toRows(const std::vector<ColumnarTableDataCall::Column>& columns, size_t rowCount) {
+    std::vector<float> table;
+    for (size_t row = 0; row < rowCount; ++row) {
+        for (auto const& col : columns) {
+            table.push_back((*col)[row]);
+        }
+    }
+    return table;
+}
+
+} // namespace
+
+
+/*
+ * ::TestTableJoin
+ */
+void TestTableJoin(void) {
+    const size_t firstColumnCount = 3;
+    const size_t firstKey = 1;
+    const size_t secondColumnCount = 4;
+    const size_t secondKey = 2;
+
+    // keys with duplicates on both sides, keys only in one of the tables, NaN keys and a signed zero
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> firstKeys(0, 199);
+    std::uniform_int_distribution<int> secondKeys(100, 299);
+    std::uniform_real_distribution<float> values(-1.0f, 1.0f);
+    std::vector<float> first(1000 * firstColumnCount);
+    for (size_t i = 0; i < first.size(); ++i) {
+        first[i] = (i % firstColumnCount == firstKey) ? static_cast<float>(firstKeys(rng)) : values(rng);
+    }
+    std::vector<float> second(800 * secondColumnCount);
+    for (size_t i = 0; i < second.size(); ++i) {
+        second[i] = (i % secondColumnCount == secondKey) ? static_cast<float>(secondKeys(rng)) : values(rng);
+    }
+    first[5 * firstColumnCount + firstKey] = std::numeric_limits<float>::quiet_NaN();
+    second[7 * secondColumnCount + secondKey] = std::numeric_limits<float>::quiet_NaN();
+    first[9 * firstColumnCount + firstKey] = 0.0f;
+    second[11 * secondColumnCount + secondKey] = -0.0f;
+
+    const TableJoin::JoinType types[] = {TableJoin::INNER_JOIN, TableJoin::LEFT_JOIN, TableJoin::OUTER_JOIN};
+    const char* names[] = {"Inner join matches nested loop join", "Left join matches nested loop join",
+        "Outer join matches nested loop join"};
+    const size_t columnCount = firstColumnCount + secondColumnCount - 1;
+    for (int t = 0; t < 3; ++t) {
+        std::vector<float> out;
+        const auto rows = TableJoin::join(types[t], first.data(), 1000, firstColumnCount, firstKey, second.data(),
+            800, secondColumnCount, secondKey, out);
+        const auto expected =
+            nestedLoopJoin(types[t], first, firstColumnCount, firstKey, second, secondColumnCount, secondKey);
+        AssertEqual("Row count fits the data", rows * columnCount, out.size());
+        AssertTrue(names[t], isSameTable(out, expected));
+
+        std::vector<ColumnarTableDataCall::Column> columns;
+        const auto columnRows = TableJoin::joinColumns(types[t], toColumns(first, firstColumnCount), 1000, firstKey,
+            toColumns(second, secondColumnCount), 800, secondKey, columns);
+        AssertEqual("Columnar join has all columns", columns.size(), columnCount);
+        AssertTrue("Columnar join matches row-major join", isSameTable(toRows(columns, columnRows), out));
+    }
+
+    // each row of the first table has at most one match, so its columns are passed on
+    std::vector<float> unique(300 * secondColumnCount);
+    for (size_t i = 0; i < unique.size(); ++i) {
+        unique[i] = (i % secondColumnCount == secondKey) ? static_cast<float>(i / secondColumnCount) : values(rng);
+    }
+    const auto firstColumns = toColumns(first, firstColumnCount);
+    std::vector<ColumnarTableDataCall::Column> leftColumns;
+    AssertEqual("Left join on unique keys keeps all rows", TableJoin::joinColumns(TableJoin::LEFT_JOIN, firstColumns,
+                                                               1000, firstKey, toColumns(unique, secondColumnCount),
+                                                               300, secondKey, leftColumns),
+        static_cast<size_t>(1000));
+    AssertTrue("Left join on unique keys shares the first columns", leftColumns[0] == firstColumns[0]);
+
+    std::vector<float> out;
+    const float zeroRow[] = {1.0f, -0.0f, 2.0f};
+    const float zeroKey[] = {3.0f, 4.0f, 0.0f, 5.0f};
+    AssertEqual("Signed zeros match", TableJoin::join(TableJoin::INNER_JOIN, zeroRow, 1, firstColumnCount, firstKey,
+                                          zeroKey, 1, secondColumnCount, secondKey, out),
+        static_cast<size_t>(1));
+    const float nanRow[] = {1.0f, std::numeric_limits<float>::quiet_NaN(), 2.0f};
+    const float nanKey[] = {3.0f, 4.0f, std::numeric_limits<float>::quiet_NaN(), 5.0f};
+    AssertEqual("NaN keys never match", TableJoin::join(TableJoin::INNER_JOIN, nanRow, 1, firstColumnCount,
+                                            firstKey, nanKey, 1, secondColumnCount, secondKey, out),
+        static_cast<size_t>(0));
+    AssertEqual("Inner join with an empty table is empty", TableJoin::join(TableJoin::INNER_JOIN, first.data(), 1000,
+                                                               firstColumnCount, firstKey, second.data(), 0,
+                                                               secondColumnCount, secondKey, out),
+        static_cast<size_t>(0));
+    AssertEqual("Left join with an empty table keeps all rows", TableJoin::join(TableJoin::LEFT_JOIN, first.data(),
+                                                                     1000, firstColumnCount, firstKey, second.data(),
+                                                                     0, secondColumnCount, secondKey, out),
+        static_cast<size_t>(1000));
+}
@@ -0,0 +1,14 @@
+/*
+ * testtablejoin.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_DATATOOLS_TEST_TESTTABLEJOIN_H_INCLUDED
+#define MMSTD_DATATOOLS_TEST_TESTTABLEJOIN_H_INCLUDED
+#pragma once
+
+void TestTableJoin(void);
+
+#endif /* MMSTD_DATATOOLS_TEST_TESTTABLEJOIN_H_INCLUDED */
@@ -35,6 +35,10 @@ megamol::stdplugin::volume::BuckyBall::BuckyBall(void)
 		core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_STOP_ASYNC), &BuckyBall::getDummyCallback);
 	this->getDataSlot.SetCallback(core::misc::VolumetricDataCall::ClassName(),
 		core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_TRY_GET_DATA), &BuckyBall::getDummyCallback);
+	this->getDataSlot.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+		core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_RANGES), &BuckyBall::getDummyCallback);
+	this->getDataSlot.SetCallback(core::misc::VolumetricDataCall::ClassName(),
+		core::misc::VolumetricDataCall::FunctionName(core::misc::VolumetricDataCall::IDX_GET_REGION), &BuckyBall::getDummyCallback);
     this->MakeSlotAvailable(&this->getDataSlot);
 
 	this->volume.resize(this->resolution[0] * this->resolution[1] * this->resolution[2]);
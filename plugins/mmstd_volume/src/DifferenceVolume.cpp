@@ -50,6 +50,12 @@ megamol::stdplugin::volume::DifferenceVolume::DifferenceVolume(void)
     this->slotOut.SetCallback(VolumetricDataCall::ClassName(),
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_TRY_GET_DATA),
         &DifferenceVolume::onUnsupported);
+    this->slotOut.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_RANGES),
+        &DifferenceVolume::onUnsupported);
+    this->slotOut.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_REGION),
+        &DifferenceVolume::onUnsupported);
     this->MakeSlotAvailable(&this->slotOut);
 
     this->paramIgnoreInputHash << new core::param::BoolParam(false);
@@ -0,0 +1,287 @@
+/*
+ * RawBrickCache.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+#include "RawBrickCache.h"
+
+#include "mmcore/misc/VolumetricDataCall.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::BRICK_SIZE
+ */
+const size_t megamol::stdplugin::volume::RawBrickCache::BRICK_SIZE = 64;
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::RawBrickCache
+ */
+megamol::stdplugin::volume::RawBrickCache::RawBrickCache(void)
+        : budget(0), frames(0), offset(0), scalarSize(0), swapBytes(false),
+        used(0), voxelSize(0) {
+    ::memset(this->resolution, 0, sizeof(this->resolution));
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::Close
+ */
+void megamol::stdplugin::volume::RawBrickCache::Close(void) {
+    this->bricks.clear();
+    this->lru.clear();
+    this->files.clear();
+    this->used = 0;
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::Open
+ */
+bool megamol::stdplugin::volume::RawBrickCache::Open(
+        const std::vector<std::string>& files, const uint64_t offset,
+        const size_t frames, const size_t resolution[3],
+        const size_t voxelSize, const size_t scalarSize,
+        const bool swapBytes) {
+    this->Close();
+    if (files.empty() || (voxelSize == 0) || (scalarSize == 0)) {
+        return false;
+    }
+
+    // Either all frames are in one file or each frame has its own file.
+    if ((files.size() != 1) && (files.size() != frames)) {
+        return false;
+    }
+
+    // Compressed files do not allow for seeking, so they must be loaded as a whole.
+    for (auto& f : files) {
+        std::ifstream stream(f, std::ios::binary);
+        unsigned char magic[2] = { 0, 0 };
+        if (!stream.read(reinterpret_cast<char *>(magic), sizeof(magic))
+                || ((magic[0] == 0x1f) && (magic[1] == 0x8b))) {
+            return false;
+        }
+    }
+
+    this->files = files;
+    this->offset = offset;
+    this->frames = frames;
+    for (int a = 0; a < 3; ++a) {
+        this->resolution[a] = std::max<size_t>(resolution[a], 1);
+    }
+    this->voxelSize = voxelSize;
+    this->scalarSize = scalarSize;
+    this->swapBytes = swapBytes && (scalarSize > 1);
+    return true;
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::ReadRegion
+ */
+bool megamol::stdplugin::volume::RawBrickCache::ReadRegion(
+        const unsigned int frame, const unsigned int level,
+        const size_t origin[3], const size_t size[3], void *dst) {
+    if (!this->IsOpen() || (frame >= this->frames)) {
+        return false;
+    }
+
+    size_t first[3], last[3];
+    for (int a = 0; a < 3; ++a) {
+        const auto res = core::misc::VolumetricDataCall::GetLevelResolution(this->resolution[a], level);
+        if ((size[a] == 0) || (origin[a] >= res) || (size[a] > res - origin[a])) {
+            return false;
+        }
+        first[a] = origin[a] / BRICK_SIZE;
+        last[a] = (origin[a] + size[a] - 1) / BRICK_SIZE;
+    }
+
+    /* Mark all bricks of the region as most recently used. */
+    std::vector<Key> keys;
+    std::vector<Key> missing;
+    for (size_t z = first[2]; z <= last[2]; ++z) {
+        for (size_t y = first[1]; y <= last[1]; ++y) {
+            for (size_t x = first[0]; x <= last[0]; ++x) {
+                Key key = { frame, level, { x, y, z } };
+                keys.push_back(key);
+                auto it = this->bricks.find(key);
+                if (it != this->bricks.end()) {
+                    this->lru.splice(this->lru.begin(), this->lru, it->second.Position);
+                } else {
+                    missing.push_back(key);
+                }
+            }
+        }
+    }
+
+    /*
+     * Read the missing bricks in parallel, each thread using its own stream.
+     * Fully cached regions do not open the file at all.
+     */
+    std::vector<std::vector<uint8_t>> loaded(missing.size());
+    if (!missing.empty()) {
+        std::atomic<bool> isFailed(false);
+        const auto& file = this->files[(this->files.size() > 1) ? frame : 0];
+#pragma omp parallel if (missing.size() > 1)
+        {
+            std::ifstream stream(file, std::ios::binary);
+#pragma omp for schedule(dynamic)
+            for (int64_t i = 0; i < static_cast<int64_t>(missing.size()); ++i) {
+                if (!this->readBrick(missing[i], stream, loaded[i])) {
+                    isFailed = true;
+                }
+            }
+        }
+        if (isFailed) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < missing.size(); ++i) {
+        this->lru.push_front(missing[i]);
+        this->used += loaded[i].size();
+        auto& brick = this->bricks[missing[i]];
+        brick.Data = std::move(loaded[i]);
+        brick.Position = this->lru.begin();
+    }
+
+    /* Copy the intersection of each brick with the region. */
+    auto out = static_cast<uint8_t *>(dst);
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t i = 0; i < static_cast<int64_t>(keys.size()); ++i) {
+        size_t bf[3], be[3];
+        this->brickBox(keys[i], bf, be);
+        auto& data = this->bricks.at(keys[i]).Data;
+
+        size_t lo[3], hi[3];
+        for (int a = 0; a < 3; ++a) {
+            lo[a] = std::max(bf[a], origin[a]);
+            hi[a] = std::min(bf[a] + be[a], origin[a] + size[a]);
+        }
+        const auto rowSize = (hi[0] - lo[0]) * this->voxelSize;
+
+        for (size_t z = lo[2]; z < hi[2]; ++z) {
+            for (size_t y = lo[1]; y < hi[1]; ++y) {
+                auto src = data.data() + (((z - bf[2]) * be[1] + (y - bf[1])) * be[0]
+                    + (lo[0] - bf[0])) * this->voxelSize;
+                auto d = out + (((z - origin[2]) * size[1] + (y - origin[1])) * size[0]
+                    + (lo[0] - origin[0])) * this->voxelSize;
+                ::memcpy(d, src, rowSize);
+            }
+        }
+    }
+
+    this->evict(keys.size());
+    return true;
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::SetBudget
+ */
+void megamol::stdplugin::volume::RawBrickCache::SetBudget(const size_t budget) {
+    this->budget = budget;
+    this->evict(0);
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::KeyHash::operator ()
+ */
+size_t megamol::stdplugin::volume::RawBrickCache::KeyHash::operator ()(
+        const Key& key) const {
+    std::hash<size_t> hash;
+    size_t retval = hash(key.Frame);
+    for (auto v : { static_cast<size_t>(key.Level), key.Brick[0], key.Brick[1], key.Brick[2] }) {
+        retval ^= hash(v) + 0x9e3779b9 + (retval << 6) + (retval >> 2);
+    }
+    return retval;
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::brickBox
+ */
+void megamol::stdplugin::volume::RawBrickCache::brickBox(const Key& key,
+        size_t first[3], size_t extents[3]) const {
+    for (int a = 0; a < 3; ++a) {
+        const auto res = core::misc::VolumetricDataCall::GetLevelResolution(this->resolution[a], key.Level);
+        first[a] = key.Brick[a] * BRICK_SIZE;
+        extents[a] = std::min(BRICK_SIZE, res - first[a]);
+    }
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::evict
+ */
+void megamol::stdplugin::volume::RawBrickCache::evict(const size_t keep) {
+    while ((this->used > this->budget) && (this->lru.size() > keep)) {
+        auto it = this->bricks.find(this->lru.back());
+        this->used -= it->second.Data.size();
+        this->bricks.erase(it);
+        this->lru.pop_back();
+    }
+}
+
+
+/*
+ * megamol::stdplugin::volume::RawBrickCache::readBrick
+ */
+bool megamol::stdplugin::volume::RawBrickCache::readBrick(const Key& key,
+        std::istream& stream, std::vector<uint8_t>& dst) const {
+    size_t first[3], extents[3];
+    this->brickBox(key, first, extents);
+
+    const size_t step = size_t(1) << key.Level;
+    const auto frameSize = static_cast<uint64_t>(this->resolution[0])
+        * this->resolution[1] * this->resolution[2] * this->voxelSize;
+    const auto frameOffset = this->offset
+        + ((this->files.size() > 1) ? 0 : key.Frame * frameSize);
+
+    // Subsampled rows are read as a whole span and thinned out afterwards.
+    const auto rowVoxels = (extents[0] - 1) * step + 1;
+    const auto rowSize = extents[0] * this->voxelSize;
+    std::vector<uint8_t> span((step > 1) ? rowVoxels * this->voxelSize : 0);
+
+    dst.resize(extents[0] * extents[1] * extents[2] * this->voxelSize);
+    for (size_t z = 0; z < extents[2]; ++z) {
+        for (size_t y = 0; y < extents[1]; ++y) {
+            const uint64_t voxel = ((static_cast<uint64_t>(first[2] + z) * step * this->resolution[1]
+                + (first[1] + y) * step) * this->resolution[0]) + first[0] * step;
+            auto row = dst.data() + (z * extents[1] + y) * rowSize;
+
+            stream.seekg(static_cast<std::streamoff>(frameOffset + voxel * this->voxelSize));
+            if (step == 1) {
+                stream.read(reinterpret_cast<char *>(row), rowSize);
+            } else {
+                stream.read(reinterpret_cast<char *>(span.data()), span.size());
+                for (size_t x = 0; x < extents[0]; ++x) {
+                    ::memcpy(row + x * this->voxelSize, span.data() + x * step * this->voxelSize,
+                        this->voxelSize);
+                }
+            }
+            if (!stream) {
+                stream.clear();
+                return false;
+            }
+        }
+    }
+
+    if (this->swapBytes) {
+        for (auto s = dst.begin(); s != dst.end(); s += this->scalarSize) {
+            std::reverse(s, s + this->scalarSize);
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,168 @@
+/*
+ * RawBrickCache.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+
+namespace megamol {
+namespace stdplugin {
+namespace volume {
+
+    /**
+     * Reads sub-regions of uncompressed raw files brick by brick, without
+     * ever loading a whole frame, and keeps the most recently used bricks
+     * within a memory budget.
+     *
+     * Level l of a frame subsamples every 2^l-th voxel of the full
+     * resolution grid (see VolumetricDataCall::GetLevelResolution()), so
+     * coarse levels only touch a small fraction of the file.
+     */
+    class RawBrickCache {
+
+    public:
+
+        /** The number of voxels along the edge of a brick. */
+        static const size_t BRICK_SIZE;
+
+        /**
+         * Initialises a closed instance.
+         */
+        RawBrickCache(void);
+
+        /**
+         * Closes the files and drops all bricks.
+         */
+        void Close(void);
+
+        /**
+         * Answer whether Open() succeeded.
+         */
+        inline bool IsOpen(void) const {
+            return !this->files.empty();
+        }
+
+        /**
+         * Prepares reading from raw files.
+         *
+         * @param files       The raw file of each frame. If there is a single
+         *                    file, the frames are stored consecutively.
+         * @param offset      The position of the first frame in each file.
+         * @param frames      The number of frames.
+         * @param resolution  The number of voxels along each axis.
+         * @param voxelSize   The size of a voxel in bytes.
+         * @param scalarSize  The size of a single component in bytes.
+         * @param swapBytes   Whether the byte order of the file differs from
+         *                    the one of the machine.
+         *
+         * @return false if a file is missing or compressed, or if there
+         *         is neither a single file nor one file per frame.
+         */
+        bool Open(const std::vector<std::string>& files, const uint64_t offset,
+            const size_t frames, const size_t resolution[3],
+            const size_t voxelSize, const size_t scalarSize,
+            const bool swapBytes);
+
+        /**
+         * Copies a box of voxels of a level into 'dst'. Missing bricks are
+         * read in parallel. Afterwards, least recently used bricks are
+         * dropped until the cache fits into its budget again, except for
+         * the bricks of the region itself.
+         *
+         * @param frame  The frame.
+         * @param level  The level.
+         * @param origin The first voxel of the box on the level.
+         * @param size   The number of voxels of the box on the level.
+         * @param dst    Receives the voxels in x-fastest order, must
+         *               designate size[0] * size[1] * size[2] voxels.
+         *
+         * @return false if the box exceeds the level or reading failed.
+         */
+        bool ReadRegion(const unsigned int frame, const unsigned int level,
+            const size_t origin[3], const size_t size[3], void *dst);
+
+        /**
+         * Sets the number of bytes the bricks may occupy.
+         */
+        void SetBudget(const size_t budget);
+
+        /**
+         * Answer the number of bytes the cached bricks occupy.
+         */
+        inline size_t Used(void) const {
+            return this->used;
+        }
+
+    private:
+
+        /** Identifies a brick. */
+        struct Key {
+            unsigned int Frame;
+            unsigned int Level;
+            size_t Brick[3];
+
+            inline bool operator ==(const Key& rhs) const {
+                return (this->Frame == rhs.Frame) && (this->Level == rhs.Level)
+                    && (this->Brick[0] == rhs.Brick[0])
+                    && (this->Brick[1] == rhs.Brick[1])
+                    && (this->Brick[2] == rhs.Brick[2]);
+            }
+        };
+
+        struct KeyHash {
+            size_t operator ()(const Key& key) const;
+        };
+
+        /** A cached brick and its position in the LRU list. */
+        struct Brick {
+            std::vector<uint8_t> Data;
+            std::list<Key>::iterator Position;
+        };
+
+        /** Answer the first voxel and the extents of a brick on its level. */
+        void brickBox(const Key& key, size_t first[3], size_t extents[3]) const;
+
+        /** Drops least recently used bricks, but keeps the 'keep' most recent ones. */
+        void evict(const size_t keep);
+
+        /** Reads a brick from an open stream. */
+        bool readBrick(const Key& key, std::istream& stream,
+            std::vector<uint8_t>& dst) const;
+
+        size_t budget;
+
+        std::unordered_map<Key, Brick, KeyHash> bricks;
+
+        std::vector<std::string> files;
+
+        size_t frames;
+
+        /** Most recently used bricks first. */
+        std::list<Key> lru;
+
+        uint64_t offset;
+
+        size_t resolution[3];
+
+        size_t scalarSize;
+
+        bool swapBytes;
+
+        size_t used;
+
+        size_t voxelSize;
+
+    };
+
+} /* end namespace volume */
+} /* end namespace stdplugin */
+} /* end namespace megamol */
@@ -48,6 +48,9 @@ megamol::stdplugin::volume::VolumetricDataSource::VolumetricDataSource(void)
     , paramOutputDataSize("OutputDataSize", "Forces the scalar type to the specified size.")
     , paramOutputDataType("OutputDataType", "Enforces the type of a scalar during loading.")
     , paramLoadAsync("LoadAsync", "Start asynchronous loading of frames.")
+    , paramBrickCacheMemory("BrickCacheMemory", "The memory in megabytes for bricks that were read for regions.")
+    , paramRangePyramid("RangePyramid", "Computes per-brick value ranges and histograms and caches them next to "
+                                        "the dat file.")
     , slotGetData("GetData", "Slot for requesting data from the source.") {
     using core::misc::VolumetricDataCall;
     core::param::EnumParam* enumParam = nullptr;
@@ -89,6 +92,12 @@ megamol::stdplugin::volume::VolumetricDataSource::VolumetricDataSource(void)
     //    &VolumetricDataSource::onLoadAsyncChanged);
     this->MakeSlotAvailable(&this->paramLoadAsync);
 
+    this->paramBrickCacheMemory.SetParameter(new core::param::IntParam(1024, 1));
+    this->MakeSlotAvailable(&this->paramBrickCacheMemory);
+
+    this->paramRangePyramid.SetParameter(new core::param::BoolParam(false));
+    this->MakeSlotAvailable(&this->paramRangePyramid);
+
     this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_DATA), &VolumetricDataSource::onGetData);
     this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
@@ -101,6 +110,10 @@ megamol::stdplugin::volume::VolumetricDataSource::VolumetricDataSource(void)
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_STOP_ASYNC), &VolumetricDataSource::onStopAsync);
     this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
         VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_TRY_GET_DATA), &VolumetricDataSource::onTryGetData);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_RANGES), &VolumetricDataSource::onGetRanges);
+    this->slotGetData.SetCallback(VolumetricDataCall::ClassName(),
+        VolumetricDataCall::FunctionName(VolumetricDataCall::IDX_GET_REGION), &VolumetricDataSource::onGetRegion);
     this->MakeSlotAvailable(&this->slotGetData);
 }
 
@@ -209,6 +222,30 @@ DatRawDataFormat megamol::stdplugin::volume::VolumetricDataSource::getOutputData
 }
 
 
+/*
+ * megamol::stdplugin::volume::VolumetricDataSource::getRawFileNames
+ */
+std::vector<std::string> megamol::stdplugin::volume::VolumetricDataSource::getRawFileNames(void) const {
+    std::vector<std::string> retval;
+
+    if (this->fileInfo != nullptr) {
+        if (this->fileInfo->multiDataFiles) {
+            for (int i = 0; i < this->fileInfo->timeSteps; ++i) {
+                auto file = ::getMultifileFilename(this->fileInfo, i);
+                if (file != nullptr) {
+                    retval.emplace_back(file);
+                    ::free(file);
+                }
+            }
+        } else {
+            retval.emplace_back(this->fileInfo->dataFileName);
+        }
+    }
+
+    return retval;
+}
+
+
 /*
  * megamol::stdplugin::volume::VolumetricDataSource::onFileNameChanged
  */
@@ -404,6 +441,8 @@ bool megamol::stdplugin::volume::VolumetricDataSource::onFileNameChanged(core::p
 
     /* Signal data having changed (this is always the case). */
     ++this->dataHash;
+    this->ranges.reset();
+    this->brickCache.Close();
 
     /* Restart loader if asynchronous loading was selected. */
     if (isAsync) {
@@ -684,36 +723,7 @@ bool megamol::stdplugin::volume::VolumetricDataSource::onGetData(core::Call& cal
         }
 
         if (retval) {
-            const VolumetricDataCall& vdc = dynamic_cast<VolumetricDataCall&>(call);
-            switch (this->getOutputDataFormat()) {
-            case DR_FORMAT_UCHAR:
-                this->calcMinMax<uint8_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_FLOAT:
-                this->calcMinMax<float>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_DOUBLE:
-                this->calcMinMax<double>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_USHORT:
-                this->calcMinMax<uint16_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_SHORT:
-                this->calcMinMax<int16_t>(vdc.GetData(), this->mins, this->maxes, *fileInfo, metadata);
-                break;
-            case DR_FORMAT_RAW:
-                megamol::core::utility::log::Log::DefaultLog.WriteWarn("Cannot determine min/max of BITS volume. Setting to [0,1].");
-                this->mins.resize(this->metadata.Components, 0.0);
-                this->maxes.resize(this->metadata.Components, 1.0);
-                break;
-            default:
-                megamol::core::utility::log::Log::DefaultLog.WriteWarn("Cannot determine min/max of unknown volume. Setting to [0,1].");
-                this->mins.resize(this->metadata.Components, 0.0);
-                this->maxes.resize(this->metadata.Components, 1.0);
-                break;
-            }
-            this->metadata.MinValues = this->mins.data();
-            this->metadata.MaxValues = this->maxes.data();
+            this->updateRanges(c.GetData(), c.FrameID());
         }
     } else {
         retval = true;
@@ -983,6 +993,133 @@ bool megamol::stdplugin::volume::VolumetricDataSource::onMemorySaturationChanged
 }
 
 
+/*
+ * megamol::stdplugin::volume::VolumetricDataSource::onGetRanges
+ */
+bool megamol::stdplugin::volume::VolumetricDataSource::onGetRanges(core::Call& call) {
+    using core::misc::VolumetricDataCall;
+    using core::misc::VolumetricRangePyramid;
+    using megamol::core::utility::log::Log;
+
+    try {
+        VolumetricDataCall& c = dynamic_cast<VolumetricDataCall&>(call);
+        c.SetRanges(nullptr);
+
+        /* Sanity check. */
+        if (this->fileInfo == nullptr) {
+            throw vislib::IllegalStateException(_T("A valid dat file must be ")
+                                                _T("loaded before the ranges can be retrieved."),
+                __FILE__, __LINE__);
+        }
+
+        if (!this->paramRangePyramid.Param<core::param::BoolParam>()->Value()) {
+            return false;
+        }
+
+        /*
+         * A frame that is not the current one might have been cached before,
+         * otherwise the caller needs to load it first. A miss keeps the
+         * pyramid of the current frame.
+         */
+        if ((this->ranges == nullptr) || (this->ranges->FrameID() != c.FrameID())) {
+            auto format = this->getOutputDataFormat();
+            std::string datFile(
+                vislib::StringA(this->paramFileName.Param<core::param::FilePathParam>()->Value()).PeekBuffer());
+            auto sources = this->getRawFileNames();
+            sources.push_back(datFile);
+
+            auto loaded = std::make_shared<VolumetricRangePyramid>();
+            if (loaded->Load(VolumetricRangePyramid::SidecarPath(datFile), sources, this->metadata.Resolution,
+                    this->metadata.Components, VolumetricDataSource::scalarTypeOf(format),
+                    ::datRaw_getFormatSize(format), this->metadata.NumberOfFrames, c.FrameID())) {
+                this->ranges = std::move(loaded);
+            }
+        }
+
+        if ((this->ranges != nullptr) && (this->ranges->FrameID() == c.FrameID())) {
+            c.SetRanges(this->ranges);
+        }
+        return true;
+    } catch (vislib::Exception e) {
+        Log::DefaultLog.WriteError(1, e.GetMsg());
+        return false;
+    } catch (...) {
+        Log::DefaultLog.WriteError(1, _T("Unexpected exception in callback ")
+                                      _T("onGetRanges (please check the call)."));
+        return false;
+    }
+}
+
+
+/*
+ * megamol::stdplugin::volume::VolumetricDataSource::onGetRegion
+ */
+bool megamol::stdplugin::volume::VolumetricDataSource::onGetRegion(core::Call& call) {
+    using core::misc::VolumetricDataCall;
+    using megamol::core::utility::log::Log;
+
+    try {
+        VolumetricDataCall& c = dynamic_cast<VolumetricDataCall&>(call);
+
+        /* Sanity check. */
+        if (this->fileInfo == nullptr) {
+            throw vislib::IllegalStateException(_T("A valid dat file must be ")
+                                                _T("loaded before a region can be retrieved."),
+                __FILE__, __LINE__);
+        }
+
+        if (!this->brickCache.IsOpen()) {
+            auto files = this->getRawFileNames();
+            if (this->fileInfo->multiDataFiles && (files.size() != this->metadata.NumberOfFrames)) {
+                Log::DefaultLog.WriteError(_T("The raw files of %u of %u frames ")
+                                           _T("could not be determined."),
+                    static_cast<unsigned int>(this->metadata.NumberOfFrames - files.size()),
+                    static_cast<unsigned int>(this->metadata.NumberOfFrames));
+                return false;
+            }
+
+            const uint16_t order = 1;
+            const auto isLittleEndian = (*reinterpret_cast<const uint8_t*>(&order) == 1);
+            const auto swapBytes = (this->fileInfo->byteOrder == DR_LITTLE_ENDIAN) != isLittleEndian;
+
+            if (!this->brickCache.Open(files, this->fileInfo->dataOffset, this->metadata.NumberOfFrames,
+                    this->metadata.Resolution, ::datRaw_getRecordSize(this->fileInfo, this->fileInfo->dataFormat),
+                    ::datRaw_getFormatSize(this->fileInfo->dataFormat), swapBytes)) {
+                Log::DefaultLog.WriteError(_T("Regions can only be read from ")
+                                           _T("uncompressed raw files."));
+                return false;
+            }
+        }
+
+        this->brickCache.SetBudget(
+            static_cast<size_t>(this->paramBrickCacheMemory.Param<core::param::IntParam>()->Value()) << 20);
+
+        auto size = c.GetRegionSize();
+        this->regionBuffer.resize(
+            size[0] * size[1] * size[2] * ::datRaw_getRecordSize(this->fileInfo, this->fileInfo->dataFormat));
+        if (!this->brickCache.ReadRegion(
+                c.FrameID(), c.GetRegionLevel(), c.GetRegionOrigin(), size, this->regionBuffer.data())) {
+            Log::DefaultLog.WriteError(_T("Failed to read region of frame %u ")
+                                       _T("on level %u."),
+                c.FrameID(), c.GetRegionLevel());
+            return false;
+        }
+
+        c.SetMetadata(&this->metadata);
+        c.SetData(this->regionBuffer.data(), 1);
+        c.SetDataHash(this->dataHash);
+        return true;
+    } catch (vislib::Exception e) {
+        Log::DefaultLog.WriteError(1, e.GetMsg());
+        return false;
+    } catch (...) {
+        Log::DefaultLog.WriteError(1, _T("Unexpected exception in callback ")
+                                      _T("onGetRegion (please check the call)."));
+        return false;
+    }
+}
+
+
 /*
  * megamol::stdplugin::volume::VolumetricDataSource::onStartAsync
  */
@@ -1107,6 +1244,71 @@ bool megamol::stdplugin::volume::VolumetricDataSource::suspendAsyncLoad(const bo
 }
 
 
+/*
+ * megamol::stdplugin::volume::VolumetricDataSource::updateRanges
+ */
+void megamol::stdplugin::volume::VolumetricDataSource::updateRanges(const void* data, const unsigned int frameID) {
+    using core::misc::VolumetricRangePyramid;
+    using megamol::core::utility::log::Log;
+
+    const auto format = this->getOutputDataFormat();
+    const auto type = VolumetricDataSource::scalarTypeOf(format);
+    const auto length = ::datRaw_getFormatSize(format);
+    const auto components = this->metadata.Components;
+    bool isValid = false;
+
+    if (this->paramRangePyramid.Param<core::param::BoolParam>()->Value()) {
+        if ((this->ranges == nullptr) || (this->ranges->FrameID() != frameID)) {
+            std::string datFile(
+                vislib::StringA(this->paramFileName.Param<core::param::FilePathParam>()->Value()).PeekBuffer());
+            auto sidecar = VolumetricRangePyramid::SidecarPath(datFile);
+            auto sources = this->getRawFileNames();
+            sources.push_back(datFile);
+
+            /* Pyramids already handed out remain valid for their callers. */
+            auto pyramid = std::make_shared<VolumetricRangePyramid>();
+            if (!pyramid->Load(sidecar, sources, this->metadata.Resolution, components, type, length,
+                    this->metadata.NumberOfFrames, frameID)) {
+                if (pyramid->Compute(data, this->metadata.Resolution, components, type, length, frameID)
+                        && !pyramid->Save(sidecar, sources, type, length, this->metadata.NumberOfFrames)) {
+                    Log::DefaultLog.WriteWarn(_T("The value ranges could not be cached in %hs."), sidecar.c_str());
+                }
+            }
+            if (pyramid->IsValid()) {
+                this->ranges = std::move(pyramid);
+            } else {
+                this->ranges.reset();
+            }
+        }
+
+        if (this->ranges != nullptr) {
+            this->mins.resize(components);
+            this->maxes.resize(components);
+            for (size_t c = 0; c < components; ++c) {
+                this->mins[c] = this->ranges->GlobalMin(c);
+                this->maxes[c] = this->ranges->GlobalMax(c);
+            }
+            isValid = true;
+        }
+
+    } else {
+        this->ranges.reset();
+        isValid = VolumetricRangePyramid::ComputeMinMax(
+            data, this->metadata.Resolution, components, type, length, this->mins, this->maxes);
+    }
+
+    if (!isValid) {
+        Log::DefaultLog.WriteWarn(_T("Cannot determine min/max of %hs volume. Setting to [0,1]."),
+            ::datRaw_getDataFormatName(format));
+        this->mins.assign(components, 0.0);
+        this->maxes.assign(components, 1.0);
+    }
+
+    this->metadata.MinValues = this->mins.data();
+    this->metadata.MaxValues = this->maxes.data();
+}
+
+
 /*
  * megamol::stdplugin::volume::VolumetricDataSource::BufferSlotUnlocker::~BufferSlotUnlocker
  */
@@ -1217,6 +1419,41 @@ DWORD megamol::stdplugin::volume::VolumetricDataSource::loadAsync(void* userData
 }
 
 
+/*
+ * megamol::stdplugin::volume::VolumetricDataSource::scalarTypeOf
+ */
+megamol::core::misc::ScalarType_t megamol::stdplugin::volume::VolumetricDataSource::scalarTypeOf(
+    const DatRawDataFormat format) {
+    using core::misc::VolumetricDataCall;
+
+    switch (format) {
+    case DR_FORMAT_CHAR:
+    case DR_FORMAT_SHORT:
+    case DR_FORMAT_INT:
+    case DR_FORMAT_LONG:
+        return VolumetricDataCall::ScalarType::SIGNED_INTEGER;
+
+    case DR_FORMAT_UCHAR:
+    case DR_FORMAT_USHORT:
+    case DR_FORMAT_UINT:
+    case DR_FORMAT_ULONG:
+        return VolumetricDataCall::ScalarType::UNSIGNED_INTEGER;
+
+    case DR_FORMAT_HALF:
+    case DR_FORMAT_FLOAT:
+    case DR_FORMAT_DOUBLE:
+        return VolumetricDataCall::ScalarType::FLOATING_POINT;
+
+    case DR_FORMAT_RAW:
+        return VolumetricDataCall::ScalarType::BITS;
+
+    case DR_FORMAT_NONE:
+    default:
+        return VolumetricDataCall::ScalarType::UNKNOWN;
+    }
+}
+
+
 /*
  * megamol::stdplugin::volume::VolumetricDataSource::setUnlocker
  */
@@ -13,11 +13,15 @@
 
 #include <atomic>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "datRaw.h"
 
+#include "RawBrickCache.h"
+
 #include "mmcore/misc/VolumetricDataCall.h"
+#include "mmcore/misc/VolumetricRangePyramid.h"
 
 #include "mmcore/param/ParamSlot.h"
 
@@ -96,6 +100,12 @@ protected:
      */
     DatRawDataFormat getOutputDataFormat(void) const;
 
+    /**
+     * Answer the paths of the raw files of the current dat file. Files of
+     * a multi-file series whose name cannot be derived are omitted.
+     */
+    std::vector<std::string> getRawFileNames(void) const;
+
     /**
      * Handles a change of 'paramFileName'.
      *
@@ -151,6 +161,26 @@ protected:
      */
     bool onGetMetadata(core::Call& call);
 
+    /**
+     * Gets the value ranges of the requested frame if they have been
+     * computed or cached in the sidecar file before.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool onGetRanges(core::Call& call);
+
+    /**
+     * Reads the requested region of a frame through the brick cache
+     * without loading the whole frame.
+     *
+     * @param caller The calling call.
+     *
+     * @return 'true' on success, 'false' on failure.
+     */
+    bool onGetRegion(core::Call& call);
+
     /**
      * Starts the asynchronous loading thread.
      *
@@ -211,6 +241,16 @@ protected:
      */
     bool suspendAsyncLoad(const bool isWait);
 
+    /**
+     * Updates the minimum and maximum of each component in the metadata
+     * and, if enabled, the range pyramid for a frame that has just been
+     * loaded.
+     *
+     * @param data    The frame in the output data format.
+     * @param frameID The ID of the frame.
+     */
+    void updateRanges(const void* data, const unsigned int frameID);
+
 private:
     /** Enapsulates all information about a buffer for a single frame. */
     typedef struct BufferSlot_t {
@@ -294,6 +334,11 @@ private:
     /** Executes the given loading call asynchronously. */
     static DWORD loadAsync(void* userData);
 
+    /**
+     * Answer the type of the scalars in the given format.
+     */
+    static core::misc::ScalarType_t scalarTypeOf(const DatRawDataFormat format);
+
     /**
      * Add an unlocker to 'call' that will eventually unlock 'buffer'.
      */
@@ -393,32 +438,31 @@ private:
     /** Enables or disables asynchronous loading. */
     core::param::ParamSlot paramLoadAsync;
 
+    /** The memory in megabytes that the brick cache may occupy. */
+    core::param::ParamSlot paramBrickCacheMemory;
+
+    /**
+     * Enables the computation of the range pyramid, which is cached in a
+     * sidecar file next to the dat file.
+     */
+    core::param::ParamSlot paramRangePyramid;
+
+    /**
+     * The range pyramid of the most recently requested frame. A pyramid
+     * handed out to a call is never modified, a new frame gets a new one.
+     */
+    std::shared_ptr<const core::misc::VolumetricRangePyramid> ranges;
+
+    /** The bricks read for requested regions. */
+    RawBrickCache brickCache;
+
+    /** The voxels of the most recently requested region. */
+    std::vector<uint8_t> regionBuffer;
+
     /** The slot that requests the data. */
     core::CalleeSlot slotGetData;
 
     std::vector<double> mins, maxes;
-
-    template <class T>
-    void calcMinMax(void const* vol_ptr, std::vector<double>& mins, std::vector<double>& maxes,
-        DatRawFileInfo const& fileinfo, core::misc::VolumetricDataCall::Metadata const& metadata) {
-        mins.resize(metadata.Components);
-        maxes.resize(metadata.Components);
-        for (auto c = 0; c < metadata.Components; ++c) {
-            double min = std::numeric_limits<double>::max();
-            double max = std::numeric_limits<double>::lowest();
-            size_t totalLength = 1;
-            for (int i = 0; i < fileinfo.dimensions; ++i) {
-                totalLength *= fileinfo.resolution[i];
-            }
-            auto* vol = reinterpret_cast<const T*>(vol_ptr);
-            for (size_t x = c; x < totalLength; x += metadata.Components) {
-                if (vol[x] < min) min = vol[x];
-                if (vol[x] > max) max = vol[x];
-            }
-            mins[c] = min;
-            maxes[c] = max;
-        }
-    }
 };
 
 } /* end namespace volume */
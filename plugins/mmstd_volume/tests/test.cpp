@@ -0,0 +1,53 @@
+/*
+ * test.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include <cstring>
+#include <iostream>
+
+/* include test implementations */
+#include "testhelper.h"
+#include "testrangepyramid.h"
+#include "testrawbrickcache.h"
+
+
+/* type for test functions */
+typedef void (*VolumeTestFunction)(void);
+
+/* type for test manager structure */
+typedef struct _VolumeTest_t {
+    const char *testName; // the tests name. Used as command line argument to select this test.
+    VolumeTestFunction testFunc; // the function called when this test is selected.
+    const char *testDesc; // the description of this test. Used for the online help.
+} VolumeTest;
+
+
+/* all available tests, run in this order if none is selected */
+VolumeTest tests[] = {
+    {"RangePyramid", ::TestRangePyramid, "Tests the range pyramid against brute force and its sidecar file."},
+    {"RawBrickCache", ::TestRawBrickCache, "Tests reading regions of raw files brick by brick."},
+    {nullptr, nullptr, nullptr}
+};
+
+
+/*
+ * main
+ */
+int main(int argc, char **argv) {
+    for (VolumeTest *t = tests; t->testName != nullptr; ++t) {
+        bool isSelected = (argc < 2);
+        for (int i = 1; i < argc; ++i) {
+            isSelected = isSelected || (::strcmp(argv[i], t->testName) == 0);
+        }
+        if (isSelected) {
+            std::cout << std::endl << t->testName << ": " << t->testDesc << std::endl;
+            t->testFunc();
+        }
+    }
+
+    ::OutputAssertTestSummary();
+    return 0;
+}
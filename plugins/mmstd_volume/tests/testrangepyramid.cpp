@@ -0,0 +1,240 @@
+/*
+ * testrangepyramid.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testrangepyramid.h"
+#include "testhelper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mmcore/misc/VolumetricRangePyramid.h"
+
+using megamol::core::misc::VolumetricRangePyramid;
+
+
+namespace {
+
+/** Answer whether two pyramids hold the same ranges and histograms */
+bool isSamePyramid(const VolumetricRangePyramid& lhs, const VolumetricRangePyramid& rhs) {
+    if (!lhs.IsValid() || !rhs.IsValid() || (lhs.Levels() != rhs.Levels()) ||
+        (lhs.Components() != rhs.Components()) || (lhs.Bins() != rhs.Bins()) ||
+        (lhs.FrameID() != rhs.FrameID())) {
+        return false;
+    }
+    for (size_t l = 0; l < lhs.Levels(); ++l) {
+        for (size_t z = 0; z < lhs.BrickCount(l, 2); ++z) {
+            for (size_t y = 0; y < lhs.BrickCount(l, 1); ++y) {
+                for (size_t x = 0; x < lhs.BrickCount(l, 0); ++x) {
+                    for (size_t c = 0; c < lhs.Components(); ++c) {
+                        if ((lhs.Min(l, x, y, z, c) != rhs.Min(l, x, y, z, c)) ||
+                            (lhs.Max(l, x, y, z, c) != rhs.Max(l, x, y, z, c)) ||
+                            !std::equal(lhs.Histogram(l, x, y, z, c), lhs.Histogram(l, x, y, z, c) + lhs.Bins(),
+                                rhs.Histogram(l, x, y, z, c))) {
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+
+/*
+ * ::TestRangePyramid
+ */
+void TestRangePyramid(void) {
+    using megamol::core::misc::FLOATING_POINT;
+
+    const size_t res[3] = {10, 7, 5};
+    const size_t comps = 2;
+    const size_t edge = 4;
+    const size_t bins = 8;
+    const size_t cntVoxels = res[0] * res[1] * res[2];
+
+    // component 0 is noise, component 1 a step along x, such that some bricks are constant
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> noise(-1.0f, 3.0f);
+    std::vector<float> vol(cntVoxels * comps);
+    for (size_t i = 0; i < cntVoxels; ++i) {
+        vol[i * comps] = noise(rng);
+        vol[i * comps + 1] = (i % res[0] < 5) ? 0.0f : 1.0f;
+    }
+    auto voxel = [&](size_t x, size_t y, size_t z, size_t c) {
+        return static_cast<double>(vol[((z * res[1] + y) * res[0] + x) * comps + c]);
+    };
+
+    VolumetricRangePyramid pyramid;
+    AssertFalse("Unsupported scalars are rejected",
+        pyramid.Compute(vol.data(), res, comps, megamol::core::misc::BITS, 1, 0, edge, bins));
+    AssertFalse("Rejected pyramid is empty", pyramid.IsValid());
+    AssertTrue("Compute succeeds", pyramid.Compute(vol.data(), res, comps, FLOATING_POINT, 4, 1, edge, bins));
+    AssertEqual("Bricks along x share border voxels", pyramid.BrickCount(0, 0), static_cast<size_t>(3));
+    AssertEqual("Bricks along y", pyramid.BrickCount(0, 1), static_cast<size_t>(2));
+    AssertEqual("Bricks along z", pyramid.BrickCount(0, 2), static_cast<size_t>(1));
+    const auto top = pyramid.Levels() - 1;
+    AssertTrue("Top level has a single brick",
+        pyramid.BrickCount(top, 0) == 1 && pyramid.BrickCount(top, 1) == 1 && pyramid.BrickCount(top, 2) == 1);
+
+    std::vector<double> globalMins, globalMaxes;
+    VolumetricRangePyramid::ComputeMinMax(vol.data(), res, comps, FLOATING_POINT, 4, globalMins, globalMaxes);
+    bool isGlobalOk = true;
+    for (size_t c = 0; c < comps; ++c) {
+        double mn = std::numeric_limits<double>::max(), mx = std::numeric_limits<double>::lowest();
+        for (size_t i = 0; i < cntVoxels; ++i) {
+            mn = std::min(mn, static_cast<double>(vol[i * comps + c]));
+            mx = std::max(mx, static_cast<double>(vol[i * comps + c]));
+        }
+        isGlobalOk = isGlobalOk && (pyramid.GlobalMin(c) == mn) && (pyramid.GlobalMax(c) == mx) &&
+                     (globalMins[c] == mn) && (globalMaxes[c] == mx);
+    }
+    AssertTrue("Global ranges match brute force", isGlobalOk);
+
+    // level 0: ranges include the shared border voxels, histograms count the owned voxels only
+    bool isRangeOk = true;
+    bool isHistogramOk = true;
+    for (size_t bz = 0; bz < pyramid.BrickCount(0, 2); ++bz) {
+        for (size_t by = 0; by < pyramid.BrickCount(0, 1); ++by) {
+            for (size_t bx = 0; bx < pyramid.BrickCount(0, 0); ++bx) {
+                const size_t b[3] = {bx, by, bz};
+                size_t first[3], last[3], end[3];
+                for (int a = 0; a < 3; ++a) {
+                    first[a] = b[a] * edge;
+                    last[a] = std::min((b[a] + 1) * edge, res[a] - 1);
+                    end[a] = (b[a] + 1 == pyramid.BrickCount(0, a)) ? res[a] : (b[a] + 1) * edge;
+                }
+                for (size_t c = 0; c < comps; ++c) {
+                    double mn = std::numeric_limits<double>::max(), mx = std::numeric_limits<double>::lowest();
+                    for (size_t z = first[2]; z <= last[2]; ++z) {
+                        for (size_t y = first[1]; y <= last[1]; ++y) {
+                            for (size_t x = first[0]; x <= last[0]; ++x) {
+                                mn = std::min(mn, voxel(x, y, z, c));
+                                mx = std::max(mx, voxel(x, y, z, c));
+                            }
+                        }
+                    }
+                    isRangeOk = isRangeOk && (pyramid.Min(0, bx, by, bz, c) == mn) &&
+                                (pyramid.Max(0, bx, by, bz, c) == mx);
+
+                    std::vector<uint64_t> hist(bins, 0);
+                    const double scale = bins / (pyramid.GlobalMax(c) - pyramid.GlobalMin(c));
+                    for (size_t z = first[2]; z < end[2]; ++z) {
+                        for (size_t y = first[1]; y < end[1]; ++y) {
+                            for (size_t x = first[0]; x < end[0]; ++x) {
+                                const auto t = (voxel(x, y, z, c) - pyramid.GlobalMin(c)) * scale;
+                                ++hist[std::min(static_cast<size_t>(t), bins - 1)];
+                            }
+                        }
+                    }
+                    isHistogramOk =
+                        isHistogramOk && std::equal(hist.begin(), hist.end(), pyramid.Histogram(0, bx, by, bz, c));
+                }
+            }
+        }
+    }
+    AssertTrue("Brick ranges match brute force", isRangeOk);
+    AssertTrue("Brick histograms count the owned voxels", isHistogramOk);
+
+    bool isTotalOk = true;
+    for (size_t l = 0; l < pyramid.Levels(); ++l) {
+        for (size_t c = 0; c < comps; ++c) {
+            uint64_t total = 0;
+            for (size_t z = 0; z < pyramid.BrickCount(l, 2); ++z) {
+                for (size_t y = 0; y < pyramid.BrickCount(l, 1); ++y) {
+                    for (size_t x = 0; x < pyramid.BrickCount(l, 0); ++x) {
+                        for (size_t h = 0; h < bins; ++h) total += pyramid.Histogram(l, x, y, z, c)[h];
+                    }
+                }
+            }
+            isTotalOk = isTotalOk && (total == cntVoxels);
+        }
+    }
+    AssertTrue("Every level counts every voxel once", isTotalOk);
+
+    // the query covers bricks 0 and 1 along x, ie voxels 0 to 8
+    const size_t lo[3] = {2, 1, 0};
+    const size_t hi[3] = {5, 3, 2};
+    double qMin, qMax;
+    pyramid.QueryRange(lo, hi, 0, qMin, qMax);
+    double boxMin = std::numeric_limits<double>::max(), boxMax = std::numeric_limits<double>::lowest();
+    double brickMin = boxMin, brickMax = boxMax;
+    for (size_t z = 0; z < res[2]; ++z) {
+        for (size_t y = 0; y < res[1]; ++y) {
+            for (size_t x = 0; x <= 8; ++x) {
+                const auto v = voxel(x, y, z, 0);
+                if (y <= 4) {
+                    brickMin = std::min(brickMin, v);
+                    brickMax = std::max(brickMax, v);
+                }
+                if (x >= lo[0] && x <= hi[0] && y >= lo[1] && y <= hi[1] && z >= lo[2] && z <= hi[2]) {
+                    boxMin = std::min(boxMin, v);
+                    boxMax = std::max(boxMax, v);
+                }
+            }
+        }
+    }
+    AssertTrue("Query range is conservative", qMin <= boxMin && qMax >= boxMax);
+    AssertTrue("Query range is the range of the touched bricks", qMin == brickMin && qMax == brickMax);
+    pyramid.QueryRange(lo, hi, 1, qMin, qMax);
+    AssertTrue("Query range of the step", qMin == 0.0 && qMax == 1.0);
+
+    // sidecar round trip
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto datFile = (dir / "mmstd_volume_test_ranges.dat").string();
+    const auto sidecar = VolumetricRangePyramid::SidecarPath(datFile);
+    std::filesystem::remove(sidecar);
+    std::ofstream(datFile) << "dummy";
+    std::filesystem::last_write_time(
+        datFile, std::filesystem::last_write_time(datFile) - std::chrono::hours(1));
+    const std::vector<std::string> sources = {datFile};
+
+    AssertTrue("Save succeeds", pyramid.Save(sidecar, sources, FLOATING_POINT, 4, 3));
+    VolumetricRangePyramid loaded;
+    AssertTrue("Load finds the saved frame",
+        loaded.Load(sidecar, sources, res, comps, FLOATING_POINT, 4, 3, 1, edge, bins));
+    AssertTrue("Loaded pyramid equals the saved one", isSamePyramid(pyramid, loaded));
+
+    AssertFalse("Load misses an unsaved frame",
+        loaded.Load(sidecar, sources, res, comps, FLOATING_POINT, 4, 3, 0, edge, bins));
+    AssertTrue("Load miss keeps the pyramid", isSamePyramid(pyramid, loaded));
+    AssertFalse("Load rejects other bins",
+        loaded.Load(sidecar, sources, res, comps, FLOATING_POINT, 4, 3, 1, edge, bins + 1));
+    AssertFalse("Load rejects another scalar type",
+        loaded.Load(sidecar, sources, res, comps, FLOATING_POINT, 8, 3, 1, edge, bins));
+
+    // a second frame is added to the file, the first one is kept
+    VolumetricRangePyramid other;
+    other.Compute(vol.data(), res, comps, FLOATING_POINT, 4, 2, edge, bins);
+    AssertTrue("Save of another frame succeeds", other.Save(sidecar, sources, FLOATING_POINT, 4, 3));
+    AssertTrue("Earlier frame is kept",
+        loaded.Load(sidecar, sources, res, comps, FLOATING_POINT, 4, 3, 1, edge, bins) &&
+            isSamePyramid(pyramid, loaded));
+
+    // any source newer than the sidecar makes it stale, eg a rewritten raw file
+    const auto rawFile = (dir / "mmstd_volume_test_ranges.raw").string();
+    std::ofstream(rawFile) << "dummy";
+    std::filesystem::last_write_time(
+        rawFile, std::filesystem::last_write_time(sidecar) + std::chrono::hours(1));
+    AssertFalse("Newer raw file makes the sidecar stale",
+        loaded.Load(sidecar, {datFile, rawFile}, res, comps, FLOATING_POINT, 4, 3, 1, edge, bins));
+    AssertTrue("Missing sources are ignored",
+        loaded.Load(sidecar, {datFile, rawFile + ".missing"}, res, comps, FLOATING_POINT, 4, 3, 1, edge, bins));
+
+    std::filesystem::remove(sidecar);
+    std::filesystem::remove(datFile);
+    std::filesystem::remove(rawFile);
+}
@@ -0,0 +1,14 @@
+/*
+ * testrangepyramid.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_VOLUME_TEST_TESTRANGEPYRAMID_H_INCLUDED
+#define MMSTD_VOLUME_TEST_TESTRANGEPYRAMID_H_INCLUDED
+#pragma once
+
+void TestRangePyramid(void);
+
+#endif /* MMSTD_VOLUME_TEST_TESTRANGEPYRAMID_H_INCLUDED */
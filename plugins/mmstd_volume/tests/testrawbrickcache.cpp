@@ -0,0 +1,149 @@
+/*
+ * testrawbrickcache.cpp
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "testrawbrickcache.h"
+#include "testhelper.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "RawBrickCache.h"
+
+using megamol::stdplugin::volume::RawBrickCache;
+
+
+namespace {
+
+const size_t RES[3] = {130, 70, 3};
+const size_t COMPONENTS = 2;
+const uint64_t OFFSET = 16;
+
+/** The value of a component of a voxel on level 0 */
+inline uint16_t value(size_t frame, size_t x, size_t y, size_t z, size_t c) {
+    return static_cast<uint16_t>(((frame * 1000003 + x + 200 * y + 20000 * z) * COMPONENTS + c) & 0xffff);
+}
+
+/** Writes frames [first, last[ to a raw file after OFFSET bytes of header */
+void writeRaw(const std::string& path, size_t first, size_t last, bool bigEndian) {
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    stream.write(std::string(OFFSET, 'h').data(), OFFSET);
+    for (size_t f = first; f < last; ++f) {
+        for (size_t z = 0; z < RES[2]; ++z) {
+            for (size_t y = 0; y < RES[1]; ++y) {
+                for (size_t x = 0; x < RES[0]; ++x) {
+                    for (size_t c = 0; c < COMPONENTS; ++c) {
+                        const auto v = value(f, x, y, z, c);
+                        const char bytes[2] = {static_cast<char>(bigEndian ? (v >> 8) : (v & 0xff)),
+                            static_cast<char>(bigEndian ? (v & 0xff) : (v >> 8))};
+                        stream.write(bytes, 2);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/** Reads a region and compares it to the expected values of the level */
+bool isRegionOk(RawBrickCache& cache, unsigned int frame, unsigned int level, const size_t origin[3],
+    const size_t size[3]) {
+    std::vector<uint16_t> dst(size[0] * size[1] * size[2] * COMPONENTS);
+    if (!cache.ReadRegion(frame, level, origin, size, dst.data())) {
+        return false;
+    }
+    const size_t step = size_t(1) << level;
+    auto d = dst.begin();
+    for (size_t z = origin[2]; z < origin[2] + size[2]; ++z) {
+        for (size_t y = origin[1]; y < origin[1] + size[1]; ++y) {
+            for (size_t x = origin[0]; x < origin[0] + size[0]; ++x) {
+                for (size_t c = 0; c < COMPONENTS; ++c) {
+                    if (*d++ != value(frame, x * step, y * step, z * step, c)) {
+                        return false;
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+
+/*
+ * ::TestRawBrickCache
+ */
+void TestRawBrickCache(void) {
+    const auto dir = std::filesystem::temp_directory_path();
+    const auto single = (dir / "mmstd_volume_test_bricks.raw").string();
+    const auto frame0 = (dir / "mmstd_volume_test_bricks0.raw").string();
+    const auto frame1 = (dir / "mmstd_volume_test_bricks1.raw").string();
+    const auto swapped = (dir / "mmstd_volume_test_bricks_be.raw").string();
+    const auto gzipped = (dir / "mmstd_volume_test_bricks.raw.gz").string();
+    writeRaw(single, 0, 2, false);
+    writeRaw(frame0, 0, 1, false);
+    writeRaw(frame1, 1, 2, false);
+    writeRaw(swapped, 0, 2, true);
+    std::ofstream(gzipped, std::ios::binary) << "\x1f\x8b compressed";
+
+    RawBrickCache cache;
+    AssertFalse("Missing file is rejected",
+        cache.Open({single + ".missing"}, OFFSET, 2, RES, 2 * COMPONENTS, 2, false));
+    AssertFalse("Compressed file is rejected", cache.Open({gzipped}, OFFSET, 2, RES, 2 * COMPONENTS, 2, false));
+    AssertFalse("File count must match the frames",
+        cache.Open({frame0, frame1}, OFFSET, 3, RES, 2 * COMPONENTS, 2, false));
+    AssertFalse("Rejected cache is closed", cache.IsOpen());
+
+    // a region spanning 2 x 2 x 1 bricks and a whole coarse level
+    const size_t origin[3] = {60, 3, 1};
+    const size_t size[3] = {10, 65, 2};
+    const size_t zero[3] = {0, 0, 0};
+    const size_t level1[3] = {65, 35, 2};
+
+    AssertTrue("Single file opens", cache.Open({single}, OFFSET, 2, RES, 2 * COMPONENTS, 2, false));
+    AssertTrue("Region of frame 0", isRegionOk(cache, 0, 0, origin, size));
+    AssertTrue("Region of frame 1", isRegionOk(cache, 1, 0, origin, size));
+    AssertTrue("Level 1 of frame 1", isRegionOk(cache, 1, 1, zero, level1));
+
+    std::vector<uint16_t> dst(130 * 70 * 3 * COMPONENTS);
+    const size_t beyond[3] = {1, 35, 1};
+    const size_t one[3] = {65, 1, 1};
+    AssertFalse("Region beyond the level is rejected", cache.ReadRegion(0, 1, beyond, one, dst.data()));
+    AssertFalse("Frame beyond the volume is rejected", cache.ReadRegion(2, 0, zero, one, dst.data()));
+
+    // without budget only the bricks of the last region are kept, cached regions do not touch the file
+    cache.SetBudget(0);
+    AssertEqual("No budget drops all bricks", cache.Used(), static_cast<size_t>(0));
+    AssertTrue("Region without budget", isRegionOk(cache, 0, 0, origin, size));
+    const auto regionBytes = cache.Used();
+    AssertEqual("Bricks of the region are kept", regionBytes,
+        static_cast<size_t>((64 + 64) * (64 + 6) * 3 * 2 * COMPONENTS));
+    AssertTrue("Region of another frame", isRegionOk(cache, 1, 0, origin, size));
+    AssertEqual("Bricks of the previous region are dropped", cache.Used(), regionBytes);
+    std::filesystem::remove(single);
+    AssertTrue("Cached region is read without the file", isRegionOk(cache, 1, 0, origin, size));
+    AssertFalse("Evicted region needs the file", isRegionOk(cache, 0, 0, origin, size));
+
+    cache.SetBudget(static_cast<size_t>(-1));
+    AssertTrue("One file per frame opens", cache.Open({frame0, frame1}, OFFSET, 2, RES, 2 * COMPONENTS, 2, false));
+    AssertTrue("Region of the first file", isRegionOk(cache, 0, 0, origin, size));
+    AssertTrue("Region of the second file", isRegionOk(cache, 1, 0, origin, size));
+    AssertTrue("Level 1 of the second file", isRegionOk(cache, 1, 1, zero, level1));
+
+    AssertTrue("Swapped file opens", cache.Open({swapped}, OFFSET, 2, RES, 2 * COMPONENTS, 2, true));
+    AssertTrue("Bytes are swapped", isRegionOk(cache, 1, 0, origin, size));
+
+    cache.Close();
+    AssertFalse("Closed cache", cache.IsOpen());
+    AssertEqual("Closed cache holds no bricks", cache.Used(), static_cast<size_t>(0));
+
+    for (auto& f : {frame0, frame1, swapped, gzipped}) {
+        std::filesystem::remove(f);
+    }
+}
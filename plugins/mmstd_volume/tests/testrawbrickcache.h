@@ -0,0 +1,14 @@
+/*
+ * testrawbrickcache.h
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#ifndef MMSTD_VOLUME_TEST_TESTRAWBRICKCACHE_H_INCLUDED
+#define MMSTD_VOLUME_TEST_TESTRAWBRICKCACHE_H_INCLUDED
+#pragma once
+
+void TestRawBrickCache(void);
+
+#endif /* MMSTD_VOLUME_TEST_TESTRAWBRICKCACHE_H_INCLUDED */
@@ -13,6 +13,7 @@
 #include <vector>
 #include "blend2d.h"
 #include "mmcore/utility/log/Log.h"
+#include "ProbeCollection.h"
 
 
 namespace megamol {
@@ -44,15 +45,15 @@ public:
 
     inline GraphType getGraphType() const { return this->_graph_type; }
 
-    template <typename T> uint8_t* draw(std::vector<T>& data, T min, T max);
+    template <typename T> uint8_t* draw(SampleSpan<T const> data, T min, T max);
 
-    template <typename T> uint8_t* draw(std::vector<T>& data, std::array<float,3> probe_direction);
+    template <typename T> uint8_t* draw(SampleSpan<T const> data, std::array<float,3> probe_direction);
 
 private:
-    template <typename T> void drawPlot(std::vector<T>& data, T min, T max);
-    template <typename T> void drawStar(std::vector<T>& data, T min, T max);
-    template <typename T> void drawLinear(std::vector<T>& data, T min, T max);
-    template <typename T> void drawRadarGlyph(std::vector<T>& data, std::array<float, 3> probe_direction);
+    template <typename T> void drawPlot(SampleSpan<T const> data, T min, T max);
+    template <typename T> void drawStar(SampleSpan<T const> data, T min, T max);
+    template <typename T> void drawLinear(SampleSpan<T const> data, T min, T max);
+    template <typename T> void drawRadarGlyph(SampleSpan<T const> data, std::array<float, 3> probe_direction);
 
     uint32_t _pixel_width = 0;
     uint32_t _pixel_height = 0;
@@ -65,7 +66,7 @@ private:
 };
 
 
-template <typename T> uint8_t* DrawTextureUtility::draw(std::vector<T>& data, T min, T max) {
+template <typename T> uint8_t* DrawTextureUtility::draw(SampleSpan<T const> data, T min, T max) {
     _img = BLImage(this->_pixel_width, this->_pixel_height, BL_FORMAT_PRGB32);
     _ctx = BLContext(_img);
 
@@ -100,7 +101,7 @@ template <typename T> uint8_t* DrawTextureUtility::draw(std::vector<T>& data, T
 }
 
 template <typename T>
-inline uint8_t* DrawTextureUtility::draw(std::vector<T>& data, std::array<float, 3> probe_direction) {
+inline uint8_t* DrawTextureUtility::draw(SampleSpan<T const> data, std::array<float, 3> probe_direction) {
 
     _img = BLImage(this->_pixel_width, this->_pixel_height, BL_FORMAT_PRGB32);
     _ctx = BLContext(_img);
@@ -132,7 +133,7 @@ inline uint8_t* DrawTextureUtility::draw(std::vector<T>& data, std::array<float,
     return NULL;
 }
 
-template <typename T> void DrawTextureUtility::drawPlot(std::vector<T>& data, T min, T max) {
+template <typename T> void DrawTextureUtility::drawPlot(SampleSpan<T const> data, T min, T max) {
 
     uint32_t width_halo = this->_pixel_width * 0.1f;
     uint32_t height_halo = this->_pixel_height * 0.1f;
@@ -171,7 +172,7 @@ template <typename T> void DrawTextureUtility::drawPlot(std::vector<T>& data, T
     _ctx.strokePath(path);
 }
 
-template <typename T> void DrawTextureUtility::drawStar(std::vector<T>& data, T min, T max) {
+template <typename T> void DrawTextureUtility::drawStar(SampleSpan<T const> data, T min, T max) {
 
     uint32_t width_halo = this->_pixel_width * 0.1f;
     uint32_t height_halo = this->_pixel_height * 0.1f;
@@ -253,7 +254,7 @@ template <typename T> void DrawTextureUtility::drawStar(std::vector<T>& data, T
 
 }
 
-template <typename T> void DrawTextureUtility::drawLinear(std::vector<T>& data, T min, T max) {
+template <typename T> void DrawTextureUtility::drawLinear(SampleSpan<T const> data, T min, T max) {
     
     uint32_t width_halo = this->_pixel_width * 0.2f;
     uint32_t height_halo = this->_pixel_height * 0.1f;
@@ -312,7 +313,7 @@ template <typename T> void DrawTextureUtility::drawLinear(std::vector<T>& data,
 }
 
 template <typename T>
-inline void DrawTextureUtility::drawRadarGlyph(std::vector<T>& data, std::array<float, 3> probe_direction) {
+inline void DrawTextureUtility::drawRadarGlyph(SampleSpan<T const> data, std::array<float, 3> probe_direction) {
 
     uint32_t width_halo = this->_pixel_width * 0.1f;
     uint32_t height_halo = this->_pixel_height * 0.1f;
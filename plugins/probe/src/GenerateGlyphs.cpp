@@ -4,7 +4,6 @@
  * Alle Rechte vorbehalten.
  */
 
-#include <variant>
 
 #include "GenerateGlyphs.h"
 #include "DrawTextureUtility.h"
@@ -38,20 +37,15 @@ GenerateGlyphs::GenerateGlyphs()
 GenerateGlyphs::~GenerateGlyphs() { this->Release(); }
 
 
-bool GenerateGlyphs::doScalarGlyphGeneration(FloatProbe& probe) {
+bool GenerateGlyphs::doScalarGlyphGeneration(FloatProbeView const& probe) {
 
-    // get probe
-    // auto probe = this->_probe_data->getProbe<FloatProbe>(i);
-    // read samples of probe
-    auto samples = probe.getSamplingResult();
-
-    if (samples->samples.empty()) {
+    if (probe.m_samples.empty()) {
         megamol::core::utility::log::Log::DefaultLog.WriteError("[GenerateGlyphs] Probes have not been sampled.");
         return false;
     }
 
     bool skip = false;
-    if (approxEq(samples->min_value, samples->max_value)) {
+    if (approxEq(probe.m_min_value, probe.m_max_value)) {
         // if ( i <= 0.5* this->_probe_data->getProbeCount()) {
         skip = true;
     }
@@ -153,21 +147,16 @@ bool GenerateGlyphs::doScalarGlyphGeneration(FloatProbe& probe) {
         _dtu.back().setResolution(300, 300);                 // should be changeable
         _dtu.back().setGraphType(DrawTextureUtility::GLYPH); // should be changeable
 
-        auto tex_ptr = _dtu.back().draw(samples->samples, samples->min_value, samples->max_value);
+        auto tex_ptr = _dtu.back().draw(probe.m_samples, probe.m_min_value, probe.m_max_value);
         this->_tex_data->addImage(mesh::ImageDataAccessCollection::RGBA8, _dtu.back().getPixelWidth(),
             _dtu.back().getPixelHeight(), tex_ptr, 4 * _dtu.back().getPixelWidth() * _dtu.back().getPixelHeight());
     }
     return true;
 }
 
-bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4Probe& probe) {
-
-    // get probe
-    // auto probe = this->_probe_data->getProbe<FloatProbe>(i);
-    // read samples of probe
-    auto samples = probe.getSamplingResult();
+bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4ProbeView const& probe) {
 
-    if (samples->samples.empty()) {
+    if (probe.m_samples.empty()) {
         megamol::core::utility::log::Log::DefaultLog.WriteError("[GenerateGlyphs] Probes have not been sampled.");
         return false;
     }
@@ -182,18 +171,18 @@ bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4Probe& probe) {
     ribbon_base[2] = probe.m_position[2] + probe.m_begin * probe.m_direction[2];
 
     std::array<float, 3> vertex1;
-    vertex1[0] = ribbon_base[0] + ribbon_width * samples->samples.front()[0];
-    vertex1[1] = ribbon_base[1] + ribbon_width * samples->samples.front()[1];
-    vertex1[2] = ribbon_base[2] + ribbon_width * samples->samples.front()[2];
+    vertex1[0] = ribbon_base[0] + ribbon_width * probe.m_samples.front()[0];
+    vertex1[1] = ribbon_base[1] + ribbon_width * probe.m_samples.front()[1];
+    vertex1[2] = ribbon_base[2] + ribbon_width * probe.m_samples.front()[2];
 
     std::array<float, 3> vertex2;
-    vertex2[0] = ribbon_base[0] - ribbon_width * samples->samples.front()[0];
-    vertex2[1] = ribbon_base[1] - ribbon_width * samples->samples.front()[1];
-    vertex2[2] = ribbon_base[2] - ribbon_width * samples->samples.front()[2];
+    vertex2[0] = ribbon_base[0] - ribbon_width * probe.m_samples.front()[0];
+    vertex2[1] = ribbon_base[1] - ribbon_width * probe.m_samples.front()[1];
+    vertex2[2] = ribbon_base[2] - ribbon_width * probe.m_samples.front()[2];
 
     // update ribbon base
     std::array<float, 3> sample_vector = {
-        samples->samples.front()[0], samples->samples.front()[1], samples->samples.front()[2]};
+        probe.m_samples.front()[0], probe.m_samples.front()[1], probe.m_samples.front()[2]};
 
     float sample_vector_length = std::sqrt(sample_vector[0] * sample_vector[0] + sample_vector[1] * sample_vector[1] +
                                      sample_vector[2] * sample_vector[2]);
@@ -225,9 +214,9 @@ bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4Probe& probe) {
     size_t base_vertex = _generated_mesh_vertices.size();
     size_t base_index = _generated_mesh_indices.size();
 
-    for (int i = 1; i < samples->samples.size(); ++i) {
+    for (int i = 1; i < probe.m_samples.size(); ++i) {
 
-        std::array<float, 3> sample_vector = {samples->samples[i][0], samples->samples[i][1], samples->samples[i][2]};
+        std::array<float, 3> sample_vector = {probe.m_samples[i][0], probe.m_samples[i][1], probe.m_samples[i][2]};
         float sample_vector_length = std::sqrt(
             sample_vector[0] * sample_vector[0] + 
             sample_vector[1] * sample_vector[1] +
@@ -287,7 +276,7 @@ bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4Probe& probe) {
     mesh::MeshDataAccessCollection::VertexAttribute pos_attrib;
     pos_attrib.data = reinterpret_cast<uint8_t*>(&this->_generated_mesh_vertices[base_vertex]);
     pos_attrib.stride = sizeof(std::array<float, 3>);
-    pos_attrib.byte_size = pos_attrib.stride * samples->samples.size();
+    pos_attrib.byte_size = pos_attrib.stride * probe.m_samples.size();
     pos_attrib.component_cnt = 3;
     pos_attrib.component_type = mesh::MeshDataAccessCollection::FLOAT;
     pos_attrib.offset = 0;
@@ -297,7 +286,7 @@ bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4Probe& probe) {
     mesh::MeshDataAccessCollection::VertexAttribute normal_attrib;
     normal_attrib.data = reinterpret_cast<uint8_t*>(&this->_generated_mesh_normals[base_vertex]);
     normal_attrib.stride = sizeof(std::array<float, 3>);
-    normal_attrib.byte_size = normal_attrib.stride * samples->samples.size();
+    normal_attrib.byte_size = normal_attrib.stride * probe.m_samples.size();
     normal_attrib.component_cnt = 3;
     normal_attrib.component_type = mesh::MeshDataAccessCollection::FLOAT;
     normal_attrib.offset = 0;
@@ -316,7 +305,7 @@ bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4Probe& probe) {
 
     mesh::MeshDataAccessCollection::IndexData index_data;
     index_data.data = reinterpret_cast<uint8_t*>(&this->_generated_mesh_indices[base_index]);
-    index_data.byte_size = sizeof(uint32_t) * 6 * samples->samples.size() -1;
+    index_data.byte_size = sizeof(uint32_t) * 6 * probe.m_samples.size() -1;
     index_data.type = mesh::MeshDataAccessCollection::UNSIGNED_INT;
 
     this->_mesh_data->addMesh(vertex_attributes, index_data);
@@ -324,14 +313,9 @@ bool GenerateGlyphs::doVectorRibbonGlyphGeneration(Vec4Probe& probe) {
     return false; 
 }
 
-bool GenerateGlyphs::doVectorRadarGlyphGeneration(Vec4Probe& probe) {
-
-    // get probe
-    // auto probe = this->_probe_data->getProbe<FloatProbe>(i);
-    // read samples of probe
-    auto samples = probe.getSamplingResult();
+bool GenerateGlyphs::doVectorRadarGlyphGeneration(Vec4ProbeView const& probe) {
 
-    if (samples->samples.empty()) {
+    if (probe.m_samples.empty()) {
         megamol::core::utility::log::Log::DefaultLog.WriteError("[GenerateGlyphs] Probes have not been sampled.");
         return false;
     }
@@ -434,7 +418,7 @@ bool GenerateGlyphs::doVectorRadarGlyphGeneration(Vec4Probe& probe) {
     _dtu.back().setResolution(400, 400);                 // should be changeable
     _dtu.back().setGraphType(DrawTextureUtility::RADARGLYPH); // should be changeable
 
-    auto tex_ptr = _dtu.back().draw(samples->samples, probe.m_direction);
+    auto tex_ptr = _dtu.back().draw(probe.m_samples, probe.m_direction);
     this->_tex_data->addImage(mesh::ImageDataAccessCollection::RGBA8, _dtu.back().getPixelWidth(),
         _dtu.back().getPixelHeight(), tex_ptr, 4 * _dtu.back().getPixelWidth() * _dtu.back().getPixelHeight());
 
@@ -486,22 +470,17 @@ bool GenerateGlyphs::getMesh(core::Call& call) {
         //#pragma omp parallel for
         for (int i = 0; i < this->_probe_data->getProbeCount(); i++) {
 
-            auto generic_probe = this->_probe_data->getGenericProbe(i);
-
-            auto visitor = [this](auto&& arg) {
-                using T = std::decay_t<decltype(arg)>;
-                if constexpr (std::is_same_v<T, FloatProbe>) {
-                    doScalarGlyphGeneration(arg);
-                } else if constexpr (std::is_same_v<T, IntProbe>) {
-                    // TODO
-                } else if constexpr (std::is_same_v<T, Vec4Probe>) {
-                    doVectorRadarGlyphGeneration(arg);
-                } else {
-                    // unknown probe type, throw error? do nothing?
-                }
-            };
-
-            std::visit(visitor, generic_probe);
+            switch (this->_probe_data->getProbeKind(i)) {
+            case ProbeKind::FLOAT:
+                doScalarGlyphGeneration(this->_probe_data->getFloatProbe(i));
+                break;
+            case ProbeKind::VEC4:
+                doVectorRadarGlyphGeneration(this->_probe_data->getVec4Probe(i));
+                break;
+            default:
+                // TODO integer probes, unsampled probes have nothing to draw
+                break;
+            }
         } // end for probe count
 
     }
@@ -570,25 +549,17 @@ bool GenerateGlyphs::getTexture(core::Call& call) {
         //#pragma omp parallel for
         for (int i = 0; i < this->_probe_data->getProbeCount(); i++) {
 
-            auto generic_probe = this->_probe_data->getGenericProbe(i);
-
-            auto visitor =
-                [this](auto&& arg) {
-                    using T = std::decay_t<decltype(arg)>;
-                if constexpr (std::is_same_v<T, FloatProbe>) {
-                    doScalarGlyphGeneration(arg);
-                }
-                else if constexpr (std::is_same_v<T, IntProbe>) {
-                    //TODO
-                }
-                else if constexpr (std::is_same_v<T, Vec4Probe>) {
-                    doVectorRadarGlyphGeneration(arg);
-                } else {
-                    // unknown probe type, throw error? do nothing?
-                }
-            };
-
-            std::visit(visitor, generic_probe);
+            switch (this->_probe_data->getProbeKind(i)) {
+            case ProbeKind::FLOAT:
+                doScalarGlyphGeneration(this->_probe_data->getFloatProbe(i));
+                break;
+            case ProbeKind::VEC4:
+                doVectorRadarGlyphGeneration(this->_probe_data->getVec4Probe(i));
+                break;
+            default:
+                // TODO integer probes, unsampled probes have nothing to draw
+                break;
+            }
 
         } // end for probe count
     }
@@ -63,11 +63,11 @@ private:
     bool getTexture(core::Call& call);
     bool getTextureMetaData(core::Call& call);
 
-    bool doScalarGlyphGeneration(FloatProbe& probe);
+    bool doScalarGlyphGeneration(FloatProbeView const& probe);
 
-    bool doVectorRibbonGlyphGeneration(Vec4Probe& probe);
+    bool doVectorRibbonGlyphGeneration(Vec4ProbeView const& probe);
  
-    bool doVectorRadarGlyphGeneration(Vec4Probe& probe);
+    bool doVectorRadarGlyphGeneration(Vec4ProbeView const& probe);
 
     uint32_t _version = 0;
 
@@ -40,16 +40,7 @@ megamol::probe::PlaceProbes::PlaceProbes()
 
     this->m_probes_per_unit_slot << new core::param::IntParam(1,0);
 
-    /* Feasibility test */
     m_probes = std::make_shared<ProbeCollection>();
-    m_probes->addProbe(FloatProbe());
-
-    auto retrieved_probe = m_probes->getProbe<FloatProbe>(0);
-
-    float data;
-    retrieved_probe.probe(&data);
-
-    auto result = retrieved_probe.getSamplingResult();
 }
 
 megamol::probe::PlaceProbes::~PlaceProbes() { this->Release(); }
@@ -254,6 +245,7 @@ void megamol::probe::PlaceProbes::vertexNormalSampling(
     auto normal_accessor = reinterpret_cast<float*>(normals.data);
     auto normal_step = normals.stride / sizeof(float);
 
+    this->m_probes->reserve(probe_count);
 //#pragma omp parallel for
     for (int i = 0; i < probe_count; i++) {
 
@@ -345,7 +337,8 @@ bool megamol::probe::PlaceProbes::placeByCenterline(uint32_t lei, std::vector<st
 
     auto vertex_step = 4;
     auto centerline_step = centerline.stride / sizeof(centerline.component_type);
-    
+
+    this->m_probes->reserve(probe_count);
     for (uint32_t i = 0; i < probe_count; i++) {
         BaseProbe probe;
 
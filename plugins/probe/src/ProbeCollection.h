@@ -9,91 +9,261 @@
 #ifndef PROBE_COLLECTION_H_INCLUDED
 #define PROBE_COLLECTION_H_INCLUDED
 
+#include <algorithm>
 #include <array>
+#include <cstdint>
 #include <string>
-#include <variant>
+#include <vector>
 
 namespace megamol {
 namespace probe {
 
+/** Type of the samples a probe holds */
+enum class ProbeKind : uint8_t { BASE, FLOAT, INT, VEC4 };
+
+/** Description of a probe, used to add probes to a collection */
 struct BaseProbe {
     /** time at which this probes samples the data */
-    size_t m_timestamp;
+    size_t m_timestamp = 0;
     /** semantic name of the values/field that this probe samples */
     std::string m_value_name;
     /** position of probe head on surface */
-    std::array<float, 3> m_position;
+    std::array<float, 3> m_position = {0.0f, 0.0f, 0.0f};
     /** probe insertion/sampling direction */
-    std::array<float, 3> m_direction;
+    std::array<float, 3> m_direction = {0.0f, 0.0f, 1.0f};
     /** "sample from" offset from position */
-    float m_begin;
+    float m_begin = 0.0f;
     /** "sample to" offset from position */
-    float m_end;
-    // std::vector<size_t>m_sample_idxs; ///< indices of samples relevant to this
-
-    // virtual void probe() = 0;
+    float m_end = 0.0f;
 };
 
-struct FloatProbe : public BaseProbe {
+/** Non-owning range of samples inside a ProbeCollection */
+template <typename T> class SampleSpan {
 public:
-    struct SamplingResult {
-        std::vector<float> samples;
-        float min_value;
-        float max_value;
-        float average_value;
-    };
+    SampleSpan() : m_data(nullptr), m_size(0) {}
+    SampleSpan(T* data, size_t size) : m_data(data), m_size(size) {}
 
-    FloatProbe() : m_result(std::make_shared<SamplingResult>()) {}
+    T* begin() const { return m_data; }
+    T* end() const { return m_data + m_size; }
+    T* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    T& operator[](size_t idx) const { return m_data[idx]; }
+    T& front() const { return m_data[0]; }
+    T& back() const { return m_data[m_size - 1]; }
 
-    template <typename DatafieldType> void probe(DatafieldType const& datafield) { /* ToDo*/ }
+private:
+    T* m_data;
+    size_t m_size;
+};
 
-    std::shared_ptr<SamplingResult> getSamplingResult() const { return m_result; }
+/** Geometry of a probe in a collection */
+struct ProbeView {
+    size_t m_timestamp;
+    std::array<float, 3> m_position;
+    std::array<float, 3> m_direction;
+    float m_begin;
+    float m_end;
+};
 
-private:
-    std::shared_ptr<SamplingResult> m_result;
+/** Probe with scalar samples. The samples stay valid until the collection is modified. */
+struct FloatProbeView : public ProbeView {
+    SampleSpan<float const> m_samples;
+    float m_min_value;
+    float m_max_value;
+    float m_average_value;
 };
 
-struct IntProbe : public BaseProbe {
-    void probe() { /*ToDo*/
-    }
+/** Probe with four component samples. The samples stay valid until the collection is modified. */
+struct Vec4ProbeView : public ProbeView {
+    SampleSpan<std::array<float, 4> const> m_samples;
 };
 
-struct Vec4Probe : public BaseProbe {
+
+/**
+ * Probes stored as structure of arrays. Every attribute is kept in its own array and the samples of all probes are
+ * stored in one contiguous array, indexed by a per probe offset, so there is no allocation per probe.
+ */
+class ProbeCollection {
 public:
-    struct SamplingResult {
-        std::vector<std::array<float,4>> samples;
-    };
+    ProbeCollection() = default;
+    ~ProbeCollection() = default;
 
-    Vec4Probe() : m_result(std::make_shared<SamplingResult>()) {}
+    void reserve(size_t cnt) {
+        m_kinds.reserve(cnt);
+        m_timestamps.reserve(cnt);
+        m_value_name_ids.reserve(cnt);
+        m_positions.reserve(cnt);
+        m_directions.reserve(cnt);
+        m_begins.reserve(cnt);
+        m_ends.reserve(cnt);
+        m_sample_offsets.reserve(cnt + 1);
+    }
 
-    template <typename DatafieldType> void probe(DatafieldType const& datafield) { /* ToDo*/ }
+    /** Appends a probe without samples */
+    void addProbe(BaseProbe const& probe, ProbeKind kind = ProbeKind::BASE) {
+        if (m_sample_offsets.empty()) m_sample_offsets.push_back(0);
 
-    std::shared_ptr<SamplingResult> getSamplingResult() const { return m_result; }
+        m_kinds.push_back(kind);
+        m_timestamps.push_back(probe.m_timestamp);
+        m_value_name_ids.push_back(valueNameId(probe.m_value_name));
+        m_positions.push_back(probe.m_position);
+        m_directions.push_back(probe.m_direction);
+        m_begins.push_back(probe.m_begin);
+        m_ends.push_back(probe.m_end);
+        m_sample_offsets.push_back(m_sample_offsets.back());
+        if (!m_min_values.empty()) {
+            m_min_values.push_back(0.0f);
+            m_max_values.push_back(0.0f);
+            m_average_values.push_back(0.0f);
+        }
+    }
 
-private:
-    std::shared_ptr<SamplingResult> m_result;
-};
+    uint32_t getProbeCount() const { return static_cast<uint32_t>(m_kinds.size()); }
 
-using GenericProbe = std::variant<FloatProbe, IntProbe, Vec4Probe, BaseProbe>;
+    ProbeKind getProbeKind(size_t idx) const { return m_kinds[idx]; }
 
+    std::string const& getValueName(size_t idx) const { return m_value_names[m_value_name_ids[idx]]; }
 
-class ProbeCollection {
-public:
-    ProbeCollection() = default;
-    ~ProbeCollection() = default;
+    std::vector<std::array<float, 3>> const& getPositions() const { return m_positions; }
+
+    std::vector<std::array<float, 3>> const& getDirections() const { return m_directions; }
+
+    std::vector<float> const& getBegins() const { return m_begins; }
+
+    std::vector<float> const& getEnds() const { return m_ends; }
+
+    ProbeView getProbe(size_t idx) const {
+        ProbeView view;
+        fillView(idx, view);
+        return view;
+    }
+
+    /** Answer a probe with all its attributes, copies the value name */
+    BaseProbe getBaseProbe(size_t idx) const {
+        BaseProbe probe;
+        probe.m_timestamp = m_timestamps[idx];
+        probe.m_value_name = getValueName(idx);
+        probe.m_position = m_positions[idx];
+        probe.m_direction = m_directions[idx];
+        probe.m_begin = m_begins[idx];
+        probe.m_end = m_ends[idx];
+        return probe;
+    }
+
+    /** Answer a probe of kind FLOAT, the samples are empty for other kinds */
+    FloatProbeView getFloatProbe(size_t idx) const {
+        FloatProbeView view;
+        fillView(idx, view);
+        bool const sampled = (m_kinds[idx] == ProbeKind::FLOAT) && !m_min_values.empty();
+        if (sampled) {
+            view.m_samples = SampleSpan<float const>(m_float_samples.data() + m_sample_offsets[idx], sampleCount(idx));
+        }
+        view.m_min_value = sampled ? m_min_values[idx] : 0.0f;
+        view.m_max_value = sampled ? m_max_values[idx] : 0.0f;
+        view.m_average_value = sampled ? m_average_values[idx] : 0.0f;
+        return view;
+    }
 
-    template <typename ProbeType> void addProbe(ProbeType const& probe) { m_probes.push_back(probe); }
+    /** Answer a probe of kind VEC4, the samples are empty for other kinds */
+    Vec4ProbeView getVec4Probe(size_t idx) const {
+        Vec4ProbeView view;
+        fillView(idx, view);
+        if (m_kinds[idx] == ProbeKind::VEC4 && !m_vec4_samples.empty()) {
+            view.m_samples =
+                SampleSpan<std::array<float, 4> const>(m_vec4_samples.data() + m_sample_offsets[idx], sampleCount(idx));
+        }
+        return view;
+    }
 
-    template <typename ProbeType> void setProbe(size_t idx, ProbeType const& probe) { m_probes[idx] = probe; }
+    /**
+     * Turns all probes except integer probes into probes of the given kind with cnt samples each and lays out their
+     * samples contiguously in probe order. Previous samples are discarded.
+     *
+     * @param kind ProbeKind::FLOAT or ProbeKind::VEC4.
+     * @param cnt  Number of samples per probe.
+     */
+    void allocateSamples(ProbeKind kind, uint32_t cnt) {
+        size_t total = 0;
+        m_sample_offsets.resize(m_kinds.size() + 1);
+        for (size_t i = 0; i < m_kinds.size(); ++i) {
+            m_sample_offsets[i] = total;
+            if (m_kinds[i] == ProbeKind::INT) continue;
+            m_kinds[i] = kind;
+            total += cnt;
+        }
+        m_sample_offsets[m_kinds.size()] = total;
 
-    template <typename ProbeType> ProbeType getProbe(size_t idx) const { return std::get<ProbeType>(m_probes[idx]); }
+        m_float_samples.clear();
+        m_vec4_samples.clear();
+        m_min_values.clear();
+        m_max_values.clear();
+        m_average_values.clear();
+        if (kind == ProbeKind::FLOAT) {
+            m_float_samples.resize(total, 0.0f);
+            m_min_values.resize(m_kinds.size(), 0.0f);
+            m_max_values.resize(m_kinds.size(), 0.0f);
+            m_average_values.resize(m_kinds.size(), 0.0f);
+        } else if (kind == ProbeKind::VEC4) {
+            m_vec4_samples.resize(total, {0.0f, 0.0f, 0.0f, 0.0f});
+        }
+    }
 
-    GenericProbe getGenericProbe(size_t idx) const { return m_probes[idx]; }
+    /** Writable samples of a FLOAT probe, different probes may be written concurrently */
+    SampleSpan<float> getFloatSamples(size_t idx) {
+        if (m_kinds[idx] != ProbeKind::FLOAT || m_float_samples.empty()) return SampleSpan<float>();
+        return SampleSpan<float>(m_float_samples.data() + m_sample_offsets[idx], sampleCount(idx));
+    }
 
-    uint32_t getProbeCount() const { return m_probes.size(); }
+    /** Writable samples of a VEC4 probe, different probes may be written concurrently */
+    SampleSpan<std::array<float, 4>> getVec4Samples(size_t idx) {
+        if (m_kinds[idx] != ProbeKind::VEC4 || m_vec4_samples.empty()) return SampleSpan<std::array<float, 4>>();
+        return SampleSpan<std::array<float, 4>>(m_vec4_samples.data() + m_sample_offsets[idx], sampleCount(idx));
+    }
+
+    void setFloatStatistics(size_t idx, float min_value, float max_value, float average_value) {
+        m_min_values[idx] = min_value;
+        m_max_values[idx] = max_value;
+        m_average_values[idx] = average_value;
+    }
 
 private:
-    std::vector<GenericProbe> m_probes;
+    size_t sampleCount(size_t idx) const { return m_sample_offsets[idx + 1] - m_sample_offsets[idx]; }
+
+    void fillView(size_t idx, ProbeView& view) const {
+        view.m_timestamp = m_timestamps[idx];
+        view.m_position = m_positions[idx];
+        view.m_direction = m_directions[idx];
+        view.m_begin = m_begins[idx];
+        view.m_end = m_ends[idx];
+    }
+
+    /** Few distinct names are shared by many probes, so they are stored once */
+    uint32_t valueNameId(std::string const& name) {
+        auto it = std::find(m_value_names.begin(), m_value_names.end(), name);
+        if (it != m_value_names.end()) return static_cast<uint32_t>(std::distance(m_value_names.begin(), it));
+        m_value_names.push_back(name);
+        return static_cast<uint32_t>(m_value_names.size() - 1);
+    }
+
+    std::vector<ProbeKind> m_kinds;
+    std::vector<size_t> m_timestamps;
+    std::vector<uint32_t> m_value_name_ids;
+    std::vector<std::string> m_value_names;
+    std::vector<std::array<float, 3>> m_positions;
+    std::vector<std::array<float, 3>> m_directions;
+    std::vector<float> m_begins;
+    std::vector<float> m_ends;
+
+    /** Samples of probe i are [m_sample_offsets[i], m_sample_offsets[i + 1]) in the array of its kind */
+    std::vector<size_t> m_sample_offsets;
+    std::vector<float> m_float_samples;
+    std::vector<std::array<float, 4>> m_vec4_samples;
+
+    /** Statistics of the FLOAT probes, empty if none have been sampled */
+    std::vector<float> m_min_values;
+    std::vector<float> m_max_values;
+    std::vector<float> m_average_values;
 };
 
 
@@ -11,6 +11,8 @@
 #include "mmcore/param/EnumParam.h"
 #include "mmcore/param/FlexEnumParam.h"
 #include "mmcore/param/FloatParam.h"
+#include "mmcore/misc/VolumetricDataCall.h"
+#include "mmcore/utility/log/Log.h"
 
 namespace megamol {
 namespace probe {
@@ -23,6 +25,8 @@ SampleAlongPobes::SampleAlongPobes()
     , _probe_rhs_slot("getProbe", "")
     , _adios_rhs_slot("getData", "")
     , _full_tree_rhs_slot("getTree", "")
+    , _volume_rhs_slot("getVolume", "Structured volume for trilinear sampling")
+    , _volume_cached_hash(0)
     , _parameter_to_sample_slot("ParameterToSample", "")
     , _num_samples_per_probe_slot("NumSamplesPerProbe", "Note: Tighter sample placement leads to reduced sampling radius.")
     , _sample_radius_factor_slot("SampleRadiusFactor", "Multiplier for base sampling distance.")
@@ -30,7 +34,10 @@ SampleAlongPobes::SampleAlongPobes()
     , _vec_param_to_samplex_x("ParameterToSampleX", "")
     , _vec_param_to_samplex_y("ParameterToSampleY", "")
     , _vec_param_to_samplex_z("ParameterToSampleZ", "")
-    , _vec_param_to_samplex_w("ParameterToSampleW", "") {
+    , _vec_param_to_samplex_w("ParameterToSampleW", "")
+    , _interpolation_slot("Interpolation",
+          "Average the neighbours in the kd-tree or interpolate trilinearly in the volume (first or first four "
+          "components)") {
 
     this->_probe_lhs_slot.SetCallback(CallProbes::ClassName(), CallProbes::FunctionName(0), &SampleAlongPobes::getData);
     this->_probe_lhs_slot.SetCallback(
@@ -46,6 +53,9 @@ SampleAlongPobes::SampleAlongPobes()
     this->_full_tree_rhs_slot.SetCompatibleCall<CallKDTreeDescription>();
     this->MakeSlotAvailable(&this->_full_tree_rhs_slot);
 
+    this->_volume_rhs_slot.SetCompatibleCall<core::misc::VolumetricDataCallDescription>();
+    this->MakeSlotAvailable(&this->_volume_rhs_slot);
+
     core::param::FlexEnumParam* paramEnum = new core::param::FlexEnumParam("undef");
     this->_parameter_to_sample_slot << paramEnum;
     this->_parameter_to_sample_slot.SetUpdateCallback(&SampleAlongPobes::paramChanged);
@@ -84,6 +94,12 @@ SampleAlongPobes::SampleAlongPobes()
     this->_vec_param_to_samplex_w << paramEnum_4;
     this->_vec_param_to_samplex_w.SetUpdateCallback(&SampleAlongPobes::paramChanged);
     this->MakeSlotAvailable(&this->_vec_param_to_samplex_w);
+
+    this->_interpolation_slot << new megamol::core::param::EnumParam(0);
+    this->_interpolation_slot.Param<megamol::core::param::EnumParam>()->SetTypePair(0, "Neighbours");
+    this->_interpolation_slot.Param<megamol::core::param::EnumParam>()->SetTypePair(1, "Trilinear");
+    this->_interpolation_slot.SetUpdateCallback(&SampleAlongPobes::paramChanged);
+    this->MakeSlotAvailable(&this->_interpolation_slot);
 }
 
 SampleAlongPobes::~SampleAlongPobes() { this->Release(); }
@@ -97,6 +113,10 @@ bool SampleAlongPobes::getData(core::Call& call) {
     auto cp = dynamic_cast<CallProbes*>(&call);
     if (cp == nullptr) return false;
 
+    if (this->_interpolation_slot.Param<core::param::EnumParam>()->Value() == 1) {
+        return this->getVolumeData(*cp);
+    }
+
     // query adios data
     auto cd = this->_adios_rhs_slot.CallAs<adios::CallADIOSData>();
     if (cd == nullptr) return false;
@@ -165,12 +185,16 @@ bool SampleAlongPobes::getData(core::Call& call) {
 			_probes = cprobes->getData();
 			auto tree = ct->getData();
 			if (cd->getData(var_str)->getType() == "double") {
-			    std::vector<double> data = cd->getData(var_str)->GetAsDouble();
-			    doSampling(tree, data);
+			    auto data = cd->getData(var_str)->GetView<double>();
+			    doSampling([&tree, &data](std::array<float, 3> const& pos, float radius) {
+			        return averageNeighbors(*tree, data, pos, radius);
+			    });
 
 			} else if (cd->getData(var_str)->getType() == "float") {
-			    std::vector<float> data = cd->getData(var_str)->GetAsFloat();
-			    doSampling(tree, data);
+			    auto data = cd->getData(var_str)->GetView<float>();
+			    doSampling([&tree, &data](std::array<float, 3> const& pos, float radius) {
+			        return averageNeighbors(*tree, data, pos, radius);
+			    });
 			}
 		}
 		else
@@ -182,20 +206,24 @@ bool SampleAlongPobes::getData(core::Call& call) {
 			if (cd->getData(x_var_str)->getType() == "double" && cd->getData(y_var_str)->getType() == "double" &&
                 cd->getData(z_var_str)->getType() == "double" && cd->getData(w_var_str)->getType() == "double")
 			{
-                std::vector<double> data_x = cd->getData(x_var_str)->GetAsDouble();
-                std::vector<double> data_y = cd->getData(y_var_str)->GetAsDouble();
-                std::vector<double> data_z = cd->getData(z_var_str)->GetAsDouble();
-                std::vector<double> data_w = cd->getData(w_var_str)->GetAsDouble();
-                doVectorSamling(tree, data_x, data_y, data_z, data_w);
+                auto data_x = cd->getData(x_var_str)->GetView<double>();
+                auto data_y = cd->getData(y_var_str)->GetView<double>();
+                auto data_z = cd->getData(z_var_str)->GetView<double>();
+                auto data_w = cd->getData(w_var_str)->GetView<double>();
+                doVectorSamling([&](std::array<float, 3> const& pos, float radius) {
+                    return averageNeighbors(*tree, data_x, data_y, data_z, data_w, pos, radius);
+                });
 			}
 			else if (cd->getData(x_var_str)->getType() == "float" && cd->getData(y_var_str)->getType() == "float" &&
                 cd->getData(z_var_str)->getType() == "float" && cd->getData(w_var_str)->getType() == "float"	)
 			{
-                std::vector<float> data_x = cd->getData(x_var_str)->GetAsFloat();
-                std::vector<float> data_y = cd->getData(y_var_str)->GetAsFloat();
-                std::vector<float> data_z = cd->getData(z_var_str)->GetAsFloat();
-                std::vector<float> data_w = cd->getData(w_var_str)->GetAsFloat();
-                doVectorSamling(tree, data_x, data_y, data_z, data_w);
+                auto data_x = cd->getData(x_var_str)->GetView<float>();
+                auto data_y = cd->getData(y_var_str)->GetView<float>();
+                auto data_z = cd->getData(z_var_str)->GetView<float>();
+                auto data_w = cd->getData(w_var_str)->GetView<float>();
+                doVectorSamling([&](std::array<float, 3> const& pos, float radius) {
+                    return averageNeighbors(*tree, data_x, data_y, data_z, data_w, pos, radius);
+                });
 			}
 		}
     }
@@ -220,6 +248,22 @@ bool SampleAlongPobes::getMetaData(core::Call& call) {
     auto cp = dynamic_cast<CallProbes*>(&call);
     if (cp == nullptr) return false;
 
+    if (this->_interpolation_slot.Param<core::param::EnumParam>()->Value() == 1) {
+        auto cv = this->_volume_rhs_slot.CallAs<core::misc::VolumetricDataCall>();
+        if (cv == nullptr) return false;
+        auto cplaceprobes = this->_probe_rhs_slot.CallAs<CallProbes>();
+        if (cplaceprobes == nullptr) return false;
+
+        auto meta_data = cp->getMetaData();
+        cv->SetFrameID(meta_data.m_frame_ID);
+        if (!(*cv)(core::misc::VolumetricDataCall::IDX_GET_EXTENTS)) return false;
+        if (!(*cplaceprobes)(1)) return false;
+
+        meta_data.m_frame_cnt = cv->FrameCount();
+        cp->setMetaData(meta_data);
+        return true;
+    }
+
     auto cd = this->_adios_rhs_slot.CallAs<adios::CallADIOSData>();
     if (cd == nullptr) return false;
 
@@ -255,6 +299,64 @@ bool SampleAlongPobes::getMetaData(core::Call& call) {
     return true;
 }
 
+bool SampleAlongPobes::getVolumeData(CallProbes& cp) {
+
+    auto cv = this->_volume_rhs_slot.CallAs<core::misc::VolumetricDataCall>();
+    if (cv == nullptr) return false;
+
+    auto cprobes = this->_probe_rhs_slot.CallAs<CallProbes>();
+    if (cprobes == nullptr) return false;
+    if (!(*cprobes)(0)) return false;
+
+    auto meta_data = cp.getMetaData();
+    cv->SetFrameID(meta_data.m_frame_ID);
+    if (!(*cv)(core::misc::VolumetricDataCall::IDX_GET_EXTENTS)) return false;
+    if (!(*cv)(core::misc::VolumetricDataCall::IDX_GET_METADATA)) return false;
+    if (!(*cv)(core::misc::VolumetricDataCall::IDX_GET_DATA)) return false;
+
+    bool something_has_changed = (cv->DataHash() != _volume_cached_hash) || cprobes->hasUpdate() || _trigger_recalc;
+
+    if (something_has_changed) {
+        ++_version;
+
+        TrilinearSampler sampler(*cv);
+        if (!sampler.IsValid()) {
+            megamol::core::utility::log::Log::DefaultLog.WriteError(
+                "[SampleAlongProbes] Trilinear sampling needs a cartesian or rectilinear floating point volume.");
+            return false;
+        }
+
+        _probes = cprobes->getData();
+        if (_sampling_mode.Param<core::param::EnumParam>()->Value() == 0) {
+            doSampling([&sampler](std::array<float, 3> const& pos, float) {
+                float value;
+                sampler.Sample(pos, &value, 1);
+                return value;
+            });
+        } else {
+            doVectorSamling([&sampler](std::array<float, 3> const& pos, float) {
+                std::array<float, 4> value = {0, 0, 0, 0};
+                sampler.Sample(pos, value.data(), std::min<size_t>(4, sampler.Components()));
+                return value;
+            });
+        }
+    }
+
+    auto probes_meta_data = cprobes->getMetaData();
+    if (probes_meta_data.m_bboxs.IsBoundingBoxValid()) {
+        meta_data.m_bboxs = probes_meta_data.m_bboxs;
+    } else {
+        meta_data.m_bboxs = cv->AccessBoundingBoxes();
+    }
+    cp.setMetaData(meta_data);
+
+    cp.setData(_probes, _version);
+    _volume_cached_hash = cv->DataHash();
+    _trigger_recalc = false;
+
+    return true;
+}
+
 bool SampleAlongPobes::paramChanged(core::param::ParamSlot& p) {
 
     _trigger_recalc = true;
@@ -17,6 +17,16 @@
 #include "kdtree.h"
 #include "mmcore/param/IntParam.h"
 #include "adios_plugin/CallADIOSData.h"
+#include "mmcore/param/FloatParam.h"
+#include "ProbeCalls.h"
+#include "TrilinearSampler.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace megamol {
 namespace probe {
@@ -64,6 +74,9 @@ protected:
     core::CallerSlot _full_tree_rhs_slot;
     size_t _full_tree_cached_hash;
 
+    core::CallerSlot _volume_rhs_slot;
+    size_t _volume_cached_hash;
+
     core::param::ParamSlot _parameter_to_sample_slot;
     core::param::ParamSlot _num_samples_per_probe_slot;
     core::param::ParamSlot _sample_radius_factor_slot;
@@ -74,14 +87,28 @@ protected:
     core::param::ParamSlot _vec_param_to_samplex_z;
     core::param::ParamSlot _vec_param_to_samplex_w;
 
+    core::param::ParamSlot _interpolation_slot;
+
 private:
+    /**
+     * Converts all probes to Kind and fills their samples with sample(position, radius).
+     *
+     * The sample positions of all probes are batched and sorted along a Z-order curve, so the queries of a thread
+     * touch neighbouring parts of the tree or volume. The queries themselves run in parallel, so sample has to be
+     * thread-safe. Integer probes are left unsampled.
+     */
+    template <ProbeKind Kind, typename Sampler>
+    void sampleProbes(Sampler const& sample);
+
 	//TODO rename to "doScalarSampling" ?
-    template <typename T>
-    void doSampling(const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, std::vector<T>& data);
+    template <typename Sampler>
+    void doSampling(Sampler const& sample);
 
-	template <typename T>
-    void doVectorSamling(const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, const std::vector<T>& data_x,
-        const std::vector<T>& data_y, const std::vector<T>& data_z, const std::vector<T>& data_w);
+	template <typename Sampler>
+    void doVectorSamling(Sampler const& sample);
+
+    /** Samples the probes by trilinear interpolation in the volume instead of the neighbours in the tree */
+    bool getVolumeData(CallProbes& cp);
 
     bool getData(core::Call& call);
 
@@ -95,173 +122,170 @@ private:
 };
 
 
-template <typename T>
-void SampleAlongPobes::doSampling(const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree, std::vector<T>& data) {
-
-    const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
-    const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
+/** Interleaves the lower 10 bits of x, y and z into a Z-order curve index */
+inline uint32_t mortonCode(uint32_t x, uint32_t y, uint32_t z) {
+    auto spread = [](uint32_t v) {
+        v &= 0x3ff;
+        v = (v | (v << 16)) & 0x030000ff;
+        v = (v | (v << 8)) & 0x0300f00f;
+        v = (v | (v << 4)) & 0x030c30c3;
+        v = (v | (v << 2)) & 0x09249249;
+        return v;
+    };
+    return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+}
 
-//#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
 
-        FloatProbe probe;
+/** Average of the data at the points within radius around pos, or at the nearest point if there is none */
+template <typename T>
+float averageNeighbors(pcl::KdTreeFLANN<pcl::PointXYZ> const& tree, const adios::containerView<T>& data,
+    std::array<float, 3> const& pos, float radius) {
+    pcl::PointXYZ sample_point(pos[0], pos[1], pos[2]);
+    std::vector<uint32_t> k_indices;
+    std::vector<float> k_distances;
+
+    auto num_neighbors = tree.radiusSearch(sample_point, radius, k_indices, k_distances);
+    if (num_neighbors == 0) {
+        num_neighbors = tree.nearestKSearch(sample_point, 1, k_indices, k_distances);
+    }
+
+    float value = 0;
+    for (int n = 0; n < num_neighbors; n++) {
+        value += data[k_indices[n]];
+    }
+    return value / num_neighbors;
+}
 
-        auto visitor = [&probe, i, this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::Vec4Probe>) {
 
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
+/** Component-wise average of four data fields, see averageNeighbors */
+template <typename T>
+std::array<float, 4> averageNeighbors(pcl::KdTreeFLANN<pcl::PointXYZ> const& tree,
+    const adios::containerView<T>& data_x, const adios::containerView<T>& data_y,
+    const adios::containerView<T>& data_z, const adios::containerView<T>& data_w, std::array<float, 3> const& pos,
+    float radius) {
+    pcl::PointXYZ sample_point(pos[0], pos[1], pos[2]);
+    std::vector<uint32_t> k_indices;
+    std::vector<float> k_distances;
+
+    auto num_neighbors = tree.radiusSearch(sample_point, radius, k_indices, k_distances);
+    if (num_neighbors == 0) {
+        num_neighbors = tree.nearestKSearch(sample_point, 1, k_indices, k_distances);
+    }
+
+    std::array<float, 4> value = {0, 0, 0, 0};
+    for (int n = 0; n < num_neighbors; n++) {
+        value[0] += data_x[k_indices[n]];
+        value[1] += data_y[k_indices[n]];
+        value[2] += data_z[k_indices[n]];
+        value[3] += data_w[k_indices[n]];
+    }
+    for (auto& v : value) v /= num_neighbors;
+    return value;
+}
 
-                _probes->setProbe(i, probe);
 
-            } else if constexpr (std::is_same_v<T, probe::FloatProbe>) {
-                probe = arg;
+template <ProbeKind Kind, typename Sampler>
+void SampleAlongPobes::sampleProbes(Sampler const& sample) {
 
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
+    const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
+    const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
+    const auto probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
+
+    _probes->allocateSamples(Kind, static_cast<uint32_t>(std::max(samples_per_probe, 0)));
+    if (samples_per_probe <= 0) return;
+
+    auto const& positions = _probes->getPositions();
+    auto const& directions = _probes->getDirections();
+    auto const& ends = _probes->getEnds();
+    auto is_sampled = [this](int64_t i) { return _probes->getProbeKind(i) == Kind; };
+    auto sample_step = [&ends, samples_per_probe](int64_t i) {
+        return ends[i] / static_cast<float>(samples_per_probe);
+    };
+    auto sample_position = [&positions, &directions, &sample_step](int64_t i, int j) {
+        auto const offset = j * sample_step(i);
+        return std::array<float, 3>{positions[i][0] + offset * directions[i][0],
+            positions[i][1] + offset * directions[i][1], positions[i][2] + offset * directions[i][2]};
+    };
+
+    // the samples lie on line segments, so the end points bound them
+    std::array<float, 3> lo, hi;
+    lo.fill(std::numeric_limits<float>::max());
+    hi.fill(std::numeric_limits<float>::lowest());
+    for (int64_t i = 0; i < probe_cnt; i++) {
+        if (!is_sampled(i)) continue;
+        for (auto const& p : {sample_position(i, 0), sample_position(i, samples_per_probe - 1)}) {
+            for (int a = 0; a < 3; ++a) {
+                lo[a] = std::min(lo[a], p[a]);
+                hi[a] = std::max(hi[a], p[a]);
+            }
+        }
+    }
+    std::array<float, 3> scale;
+    for (int a = 0; a < 3; ++a) {
+        scale[a] = (hi[a] > lo[a]) ? 1023.0f / (hi[a] - lo[a]) : 0.0f;
+    }
+
+    // batch of all samples along the Z-order curve
+    std::vector<std::pair<uint32_t, int64_t>> order(probe_cnt * samples_per_probe);
+#pragma omp parallel for
+    for (int64_t s = 0; s < static_cast<int64_t>(order.size()); ++s) {
+        auto const i = s / samples_per_probe;
+        uint32_t code = 0;
+        if (is_sampled(i)) {
+            auto const p = sample_position(i, static_cast<int>(s % samples_per_probe));
+            uint32_t cell[3];
+            for (int a = 0; a < 3; ++a) {
+                cell[a] = static_cast<uint32_t>(std::clamp((p[a] - lo[a]) * scale[a], 0.0f, 1023.0f));
             }
-        };
+            code = mortonCode(cell[0], cell[1], cell[2]);
+        }
+        order[s] = std::make_pair(code, s);
+    }
+    std::sort(order.begin(), order.end());
+
+    // each sample has its own slot in the contiguous sample storage, so the writes do not conflict
+#pragma omp parallel for schedule(dynamic, 256)
+    for (int64_t s = 0; s < static_cast<int64_t>(order.size()); ++s) {
+        auto const i = order[s].second / samples_per_probe;
+        auto const j = static_cast<int>(order[s].second % samples_per_probe);
+        if (!is_sampled(i)) continue;
+        auto const value = sample(sample_position(i, j), sample_step(i) * sample_radius_factor);
+        if constexpr (Kind == ProbeKind::FLOAT) {
+            _probes->getFloatSamples(i)[j] = value;
+        } else {
+            _probes->getVec4Samples(i)[j] = value;
+        }
+    }
+}
 
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
 
-        std::shared_ptr<FloatProbe::SamplingResult> samples = probe.getSamplingResult();
+template <typename Sampler>
+void SampleAlongPobes::doSampling(Sampler const& sample) {
 
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = sample_step * sample_radius_factor;
+    this->sampleProbes<ProbeKind::FLOAT>(sample);
+
+    const auto probe_cnt = static_cast<int64_t>(_probes->getProbeCount());
+#pragma omp parallel for
+    for (int64_t i = 0; i < probe_cnt; i++) {
+        auto const samples = _probes->getFloatSamples(i);
+        if (samples.empty()) continue;
 
         float min_value = std::numeric_limits<float>::max();
         float max_value = -std::numeric_limits<float>::max();
         float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
-
-        for (int j = 0; j < samples_per_probe; j++) {
-
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
-
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
-
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
-            }
-
-
-            // accumulate values
-            float value = 0;
-            for (int n = 0; n < num_neighbors; n++) {
-                value += data[k_indices[n]];
-            } // end num_neighbors
-            value /= num_neighbors;
-            samples->samples[j] = value;
+        for (auto const value : samples) {
             min_value = std::min(min_value, value);
             max_value = std::max(max_value, value);
             avg_value += value;
-        } // end num samples per probe
-        avg_value /= samples_per_probe;
-        samples->average_value = avg_value;
-        samples->max_value = max_value;
-        samples->min_value = min_value;
+        }
+        avg_value /= samples.size();
+        _probes->setFloatStatistics(i, min_value, max_value, avg_value);
     } // end for probes
 }
 
-template <typename T>
-inline void SampleAlongPobes::doVectorSamling(
-	const std::shared_ptr<pcl::KdTreeFLANN<pcl::PointXYZ>>& tree,
-    const std::vector<T>& data_x,
-	const std::vector<T>& data_y,
-	const std::vector<T>& data_z,
-    const std::vector<T>& data_w) {
-	
-    const int samples_per_probe = this->_num_samples_per_probe_slot.Param<core::param::IntParam>()->Value();
-    const float sample_radius_factor = this->_sample_radius_factor_slot.Param<core::param::FloatParam>()->Value();
-
-    //#pragma omp parallel for
-    for (int32_t i = 0; i < static_cast<int32_t>(_probes->getProbeCount()); i++) {
-
-        Vec4Probe probe;
-
-        auto visitor = [&probe,i,this](auto&& arg) {
-            using T = std::decay_t<decltype(arg)>;
-            if constexpr (std::is_same_v<T, probe::BaseProbe> || std::is_same_v<T, probe::FloatProbe>) {
-
-                probe.m_timestamp = arg.m_timestamp;
-                probe.m_value_name = arg.m_value_name;
-                probe.m_position = arg.m_position;
-                probe.m_direction = arg.m_direction;
-                probe.m_begin = arg.m_begin;
-                probe.m_end = arg.m_end;
-
-                _probes->setProbe(i, probe);
-
-            } else if constexpr (std::is_same_v<T, probe::Vec4Probe>) {
-                probe = arg;
-
-            } else {
-                // unknown/incompatible probe type, throw error? do nothing?
-            }
-        };
-
-        auto generic_probe = _probes->getGenericProbe(i);
-        std::visit(visitor, generic_probe);
-
-        std::shared_ptr<Vec4Probe::SamplingResult> samples = probe.getSamplingResult();
-
-        auto sample_step = probe.m_end / static_cast<float>(samples_per_probe);
-        auto radius = sample_step * sample_radius_factor;
-
-        float min_value = std::numeric_limits<float>::max();
-        float max_value = -std::numeric_limits<float>::max();
-        float avg_value = 0.0f;
-        samples->samples.resize(samples_per_probe);
-
-        for (int j = 0; j < samples_per_probe; j++) {
-
-            pcl::PointXYZ sample_point;
-            sample_point.x = probe.m_position[0] + j * sample_step * probe.m_direction[0];
-            sample_point.y = probe.m_position[1] + j * sample_step * probe.m_direction[1];
-            sample_point.z = probe.m_position[2] + j * sample_step * probe.m_direction[2];
-
-            std::vector<uint32_t> k_indices;
-            std::vector<float> k_distances;
-
-            auto num_neighbors = tree->radiusSearch(sample_point, radius, k_indices, k_distances);
-            if (num_neighbors == 0) {
-                num_neighbors = tree->nearestKSearch(sample_point, 1, k_indices, k_distances);
-            }
-
-
-            // accumulate values
-            float value_x = 0, value_y = 0, value_z = 0, value_w = 0;
-            for (int n = 0; n < num_neighbors; n++) {
-                value_x += data_x[k_indices[n]];
-                value_y += data_y[k_indices[n]];
-                value_z += data_z[k_indices[n]];
-                value_w += data_w[k_indices[n]];
-            } // end num_neighbors
-            samples->samples[j][0] = value_x / num_neighbors;;
-            samples->samples[j][1] = value_y / num_neighbors;;
-            samples->samples[j][2] = value_z / num_neighbors;;
-            samples->samples[j][3] = value_w / num_neighbors;;
-            //min_value = std::min(min_value, value);
-            //max_value = std::max(max_value, value);
-            //avg_value += value;
-        } // end num samples per probe
-        //avg_value /= samples_per_probe;
-        //samples->average_value = avg_value;
-        //samples->max_value = max_value;
-        //samples->min_value = min_value;
-    } // end for probes
-
+template <typename Sampler>
+inline void SampleAlongPobes::doVectorSamling(Sampler const& sample) {
+    this->sampleProbes<ProbeKind::VEC4>(sample);
 }
 
 
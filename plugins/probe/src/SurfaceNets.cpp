@@ -10,6 +10,10 @@
 #include "mmcore/misc/VolumetricDataCall.h"
 #include "mmcore/moldyn/MultiParticleDataCall.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
 namespace megamol {
 namespace probe {
 
@@ -57,218 +61,51 @@ void SurfaceNets::release() {}
 
 bool SurfaceNets::InterfaceIsDirty() { return this->_isoSlot.IsDirty(); }
 
-void SurfaceNets::calculateSurfaceNets() {
-
-    // The MIT License (MIT)
-    //
-    // Copyright (c) 2012-2013 Mikola Lysenko
-    //
-    // Permission is hereby granted, free of charge, to any person obtaining a copy
-    // of this software and associated documentation files (the "Software"), to deal
-    // in the Software without restriction, including without limitation the rights
-    // to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
-    // copies of the Software, and to permit persons to whom the Software is
-    // furnished to do so, subject to the following conditions:
-    //
-    // The above copyright notice and this permission notice shall be included in
-    // all copies or substantial portions of the Software.
-    //
-    // THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
-    // IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
-    // FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
-    // AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
-    // LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
-    // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
-    // THE SOFTWARE.
-
-    /**
-     * SurfaceNets in JavaScript
-     *
-     * Written by Mikola Lysenko (C) 2012
-     *
-     * MIT License
-     *
-     * Based on: S.F. Gibson, "Constrained Elastic Surface Nets". (1998) MERL Tech Report.
-     */
-
-    //var SurfaceNets = (function() {
-    //    "use strict";
-
-    float const iso_value = this->_isoSlot.Param<core::param::FloatParam>()->Value();
+void SurfaceNets::updateBrickRanges() {
 
-    // Precompute edge table, like Paul Bourke does.
-    // This saves a bit of time when computing the centroid of each boundary cell
-    std::array<uint32_t, 24> cube_edges;
-    std::array<uint32_t, 256> edge_table;
-
-    //(function() {
-    // Initialize the cube_edges table
-    // This is just the vertex number of each cube
-    uint32_t k = 0;
-    for (int32_t i = 0; i < 8; ++i) {
-        for (int32_t j = 1; j <= 4; j <<= 1) {
-            int32_t p = i ^ j;
-            if (i <= p) {
-                cube_edges[k++] = i;
-                cube_edges[k++] = p;
-            }
-        }
+    for (int a = 0; a < 3; ++a) {
+        _brick_cnt[a] = (_dims[a] - 2) / _brick_edge + 1;
     }
-
-    //  Initialize the intersection table.
-    //  This is a 2^(cube configuration) ->  2^(edge configuration) map
-    //  There is one entry for each possible cube configuration, and the output is a 12-bit vector enumerating
-    //  all edges crossing the 0-level.
-    for (int32_t i = 0; i < 256; ++i) {
-        int32_t em = 0;
-        for (int32_t j = 0; j < 24; j += 2) {
-            bool a = !(i & (1 << cube_edges[j]));
-            bool b = !(i & (1 << cube_edges[j + 1]));
-            em |= a != b ? (1 << (j >> 1)) : 0;
+    auto const brick_total = static_cast<int64_t>(_brick_cnt[0]) * _brick_cnt[1] * _brick_cnt[2];
+    _brick_min.resize(brick_total);
+    _brick_max.resize(brick_total);
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t b = 0; b < brick_total; ++b) {
+        std::array<size_t, 3> const brick = {b % _brick_cnt[0], (b / _brick_cnt[0]) % _brick_cnt[1],
+            b / (static_cast<int64_t>(_brick_cnt[0]) * _brick_cnt[1])};
+        // the cells of a brick touch the voxels up to one behind their own index
+        std::array<size_t, 3> lo, hi;
+        for (int a = 0; a < 3; ++a) {
+            lo[a] = brick[a] * _brick_edge;
+            hi[a] = std::min<size_t>(lo[a] + _brick_edge, _dims[a] - 1);
         }
-        edge_table[i] = em;
-    }
-    // })();
-
-    // Internal buffer, this may get resized at run time
-    std::vector<uint32_t> buffer(4096);
-
-    // return function(data, _dims) {
-    _vertices.clear();
-    _faces.clear();
-    int32_t n = 0;
-    std::array<uint32_t, 3> x = {0,0,0};
-    std::array<uint32_t, 3> R = {1, (_dims[0] + 1), (_dims[0] + 1) * (_dims[1] + 1)};
-    std::array<float, 8> grid;
-    int32_t buf_no = 1;
-
-    // Resize buffer if necessary
-    if (R[2] * 2 > buffer.size()) {
-        buffer.resize(R[2] * 2);
-    }
-
-    // March over the voxel grid
-    for (x[2] = 0; x[2] < _dims[2] - 1; ++x[2], n += _dims[0], buf_no ^= 1, R[2] = -R[2]) {
-
-        // m is the pointer into the buffer we are going to use.
-        // This is slightly obtuse because javascript does not have good support for packed data structures, so
-        // we must use typed arrays :( The contents of the buffer will be the indices of the vertices on the
-        // previous x/y slice of the volume
-        int32_t m = 1 + (_dims[0] + 1) * (1 + buf_no * (_dims[1] + 1));
-
-        for (x[1] = 0; x[1] < _dims[1] - 1; ++x[1], ++n, m += 2) {
-        
-            for (x[0] = 0; x[0] < _dims[0] - 1; ++x[0], ++n, ++m) {
-
-                // Read in 8 field values around this vertex and store them in an array
-                // Also calculate 8-bit mask, like in marching cubes, so we can speed up sign checks later
-                unsigned char mask = 0;
-                int32_t g = 0;
-                int32_t idx = n;
-                for (int32_t l = 0; l < 2; ++l, idx += _dims[0] * (_dims[1] - 2)) {
-                    for (int32_t j = 0; j < 2; ++j, idx += _dims[0] - 2) {
-                        for (int32_t i = 0; i < 2; ++i, ++g, ++idx) {
-                            float p = _data[idx];
-                            grid[g] = p;
-                            mask |= (p <= iso_value) ? (1 << g) : 0;
-                        }
-                    }
-                }
-
-                // Check for early termination if cell does not intersect boundary
-                if (mask == 0 || mask == 0xff) {
-                    continue;
-                }
 
-                // Sum up edge intersections
-                auto const edge_mask = edge_table[mask];
-                std::array<float, 3> v = {0.0, 0.0, 0.0};
-                int32_t e_count = 0;
-                // For every edge of the cube...
-                for (int32_t i = 0; i < 12; ++i) {
-
-                    // Use edge mask to check if it is crossed
-                    if (!(edge_mask & (1 << i))) {
-                        continue;
-                    }
-
-                    // If it did, increment number of edge crossings
-                    ++e_count;
-
-                    // Now find the point of intersection
-                    auto e0 = cube_edges[i << 1]; // Unpack vertices
-                    auto e1 = cube_edges[(i << 1) + 1];
-                    auto g0 = grid[e0]; // Unpack grid values
-                    auto g1 = grid[e1];
-                    auto t = g0 - g1; // Compute point of intersection
-                    //if (std::abs(t) > 1e-6) {
-                    //if (std::abs(t) >= iso_value) {
-                        //t = g0 / t;
-                        t = (iso_value - g1) / t;
-                    //} else {
-                    //    continue;
-                    //    //t = (iso_value - g1) / std::abs(t);
-                    //}
-
-                    // Interpolate vertices and add up intersections (this can be done without multiplying)
-                    for (uint32_t j = 0, l = 1; j < 3; ++j, l <<= 1) {
-                        auto a = e0 & l;
-                        auto b = e1 & l;
-                        if (a != b) {
-                            v[j] += a ? 1.0 - t : t;
-                        } else {
-                            v[j] += a ? 1.0 : 0;
-                        }
-                    }
-                }
-
-                // Now we just average the edge intersections and add them to coordinate
-                float s = 1.0 / e_count;
-                for (int32_t i = 0; i < 3; ++i) {
-                    v[i] = (x[i] + s * v[i]) * _spacing[i] + _volume_origin[i];
-                }
-
-                // Add vertex to buffer, store pointer to vertex index in buffer
-                buffer[m] = _vertices.size();
-                _vertices.push_back(v);
-
-                // Now we need to add faces together, to do this we just loop over 3 basis components
-                for (int32_t i = 0; i < 3; ++i) {
-                    // The first three entries of the edge_mask count the crossings along the edge
-                    if (!(edge_mask & (1 << i))) {
-                        continue;
-                    }
-
-                    // i = axes we are point along.  iu, iv = orthogonal axes
-                    auto iu = (i + 1) % 3;
-                    auto iv = (i + 2) % 3;
-
-                    // If we are on a boundary, skip it
-                    if (x[iu] == 0 || x[iv] == 0) {
-                        continue;
-                    }
-
-                    // Otherwise, look up adjacent edges in buffer
-                    auto du = R[iu];
-                    auto dv = R[iv];
-
-                    // Remember to flip orientation depending on the sign of the corner.
-                    if (mask & 1) {
-                        _faces.push_back({buffer[m], buffer[m - du], buffer[m - du - dv], buffer[m - dv]});
-                    } else {
-                        _faces.push_back({buffer[m], buffer[m - dv], buffer[m - du - dv], buffer[m - du]});
-                    }
+        float min_value = std::numeric_limits<float>::max();
+        float max_value = std::numeric_limits<float>::lowest();
+        for (size_t z = lo[2]; z <= hi[2]; ++z) {
+            for (size_t y = lo[1]; y <= hi[1]; ++y) {
+                auto const* row = _data + (z * _dims[1] + y) * _dims[0];
+                for (size_t x = lo[0]; x <= hi[0]; ++x) {
+                    min_value = std::min(min_value, row[x]);
+                    max_value = std::max(max_value, row[x]);
                 }
             }
         }
+        _brick_min[b] = min_value;
+        _brick_max[b] = max_value;
     }
-    //})();
 }
 
-void SurfaceNets::calculateSurfaceNets2() {
+void SurfaceNets::calculateSurfaceNets() {
 
     _vertices.clear();
+    _normals.clear();
     _faces.clear();
+    _triangles.clear();
+
+    if (_dims[0] < 2 || _dims[1] < 2 || _dims[2] < 2) return;
+    if (_brick_min.empty()) this->updateBrickRanges();
 
     std::array<std::array<uint32_t, 3>, 8> cube_offsets;
     cube_offsets[0] = {0, 0, 0};
@@ -307,169 +144,181 @@ void SurfaceNets::calculateSurfaceNets2() {
 
     float const iso_value = this->_isoSlot.Param<core::param::FloatParam>()->Value();
 
-    std::vector<uint32_t> voxel_lookup(_dims[0]*_dims[1]*_dims[2]);
-    std::vector<uint32_t> voxel_filled;
-    voxel_filled.reserve(voxel_lookup.size());
-
-    std::vector<uint32_t> voxel_edge_crossings(_dims[0] * _dims[1] * _dims[2]);
-
-    auto dims = _dims;
-
-    auto const offset_now = [dims](uint32_t x, uint32_t y, uint32_t z) { return dims[0] * dims[1] * z + dims[0] * y + x; };
-
-    for (uint32_t z = 0; z < _dims[2] - 1; z++) {
-        for (uint32_t y = 0; y < _dims[1] - 1; y++) {
-            for (uint32_t x = 0; x < _dims[0] - 1; x++) {
-
-                std::array<float, 8> sample_value;
-                sample_value[0] =
-                    _data[offset_now(x + cube_offsets[0][0], y + cube_offsets[0][1], z + cube_offsets[0][2])];
-                sample_value[1] =
-                    _data[offset_now(x + cube_offsets[1][0], y + cube_offsets[1][1], z + cube_offsets[1][2])];
-                sample_value[2] =
-                    _data[offset_now(x + cube_offsets[2][0], y + cube_offsets[2][1], z + cube_offsets[2][2])];
-                sample_value[3] =
-                    _data[offset_now(x + cube_offsets[3][0], y + cube_offsets[3][1], z + cube_offsets[3][2])];
-                sample_value[4] =
-                    _data[offset_now(x + cube_offsets[4][0], y + cube_offsets[4][1], z + cube_offsets[4][2])];
-                sample_value[5] =
-                    _data[offset_now(x + cube_offsets[5][0], y + cube_offsets[5][1], z + cube_offsets[5][2])];
-                sample_value[6] =
-                    _data[offset_now(x + cube_offsets[6][0], y + cube_offsets[6][1], z + cube_offsets[6][2])];
-                sample_value[7] =
-                    _data[offset_now(x + cube_offsets[7][0], y + cube_offsets[7][1], z + cube_offsets[7][2])];
-
-                uint32_t edge_crossings = 0;
-
-                std::array<float, 3> center_of_mass = {0.0f, 0.0f, 0.0f};
-                float normalization = 0.0f;
-
-                // Compute edge crossings and center of mass
-                for (int i = 0; i < 12; ++i) {
-                    uint32_t const idx_0 = edge_vertex_offsets[i * 2 + 0];
-                    uint32_t const idx_1 = edge_vertex_offsets[i * 2 + 1];
-
-                    auto const v_0 = sample_value[idx_0];
-                    auto const v_1 = sample_value[idx_1];
-
-                    auto edge_crossing = uint32_t(!((v_0 > iso_value) == (v_1 > iso_value)));
-                    edge_crossings |= (edge_crossing << i);
-
-
-                    if (edge_crossing == 1) {
-
-                        float d = ((iso_value - v_0) / (v_1 - v_0));
-                        std::array<float, 3> mix;
-                        mix[0] = static_cast<float>(cube_offsets[idx_0][0]) * (1.0f - d) +
-                                 static_cast<float>(cube_offsets[idx_1][0]) * d;
-                        mix[1] = static_cast<float>(cube_offsets[idx_0][1]) * (1.0f - d) +
-                                 static_cast<float>(cube_offsets[idx_1][1]) * d;
-                        mix[2] = static_cast<float>(cube_offsets[idx_0][2]) * (1.0f - d) +
-                                 static_cast<float>(cube_offsets[idx_1][2]) * d;
-                        std::array<float, 3> intersect_pos;
-                        intersect_pos[0] = static_cast<float>(x) + mix[0];
-                        intersect_pos[1] = static_cast<float>(y) + mix[1];
-                        intersect_pos[2] = static_cast<float>(z) + mix[2];
-                        center_of_mass[0] += intersect_pos[0];
-                        center_of_mass[1] += intersect_pos[1];
-                        center_of_mass[2] += intersect_pos[2];
-                        normalization += 1.0f;
-                    }
-                } // for i < 12
-
-                voxel_edge_crossings[offset_now(x, y, z)] = edge_crossings;
+    auto const dims = _dims;
+    auto const* data = _data;
+    auto const offset_now = [dims](size_t x, size_t y, size_t z) { return (z * dims[1] + y) * dims[0] + x; };
 
-                if (normalization > 0.0f) {
+    // reads the corners of a cell and answers the bit mask of the edges crossing the iso value
+    auto const cell_crossings = [&](size_t x, size_t y, size_t z, std::array<float, 8>& sample_value) {
+        uint32_t edge_crossings = 0;
+        for (int c = 0; c < 8; ++c) {
+            sample_value[c] = data[offset_now(x + cube_offsets[c][0], y + cube_offsets[c][1], z + cube_offsets[c][2])];
+        }
+        for (int i = 0; i < 12; ++i) {
+            auto const v_0 = sample_value[edge_vertex_offsets[i * 2 + 0]];
+            auto const v_1 = sample_value[edge_vertex_offsets[i * 2 + 1]];
+            edge_crossings |= uint32_t(!((v_0 > iso_value) == (v_1 > iso_value))) << i;
+        }
+        return edge_crossings;
+    };
 
-                    center_of_mass[0] /= normalization;
-                    center_of_mass[1] /= normalization;
-                    center_of_mass[2] /= normalization;
+    // bricks of cells that can contain the iso value
+    std::vector<int64_t> active_bricks;
+    for (int64_t b = 0; b < static_cast<int64_t>(_brick_min.size()); ++b) {
+        if (_brick_min[b] <= iso_value && _brick_max[b] > iso_value) active_bricks.push_back(b);
+    }
+    auto const active_cnt = static_cast<int64_t>(active_bricks.size());
+
+    auto const brick_extent = [this](int64_t b, std::array<uint32_t, 3>& lo, std::array<uint32_t, 3>& hi) {
+        std::array<uint32_t, 3> const brick = {static_cast<uint32_t>(b % _brick_cnt[0]),
+            static_cast<uint32_t>((b / _brick_cnt[0]) % _brick_cnt[1]),
+            static_cast<uint32_t>(b / (static_cast<int64_t>(_brick_cnt[0]) * _brick_cnt[1]))};
+        for (int a = 0; a < 3; ++a) {
+            lo[a] = brick[a] * _brick_edge;
+            hi[a] = std::min(lo[a] + _brick_edge, _dims[a] - 1);
+        }
+    };
+    auto const local_cell = [](uint32_t x, uint32_t y, uint32_t z) {
+        return ((z % _brick_edge) * _brick_edge + (y % _brick_edge)) * _brick_edge + (x % _brick_edge);
+    };
 
-                    std::array<float, 3> position;
-                    position[0] = ((center_of_mass[0] / _dims[0]) * _dims[0] * _spacing[0]) + _volume_origin[0];
-                    position[1] = ((center_of_mass[1] / _dims[1]) * _dims[1] * _spacing[1]) + _volume_origin[1];
-                    position[2] = ((center_of_mass[2] / _dims[2]) * _dims[2] * _spacing[2]) + _volume_origin[2];
-                    _vertices.push_back(position);
-
-                    voxel_lookup[offset_now(x, y, z)] = _vertices.size() - 1;
-                    voxel_filled.push_back(offset_now(x, y, z));
-
-                    std::array<float,3> normal;
-                    normal[0] =
-                        _data[offset_now(x >= _dims[0]-1 ? x : x + 1, y, z)] - _data[offset_now(x < 1 ? x : x - 1, y, z)];
-                    normal[1] =
-                        _data[offset_now(x, y >= _dims[1] -1 ? y : y + 1, z)] - _data[offset_now(x, y < 1 ? y : y - 1, z)];
-                    normal[2] =
-                        _data[offset_now(x, y, z>= _dims[2] -1 ? z : z + 1)] - _data[offset_now(x, y, z < 1 ? z : z - 1)];
-                    if (normal[0] <= 1e-6 && normal[1] <= 1e-6 && normal[2] <= 1e-6) {
-                        normal[0] = _data[offset_now(x >= _dims[0] - 2 ? x : x + 2, y, z)] -
-                                    _data[offset_now(x < 2 ? x : x - 2, y, z)];
-                        normal[1] = _data[offset_now(x, y >= _dims[1] - 2 ? y : y + 2, z)] -
-                                    _data[offset_now(x, y < 2 ? y : y - 2, z)];
-                        normal[2] = _data[offset_now(x, y, z >= _dims[2] - 2 ? z : z + 2)] -
-                                    _data[offset_now(x, y, z < 2 ? z : z - 2)];
+    // first pass: number the vertices within each brick and count the faces
+    constexpr uint32_t no_vertex = std::numeric_limits<uint32_t>::max();
+    std::vector<int64_t> brick_slot(_brick_min.size(), -1);
+    std::vector<std::vector<uint32_t>> local_vertex(active_cnt);
+    std::vector<size_t> vertex_offsets(active_cnt + 1, 0);
+    std::vector<size_t> face_offsets(active_cnt + 1, 0);
+    for (int64_t s = 0; s < active_cnt; ++s) brick_slot[active_bricks[s]] = s;
+
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t s = 0; s < active_cnt; ++s) {
+        std::array<uint32_t, 3> lo, hi;
+        brick_extent(active_bricks[s], lo, hi);
+        auto& lookup = local_vertex[s];
+        lookup.assign(_brick_edge * _brick_edge * _brick_edge, no_vertex);
+
+        std::array<float, 8> sample_value;
+        uint32_t vertex_cnt = 0;
+        size_t face_cnt = 0;
+        for (uint32_t z = lo[2]; z < hi[2]; ++z) {
+            for (uint32_t y = lo[1]; y < hi[1]; ++y) {
+                for (uint32_t x = lo[0]; x < hi[0]; ++x) {
+                    auto const edge_crossings = cell_crossings(x, y, z, sample_value);
+                    if (edge_crossings == 0) continue;
+                    lookup[local_cell(x, y, z)] = vertex_cnt++;
+                    if (x > 0 && y > 0 && z > 0) {
+                        face_cnt += (edge_crossings & 1) + ((edge_crossings >> 1) & 1) + ((edge_crossings >> 2) & 1);
                     }
-                    auto const normal_length = std::sqrt(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
-                    normal[0] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
-                    normal[1] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
-                    normal[2] /= (normal_length < 0.00000001) ? 1.0 : normal_length;
-                    _normals.push_back(normal);
                 }
-            } // for x
-        }     // for y
-    }         // for z
-    voxel_filled.shrink_to_fit();
-
-    auto const coordinateFromLinearIndex = [](uint32_t idx, uint32_t max_x, uint32_t max_y) {
-        std::array<uint32_t,3> coords;
-        coords[0] = idx % (max_x) ;
-        idx /= (max_x);
-        coords[1] = idx % (max_y);
-        idx /= (max_y);
-        coords[2] = idx;
-        return coords;
+            }
+        }
+        vertex_offsets[s + 1] = vertex_cnt;
+        face_offsets[s + 1] = face_cnt;
+    }
+
+    for (int64_t s = 0; s < active_cnt; ++s) {
+        vertex_offsets[s + 1] += vertex_offsets[s];
+        face_offsets[s + 1] += face_offsets[s];
+    }
+    _vertices.resize(vertex_offsets.back());
+    _normals.resize(vertex_offsets.back());
+    _faces.resize(face_offsets.back());
+    _triangles.resize(2 * face_offsets.back());
+
+    // global index of the vertex of a cell, the four cells around a crossed edge always have one
+    auto const vertex_of = [&](uint32_t x, uint32_t y, uint32_t z) {
+        auto const brick = (static_cast<int64_t>(z / _brick_edge) * _brick_cnt[1] + y / _brick_edge) * _brick_cnt[0] +
+                           x / _brick_edge;
+        auto const s = brick_slot[brick];
+        return static_cast<uint32_t>(vertex_offsets[s] + local_vertex[s][local_cell(x, y, z)]);
     };
 
+    // second pass: write vertices and faces straight to their final place in the mesh buffers
+#pragma omp parallel for schedule(dynamic)
+    for (int64_t s = 0; s < active_cnt; ++s) {
+        std::array<uint32_t, 3> lo, hi;
+        brick_extent(active_bricks[s], lo, hi);
+
+        std::array<float, 8> sample_value;
+        auto vertex_idx = vertex_offsets[s];
+        auto face_idx = face_offsets[s];
+        for (uint32_t z = lo[2]; z < hi[2]; ++z) {
+            for (uint32_t y = lo[1]; y < hi[1]; ++y) {
+                for (uint32_t x = lo[0]; x < hi[0]; ++x) {
+                    auto const edge_crossings = cell_crossings(x, y, z, sample_value);
+                    if (edge_crossings == 0) continue;
+
+                    // center of mass of the edge crossings
+                    std::array<float, 3> center_of_mass = {0.0f, 0.0f, 0.0f};
+                    float normalization = 0.0f;
+                    for (int i = 0; i < 12; ++i) {
+                        if (!(edge_crossings & (1 << i))) continue;
+                        uint32_t const idx_0 = edge_vertex_offsets[i * 2 + 0];
+                        uint32_t const idx_1 = edge_vertex_offsets[i * 2 + 1];
+                        float const d =
+                            (iso_value - sample_value[idx_0]) / (sample_value[idx_1] - sample_value[idx_0]);
+                        for (int a = 0; a < 3; ++a) {
+                            center_of_mass[a] += static_cast<float>(cube_offsets[idx_0][a]) * (1.0f - d) +
+                                                 static_cast<float>(cube_offsets[idx_1][a]) * d;
+                        }
+                        normalization += 1.0f;
+                    }
+                    std::array<uint32_t, 3> const cell = {x, y, z};
+                    std::array<float, 3> position;
+                    for (int a = 0; a < 3; ++a) {
+                        position[a] =
+                            (static_cast<float>(cell[a]) + center_of_mass[a] / normalization) * _spacing[a] +
+                            _volume_origin[a];
+                    }
+                    _vertices[vertex_idx] = position;
 
-    for (auto id : voxel_filled) {
-        for (uint32_t i = 0; i < 3; ++i) {
-            auto const edge_crossing = 1 & (voxel_edge_crossings[id] >> i);
-            if (edge_crossing == 1) {
-                auto coords = coordinateFromLinearIndex(id, _dims[0], _dims[1]);
-                if (coords[0] > 0 && coords[1] > 0 && coords[2] > 0) {
-                    std::array<uint32_t, 4> indices;
-                    std::array<uint32_t, 3> triangle1;
-                    std::array<uint32_t, 3> triangle2;
-                    if (i == 0) {
-                        indices[0] = voxel_lookup[offset_now(coords[0], coords[1] - 1, coords[2])];
-                        indices[1] = voxel_lookup[offset_now(coords[0], coords[1] - 1, coords[2] - 1)];
-                        indices[2] = voxel_lookup[offset_now(coords[0], coords[1], coords[2] - 1)];
-                        indices[3] = voxel_lookup[offset_now(coords[0], coords[1], coords[2])]; // or just id
-                    } else if (i == 1) {
-                        indices[0] = voxel_lookup[offset_now(coords[0] - 1, coords[1] - 1, coords[2])];
-                        indices[1] = voxel_lookup[offset_now(coords[0], coords[1] - 1, coords[2])];
-                        indices[2] = voxel_lookup[offset_now(coords[0], coords[1], coords[2])];
-                        indices[3] = voxel_lookup[offset_now(coords[0] - 1, coords[1], coords[2])];
-                    } else if (i == 2) {
-                        indices[0] = voxel_lookup[offset_now(coords[0] - 1, coords[1], coords[2])];
-                        indices[1] = voxel_lookup[offset_now(coords[0], coords[1], coords[2])];
-                        indices[2] = voxel_lookup[offset_now(coords[0], coords[1], coords[2] - 1)];
-                        indices[3] = voxel_lookup[offset_now(coords[0] - 1, coords[1], coords[2] - 1)];
+                    std::array<float, 3> normal;
+                    normal[0] = data[offset_now(x + 1, y, z)] - data[offset_now(x < 1 ? x : x - 1, y, z)];
+                    normal[1] = data[offset_now(x, y + 1, z)] - data[offset_now(x, y < 1 ? y : y - 1, z)];
+                    normal[2] = data[offset_now(x, y, z + 1)] - data[offset_now(x, y, z < 1 ? z : z - 1)];
+                    if (normal[0] <= 1e-6 && normal[1] <= 1e-6 && normal[2] <= 1e-6) {
+                        normal[0] = data[offset_now(x >= _dims[0] - 2 ? x : x + 2, y, z)] -
+                                    data[offset_now(x < 2 ? x : x - 2, y, z)];
+                        normal[1] = data[offset_now(x, y >= _dims[1] - 2 ? y : y + 2, z)] -
+                                    data[offset_now(x, y < 2 ? y : y - 2, z)];
+                        normal[2] = data[offset_now(x, y, z >= _dims[2] - 2 ? z : z + 2)] -
+                                    data[offset_now(x, y, z < 2 ? z : z - 2)];
+                    }
+                    auto const normal_length =
+                        std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+                    for (auto& n : normal) n /= (normal_length < 0.00000001) ? 1.0f : normal_length;
+                    _normals[vertex_idx] = normal;
+                    ++vertex_idx;
+
+                    if (x == 0 || y == 0 || z == 0) continue;
+                    for (uint32_t i = 0; i < 3; ++i) {
+                        if (!(1 & (edge_crossings >> i))) continue;
+                        std::array<uint32_t, 4> indices;
+                        if (i == 0) {
+                            indices[0] = vertex_of(x, y - 1, z);
+                            indices[1] = vertex_of(x, y - 1, z - 1);
+                            indices[2] = vertex_of(x, y, z - 1);
+                            indices[3] = vertex_of(x, y, z);
+                        } else if (i == 1) {
+                            indices[0] = vertex_of(x - 1, y - 1, z);
+                            indices[1] = vertex_of(x, y - 1, z);
+                            indices[2] = vertex_of(x, y, z);
+                            indices[3] = vertex_of(x - 1, y, z);
+                        } else {
+                            indices[0] = vertex_of(x - 1, y, z);
+                            indices[1] = vertex_of(x, y, z);
+                            indices[2] = vertex_of(x, y, z - 1);
+                            indices[3] = vertex_of(x - 1, y, z - 1);
+                        }
+                        _faces[face_idx] = indices;
+                        _triangles[2 * face_idx + 0] = {indices[0], indices[1], indices[2]};
+                        _triangles[2 * face_idx + 1] = {indices[0], indices[2], indices[3]};
+                        ++face_idx;
                     }
-                    triangle1[0] = indices[0];
-                    triangle1[1] = indices[1];
-                    triangle1[2] = indices[2];
-                    triangle2[0] = indices[0];
-                    triangle2[1] = indices[2];
-                    triangle2[2] = indices[3];
-
-                    _faces.emplace_back(indices);
-                    _triangles.emplace_back(triangle1);
-                    _triangles.emplace_back(triangle2);
                 }
-            }
-        } // for i < 3
-    } // for voxel_filled
+            } // for y
+        }     // for z
+    }         // for bricks
 }
 
 bool SurfaceNets::getData(core::Call& call) {
@@ -486,6 +335,7 @@ bool SurfaceNets::getData(core::Call& call) {
     if (cd->DataHash() != _old_datahash) {
         if (!(*cd)(core::misc::VolumetricDataCall::IDX_GET_DATA)) return false;
         something_changed = true;
+        _brick_min.clear();
 
         auto mesh_meta_data = cm->getMetaData();
         mesh_meta_data.m_bboxs = cd->AccessBoundingBoxes();
@@ -507,7 +357,7 @@ bool SurfaceNets::getData(core::Call& call) {
     _data = reinterpret_cast<float*>(cd->GetData());
 
     if (something_changed || _recalc) {
-        this->calculateSurfaceNets2();
+        this->calculateSurfaceNets();
 
         _mesh_attribs.resize(2);
         _mesh_attribs[0].component_type = mesh::MeshDataAccessCollection::ValueType::FLOAT;
@@ -595,6 +445,7 @@ bool SurfaceNets::getNormalData(core::Call& call) {
     if (cd->DataHash() != _old_datahash) {
         if (!(*cd)(core::misc::VolumetricDataCall::IDX_GET_DATA)) return false;
         something_changed = true;
+        _brick_min.clear();
     }
 
     _dims[0] = cd->GetResolution(0);
@@ -611,7 +462,7 @@ bool SurfaceNets::getNormalData(core::Call& call) {
     _data = reinterpret_cast<float*>(cd->GetData());
 
     if (something_changed || _recalc) {
-        this->calculateSurfaceNets2();
+        this->calculateSurfaceNets();
     }
 
     mpd->SetParticleListCount(1);
@@ -5,7 +5,10 @@
  */
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <cstdlib>
+#include <vector>
 #include "concave_hull.h"
 #include "mesh/MeshCalls.h"
 #include "mmcore/CalleeSlot.h"
@@ -63,8 +66,14 @@ protected:
 private:
     bool InterfaceIsDirty();
 
+    /**
+     * Extracts the surface net of the current iso value. The cells are split into bricks that are meshed in parallel,
+     * every cell belongs to exactly one brick, so vertices on brick borders are shared by the faces of both bricks.
+     */
     void calculateSurfaceNets();
-    void calculateSurfaceNets2();
+
+    /** Caches the value range of every brick, so bricks that cannot contain the iso value are skipped */
+    void updateBrickRanges();
 
     bool getMetaData(core::Call& call);
     bool getData(core::Call& call);
@@ -89,6 +98,14 @@ private:
     std::array<float, 3> _volume_origin;
     float* _data;
 
+    /** Edge length of a brick in cells */
+    static constexpr uint32_t _brick_edge = 32;
+
+    /** Number of bricks per dimension and the value range of the voxels of each brick */
+    std::array<uint32_t, 3> _brick_cnt;
+    std::vector<float> _brick_min;
+    std::vector<float> _brick_max;
+
     // store surface
     std::vector<std::array<float, 3>> _vertices;
     std::vector<std::array<float, 3>> _normals;
@@ -0,0 +1,124 @@
+/*
+ * TrilinearSampler.h
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include "mmcore/misc/VolumetricDataCall.h"
+
+namespace megamol {
+namespace probe {
+
+/**
+ * Trilinear interpolation in the current frame of a cartesian or rectilinear VolumetricDataCall. Only reads the
+ * volume, so one instance can be shared by all threads. The call has to keep its data while the sampler is in use.
+ */
+class TrilinearSampler {
+public:
+    explicit TrilinearSampler(core::misc::VolumetricDataCall const& call)
+        : _data(call.GetData()), _components(call.GetComponents()), _is_double(false), _valid(false) {
+        auto const* meta = call.GetMetadata();
+        if (_data == nullptr || meta == nullptr || call.GetScalarType() != core::misc::FLOATING_POINT) return;
+        if (call.GetScalarLength() != sizeof(float) && call.GetScalarLength() != sizeof(double)) return;
+        if (meta->GridType != core::misc::CARTESIAN && meta->GridType != core::misc::RECTILINEAR) return;
+        _is_double = (call.GetScalarLength() == sizeof(double));
+
+        for (int a = 0; a < 3; ++a) {
+            _res[a] = call.GetResolution(a);
+            if (_res[a] == 0) return;
+            _uniform[a] = (meta->GridType == core::misc::CARTESIAN) || meta->IsUniform[a];
+            _origin[a] = meta->Origin[a];
+            _spacing[a] = meta->SliceDists[a][0];
+            if (!_uniform[a]) {
+                _coords[a].resize(_res[a]);
+                _coords[a][0] = meta->Origin[a];
+                for (size_t i = 1; i < _res[a]; ++i) {
+                    _coords[a][i] = _coords[a][i - 1] + meta->SliceDists[a][i - 1];
+                }
+            }
+        }
+        _valid = (_components > 0);
+    }
+
+    /** Answer whether the volume can be sampled */
+    bool IsValid() const { return _valid; }
+
+    /** Answer the number of components per voxel */
+    size_t Components() const { return _components; }
+
+    /**
+     * Interpolates the first cnt components at pos, positions outside the grid are clamped to its border.
+     *
+     * @param pos World space position.
+     * @param out Receives cnt values.
+     * @param cnt Number of components, at most Components().
+     */
+    void Sample(std::array<float, 3> const& pos, float* out, size_t cnt) const {
+        size_t cell[3];
+        float t[3];
+        for (int a = 0; a < 3; ++a) locate(a, pos[a], cell[a], t[a]);
+
+        std::fill(out, out + cnt, 0.0f);
+        for (int corner = 0; corner < 8; ++corner) {
+            float w = 1.0f;
+            size_t idx[3];
+            for (int a = 0; a < 3; ++a) {
+                bool const upper = (corner >> a) & 1;
+                idx[a] = std::min(cell[a] + upper, _res[a] - 1);
+                w *= upper ? t[a] : (1.0f - t[a]);
+            }
+            if (w == 0.0f) continue;
+            auto const voxel = ((idx[2] * _res[1] + idx[1]) * _res[0] + idx[0]) * _components;
+            for (size_t c = 0; c < cnt; ++c) out[c] += w * value(voxel + c);
+        }
+    }
+
+private:
+    /** Finds the cell along an axis and the relative position within it */
+    void locate(int a, float p, size_t& cell, float& t) const {
+        if (_res[a] < 2) {
+            cell = 0;
+            t = 0.0f;
+            return;
+        }
+        if (_uniform[a]) {
+            auto const rel = std::clamp((p - _origin[a]) / _spacing[a], 0.0f, static_cast<float>(_res[a] - 1));
+            cell = std::min(static_cast<size_t>(rel), _res[a] - 2);
+            t = rel - static_cast<float>(cell);
+        } else {
+            auto const& c = _coords[a];
+            p = std::clamp(p, c.front(), c.back());
+            auto const it = std::upper_bound(c.begin(), c.end(), p);
+            cell = std::min(static_cast<size_t>(std::max<std::ptrdiff_t>(it - c.begin() - 1, 0)), _res[a] - 2);
+            t = (p - c[cell]) / (c[cell + 1] - c[cell]);
+        }
+    }
+
+    float value(size_t idx) const {
+        return _is_double ? static_cast<float>(static_cast<double const*>(_data)[idx])
+                          : static_cast<float const*>(_data)[idx];
+    }
+
+    void const* _data;
+    size_t _components;
+    bool _is_double;
+    bool _valid;
+
+    size_t _res[3] = {0, 0, 0};
+    bool _uniform[3] = {true, true, true};
+    float _origin[3] = {0.0f, 0.0f, 0.0f};
+    float _spacing[3] = {1.0f, 1.0f, 1.0f};
+
+    /** Slice positions of non-uniform axes */
+    std::array<std::vector<float>, 3> _coords;
+};
+
+} // namespace probe
+} // namespace megamol
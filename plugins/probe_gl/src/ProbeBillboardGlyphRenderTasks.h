@@ -132,12 +132,12 @@ private:
         float scale);
 
      GlyphScalarProbeData createScalarProbeGlyphData(
-        probe::FloatProbe const& probe,
+        probe::FloatProbeView const& probe,
         int probe_id,
         float scale);
 
     GlyphVectorProbeData createVectorProbeGlyphData(
-        probe::Vec4Probe const& probe,
+        probe::Vec4ProbeView const& probe,
         int probe_id,
         float scale);
 };
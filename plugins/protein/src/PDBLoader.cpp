@@ -22,10 +22,15 @@
 #include "vislib/StringConverter.h"
 #include "vislib/StringTokeniser.h"
 #include "mmcore/utility/sys/ASCIIFileBuffer.h"
+#include "mmcore/utility/FileUtils.h"
+#include <algorithm>
+#include <cstring>
 #include <ctime>
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #define SFB716DEMO
 #define DARKER_COLORS
@@ -37,6 +42,42 @@ using namespace megamol::protein_calls;
 
 #define SOLVENT_CHAIN_IDENTIFIER 127
 
+namespace {
+
+/** Extension of the frame index file written next to an XTC file */
+const char XTC_INDEX_EXTENSION[] = ".mmidx";
+
+/** Magic number and version of the frame index file */
+const char XTC_INDEX_MAGIC[8] = { 'M', 'M', 'X', 'T', 'C', 'I', 'X', '1' };
+
+/*
+ * Read a big endian value from an XTC header.
+ */
+template<class T>
+T readBigEndian(const char *buff) {
+    char tmp[sizeof(T)];
+    for (size_t i = 0; i < sizeof(T); i++) {
+        tmp[i] = buff[sizeof(T) - 1 - i];
+    }
+    T val;
+    std::memcpy(&val, tmp, sizeof(T));
+    return val;
+}
+
+/*
+ * Get size and modification time of a file to validate its index file.
+ */
+bool getFileStamp(const std::string& filename, UINT64& size, INT64& time) {
+    std::error_code ec;
+    const stdfs::path path(filename);
+    size = static_cast<UINT64>(stdfs::file_size(path, ec));
+    if (ec) return false;
+    time = static_cast<INT64>(stdfs::last_write_time(path, ec).time_since_epoch().count());
+    return !ec;
+}
+
+} // namespace
+
 /*
  * PDBLoader::Frame::Frame
  */
@@ -1093,7 +1134,7 @@ void PDBLoader::loadFrame( view::AnimDataModule::Frame *frame,
           Param<core::param::FilePathParam>()->Value(),
           std::ios::in | std::ios::binary);
 
-        xtcFile.seekg( this->XTCFrameOffset[idx]);
+        xtcFile.seekg( static_cast<std::streamoff>(this->XTCFrameOffset[idx]));
 
         fr->readFrame(&xtcFile);
 
@@ -1479,6 +1520,10 @@ void PDBLoader::loadFile( const vislib::TString& filename) {
                     // frames in xtc-file - 1 (without the last frame)
                     this->setFrameCount( this->numXTCFrames);
 
+                    // every frame is read through its own file stream, so
+                    // several frames can be decoded ahead in parallel
+                    this->setLoaderThreadCount(std::max(1u, std::min(4u, std::thread::hardware_concurrency())));
+
                     // start the loading thread
                     this->initFrameCache( maxFrames);
                 }
@@ -2125,72 +2170,72 @@ bool PDBLoader::readNumXTCFrames() {
     this->numXTCFrames = 0;
     this->XTCFrameOffset.Clear();
 
+    const std::string xtcFilename(T2A(this->xtcFilenameSlot.
+      Param<core::param::FilePathParam>()->Value().PeekBuffer()));
+
+    // reuse the index of an earlier load if the trajectory did not change
+    vislib::math::Cuboid<float> xtcBBox;
+    if( this->readXTCIndex(xtcFilename, xtcBBox) ) {
+        if( this->numXTCFrames > 0 ) {
+            this->bbox.Union(xtcBBox);
+        }
+        megamol::core::utility::log::Log::DefaultLog.WriteMsg( megamol::core::utility::log::Log::LEVEL_INFO,
+        "Time for reading the XTC index: %f",
+        ( double( clock() - t) / double( CLOCKS_PER_SEC) )); // DEBUG
+        return true;
+    }
+
     // try to open xtc file
     std::fstream xtcFile;
-    xtcFile.open(this->xtcFilenameSlot.
-      Param<core::param::FilePathParam>()->Value(),
-      std::ios::in | std::ios::binary);
+    xtcFile.open(xtcFilename.c_str(), std::ios::in | std::ios::binary);
 
     // check if file could be opened
     if( !xtcFile ) return false;
 
     this->XTCFrameOffset.SetCapacityIncrement( 1000);
-    int size;
-    char tmpByte;
-    char *num;
-
-    int minint[3];
-    int maxint[3];
-
-    unsigned int i;
-
-    float precision;
-
-    xtcFile.seekg(0, std::ios_base::beg);
-
-    vislib::math::Cuboid<float> tmpBBox( this->bbox);
-
-    //std::fstream::iostate st = 0;
 
     // get length of file:
     xtcFile.seekg(0, xtcFile.end);
-    int xtcFileLength = (int)xtcFile.tellg();
+    const UINT64 xtcFileLength = static_cast<UINT64>(xtcFile.tellg());
     xtcFile.seekg (0, xtcFile.beg);
 
-    // read until eof
-    while( !xtcFile.eof() && xtcFile.tellg() < xtcFileLength ) {
+    // frame header up to the size of the compressed block:
+    // + version, number of atoms, step, time, box, number of atoms (56 Bytes)
+    // + precision, lower and upper bound, small index (32 Bytes)
+    // + size of the compressed block of data (4 Bytes)
+    const UINT64 headerSize = 92;
+    char header[headerSize];
+
+    vislib::math::Cuboid<float> frameBBox;
+    UINT64 offset = 0;
+
+    // only the headers are read, the compressed data is skipped
+    while( offset < xtcFileLength ) {
+        xtcFile.seekg(static_cast<std::streamoff>(offset), std::ios_base::beg);
+        if( !xtcFile.read(header, headerSize) ) break;
+
         // add the offset to the offset array
-        this->XTCFrameOffset.Add( (unsigned int)xtcFile.tellg());
-
-        // skip some header data
-        xtcFile.seekg(56, std::ios_base::cur);
-        // read precision
-        xtcFile.read((char*)&precision, 4);
-        // change byte-order
-        num = (char*)&precision;
-        tmpByte = num[0]; num[0] = num[3]; num[3] = tmpByte;
-        tmpByte = num[1]; num[1] = num[2]; num[2] = tmpByte;
-        precision /= 10.0f;
-
-        // get the lower bound
-        xtcFile.read((char*)&minint, 12);
-        // get the upper bound
-        xtcFile.read((char*)&maxint, 12);
-        // change byte-order
-        for(i = 0; i < 3; i++ ) {
-            num = (char*)&minint[i];
-            tmpByte = num[0]; num[0] = num[3]; num[3] = tmpByte;
-            tmpByte = num[1]; num[1] = num[2]; num[2] = tmpByte;
-            num = (char*)&maxint[i];
-            tmpByte = num[0]; num[0] = num[3]; num[3] = tmpByte;
-            tmpByte = num[1]; num[1] = num[2]; num[2] = tmpByte;
+        this->XTCFrameOffset.Add( offset);
+
+        // add the box of the previous frame, so the box of the ignored last
+        // frame does not end up in the bounding box
+        if( this->numXTCFrames == 1 ) {
+            xtcBBox = frameBBox;
+        } else if( this->numXTCFrames > 1 ) {
+            xtcBBox.Union(frameBBox);
+        }
+
+        float precision = readBigEndian<float>(header + 56) / 10.0f;
+        int minint[3];
+        int maxint[3];
+        for( unsigned int i = 0; i < 3; i++ ) {
+            minint[i] = readBigEndian<int>(header + 60 + 4 * i);
+            maxint[i] = readBigEndian<int>(header + 72 + 4 * i);
         }
 
-        // update the bounding box by uniting it with the last frames box
-        this->bbox.Union(tmpBBox);
         // get the current frames bounding box including the atom radius
         // note: atom radius is divided by 10
-        tmpBBox = vislib::math::Cuboid<float>(
+        frameBBox = vislib::math::Cuboid<float>(
             (float)minint[0] / precision - 0.3f,
             (float)minint[1] / precision - 0.3f,
             (float)minint[2] / precision - 0.3f,
@@ -2199,32 +2244,27 @@ bool PDBLoader::readNumXTCFrames() {
             (float)maxint[1] / precision + 0.3f,
             (float)maxint[2] / precision + 0.3f);
 
-        // skip some header data
-        xtcFile.seekg(4, std::ios_base::cur);
-
-        // read size of the compressed block of data
-        xtcFile.read((char*)&size, 4);
-        // change byte-order
-        num = (char*)&size;
-        tmpByte = num[0]; num[0] = num[3]; num[3] = tmpByte;
-        tmpByte = num[1]; num[1] = num[2]; num[2] = tmpByte;
-
-        // skip the compressed block of data except for the last byte and
-        // ignore the remaining bytes to prevent skipping over the end
-        // of the file
-        xtcFile.seekg(size-1, std::ios_base::cur);
-        xtcFile.ignore(((4 - size % 4) % 4)+1);
-
         // add this frame to the frame count
         this->numXTCFrames++;
-        //st = xtcFile.rdstate();
-        xtcFile.rdstate();
+
+        // skip the compressed block of data including its padding
+        const int size = readBigEndian<int>(header + 88);
+        if( size < 0 ) break;
+        offset += headerSize + static_cast<UINT64>(size) + (4 - size % 4) % 4;
     }
     xtcFile.close();
 
     // remove the last frame
-    this->XTCFrameOffset.RemoveLast();
-    this->numXTCFrames--;
+    if( this->numXTCFrames > 0 ) {
+        this->XTCFrameOffset.RemoveLast();
+        this->numXTCFrames--;
+    }
+
+    if( this->numXTCFrames > 0 ) {
+        this->bbox.Union(xtcBBox);
+    }
+
+    this->writeXTCIndex(xtcFilename, xtcBBox);
 
     megamol::core::utility::log::Log::DefaultLog.WriteMsg( megamol::core::utility::log::Log::LEVEL_INFO,
     "Time for parsing the XTC-file: %f",
@@ -2233,6 +2273,82 @@ bool PDBLoader::readNumXTCFrames() {
     return true;
 }
 
+/*
+ * Read the frame index of the XTC file from its index file.
+ */
+bool PDBLoader::readXTCIndex(const std::string& xtcFilename, vislib::math::Cuboid<float>& xtcBBox) {
+    UINT64 fileSize;
+    INT64 fileTime;
+    if( !getFileStamp(xtcFilename, fileSize, fileTime) ) return false;
+
+    std::ifstream indexFile(xtcFilename + XTC_INDEX_EXTENSION, std::ios::in | std::ios::binary);
+    if( !indexFile ) return false;
+
+    char magic[sizeof(XTC_INDEX_MAGIC)];
+    UINT64 indexFileSize;
+    INT64 indexFileTime;
+    unsigned int frameCnt;
+    float box[6];
+    indexFile.read(magic, sizeof(magic));
+    indexFile.read(reinterpret_cast<char*>(&indexFileSize), sizeof(indexFileSize));
+    indexFile.read(reinterpret_cast<char*>(&indexFileTime), sizeof(indexFileTime));
+    indexFile.read(reinterpret_cast<char*>(&frameCnt), sizeof(frameCnt));
+    indexFile.read(reinterpret_cast<char*>(box), sizeof(box));
+    if( !indexFile
+            || ( std::memcmp(magic, XTC_INDEX_MAGIC, sizeof(magic)) != 0 )
+            || ( indexFileSize != fileSize ) || ( indexFileTime != fileTime )
+            || ( static_cast<UINT64>(frameCnt) * sizeof(UINT64) > fileSize ) ) {
+        return false;
+    }
+
+    std::vector<UINT64> offsets(frameCnt);
+    indexFile.read(reinterpret_cast<char*>(offsets.data()),
+        static_cast<std::streamsize>(frameCnt) * sizeof(UINT64));
+    if( !indexFile || ( !offsets.empty() && ( offsets.back() >= fileSize ) ) ) {
+        return false;
+    }
+
+    this->XTCFrameOffset.SetCount(frameCnt);
+    for( unsigned int i = 0; i < frameCnt; i++ ) {
+        this->XTCFrameOffset[i] = offsets[i];
+    }
+    this->numXTCFrames = frameCnt;
+    xtcBBox.Set(box[0], box[1], box[2], box[3], box[4], box[5]);
+
+    megamol::core::utility::log::Log::DefaultLog.WriteMsg( megamol::core::utility::log::Log::LEVEL_INFO,
+        "Using XTC index file %s%s", xtcFilename.c_str(), XTC_INDEX_EXTENSION);
+    return true;
+}
+
+/*
+ * Write the frame index of the XTC file into its index file.
+ */
+void PDBLoader::writeXTCIndex(const std::string& xtcFilename, const vislib::math::Cuboid<float>& xtcBBox) const {
+    UINT64 fileSize;
+    INT64 fileTime;
+    if( !getFileStamp(xtcFilename, fileSize, fileTime) ) return;
+
+    std::ofstream indexFile(xtcFilename + XTC_INDEX_EXTENSION,
+        std::ios::out | std::ios::binary | std::ios::trunc);
+    if( indexFile ) {
+        const unsigned int frameCnt = static_cast<unsigned int>(this->XTCFrameOffset.Count());
+        const float box[6] = { xtcBBox.Left(), xtcBBox.Bottom(), xtcBBox.Back(),
+            xtcBBox.Right(), xtcBBox.Top(), xtcBBox.Front() };
+        indexFile.write(XTC_INDEX_MAGIC, sizeof(XTC_INDEX_MAGIC));
+        indexFile.write(reinterpret_cast<const char*>(&fileSize), sizeof(fileSize));
+        indexFile.write(reinterpret_cast<const char*>(&fileTime), sizeof(fileTime));
+        indexFile.write(reinterpret_cast<const char*>(&frameCnt), sizeof(frameCnt));
+        indexFile.write(reinterpret_cast<const char*>(box), sizeof(box));
+        indexFile.write(reinterpret_cast<const char*>(this->XTCFrameOffset.PeekElements()),
+            static_cast<std::streamsize>(frameCnt) * sizeof(UINT64));
+    }
+    if( !indexFile ) {
+        // the index is only a cache, a read-only data directory is fine
+        megamol::core::utility::log::Log::DefaultLog.WriteMsg( megamol::core::utility::log::Log::LEVEL_WARN,
+            "Unable to write XTC index file %s%s", xtcFilename.c_str(), XTC_INDEX_EXTENSION);
+    }
+}
+
 /*
  * Write all frames except for the first one from the currently loaded PDB-file
  * into a new XTC-file.
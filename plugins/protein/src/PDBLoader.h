@@ -24,6 +24,7 @@
 #include "mmcore/view/AnimDataModule.h"
 #include "MDDriverConnector.h"
 #include <fstream>
+#include <string>
 #include "MultiPDBLoader.h"
 #include "vislib/math/Vector.h"
 
@@ -616,6 +617,27 @@ namespace protein {
          */
         bool readNumXTCFrames();
 
+        /**
+         * Read the frame offsets and the bounding box of the XTC file from
+         * its index file. The index is only accepted if it was written for a
+         * trajectory of the same size and modification time.
+         *
+         * @param xtcFilename The path of the XTC file.
+         * @param xtcBBox     Receives the bounding box of the trajectory.
+         *
+         * @return 'true' if a valid index was read, otherwise 'false'
+         */
+        bool readXTCIndex(const std::string& xtcFilename, vislib::math::Cuboid<float>& xtcBBox);
+
+        /**
+         * Write the frame offsets and the bounding box of the XTC file into
+         * its index file, so later loads do not have to scan the trajectory.
+         *
+         * @param xtcFilename The path of the XTC file.
+         * @param xtcBBox     The bounding box of the trajectory.
+         */
+        void writeXTCIndex(const std::string& xtcFilename, const vislib::math::Cuboid<float>& xtcBBox) const;
+
         /**
          * Writes the frames of the current PDB-file (beginning with second
          * frame) into a new compressed XTC-file.
@@ -721,7 +743,7 @@ namespace protein {
         /** the number of frames */
         unsigned int numXTCFrames;
         /** the byte offset of all frames */
-        vislib::Array<unsigned int> XTCFrameOffset;
+        vislib::Array<UINT64> XTCFrameOffset;
         /** Flag whether the current xtc-filename is valid */
         bool xtcFileValid;
 
@@ -0,0 +1,666 @@
+/*
+ * CompositingBench.cpp
+ *
+ * Headless sort-last compositing benchmark for the remote plugin. A compositor drives N sender processes through
+ * FBOCommFabric, the senders answer with synthetic color and depth tiles encoded the same way as in FBOTransmitter2,
+ * and the compositor decodes and depth-composites them on the CPU. No GPU is involved on either side.
+ *
+ * Copyright (C) 2021 by MegaMol Team
+ * Alle Rechte vorbehalten.
+ */
+
+#include "stdafx.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FBOCodec.h"
+#include "FBOCommFabric.h"
+#include "FBOProto.h"
+
+using namespace megamol::remote;
+
+namespace {
+
+using bench_clock = std::chrono::steady_clock;
+
+/// flags of a bench_request
+enum bench_flags : unsigned int {
+    BenchKeyframe = 1u << 0, ///< sender must not delta-encode against its previous tile
+    BenchQuit = 1u << 1      ///< sender answers with a bare header and terminates
+};
+
+/// request sent by the compositor, the sender answers with a fbo_msg_header followed by the encoded buffers
+struct bench_request {
+    unsigned int frame_id;
+    int num_nodes;
+    int width;
+    int height;
+    int tile[4];
+    fbo_color_codec color_codec;
+    fbo_depth_codec depth_codec;
+    unsigned int flags;
+};
+
+enum bench_layout { LayoutFull, LayoutStripes, LayoutGrid };
+
+struct bench_config {
+    std::string comm = "zmq";
+    std::string role = "compositor";
+    std::vector<std::string> hosts = {"127.0.0.1"};
+    int port = 34242;
+    int nodes = 4;
+    int rank = 0;
+    int frames = 100;
+    int warmup = 10;
+    int timeout = 30;
+    bool spawn = true;
+    bool verify = false;
+    std::vector<std::pair<int, int>> resolutions = {{1920, 1080}};
+    std::vector<bench_layout> layouts = {LayoutFull, LayoutStripes, LayoutGrid};
+    fbo_color_codec color_codec = ColSnappy;
+    fbo_depth_codec depth_codec = DepthSnappy;
+};
+
+struct frame_stats {
+    double latency;
+    double transfer;
+    double decode;
+    double composite;
+    size_t wire_bytes;
+    size_t raw_bytes;
+};
+
+const std::map<std::string, fbo_color_codec> color_codec_names = {
+    {"raw", ColRaw}, {"snappy", ColSnappy}, {"rle", ColRLE}, {"delta", ColDelta}};
+
+const std::map<std::string, fbo_depth_codec> depth_codec_names = {
+    {"raw", DepthRaw}, {"snappy", DepthSnappy}, {"q16", DepthQ16}, {"q24", DepthQ24}};
+
+const std::map<std::string, bench_layout> layout_names = {
+    {"full", LayoutFull}, {"stripes", LayoutStripes}, {"grid", LayoutGrid}};
+
+
+template <typename T> std::string nameOf(std::map<std::string, T> const& names, T val) {
+    for (auto const& n : names) {
+        if (n.second == val) return n.first;
+    }
+    return "?";
+}
+
+
+template <typename T> bool parseName(std::map<std::string, T> const& names, std::string const& str, T& val) {
+    auto const it = names.find(str);
+    if (it == names.end()) {
+        std::fprintf(stderr, "Unknown value \"%s\"\n", str.c_str());
+        return false;
+    }
+    val = it->second;
+    return true;
+}
+
+
+std::vector<std::string> splitList(std::string const& str) {
+    std::vector<std::string> ret;
+    std::istringstream stream(str);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) ret.push_back(item);
+    }
+    return ret;
+}
+
+
+double elapsedMs(bench_clock::time_point const& begin, bench_clock::time_point const& end) {
+    return std::chrono::duration<double, std::milli>(end - begin).count();
+}
+
+
+void printUsage(char const* exe) {
+    std::fprintf(stderr,
+        "Usage: %s [options]\n"
+        "  --comm zmq|mpi           communication fabric (default zmq, mpi requires mpiexec with nodes + 1 ranks)\n"
+        "  --nodes N                number of sender processes (zmq only, default 4)\n"
+        "  --hosts H,... --port P   sender i runs on host i (or on the only host given) and binds port P + i\n"
+        "                           (default 127.0.0.1 and 34242)\n"
+        "  --no-spawn               do not start the senders locally, e.g. to run them on other hosts\n"
+        "  --resolutions WxH,...    viewport sizes (default 1920x1080)\n"
+        "  --layouts L,...          tile layouts full, stripes, grid (default all)\n"
+        "  --color-codec C          raw, snappy, rle, delta (default snappy)\n"
+        "  --depth-codec C          raw, snappy, q16, q24 (default snappy)\n"
+        "  --frames N --warmup N    measured and discarded frames per configuration (default 100, 10)\n"
+        "  --timeout S              seconds to wait for a sender before giving up (default 30)\n"
+        "  --verify                 compare every frame against a locally composited reference\n"
+        "  --role sender --rank I   run as sender I, used when spawning the senders\n",
+        exe);
+}
+
+
+bool parseArgs(int argc, char* argv[], bench_config& cfg) {
+    for (int i = 1; i < argc; ++i) {
+        std::string const arg = argv[i];
+        bool const has_val = i + 1 < argc;
+        if (arg == "--no-spawn") {
+            cfg.spawn = false;
+        } else if (arg == "--verify") {
+            cfg.verify = true;
+        } else if (!has_val) {
+            return false;
+        } else if (arg == "--comm") {
+            cfg.comm = argv[++i];
+        } else if (arg == "--role") {
+            cfg.role = argv[++i];
+        } else if (arg == "--hosts" || arg == "--host") {
+            cfg.hosts = splitList(argv[++i]);
+        } else if (arg == "--port") {
+            cfg.port = std::atoi(argv[++i]);
+        } else if (arg == "--nodes") {
+            cfg.nodes = std::atoi(argv[++i]);
+        } else if (arg == "--rank") {
+            cfg.rank = std::atoi(argv[++i]);
+        } else if (arg == "--frames") {
+            cfg.frames = std::atoi(argv[++i]);
+        } else if (arg == "--warmup") {
+            cfg.warmup = std::atoi(argv[++i]);
+        } else if (arg == "--timeout") {
+            cfg.timeout = std::atoi(argv[++i]);
+        } else if (arg == "--resolutions") {
+            cfg.resolutions.clear();
+            for (auto const& res : splitList(argv[++i])) {
+                int w = 0, h = 0;
+                if (std::sscanf(res.c_str(), "%dx%d", &w, &h) != 2 || w <= 0 || h <= 0) return false;
+                cfg.resolutions.emplace_back(w, h);
+            }
+        } else if (arg == "--layouts") {
+            cfg.layouts.clear();
+            for (auto const& name : splitList(argv[++i])) {
+                bench_layout layout;
+                if (!parseName(layout_names, name, layout)) return false;
+                cfg.layouts.push_back(layout);
+            }
+        } else if (arg == "--color-codec") {
+            if (!parseName(color_codec_names, std::string(argv[++i]), cfg.color_codec)) return false;
+        } else if (arg == "--depth-codec") {
+            if (!parseName(depth_codec_names, std::string(argv[++i]), cfg.depth_codec)) return false;
+        } else {
+            return false;
+        }
+    }
+    return cfg.nodes > 0 && (cfg.hosts.size() == 1 || cfg.hosts.size() == static_cast<size_t>(cfg.nodes)) &&
+           cfg.frames > 0 && cfg.warmup >= 0 && cfg.timeout > 0 && !cfg.resolutions.empty() &&
+           !cfg.layouts.empty() && (cfg.comm == "zmq" || cfg.comm == "mpi") &&
+           (cfg.role == "compositor" || cfg.role == "sender");
+}
+
+
+/**
+ * Answer the updated area of a node within the viewport.
+ * Full overlap is the classic sort-last case, stripes and grid model nodes whose data project to disjoint regions.
+ */
+void tileOf(bench_layout layout, int node, int num_nodes, int width, int height, int tile[4]) {
+    switch (layout) {
+    case LayoutStripes:
+        tile[0] = 0;
+        tile[1] = static_cast<int>(static_cast<int64_t>(height) * node / num_nodes);
+        tile[2] = width;
+        tile[3] = static_cast<int>(static_cast<int64_t>(height) * (node + 1) / num_nodes);
+        break;
+    case LayoutGrid: {
+        auto const cols = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(num_nodes))));
+        auto const rows = (num_nodes + cols - 1) / cols;
+        auto const cx = node % cols;
+        auto const cy = node / cols;
+        tile[0] = static_cast<int>(static_cast<int64_t>(width) * cx / cols);
+        tile[1] = static_cast<int>(static_cast<int64_t>(height) * cy / rows);
+        tile[2] = static_cast<int>(static_cast<int64_t>(width) * (cx + 1) / cols);
+        tile[3] = static_cast<int>(static_cast<int64_t>(height) * (cy + 1) / rows);
+    } break;
+    case LayoutFull:
+    default:
+        tile[0] = 0;
+        tile[1] = 0;
+        tile[2] = width;
+        tile[3] = height;
+    }
+}
+
+
+/**
+ * Renders the synthetic tile of a node: shaded spheres in front of the far plane, moving with the frame id.
+ * The spheres of all nodes interleave in depth, so overlapping tiles need a real z-test.
+ * The color is RGBAu8 and the depth Df, as read back by FBOTransmitter2.
+ */
+void renderTile(int node, int num_nodes, unsigned int frame_id, int width, int height, int const tile[4],
+    std::vector<char>& color, std::vector<char>& depth) {
+    constexpr int spheres_per_node = 3;
+    constexpr float pi = 3.14159265358979f;
+
+    struct sphere {
+        float x, y, r, z;
+    } spheres[spheres_per_node];
+    auto const t = 0.01f * static_cast<float>(frame_id);
+    for (int s = 0; s < spheres_per_node; ++s) {
+        auto const idx = static_cast<float>(s * num_nodes + node);
+        auto const cnt = static_cast<float>(spheres_per_node * num_nodes);
+        auto const phase = 2.0f * pi * idx / cnt;
+        spheres[s].x = width * (0.5f + 0.35f * std::cos(phase + t));
+        spheres[s].y = height * (0.5f + 0.35f * std::sin(2.0f * phase + t));
+        spheres[s].r = 0.15f * static_cast<float>(std::min(width, height));
+        spheres[s].z = 0.25f + 0.5f * idx / cnt;
+    }
+    unsigned char const rgb[3] = {static_cast<unsigned char>(64 + (node * 97) % 192),
+        static_cast<unsigned char>(64 + (node * 57 + 85) % 192),
+        static_cast<unsigned char>(64 + (node * 151 + 170) % 192)};
+
+    auto const tile_w = tile[2] - tile[0];
+    auto const tile_h = tile[3] - tile[1];
+    color.resize(static_cast<size_t>(tile_w) * tile_h * sizeof(uint32_t));
+    depth.resize(static_cast<size_t>(tile_w) * tile_h * sizeof(float));
+
+#pragma omp parallel for
+    for (int64_t row = 0; row < tile_h; ++row) {
+        auto const py = static_cast<float>(tile[1] + row) + 0.5f;
+        for (int col = 0; col < tile_w; ++col) {
+            auto const px = static_cast<float>(tile[0] + col) + 0.5f;
+            float d = 1.0f;
+            unsigned char c[4] = {0, 0, 0, 0};
+            for (auto const& s : spheres) {
+                auto const dx = (px - s.x) / s.r;
+                auto const dy = (py - s.y) / s.r;
+                auto const r2 = dx * dx + dy * dy;
+                if (r2 >= 1.0f) continue;
+                auto const h = std::sqrt(1.0f - r2);
+                auto const z = s.z - 0.2f * h;
+                if (z < d) {
+                    d = z;
+                    auto const shade = 0.2f + 0.8f * h;
+                    for (int i = 0; i < 3; ++i) c[i] = static_cast<unsigned char>(shade * rgb[i]);
+                    c[3] = 255;
+                }
+            }
+            auto const idx = static_cast<size_t>(row) * tile_w + col;
+            std::memcpy(color.data() + idx * sizeof(uint32_t), c, sizeof(c));
+            std::memcpy(depth.data() + idx * sizeof(float), &d, sizeof(d));
+        }
+    }
+}
+
+
+/**
+ * CPU reference of the depth compositing done by FBOCompositor2 on the GPU: a strict less z-test,
+ * so on equal depth the node composited first wins.
+ */
+void compositeTile(int const tile[4], int width, std::vector<char> const& color, std::vector<char> const& depth,
+    std::vector<uint32_t>& out_color, std::vector<float>& out_depth) {
+    auto const tile_w = tile[2] - tile[0];
+    auto const tile_h = tile[3] - tile[1];
+#pragma omp parallel for
+    for (int64_t row = 0; row < tile_h; ++row) {
+        auto const dst = static_cast<size_t>(tile[1] + row) * width + tile[0];
+        auto const src = static_cast<size_t>(row) * tile_w;
+        for (int col = 0; col < tile_w; ++col) {
+            float d;
+            std::memcpy(&d, depth.data() + (src + col) * sizeof(float), sizeof(d));
+            if (d < out_depth[dst + col]) {
+                out_depth[dst + col] = d;
+                std::memcpy(&out_color[dst + col], color.data() + (src + col) * sizeof(uint32_t), sizeof(uint32_t));
+            }
+        }
+    }
+}
+
+
+bool sendRequest(FBOCommFabric& comm, bench_request const& req) {
+    std::vector<char> buf(sizeof(bench_request));
+    std::memcpy(buf.data(), &req, sizeof(req));
+    return comm.Send(buf, send_type::SEND);
+}
+
+
+/**
+ * Receives one answer from every sender. ZMQ receives do not block, so all senders are polled round robin.
+ */
+bool recvAll(std::vector<FBOCommFabric>& comms, std::vector<std::vector<char>>& replies, int timeout) {
+    std::vector<bool> pending(comms.size(), true);
+    size_t num_pending = comms.size();
+    auto const deadline = bench_clock::now() + std::chrono::seconds(timeout);
+    while (num_pending > 0) {
+        bool progress = false;
+        for (size_t i = 0; i < comms.size(); ++i) {
+            if (pending[i] && comms[i].Recv(replies[i], recv_type::RECV)) {
+                pending[i] = false;
+                --num_pending;
+                progress = true;
+            }
+        }
+        if (!progress) {
+            if (bench_clock::now() > deadline) return false;
+            std::this_thread::yield();
+        }
+    }
+    return true;
+}
+
+
+/**
+ * Sender loop, answers requests until it is asked to quit or no request arrived within the timeout.
+ */
+int runSender(FBOCommFabric& comm, int node, int timeout) {
+    std::vector<char> buf, color, depth, prev_color, color_enc, depth_enc;
+    auto last_request = bench_clock::now();
+
+    while (true) {
+        if (!comm.Recv(buf, recv_type::RECV)) {
+            if (bench_clock::now() - last_request > std::chrono::seconds(timeout)) {
+                std::fprintf(stderr, "Sender %d: no request within %d s, giving up\n", node, timeout);
+                return 1;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+        }
+        last_request = bench_clock::now();
+        if (buf.size() != sizeof(bench_request)) {
+            std::fprintf(stderr, "Sender %d: malformed request\n", node);
+            return 1;
+        }
+        bench_request req;
+        std::memcpy(&req, buf.data(), sizeof(req));
+
+        fbo_msg_header_t header;
+        std::memset(&header, 0, sizeof(header));
+        header.node_id = node;
+        header.frame_id = req.frame_id;
+        header.screen_area[2] = req.width;
+        header.screen_area[3] = req.height;
+        std::copy(req.tile, req.tile + 4, header.updated_area);
+        header.color_type = RGBAu8;
+        header.depth_type = Df;
+        header.color_codec = req.color_codec;
+        header.depth_codec = req.depth_codec;
+
+        if (req.flags & BenchQuit) {
+            buf.assign(reinterpret_cast<char*>(&header), reinterpret_cast<char*>(&header) + sizeof(header));
+            comm.Send(buf, send_type::SEND);
+            break;
+        }
+
+        renderTile(node, req.num_nodes, req.frame_id, req.width, req.height, req.tile, color, depth);
+        bool const keyframe = (req.flags & BenchKeyframe) || (prev_color.size() != color.size());
+        EncodeColor(req.color_codec, color, keyframe ? nullptr : &prev_color, color_enc);
+        EncodeDepth(req.depth_codec, depth, depth_enc);
+        header.flags = keyframe ? MsgKeyframe : 0u;
+        header.color_buf_size = color_enc.size();
+        header.depth_buf_size = depth_enc.size();
+
+        buf.resize(sizeof(header) + color_enc.size() + depth_enc.size());
+        std::memcpy(buf.data(), &header, sizeof(header));
+        std::copy(color_enc.begin(), color_enc.end(), buf.data() + sizeof(header));
+        std::copy(depth_enc.begin(), depth_enc.end(), buf.data() + sizeof(header) + color_enc.size());
+        if (!comm.Send(buf, send_type::SEND)) {
+            std::fprintf(stderr, "Sender %d: send failed\n", node);
+            return 1;
+        }
+        prev_color.swap(color);
+    }
+
+    comm.Disconnect();
+    return 0;
+}
+
+
+/**
+ * Runs all configurations against the connected senders and prints one result row per configuration.
+ */
+int runCompositor(std::vector<FBOCommFabric>& comms, bench_config const& cfg) {
+    auto const num_nodes = static_cast<int>(comms.size());
+    std::vector<std::vector<char>> replies(num_nodes);
+    std::vector<std::vector<char>> colors(num_nodes), depths(num_nodes), prev_colors(num_nodes);
+    std::vector<std::vector<char>> ref_color, ref_depth;
+    std::vector<fbo_msg_header_t> headers(num_nodes);
+    unsigned int frame_id = 0;
+    int ret = 0;
+
+    std::printf("%-8s %11s %5s %-6s %-6s %8s %8s %8s %8s %8s %8s %8s %8s %9s %9s %9s\n", "layout", "resolution",
+        "nodes", "color", "depth", "lat_ms", "p50_ms", "p95_ms", "max_ms", "xfer_ms", "dec_ms", "comp_ms", "fps",
+        "wire_MBs", "raw_MBs", "mismatch");
+
+    for (auto const& res : cfg.resolutions) {
+        auto const width = res.first;
+        auto const height = res.second;
+        std::vector<uint32_t> out_color(static_cast<size_t>(width) * height);
+        std::vector<float> out_depth(out_color.size());
+        std::vector<uint32_t> expected_color(cfg.verify ? out_color.size() : 0);
+        std::vector<float> expected_depth(expected_color.size());
+
+        for (auto const layout : cfg.layouts) {
+            std::vector<bench_request> reqs(num_nodes);
+            for (int i = 0; i < num_nodes; ++i) {
+                reqs[i].num_nodes = num_nodes;
+                reqs[i].width = width;
+                reqs[i].height = height;
+                tileOf(layout, i, num_nodes, width, height, reqs[i].tile);
+                reqs[i].color_codec = cfg.color_codec;
+                reqs[i].depth_codec = cfg.depth_codec;
+            }
+
+            std::vector<frame_stats> stats;
+            stats.reserve(cfg.frames);
+            size_t mismatches = 0;
+            auto measure_begin = bench_clock::now();
+
+            for (int frame = 0; frame < cfg.warmup + cfg.frames; ++frame, ++frame_id) {
+                if (frame == cfg.warmup) measure_begin = bench_clock::now();
+
+                auto const t0 = bench_clock::now();
+                for (int i = 0; i < num_nodes; ++i) {
+                    reqs[i].frame_id = frame_id;
+                    reqs[i].flags = (frame == 0) ? BenchKeyframe : 0u;
+                    if (!sendRequest(comms[i], reqs[i])) {
+                        std::fprintf(stderr, "Compositor: send to node %d failed\n", i);
+                        return 1;
+                    }
+                }
+                if (!recvAll(comms, replies, cfg.timeout)) {
+                    std::fprintf(stderr, "Compositor: no answer from all senders within %d s\n", cfg.timeout);
+                    return 1;
+                }
+                auto const t1 = bench_clock::now();
+
+                // one decoder per node, like the receiver threads of FBOCompositor2
+                int failed = 0;
+#pragma omp parallel for reduction(| : failed)
+                for (int64_t i = 0; i < num_nodes; ++i) {
+                    auto const& buf = replies[i];
+                    auto& header = headers[i];
+                    if (buf.size() < sizeof(header)) {
+                        failed |= 1;
+                        continue;
+                    }
+                    std::memcpy(&header, buf.data(), sizeof(header));
+                    auto const tile_px = static_cast<size_t>(header.updated_area[2] - header.updated_area[0]) *
+                                         (header.updated_area[3] - header.updated_area[1]);
+                    if (buf.size() < sizeof(header) + header.color_buf_size + header.depth_buf_size) {
+                        failed |= 1;
+                        continue;
+                    }
+                    colors[i].resize(tile_px * sizeof(uint32_t));
+                    depths[i].resize(tile_px * sizeof(float));
+                    auto const* base = (header.flags & MsgKeyframe) ? nullptr : &prev_colors[i];
+                    auto const* data = buf.data() + sizeof(header);
+                    if (!DecodeColor(header.color_codec, data, header.color_buf_size, base, colors[i]) ||
+                        !DecodeDepth(header.depth_codec, data + header.color_buf_size, header.depth_buf_size,
+                            depths[i])) {
+                        failed |= 1;
+                    }
+                }
+                if (failed != 0) {
+                    std::fprintf(stderr, "Compositor: could not decode frame %u\n", frame_id);
+                    return 1;
+                }
+                auto const t2 = bench_clock::now();
+
+                std::fill(out_color.begin(), out_color.end(), 0u);
+                std::fill(out_depth.begin(), out_depth.end(), 1.0f);
+                for (int i = 0; i < num_nodes; ++i) {
+                    compositeTile(headers[i].updated_area, width, colors[i], depths[i], out_color, out_depth);
+                }
+                auto const t3 = bench_clock::now();
+
+                if (frame >= cfg.warmup) {
+                    frame_stats fs;
+                    fs.latency = elapsedMs(t0, t3);
+                    fs.transfer = elapsedMs(t0, t1);
+                    fs.decode = elapsedMs(t1, t2);
+                    fs.composite = elapsedMs(t2, t3);
+                    fs.wire_bytes = 0;
+                    fs.raw_bytes = 0;
+                    for (int i = 0; i < num_nodes; ++i) {
+                        fs.wire_bytes += replies[i].size();
+                        fs.raw_bytes += colors[i].size() + depths[i].size();
+                    }
+                    stats.push_back(fs);
+                }
+
+                if (cfg.verify) {
+                    // render and composite all tiles locally, without any codec in between
+                    ref_color.resize(num_nodes);
+                    ref_depth.resize(num_nodes);
+                    std::fill(expected_color.begin(), expected_color.end(), 0u);
+                    std::fill(expected_depth.begin(), expected_depth.end(), 1.0f);
+                    for (int i = 0; i < num_nodes; ++i) {
+                        renderTile(i, num_nodes, frame_id, width, height, reqs[i].tile, ref_color[i], ref_depth[i]);
+                        compositeTile(reqs[i].tile, width, ref_color[i], ref_depth[i], expected_color, expected_depth);
+                    }
+                    for (size_t px = 0; px < out_color.size(); ++px) {
+                        if (out_color[px] != expected_color[px]) ++mismatches;
+                    }
+                }
+
+                for (int i = 0; i < num_nodes; ++i) {
+                    prev_colors[i].swap(colors[i]);
+                }
+            }
+            auto const measure_s = elapsedMs(measure_begin, bench_clock::now()) / 1000.0;
+
+            std::vector<double> latencies;
+            double transfer = 0.0, decode = 0.0, composite = 0.0, wire = 0.0, raw = 0.0;
+            for (auto const& fs : stats) {
+                latencies.push_back(fs.latency);
+                transfer += fs.transfer;
+                decode += fs.decode;
+                composite += fs.composite;
+                wire += static_cast<double>(fs.wire_bytes);
+                raw += static_cast<double>(fs.raw_bytes);
+            }
+            std::sort(latencies.begin(), latencies.end());
+            auto const cnt = static_cast<double>(latencies.size());
+            auto const mean = [cnt](double sum) { return sum / cnt; };
+            double lat_sum = 0.0;
+            for (auto const l : latencies) lat_sum += l;
+            auto const percentile = [&latencies](double p) {
+                return latencies[std::min(latencies.size() - 1, static_cast<size_t>(p * latencies.size()))];
+            };
+
+            std::printf("%-8s %5dx%-5d %5d %-6s %-6s %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.2f %8.1f %9.1f %9.1f %9zu\n",
+                nameOf(layout_names, layout).c_str(), width, height, num_nodes,
+                nameOf(color_codec_names, cfg.color_codec).c_str(), nameOf(depth_codec_names, cfg.depth_codec).c_str(),
+                mean(lat_sum), percentile(0.5), percentile(0.95), latencies.back(), mean(transfer), mean(decode),
+                mean(composite), cnt / measure_s, wire / measure_s / (1 << 20), raw / measure_s / (1 << 20),
+                mismatches);
+            std::fflush(stdout);
+            if (cfg.verify && mismatches > 0) ret = 2;
+        }
+    }
+
+    // release the senders
+    bench_request quit;
+    std::memset(&quit, 0, sizeof(quit));
+    quit.flags = BenchQuit;
+    for (auto& comm : comms) sendRequest(comm, quit);
+    recvAll(comms, replies, cfg.timeout);
+    for (auto& comm : comms) comm.Disconnect();
+
+    return ret;
+}
+
+} // namespace
+
+
+int main(int argc, char* argv[]) {
+    bench_config cfg;
+    if (!parseArgs(argc, argv, cfg)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    if (cfg.comm == "mpi") {
+#ifdef WITH_MPI
+        ::MPI_Init(&argc, &argv);
+        int rank = 0, size = 0;
+        ::MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+        ::MPI_Comm_size(MPI_COMM_WORLD, &size);
+        if (size < 2) {
+            std::fprintf(stderr, "MPI mode needs at least two ranks, rank 0 composites\n");
+            ::MPI_Finalize();
+            return 1;
+        }
+
+        int ret = 0;
+        if (rank == 0) {
+            std::vector<FBOCommFabric> comms;
+            for (int i = 1; i < size; ++i) {
+                comms.emplace_back(std::make_unique<MPICommFabric>(i, i));
+            }
+            ret = runCompositor(comms, cfg);
+        } else {
+            FBOCommFabric comm{std::make_unique<MPICommFabric>(0, 0)};
+            ret = runSender(comm, rank - 1, cfg.timeout);
+        }
+        ::MPI_Finalize();
+        return ret;
+#else
+        std::fprintf(stderr, "Built without MPI support\n");
+        return 1;
+#endif // WITH_MPI
+    }
+
+    if (cfg.role == "sender") {
+        FBOCommFabric comm{std::make_unique<ZMQCommFabric>(zmq::socket_type::rep)};
+        comm.Bind("tcp://*:" + std::to_string(cfg.port + cfg.rank));
+        return runSender(comm, cfg.rank, cfg.timeout);
+    }
+
+    // start the senders as separate processes of this executable
+    std::vector<std::thread> children;
+    if (cfg.spawn) {
+        for (int i = 0; i < cfg.nodes; ++i) {
+            auto const cmd = std::string("\"") + argv[0] + "\" --role sender --comm zmq --rank " + std::to_string(i) +
+                             " --port " + std::to_string(cfg.port) + " --timeout " + std::to_string(cfg.timeout);
+            children.emplace_back([cmd]() { std::system(cmd.c_str()); });
+        }
+    }
+
+    std::vector<FBOCommFabric> comms;
+    for (int i = 0; i < cfg.nodes; ++i) {
+        comms.emplace_back(std::make_unique<ZMQCommFabric>(zmq::socket_type::req));
+        auto const& host = cfg.hosts[(cfg.hosts.size() > 1) ? i : 0];
+        comms.back().Connect("tcp://" + host + ":" + std::to_string(cfg.port + i));
+    }
+
+    auto const ret = runCompositor(comms, cfg);
+
+    // senders time out on their own if the compositor bailed out
+    for (auto& c : children) c.join();
+    return ret;
+}
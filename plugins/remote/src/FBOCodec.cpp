@@ -0,0 +1,300 @@
+#include "stdafx.h"
+#include "FBOCodec.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+#include "snappy.h"
+
+
+namespace {
+
+/** raw bytes per independently coded chunk, multiple of the pixel size */
+constexpr size_t chunk_size = 1 << 20;
+
+/** chunk stream header: raw size and number of chunks, followed by the encoded size of each chunk */
+constexpr size_t stream_header_size = sizeof(uint64_t) + sizeof(uint32_t);
+
+using color_px_t = uint32_t;
+
+using run_length_t = uint16_t;
+
+constexpr size_t run_size = sizeof(run_length_t) + sizeof(color_px_t);
+
+
+template <typename ENC> void encodeChunks(char const* src, size_t size, ENC const& enc, std::vector<char>& out) {
+    auto const num_chunks = (size + chunk_size - 1) / chunk_size;
+    std::vector<std::vector<char>> chunks(num_chunks);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(num_chunks); ++i) {
+        auto const begin = static_cast<size_t>(i) * chunk_size;
+        enc(src + begin, std::min(chunk_size, size - begin), chunks[i]);
+    }
+
+    auto const raw_size = static_cast<uint64_t>(size);
+    auto const chunk_cnt = static_cast<uint32_t>(num_chunks);
+    size_t total = stream_header_size + num_chunks * sizeof(uint64_t);
+    for (auto const& c : chunks) total += c.size();
+    out.resize(total);
+
+    char* dst = out.data();
+    std::memcpy(dst, &raw_size, sizeof(raw_size));
+    dst += sizeof(raw_size);
+    std::memcpy(dst, &chunk_cnt, sizeof(chunk_cnt));
+    dst += sizeof(chunk_cnt);
+    for (auto const& c : chunks) {
+        auto const c_size = static_cast<uint64_t>(c.size());
+        std::memcpy(dst, &c_size, sizeof(c_size));
+        dst += sizeof(c_size);
+    }
+    for (auto const& c : chunks) {
+        std::copy(c.begin(), c.end(), dst);
+        dst += c.size();
+    }
+}
+
+
+template <typename DEC> bool decodeChunks(char const* src, size_t size, DEC const& dec, char* dst, size_t dst_size) {
+    if (size < stream_header_size) return false;
+    uint64_t raw_size = 0;
+    uint32_t chunk_cnt = 0;
+    std::memcpy(&raw_size, src, sizeof(raw_size));
+    std::memcpy(&chunk_cnt, src + sizeof(raw_size), sizeof(chunk_cnt));
+    if (raw_size != dst_size || chunk_cnt != (dst_size + chunk_size - 1) / chunk_size) return false;
+    if (size < stream_header_size + chunk_cnt * sizeof(uint64_t)) return false;
+
+    std::vector<size_t> offsets(chunk_cnt + 1);
+    offsets[0] = stream_header_size + chunk_cnt * sizeof(uint64_t);
+    for (uint32_t i = 0; i < chunk_cnt; ++i) {
+        uint64_t c_size = 0;
+        std::memcpy(&c_size, src + stream_header_size + i * sizeof(uint64_t), sizeof(c_size));
+        offsets[i + 1] = offsets[i] + static_cast<size_t>(c_size);
+        if (offsets[i + 1] > size) return false;
+    }
+
+    int failed = 0;
+#pragma omp parallel for reduction(| : failed)
+    for (int64_t i = 0; i < static_cast<int64_t>(chunk_cnt); ++i) {
+        auto const begin = static_cast<size_t>(i) * chunk_size;
+        if (!dec(src + offsets[i], offsets[i + 1] - offsets[i], dst + begin, std::min(chunk_size, dst_size - begin))) {
+            failed |= 1;
+        }
+    }
+    return failed == 0;
+}
+
+
+void snappyEncode(char const* src, size_t size, std::vector<char>& out) {
+    size_t comp_size = 0;
+    out.resize(snappy::MaxCompressedLength(size));
+    snappy::RawCompress(src, size, out.data(), &comp_size);
+    out.resize(comp_size);
+}
+
+
+bool snappyDecode(char const* src, size_t size, char* dst, size_t dst_size) {
+    size_t raw_size = 0;
+    return snappy::GetUncompressedLength(src, size, &raw_size) && (raw_size == dst_size) &&
+           snappy::RawUncompress(src, size, dst);
+}
+
+
+void rleEncode(char const* src, size_t size, std::vector<char>& out) {
+    auto const num_px = size / sizeof(color_px_t);
+    out.clear();
+    out.reserve(size / 4);
+    size_t px = 0;
+    while (px < num_px) {
+        color_px_t val;
+        std::memcpy(&val, src + px * sizeof(color_px_t), sizeof(val));
+        run_length_t len = 1;
+        while ((px + len < num_px) && (len < std::numeric_limits<run_length_t>::max()) &&
+               (std::memcmp(&val, src + (px + len) * sizeof(color_px_t), sizeof(val)) == 0)) {
+            ++len;
+        }
+        auto const pos = out.size();
+        out.resize(pos + run_size);
+        std::memcpy(out.data() + pos, &len, sizeof(len));
+        std::memcpy(out.data() + pos + sizeof(len), &val, sizeof(val));
+        px += len;
+    }
+}
+
+
+bool rleDecode(char const* src, size_t size, char* dst, size_t dst_size) {
+    auto const num_px = dst_size / sizeof(color_px_t);
+    if (size % run_size != 0) return false;
+    size_t px = 0;
+    for (size_t pos = 0; pos < size; pos += run_size) {
+        run_length_t len = 0;
+        color_px_t val;
+        std::memcpy(&len, src + pos, sizeof(len));
+        std::memcpy(&val, src + pos + sizeof(len), sizeof(val));
+        if (px + len > num_px) return false;
+        for (run_length_t i = 0; i < len; ++i, ++px) {
+            std::memcpy(dst + px * sizeof(color_px_t), &val, sizeof(val));
+        }
+    }
+    return px == num_px;
+}
+
+
+void xorBuffers(char const* lhs, char const* rhs, char* dst, size_t size) {
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(size); ++i) {
+        dst[i] = lhs[i] ^ rhs[i];
+    }
+}
+
+
+template <typename T> void quantizeDepth(std::vector<char> const& depth, std::vector<char>& out, size_t bytes) {
+    auto const num_px = depth.size() / sizeof(float);
+    auto const max_val = static_cast<double>((uint64_t{1} << (8 * bytes)) - 1);
+    out.resize(num_px * bytes);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(num_px); ++i) {
+        float d;
+        std::memcpy(&d, depth.data() + i * sizeof(float), sizeof(d));
+        auto const q = static_cast<T>(std::min(std::max(static_cast<double>(d), 0.0), 1.0) * max_val + 0.5);
+        // little endian, lowest bytes first
+        for (size_t b = 0; b < bytes; ++b) {
+            out[i * bytes + b] = static_cast<char>((q >> (8 * b)) & 0xff);
+        }
+    }
+}
+
+
+template <typename T> void dequantizeDepth(std::vector<char> const& in, std::vector<char>& depth, size_t bytes) {
+    auto const num_px = depth.size() / sizeof(float);
+    auto const max_val = static_cast<double>((uint64_t{1} << (8 * bytes)) - 1);
+#pragma omp parallel for
+    for (int64_t i = 0; i < static_cast<int64_t>(num_px); ++i) {
+        T q = 0;
+        for (size_t b = 0; b < bytes; ++b) {
+            q |= static_cast<T>(static_cast<unsigned char>(in[i * bytes + b])) << (8 * b);
+        }
+        auto const d = static_cast<float>(static_cast<double>(q) / max_val);
+        std::memcpy(depth.data() + i * sizeof(float), &d, sizeof(d));
+    }
+}
+
+} // namespace
+
+
+megamol::remote::fbo_codec_offer megamol::remote::SupportedCodecs(void) {
+    fbo_codec_offer offer;
+    offer.version = fbo_proto_version;
+    offer.color_codecs = (1u << ColRaw) | (1u << ColSnappy) | (1u << ColRLE) | (1u << ColDelta);
+    offer.depth_codecs = (1u << DepthRaw) | (1u << DepthSnappy) | (1u << DepthQ16) | (1u << DepthQ24);
+    return offer;
+}
+
+
+void megamol::remote::EncodeColor(
+    fbo_color_codec codec, std::vector<char> const& color, std::vector<char> const* base, std::vector<char>& out) {
+    switch (codec) {
+    case ColRaw:
+        out = color;
+        break;
+    case ColRLE:
+        encodeChunks(color.data(), color.size(), rleEncode, out);
+        break;
+    case ColDelta:
+        if (base != nullptr && base->size() == color.size()) {
+            // unchanged pixels become zero and compress to almost nothing
+            std::vector<char> delta(color.size());
+            xorBuffers(color.data(), base->data(), delta.data(), delta.size());
+            encodeChunks(delta.data(), delta.size(), snappyEncode, out);
+        } else {
+            encodeChunks(color.data(), color.size(), snappyEncode, out);
+        }
+        break;
+    case ColSnappy:
+    default:
+        encodeChunks(color.data(), color.size(), snappyEncode, out);
+    }
+}
+
+
+bool megamol::remote::DecodeColor(
+    fbo_color_codec codec, char const* data, size_t size, std::vector<char> const* base, std::vector<char>& color) {
+    switch (codec) {
+    case ColRaw:
+        if (size != color.size()) return false;
+        std::copy(data, data + size, color.begin());
+        return true;
+    case ColRLE:
+        return decodeChunks(data, size, rleDecode, color.data(), color.size());
+    case ColDelta:
+        if (!decodeChunks(data, size, snappyDecode, color.data(), color.size())) return false;
+        if (base != nullptr) {
+            if (base->size() != color.size()) return false;
+            xorBuffers(color.data(), base->data(), color.data(), color.size());
+        }
+        return true;
+    case ColSnappy:
+        return decodeChunks(data, size, snappyDecode, color.data(), color.size());
+    default:
+        return false;
+    }
+}
+
+
+void megamol::remote::EncodeDepth(fbo_depth_codec codec, std::vector<char> const& depth, std::vector<char>& out) {
+    switch (codec) {
+    case DepthRaw:
+        out = depth;
+        break;
+    case DepthQ16: {
+        std::vector<char> quant;
+        quantizeDepth<uint16_t>(depth, quant, 2);
+        encodeChunks(quant.data(), quant.size(), snappyEncode, out);
+    } break;
+    case DepthQ24: {
+        std::vector<char> quant;
+        quantizeDepth<uint32_t>(depth, quant, 3);
+        encodeChunks(quant.data(), quant.size(), snappyEncode, out);
+    } break;
+    case DepthSnappy:
+    default:
+        encodeChunks(depth.data(), depth.size(), snappyEncode, out);
+    }
+}
+
+
+bool megamol::remote::DecodeDepth(fbo_depth_codec codec, char const* data, size_t size, std::vector<char>& depth) {
+    switch (codec) {
+    case DepthRaw:
+        if (size != depth.size()) return false;
+        std::copy(data, data + size, depth.begin());
+        return true;
+    case DepthQ16:
+    case DepthQ24: {
+        size_t const bytes = (codec == DepthQ16) ? 2 : 3;
+        std::vector<char> quant((depth.size() / sizeof(float)) * bytes);
+        if (!decodeChunks(data, size, snappyDecode, quant.data(), quant.size())) return false;
+        if (codec == DepthQ16) {
+            dequantizeDepth<uint16_t>(quant, depth, bytes);
+        } else {
+            dequantizeDepth<uint32_t>(quant, depth, bytes);
+        }
+        return true;
+    }
+    case DepthSnappy:
+        return decodeChunks(data, size, snappyDecode, depth.data(), depth.size());
+    default:
+        return false;
+    }
+}
+
+
+void megamol::remote::EncodeSnappyBlock(std::vector<char> const& in, std::vector<char>& out) {
+    snappyEncode(in.data(), in.size(), out);
+}
+
+
+bool megamol::remote::DecodeSnappyBlock(char const* data, size_t size, std::vector<char>& out) {
+    return snappyDecode(data, size, out.data(), out.size());
+}
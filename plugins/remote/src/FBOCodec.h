@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "FBOProto.h"
+
+namespace megamol {
+namespace remote {
+
+/**
+ * Answer the codecs implemented by this build, to be offered during the handshake.
+ */
+fbo_codec_offer SupportedCodecs(void);
+
+/**
+ * Encodes a RGBAu8 color buffer.
+ * Compressing codecs work on independent chunks of the buffer in parallel.
+ *
+ * @param codec The codec to use.
+ * @param color The color buffer.
+ * @param base  The color buffer of the previous message for ColDelta, nullptr for a keyframe.
+ * @param out   Receives the encoded buffer.
+ */
+void EncodeColor(fbo_color_codec codec, std::vector<char> const& color, std::vector<char> const* base,
+    std::vector<char>& out);
+
+/**
+ * Decodes a RGBAu8 color buffer.
+ *
+ * @param codec The codec of the encoded buffer.
+ * @param data  The encoded buffer.
+ * @param size  The size of the encoded buffer in bytes.
+ * @param base  The color buffer of the previous message for ColDelta, nullptr for a keyframe.
+ * @param color The color buffer, has to be resized to the expected size in advance.
+ *
+ * @return True on success, false if the encoded buffer does not match the expected size.
+ */
+bool DecodeColor(fbo_color_codec codec, char const* data, size_t size, std::vector<char> const* base,
+    std::vector<char>& color);
+
+/**
+ * Encodes a Df depth buffer.
+ *
+ * @param codec The codec to use.
+ * @param depth The depth buffer.
+ * @param out   Receives the encoded buffer.
+ */
+void EncodeDepth(fbo_depth_codec codec, std::vector<char> const& depth, std::vector<char>& out);
+
+/**
+ * Decodes a Df depth buffer.
+ *
+ * @param codec The codec of the encoded buffer.
+ * @param data  The encoded buffer.
+ * @param size  The size of the encoded buffer in bytes.
+ * @param depth The depth buffer, has to be resized to the expected size in advance.
+ *
+ * @return True on success, false if the encoded buffer does not match the expected size.
+ */
+bool DecodeDepth(fbo_depth_codec codec, char const* data, size_t size, std::vector<char>& depth);
+
+/**
+ * Encodes a buffer as a single snappy block, the format of protocol version 1.
+ *
+ * @param in  The raw buffer.
+ * @param out Receives the encoded buffer.
+ */
+void EncodeSnappyBlock(std::vector<char> const& in, std::vector<char>& out);
+
+/**
+ * Decodes a buffer encoded by EncodeSnappyBlock.
+ *
+ * @param data The encoded buffer.
+ * @param size The size of the encoded buffer in bytes.
+ * @param out  The raw buffer, has to be resized to the expected size in advance.
+ *
+ * @return True on success, false if the encoded buffer does not match the expected size.
+ */
+bool DecodeSnappyBlock(char const* data, size_t size, std::vector<char>& out);
+
+} // end namespace remote
+} // end namespace megamol
@@ -35,10 +35,13 @@ bool megamol::remote::MPICommFabric::Send(std::vector<char> const& buf, send_typ
 bool megamol::remote::MPICommFabric::Recv(std::vector<char>& buf, recv_type const type) {
 #ifdef WITH_MPI
     MPI_Status stat;
-    buf.resize(recv_count_);
     // TODO this is wrong. mpiprovider gives you the correct comm
-    auto status = MPI_Recv(buf.data(), recv_count_, MPI_CHAR, source_rank_, 0, MPI_COMM_WORLD, &stat);
+    // probe first, the size of the next message is not known in advance
+    auto status = MPI_Probe(source_rank_, 0, MPI_COMM_WORLD, &stat);
+    if (status != MPI_SUCCESS) return false;
     MPI_Get_count(&stat, MPI_CHAR, &recv_count_);
+    buf.resize(recv_count_);
+    status = MPI_Recv(buf.data(), recv_count_, MPI_CHAR, source_rank_, 0, MPI_COMM_WORLD, &stat);
     return status == MPI_SUCCESS;
 #else 
     return false;
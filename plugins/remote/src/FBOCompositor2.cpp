@@ -1,6 +1,7 @@
 #include "stdafx.h"
 #include "FBOCompositor2.h"
 
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -15,7 +16,7 @@
 #include "mmcore/view/Camera_2.h"
 #include "mmcore/utility/log/Log.h"
 
-#include "snappy.h"
+#include "FBOCodec.h"
 
 #include <exception>
 #include "vislib/Exception.h"
@@ -32,6 +33,8 @@ megamol::remote::FBOCompositor2::FBOCompositor2()
     , handshakePortSlot_{"handshakePort", "Port for ZMQ handshake"}
     , startSlot_{"start", "Start listening for connections"}
     , restartSlot_{"restart", "Restart compositor to wait for incoming connections"}
+    , colorCodecSlot_{"colorCodec", "Codec requested from the rendernodes for the color buffer"}
+    , depthCodecSlot_{"depthCodec", "Codec requested from the rendernodes for the depth buffer"}
     , renderOnlyRequestedFramesSlot_{"only_requested_frames",
           "Required to be set for cinematic rendering. If true, rendering is skipped until frame for requested camera "
           "and time is received."}
@@ -64,6 +67,20 @@ megamol::remote::FBOCompositor2::FBOCompositor2()
     this->MakeSlotAvailable(&targetBandwidthSlot_);
     numRendernodesSlot_ << new megamol::core::param::IntParam(1, 1, std::numeric_limits<int>::max());
     this->MakeSlotAvailable(&numRendernodesSlot_);
+    auto col_ep = new megamol::core::param::EnumParam(ColSnappy);
+    col_ep->SetTypePair(ColRaw, "Raw");
+    col_ep->SetTypePair(ColSnappy, "Snappy");
+    col_ep->SetTypePair(ColRLE, "RLE");
+    col_ep->SetTypePair(ColDelta, "Delta");
+    colorCodecSlot_ << col_ep;
+    this->MakeSlotAvailable(&colorCodecSlot_);
+    auto depth_ep = new megamol::core::param::EnumParam(DepthSnappy);
+    depth_ep->SetTypePair(DepthRaw, "Raw");
+    depth_ep->SetTypePair(DepthSnappy, "Snappy");
+    depth_ep->SetTypePair(DepthQ16, "Quantized16");
+    depth_ep->SetTypePair(DepthQ24, "Quantized24");
+    depthCodecSlot_ << depth_ep;
+    this->MakeSlotAvailable(&depthCodecSlot_);
     startSlot_ << new megamol::core::param::ButtonParam(core::view::Key::KEY_F10);
     startSlot_.SetUpdateCallback(&FBOCompositor2::startCallback);
     this->MakeSlotAvailable(&startSlot_);
@@ -391,15 +408,30 @@ bool megamol::remote::FBOCompositor2::initThreads() {
 }
 
 
-void megamol::remote::FBOCompositor2::receiverJob(
-    FBOCommFabric& comm, core::utility::sys::FutureReset<fbo_msg_t>* fbo_msg_future, std::future<bool>&& close) {
+void megamol::remote::FBOCompositor2::receiverJob(FBOCommFabric& comm,
+    core::utility::sys::FutureReset<fbo_msg_t>* fbo_msg_future, std::future<bool>&& close,
+    unsigned int proto_version) {
     try {
+        auto const header_size = fbo_msg_header_size(proto_version);
+
+        // last decoded message, reused for unchanged frames and base of delta frames
+        fbo_msg_t prev_msg;
+        bool has_prev_msg = false;
+        // a delta could not be applied, frames are dropped until the next keyframe
+        bool need_keyframe = false;
+        // decode targets, swapped with the buffers of prev_msg
+        std::vector<char> col_buf;
+        std::vector<char> depth_buf;
+
         while (!shutdown_) {
             auto const status = close.wait_for(std::chrono::milliseconds(1));
             if (status == std::future_status::ready) break;
 
-            // send a request for data
+            // send a request for data, a trailing 'k' asks for a keyframe
             std::vector<char> buf{'r', 'e', 'q'};
+            if (need_keyframe && proto_version >= 2) {
+                buf.push_back('k');
+            }
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOCompositor2: Sending request\n");
@@ -443,10 +475,18 @@ void megamol::remote::FBOCompositor2::receiverJob(
                 megamol::core::utility::log::Log::DefaultLog.WriteError("FBOCompositor2: Exception during recv in 'receiverJob'\n");
             }
 
-            fbo_msg_header_t header;
+            if (buf.size() < header_size) continue;
+
+            // version 1 headers end in front of the codecs, their buffers are single snappy blocks
+            fbo_msg_header_t header{};
             char* buf_ptr = buf.data();
-            std::copy(buf_ptr, buf_ptr + sizeof(fbo_msg_header_t), reinterpret_cast<char*>(&header));
-            buf_ptr += sizeof(fbo_msg_header_t);
+            std::copy(buf_ptr, buf_ptr + header_size, reinterpret_cast<char*>(&header));
+            buf_ptr += header_size;
+            if (proto_version < 2) {
+                header.color_codec = ColSnappy;
+                header.depth_codec = DepthSnappy;
+                header.flags = MsgKeyframe;
+            }
             size_t fbo_depth_size;
             auto vol =
                 (header.updated_area[2] - header.updated_area[0]) * (header.updated_area[3] - header.updated_area[1]);
@@ -454,33 +494,59 @@ void megamol::remote::FBOCompositor2::receiverJob(
             fbo_col_size *= static_cast<size_t>(col_buf_el_size_);
             fbo_depth_size *= static_cast<size_t>(depth_buf_el_size_);
 
-            if (header.depth_buf_size <= 1 || header.color_buf_size <= 1) {
+            if (header.flags & MsgUnchanged) {
+                if (!has_prev_msg || need_keyframe) continue;
+                while (!shutdown_) {
+                    try {
+                        fbo_msg_future->SetPromise(prev_msg);
+                        break;
+                    } catch (std::future_error const& e) {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                    }
+                }
+                continue;
+            }
+
+            bool const keyframe = (header.flags & MsgKeyframe) != 0;
+            if (need_keyframe && !keyframe) continue;
+
+            if (header.depth_buf_size == 0 || header.color_buf_size == 0 ||
+                buf.size() < header_size + header.color_buf_size + header.depth_buf_size) {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteWarn(
                     "FBOCompositor2: Bad size for alloc color/depth; col_buf size: %d; col_comp_buf size: %d; "
                     "depth_buf size: %d; depth_comp_buf size: %d;\n",
                     fbo_col_size, header.color_buf_size, fbo_depth_size, header.depth_buf_size);
 #endif
+                need_keyframe = true;
                 continue;
             }
 
-            std::vector<char> col_buf(fbo_col_size);
-            std::vector<char> col_comp_buf(header.color_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.color_buf_size, col_comp_buf.begin());
-            buf_ptr += header.color_buf_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::vector<char> depth_comp_buf(header.depth_buf_size);
-            std::copy(buf_ptr, buf_ptr + header.depth_buf_size, depth_comp_buf.begin());
-
-            // snappy uncompress
-            snappy::RawUncompress(col_comp_buf.data(), col_comp_buf.size(), col_buf.data());
-            snappy::RawUncompress(depth_comp_buf.data(), depth_comp_buf.size(), depth_buf.data());
-
-            /*std::vector<char> col_buf(fbo_col_size);
-            std::copy(buf_ptr, buf_ptr + fbo_col_size, col_buf.begin());
-            buf_ptr += fbo_col_size;
-            std::vector<char> depth_buf(fbo_depth_size);
-            std::copy(buf_ptr, buf_ptr + fbo_depth_size, depth_buf.begin());*/
+            // decode
+            col_buf.resize(fbo_col_size);
+            depth_buf.resize(fbo_depth_size);
+            bool decoded = false;
+            if (proto_version < 2) {
+                decoded = DecodeSnappyBlock(buf_ptr, header.color_buf_size, col_buf) &&
+                          DecodeSnappyBlock(buf_ptr + header.color_buf_size, header.depth_buf_size, depth_buf);
+            } else {
+                auto const* col_base = (has_prev_msg && !keyframe) ? &prev_msg.color_buf : nullptr;
+                decoded = !(header.color_codec == ColDelta && !keyframe && col_base == nullptr) &&
+                          DecodeColor(header.color_codec, buf_ptr, header.color_buf_size, col_base, col_buf) &&
+                          DecodeDepth(header.depth_codec, buf_ptr + header.color_buf_size, header.depth_buf_size,
+                              depth_buf);
+            }
+            if (!decoded) {
+#if _DEBUG
+                megamol::core::utility::log::Log::DefaultLog.WriteWarn(
+                    "FBOCompositor2: Could not decode message with color codec %u and depth codec %u\n",
+                    header.color_codec, header.depth_codec);
+#endif
+                // the delta base is lost, do not show anything until the transmitter sends a keyframe
+                need_keyframe = true;
+                continue;
+            }
+            need_keyframe = false;
 
 #ifdef _DEBUG
             megamol::core::utility::log::Log::DefaultLog.WriteInfo(
@@ -488,11 +554,15 @@ void megamol::remote::FBOCompositor2::receiverJob(
                 depth_buf.size());
 #endif
 
-            auto const msg = fbo_msg{std::move(header), std::move(col_buf), std::move(depth_buf)};
+            // the decoded buffers become the new base, the old ones are recycled for the next frame
+            prev_msg.fbo_msg_header = header;
+            swap(prev_msg.color_buf, col_buf);
+            swap(prev_msg.depth_buf, depth_buf);
+            has_prev_msg = true;
 
             while (!shutdown_) {
                 try {
-                    fbo_msg_future->SetPromise(msg);
+                    fbo_msg_future->SetPromise(prev_msg);
                     break;
                 } catch (std::future_error const& e) {
                     std::this_thread::sleep_for(std::chrono::milliseconds(1));
@@ -537,8 +607,9 @@ void megamol::remote::FBOCompositor2::collectorJob(std::vector<FBOCommFabric>&&
             auto close_sig_fut = close_sig.get_future();
             recv_close_sig.emplace_back(std::move(close_sig));
             // fbo_msg_futures.emplace_back();
+            auto const proto_version = (i < this->proto_versions_.size()) ? this->proto_versions_[i] : 1u;
             jobs.emplace_back(&FBOCompositor2::receiverJob, this, std::ref(comm), fbo_msg_futures[i].GetPtr(),
-                std::move(close_sig_fut));
+                std::move(close_sig_fut), proto_version);
             i += 1;
         }
 
@@ -690,19 +761,33 @@ void megamol::remote::FBOCompositor2::registerJob(std::vector<std::string>& addr
                 megamol::core::utility::log::Log::DefaultLog.WriteError(
                     "FBOCompositor2: Failed to recv on register socket %s\n", e.what());
             }
-            std::string str{buf.begin(), buf.end()};
+            // the address may be followed by the codecs the transmitter supports
+            auto const name_end = std::find(buf.begin(), buf.end(), '\0');
+            std::string str{buf.begin(), name_end};
+            fbo_codec_offer offer;
+            offer.version = 1;
+            offer.color_codecs = 1u << ColSnappy;
+            offer.depth_codecs = 1u << DepthSnappy;
+            if (name_end != buf.end() &&
+                static_cast<size_t>(std::distance(name_end, buf.end())) == 1 + sizeof(fbo_codec_offer)) {
+                std::copy(name_end + 1, buf.end(), reinterpret_cast<char*>(&offer));
+            }
+            auto const choice = this->chooseCodecs(offer);
 
             if (shutdown_) break;
 #if _DEBUG
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOCompositor2: Received address: %s\n", str.c_str());
 #endif
             addresses.push_back(str);
+            this->proto_versions_.push_back(choice.version);
 
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOCompositor2: Sending client ack\n");
 #endif
-                registerComm_.Send(buf);
+                std::vector<char> ack(reinterpret_cast<char const*>(&choice),
+                    reinterpret_cast<char const*>(&choice) + sizeof(fbo_codec_choice));
+                registerComm_.Send(ack);
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOCompositor2: Sent client ack\n");
 #endif
@@ -720,6 +805,25 @@ void megamol::remote::FBOCompositor2::registerJob(std::vector<std::string>& addr
 }
 
 
+megamol::remote::fbo_codec_choice megamol::remote::FBOCompositor2::chooseCodecs(
+    fbo_codec_offer const& offer) const {
+    // fall back to snappy, which every transmitter supports
+    fbo_codec_choice choice;
+    choice.version = std::min(offer.version, fbo_proto_version);
+    choice.color_codec = static_cast<fbo_color_codec>(
+        this->colorCodecSlot_.Param<megamol::core::param::EnumParam>()->Value());
+    choice.depth_codec = static_cast<fbo_depth_codec>(
+        this->depthCodecSlot_.Param<megamol::core::param::EnumParam>()->Value());
+    if (!(offer.color_codecs & (1u << choice.color_codec))) {
+        choice.color_codec = ColSnappy;
+    }
+    if (!(offer.depth_codecs & (1u << choice.depth_codec))) {
+        choice.depth_codec = DepthSnappy;
+    }
+    return choice;
+}
+
+
 void megamol::remote::FBOCompositor2::initTextures(size_t n, GLsizei width, GLsizei heigth) {
     glActiveTexture(GL_TEXTURE0);
 
@@ -69,13 +69,16 @@ private:
         data_has_changed_.store(true);
     }
 
-    void receiverJob(
-        FBOCommFabric& comm, core::utility::sys::FutureReset<fbo_msg_t>* fbo_msg_future, std::future<bool>&& close);
+    void receiverJob(FBOCommFabric& comm, core::utility::sys::FutureReset<fbo_msg_t>* fbo_msg_future,
+        std::future<bool>&& close, unsigned int proto_version);
 
     void collectorJob(std::vector<FBOCommFabric>&& comms);
 
     void registerJob(std::vector<std::string>& addresses);
 
+    /** Selects the requested codecs if offered by a transmitter */
+    fbo_codec_choice chooseCodecs(fbo_codec_offer const& offer) const;
+
     void initTextures(size_t n, GLsizei width, GLsizei heigth);
 
     void resize(size_t n, GLsizei width, GLsizei height);
@@ -116,6 +119,10 @@ private:
 
     megamol::core::param::ParamSlot restartSlot_;
 
+    megamol::core::param::ParamSlot colorCodecSlot_;
+
+    megamol::core::param::ParamSlot depthCodecSlot_;
+
     megamol::core::param::ParamSlot renderOnlyRequestedFramesSlot_;
 
     // megamol::core::utility::gl::FramebufferObject fbo_;
@@ -196,6 +203,9 @@ private:
 
     std::vector<std::string> addresses_;
 
+    /** protocol versions negotiated with the transmitters, in the order of addresses_ */
+    std::vector<unsigned int> proto_versions_;
+
     std::vector<unsigned char> img_data_;
 
     // std::shared_ptr<unsigned char[]> img_data_ptr_;
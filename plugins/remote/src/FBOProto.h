@@ -1,7 +1,9 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 #include <memory>
+#include <vector>
 
 
 namespace megamol {
@@ -74,6 +76,37 @@ enum fbo_color_type : unsigned int { RGBAf, RGBAu8, RGBf, RGBu8 };
 
 enum fbo_depth_type : unsigned int { Df, Du16, Du24, Du32 };
 
+/// encoding of the color buffer on the wire, decoded to RGBAu8
+enum fbo_color_codec : unsigned int { ColRaw, ColSnappy, ColRLE, ColDelta };
+
+/// encoding of the depth buffer on the wire, decoded to Df
+enum fbo_depth_codec : unsigned int { DepthRaw, DepthSnappy, DepthQ16, DepthQ24 };
+
+/// wire protocol version, negotiated during the handshake
+/// 1: header up to depth_buf_size, color and depth each compressed as a single snappy block
+/// 2: full header with codecs and flags, buffers coded by FBOCodec, keyframe requests
+constexpr unsigned int fbo_proto_version = 2;
+
+/// message flags
+enum fbo_msg_flags : unsigned int {
+    MsgKeyframe = 1u << 0, ///< color does not depend on a previous message
+    MsgUnchanged = 1u << 1 ///< no new frame, the receiver reuses the previous message
+};
+
+/// codecs supported by a transmitter, sent with its address during the handshake
+struct fbo_codec_offer {
+    unsigned int version;      ///< highest protocol version of the transmitter
+    unsigned int color_codecs; ///< bit mask of fbo_color_codec
+    unsigned int depth_codecs; ///< bit mask of fbo_depth_codec
+};
+
+/// codecs selected by the compositor, sent as acknowledgement of the handshake
+struct fbo_codec_choice {
+    unsigned int version; ///< protocol version used for the messages
+    fbo_color_codec color_codec;
+    fbo_depth_codec depth_codec;
+};
+
 using data_ptr = char*;
 
 using id_t = unsigned int;
@@ -103,10 +136,24 @@ struct fbo_msg_header {
     size_t color_buf_size;
     // depth buf size
     size_t depth_buf_size;
+    // color codec
+    fbo_color_codec color_codec;
+    // depth codec
+    fbo_depth_codec depth_codec;
+    // fbo_msg_flags
+    unsigned int flags;
 };
 
 using fbo_msg_header_t = fbo_msg_header;
 
+/// size of the protocol version 1 header, which ends in front of color_codec
+constexpr size_t fbo_msg_header_v1_size = offsetof(fbo_msg_header, color_codec);
+
+/// answer the size of the message header in a protocol version
+inline size_t fbo_msg_header_size(unsigned int version) {
+    return (version >= 2) ? sizeof(fbo_msg_header_t) : fbo_msg_header_v1_size;
+}
+
 struct fbo_msg {
     fbo_msg() = default;
 
@@ -1,11 +1,12 @@
 #include "stdafx.h"
 #include "FBOTransmitter2.h"
 
+#include <algorithm>
 #include <array>
 
 #include "glad/glad.h"
 
-#include "snappy.h"
+#include "FBOCodec.h"
 
 #include "mmcore/utility/log/Log.h"
 
@@ -47,12 +48,22 @@ megamol::remote::FBOTransmitter2::FBOTransmitter2()
     , aggregate_{false}
     , frame_id_{0}
     , thread_stop_{false}
+    , new_frame_{false}
+    , encoded_ready_{false}
     , fbo_msg_read_{new fbo_msg_header_t}
     , fbo_msg_send_{new fbo_msg_header_t}
     , color_buf_read_{new std::vector<char>}
     , depth_buf_read_{new std::vector<char>}
     , color_buf_send_{new std::vector<char>}
     , depth_buf_send_{new std::vector<char>}
+    , fbo_msg_enc_{new fbo_msg_header_t}
+    , color_buf_enc_{new std::vector<char>}
+    , depth_buf_enc_{new std::vector<char>}
+    , frames_since_keyframe_{0}
+    , force_keyframe_{false}
+    , proto_version_{1}
+    , color_codec_{ColSnappy}
+    , depth_codec_{DepthSnappy}
     , col_buf_el_size_{4}
     , depth_buf_el_size_{4}
     , connected_{false}
@@ -311,84 +322,54 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
                 megamol::core::utility::log::Log::DefaultLog.WriteError("FBOTransmitter2: Exception during recv in 'transmitterJob'\n");
             }
 
-            // wait for request
+            // a request ending in 'k' asks for a keyframe
+            if (buf.size() == 4 && buf[3] == 'k') {
+                this->force_keyframe_.store(true);
+            }
+
+            // take the latest encoded message
             {
                 std::lock_guard<std::mutex> send_lock(this->buffer_send_guard_);
-
-                //#ifdef WITH_MPI
-                //            IceTUByte* icet_col_buf = nullptr;
-                //            IceTFloat* icet_depth_buf = nullptr;
-                //            if (aggregate_) {
-                //#if _DEBUG
-                //                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Complex IceT commit at rank
-                //                %d\n", rank_);
-                //#endif
-                //                std::array<IceTFloat, 4> backgroundColor = {0, 0, 0, 0};
-                //                auto const icet_comp_image = icetCompositeImage(this->color_buf_send_->data(),
-                //                    this->depth_buf_send_->data(), nullptr, nullptr, nullptr, backgroundColor.data());
-                //#if _DEBUG
-                //                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Recieved IceT image at rank
-                //                %d\n", rank_);
-                //#endif
-                //                icet_col_buf = icetImageGetColorub(icet_comp_image);
-                //                icet_depth_buf = icetImageGetDepthf(icet_comp_image);
-                //            }
-                //#endif
-
-                // snappy compression
-                std::vector<char> col_comp_buf(snappy::MaxCompressedLength(this->color_buf_send_->size()));
-                std::vector<char> depth_comp_buf(snappy::MaxCompressedLength(this->depth_buf_send_->size()));
-                size_t col_comp_size = 0;
-                size_t depth_comp_size = 0;
-
-                // if (aggregate_) {
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_col_buf), this->color_buf_send_->size(),
-                //        col_comp_buf.data(), &col_comp_size);
-                //    snappy::RawCompress(reinterpret_cast<char*>(icet_depth_buf), this->depth_buf_send_->size(),
-                //        depth_comp_buf.data(), &depth_comp_size);
-                //} else {
-                snappy::RawCompress(
-                    this->color_buf_send_->data(), this->color_buf_send_->size(), col_comp_buf.data(), &col_comp_size);
-                snappy::RawCompress(this->depth_buf_send_->data(), this->depth_buf_send_->size(), depth_comp_buf.data(),
-                    &depth_comp_size);
-                //}
-
-                fbo_msg_send_->color_buf_size = col_comp_size;
-                fbo_msg_send_->depth_buf_size = depth_comp_size;
-                // compose message from header, color_buf, and depth_buf
-                buf.resize(sizeof(fbo_msg_header_t) + col_comp_size + depth_comp_size);
-                std::copy(reinterpret_cast<char*>(&(*fbo_msg_send_)),
-                    reinterpret_cast<char*>(&(*fbo_msg_send_)) + sizeof(fbo_msg_header_t), buf.data());
-                /*std::copy(
-                    this->color_buf_send_->begin(), this->color_buf_send_->end(), buf.data() +
-                sizeof(fbo_msg_header_t)); std::copy(this->depth_buf_send_->begin(), this->depth_buf_send_->end(),
-                    buf.data() + sizeof(fbo_msg_header_t) + this->color_buf_send_->size());*/
-                std::copy(
-                    col_comp_buf.data(), col_comp_buf.data() + col_comp_size, buf.data() + sizeof(fbo_msg_header_t));
-                std::copy(depth_comp_buf.data(), depth_comp_buf.data() + depth_comp_size,
-                    buf.data() + sizeof(fbo_msg_header_t) + col_comp_size);
-
-                // send data
-                try {
-#if _DEBUG
-                    megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Sending answer\n");
-#endif
-                    if (!this->comm_->Send(buf, send_type::SEND)) {
-                        megamol::core::utility::log::Log::DefaultLog.WriteError(
-                            "FBOTransmitter2: Error during send in 'transmitterJob'\n");
+                bool const v1 = this->proto_version_ < 2;
+                if (this->encoded_ready_) {
+                    swap(buf, this->encoded_msg_);
+                    this->encoded_ready_ = false;
+                    if (v1) {
+                        this->sent_msg_v1_ = buf;
                     }
+                } else if (v1 && !this->sent_msg_v1_.empty()) {
+                    // version 1 compositors do not know MsgUnchanged, repeat the previous frame
+                    buf = this->sent_msg_v1_;
+                } else {
+                    // nothing new has been rendered, the compositor keeps the previous frame
+                    fbo_msg_header_t unchanged{};
+                    unchanged.flags = MsgUnchanged;
+                    buf.assign(reinterpret_cast<char*>(&unchanged),
+                        reinterpret_cast<char*>(&unchanged) + fbo_msg_header_size(this->proto_version_));
+                }
+            }
+            this->encoder_cond_.notify_one();
+
+            // send data
+            try {
 #if _DEBUG
-                    else {
-                        megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Answer sent\n");
-                    }
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Sending answer\n");
 #endif
-                } catch (zmq::error_t const& e) {
+                if (!this->comm_->Send(buf, send_type::SEND)) {
                     megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "FBOTransmitter2: Exception during send in 'transmitterJob': %s\n", e.what());
-                } catch (...) {
-                    megamol::core::utility::log::Log::DefaultLog.WriteError(
-                        "FBOTransmitter2: Exception during send in 'transmitterJob'\n");
+                        "FBOTransmitter2: Error during send in 'transmitterJob'\n");
+                }
+#if _DEBUG
+                else {
+                    megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Answer sent\n");
                 }
+#endif
+            } catch (zmq::error_t const& e) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "FBOTransmitter2: Exception during send in 'transmitterJob': %s\n", e.what());
+            } catch (...) {
+                megamol::core::utility::log::Log::DefaultLog.WriteError(
+                    "FBOTransmitter2: Exception during send in 'transmitterJob'\n");
             }
         }
     } catch (...) {
@@ -397,6 +378,71 @@ void megamol::remote::FBOTransmitter2::transmitterJob() {
 }
 
 
+void megamol::remote::FBOTransmitter2::encoderJob() {
+    // delta frames are only valid on top of the previous message, start over regularly
+    unsigned int const keyframe_interval = 60;
+
+    try {
+        std::vector<char> col_enc_buf;
+        std::vector<char> depth_enc_buf;
+        std::vector<char> msg;
+        while (true) {
+            // wait until a new frame is available and the last message has been sent, so no message a delta frame
+            // depends on is skipped
+            {
+                std::unique_lock<std::mutex> send_lock(this->buffer_send_guard_);
+                this->encoder_cond_.wait(send_lock,
+                    [this]() { return this->thread_stop_ || (this->new_frame_ && !this->encoded_ready_); });
+                if (this->thread_stop_) break;
+                swap(this->fbo_msg_send_, this->fbo_msg_enc_);
+                swap(this->color_buf_send_, this->color_buf_enc_);
+                swap(this->depth_buf_send_, this->depth_buf_enc_);
+                this->new_frame_ = false;
+            }
+
+            auto const& color = *this->color_buf_enc_;
+            bool const v1 = this->proto_version_ < 2;
+            bool const requested = this->force_keyframe_.exchange(false);
+            bool const keyframe = v1 || requested || (this->color_codec_ != ColDelta) ||
+                                  (this->delta_base_.size() != color.size()) ||
+                                  (this->frames_since_keyframe_ >= keyframe_interval);
+            if (v1) {
+                EncodeSnappyBlock(color, col_enc_buf);
+                EncodeSnappyBlock(*this->depth_buf_enc_, depth_enc_buf);
+            } else {
+                EncodeColor(this->color_codec_, color, keyframe ? nullptr : &this->delta_base_, col_enc_buf);
+                EncodeDepth(this->depth_codec_, *this->depth_buf_enc_, depth_enc_buf);
+            }
+            if (!v1 && this->color_codec_ == ColDelta) {
+                this->delta_base_ = color;
+                this->frames_since_keyframe_ = keyframe ? 0 : this->frames_since_keyframe_ + 1;
+            }
+
+            // compose message from header, color_buf, and depth_buf; version 1 peers only know the leading fields
+            auto& header = *this->fbo_msg_enc_;
+            header.color_codec = this->color_codec_;
+            header.depth_codec = this->depth_codec_;
+            header.flags = keyframe ? MsgKeyframe : 0u;
+            header.color_buf_size = col_enc_buf.size();
+            header.depth_buf_size = depth_enc_buf.size();
+            auto const header_size = fbo_msg_header_size(this->proto_version_);
+            msg.resize(header_size + col_enc_buf.size() + depth_enc_buf.size());
+            std::copy(reinterpret_cast<char*>(&header), reinterpret_cast<char*>(&header) + header_size, msg.data());
+            std::copy(col_enc_buf.begin(), col_enc_buf.end(), msg.data() + header_size);
+            std::copy(depth_enc_buf.begin(), depth_enc_buf.end(), msg.data() + header_size + col_enc_buf.size());
+
+            {
+                std::lock_guard<std::mutex> send_lock(this->buffer_send_guard_);
+                swap(this->encoded_msg_, msg);
+                this->encoded_ready_ = true;
+            }
+        }
+    } catch (...) {
+        megamol::core::utility::log::Log::DefaultLog.WriteError("FBOTransmitter2: EncoderJob died\n");
+    }
+}
+
+
 bool megamol::remote::FBOTransmitter2::triggerButtonClicked(megamol::core::param::ParamSlot& slot) {
     // happy trigger finger hit button action happened
     using megamol::core::utility::log::Log;
@@ -649,6 +695,14 @@ bool megamol::remote::FBOTransmitter2::initThreads() {
             sprintf(stuff, "tcp://%s:%s", hostname.c_str(), address.c_str());
             auto name = std::string{stuff};
             std::vector<char> buf(name.begin(), name.end()); //<TODO there should be a better way
+            // offer the supported codecs behind the name, the compositor answers with its choice
+            auto const offer = SupportedCodecs();
+            buf.push_back('\0');
+            buf.insert(buf.end(), reinterpret_cast<char const*>(&offer),
+                reinterpret_cast<char const*>(&offer) + sizeof(fbo_codec_offer));
+            this->proto_version_ = 1;
+            this->color_codec_ = ColSnappy;
+            this->depth_codec_ = DepthSnappy;
             try {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Sending client name %s\n", name.c_str());
@@ -671,6 +725,21 @@ bool megamol::remote::FBOTransmitter2::initThreads() {
 #if _DEBUG
                 megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Received client ack\n");
 #endif
+                // compositors without codec negotiation echo the name and speak protocol version 1
+                if (buf.size() == sizeof(fbo_codec_choice)) {
+                    fbo_codec_choice choice;
+                    std::copy(buf.begin(), buf.end(), reinterpret_cast<char*>(&choice));
+                    if ((choice.version >= 2) && (choice.color_codec <= ColDelta) &&
+                        (choice.depth_codec <= DepthQ24) && (offer.color_codecs & (1u << choice.color_codec)) &&
+                        (offer.depth_codecs & (1u << choice.depth_codec))) {
+                        this->proto_version_ = std::min(choice.version, fbo_proto_version);
+                        this->color_codec_ = choice.color_codec;
+                        this->depth_codec_ = choice.depth_codec;
+                    }
+                }
+                megamol::core::utility::log::Log::DefaultLog.WriteInfo(
+                    "FBOTransmitter2: Using protocol version %u with color codec %u and depth codec %u\n",
+                    this->proto_version_, this->color_codec_, this->depth_codec_);
 
 
 #if _DEBUG
@@ -701,8 +770,12 @@ bool megamol::remote::FBOTransmitter2::initThreads() {
             this->comm_->Bind(std::string{"tcp://*:"} + address);
 
             this->thread_stop_ = false;
+            this->new_frame_ = false;
+            this->encoded_ready_ = false;
+            this->delta_base_.clear();
 
             this->transmitter_thread_ = std::thread(&FBOTransmitter2::transmitterJob, this);
+            this->encoder_thread_ = std::thread(&FBOTransmitter2::encoderJob, this);
 
             megamol::core::utility::log::Log::DefaultLog.WriteInfo("FBOTransmitter2: Connection established.\n");
 
@@ -717,10 +790,15 @@ bool megamol::remote::FBOTransmitter2::initThreads() {
 
 
 bool megamol::remote::FBOTransmitter2::shutdownThreads() {
-    this->thread_stop_ = true;
+    {
+        std::lock_guard<std::mutex> send_lock(this->buffer_send_guard_);
+        this->thread_stop_ = true;
+    }
+    this->encoder_cond_.notify_all();
     // shutdown_ = true;
 
     if (this->transmitter_thread_.joinable()) this->transmitter_thread_.join();
+    if (this->encoder_thread_.joinable()) this->encoder_thread_.join();
 
 #ifdef WITH_MPI
     if (useMpi) {
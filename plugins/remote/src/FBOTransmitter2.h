@@ -73,14 +73,21 @@ protected:
 
 private:
     void swapBuffers(void) {
-        std::scoped_lock<std::mutex, std::mutex> guard{this->buffer_send_guard_, this->buffer_read_guard_};
-        swap(fbo_msg_read_, fbo_msg_send_);
-        swap(color_buf_read_, color_buf_send_);
-        swap(depth_buf_read_, depth_buf_send_);
+        {
+            std::scoped_lock<std::mutex, std::mutex> guard{this->buffer_send_guard_, this->buffer_read_guard_};
+            swap(fbo_msg_read_, fbo_msg_send_);
+            swap(color_buf_read_, color_buf_send_);
+            swap(depth_buf_read_, depth_buf_send_);
+            new_frame_ = true;
+        }
+        encoder_cond_.notify_one();
     }
 
     void transmitterJob();
 
+    /** Encodes the latest frame while the next one is rendered */
+    void encoderJob();
+
     bool triggerButtonClicked(core::param::ParamSlot& slot);
 
     bool extractMetaData(float bbox[6], float frame_times[2], float cam_params[9]);
@@ -151,6 +158,17 @@ private:
 
     std::thread transmitter_thread_;
 
+    std::thread encoder_thread_;
+
+    /** signals the encoder a new frame or a sent message, uses buffer_send_guard_ */
+    std::condition_variable encoder_cond_;
+
+    /** the send buffers hold a frame which has not been encoded yet */
+    bool new_frame_;
+
+    /** encoded_msg_ holds a message which has not been sent yet */
+    bool encoded_ready_;
+
     std::unique_ptr<fbo_msg_header_t> fbo_msg_read_;
 
     std::unique_ptr<fbo_msg_header_t> fbo_msg_send_;
@@ -163,6 +181,32 @@ private:
 
     std::unique_ptr<std::vector<char>> depth_buf_send_;
 
+    std::unique_ptr<fbo_msg_header_t> fbo_msg_enc_;
+
+    std::unique_ptr<std::vector<char>> color_buf_enc_;
+
+    std::unique_ptr<std::vector<char>> depth_buf_enc_;
+
+    std::vector<char> encoded_msg_;
+
+    /** last message sent to a version 1 compositor, repeated if nothing new has been rendered */
+    std::vector<char> sent_msg_v1_;
+
+    /** color of the previously encoded message, base of ColDelta */
+    std::vector<char> delta_base_;
+
+    unsigned int frames_since_keyframe_;
+
+    /** set by a keyframe request of the compositor, e.g. after it lost a delta base */
+    std::atomic<bool> force_keyframe_;
+
+    /** protocol version and codecs selected by the compositor during the handshake */
+    unsigned int proto_version_;
+
+    fbo_color_codec color_codec_;
+
+    fbo_depth_codec depth_codec_;
+
     std::unique_ptr<AbstractCommFabric> comm_impl_;
 
     std::unique_ptr<FBOCommFabric> comm_;